@@ -0,0 +1,64 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "DiagonalRegion.h"
+#include "SC4CellRegion.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+namespace BenchmarkRegions
+{
+	// The square selection sizes, 8x8 to 1024x1024 cells.
+	inline void SizeRange(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->RangeMultiplier(4)->Range(8, 1024);
+	}
+
+	// Every selection size combined with every diagonal thickness the tool allows.
+	inline void SizeAndThicknessRange(benchmark::internal::Benchmark* benchmark)
+	{
+		for (int64_t size : benchmark::CreateRange(8, 1024, 4))
+		{
+			for (int64_t thickness = -9; thickness <= 9; thickness++)
+			{
+				if (thickness != 0)
+				{
+					benchmark->Args({ size, thickness });
+				}
+			}
+		}
+	}
+
+	// A thick diagonal that starts at the specified corner offset.
+	inline SC4CellRegion<int32_t> CreateDiagonal(int32_t offset, int32_t size, int32_t thickness)
+	{
+		return DiagonalRegion::Create(offset, offset, offset + size - 1, offset + size - 1, thickness);
+	}
+
+	// Reports the number of cells in the selection bounds that each iteration processes.
+	inline void SetCellsProcessed(benchmark::State& state, int64_t cellsPerIteration)
+	{
+		state.counters["cells/s"] = benchmark::Counter(
+			static_cast<double>(cellsPerIteration),
+			benchmark::Counter::kIsIterationInvariantRate);
+	}
+}
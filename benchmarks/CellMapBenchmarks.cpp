@@ -0,0 +1,197 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRegions.h"
+#include "cRZCellMap.h"
+#include <algorithm>
+
+namespace
+{
+	// The earlier cRZCellMap storage and copy constructor, one allocation per row and
+	// a copy that reads and writes each cell.
+	class PerRowCellMap
+	{
+	public:
+		PerRowCellMap(uint32_t rows, uint32_t columns, bool value)
+			: rows(rows),
+			  columns(columns),
+			  columnIntegerCount((columns + 31) / 32),
+			  data(new uint32_t*[rows])
+		{
+			for (uint32_t i = 0; i < rows; i++)
+			{
+				data[i] = new uint32_t[columnIntegerCount];
+				std::fill_n(data[i], columnIntegerCount, value ? 0xffffffff : 0);
+			}
+		}
+
+		PerRowCellMap(const PerRowCellMap& other)
+			: rows(other.rows),
+			  columns(other.columns),
+			  columnIntegerCount(other.columnIntegerCount),
+			  data(new uint32_t*[rows])
+		{
+			for (uint32_t i = 0; i < rows; i++)
+			{
+				data[i] = new uint32_t[columnIntegerCount];
+			}
+
+			for (uint32_t x = 0; x < rows; x++)
+			{
+				for (uint32_t y = 0; y < columns; y++)
+				{
+					SetValue(x, y, other.GetValue(x, y));
+				}
+			}
+		}
+
+		PerRowCellMap& operator=(const PerRowCellMap&) = delete;
+
+		~PerRowCellMap()
+		{
+			for (uint32_t i = 0; i < rows; i++)
+			{
+				delete[] data[i];
+			}
+
+			delete[] data;
+		}
+
+		bool GetValue(uint32_t row, uint32_t column) const
+		{
+			return (data[row][column / 32] & (1U << (column & 31))) != 0;
+		}
+
+		void SetValue(uint32_t row, uint32_t column, bool value)
+		{
+			if (value)
+			{
+				data[row][column / 32] |= 1U << (column & 31);
+			}
+			else
+			{
+				data[row][column / 32] &= ~(1U << (column & 31));
+			}
+		}
+
+		const uint32_t* GetRowWords(uint32_t row) const
+		{
+			return data[row];
+		}
+
+	private:
+		uint32_t rows;
+		uint32_t columns;
+		uint32_t columnIntegerCount;
+		uint32_t** data;
+	};
+
+	void BM_CellMapCopyConstructPerBit(benchmark::State& state)
+	{
+		const uint32_t size = static_cast<uint32_t>(state.range(0));
+		const PerRowCellMap source(size, size, true);
+
+		for (auto _ : state)
+		{
+			PerRowCellMap copy(source);
+			benchmark::DoNotOptimize(copy.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	void BM_CellMapCopyConstruct(benchmark::State& state)
+	{
+		const uint32_t size = static_cast<uint32_t>(state.range(0));
+		const cRZCellMap source(size, size, true);
+
+		for (auto _ : state)
+		{
+			cRZCellMap copy(source);
+			benchmark::DoNotOptimize(copy.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	// Assigning a map with the same dimensions reuses the existing allocation.
+	void BM_CellMapCopyAssign(benchmark::State& state)
+	{
+		const uint32_t size = static_cast<uint32_t>(state.range(0));
+		const cRZCellMap source(size, size, true);
+		cRZCellMap target(size, size, false);
+
+		for (auto _ : state)
+		{
+			target = source;
+			benchmark::DoNotOptimize(target.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	void BM_CellMapFillSpan(benchmark::State& state)
+	{
+		const uint32_t size = static_cast<uint32_t>(state.range(0));
+		cRZCellMap map(size, size, false);
+
+		for (auto _ : state)
+		{
+			for (uint32_t row = 0; row < size; row++)
+			{
+				map.FillSpan(row, row / 2, size - 1 - (row / 4), true);
+			}
+
+			benchmark::DoNotOptimize(map.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	void BM_CellMapGetValue(benchmark::State& state)
+	{
+		const uint32_t size = static_cast<uint32_t>(state.range(0));
+		const cRZCellMap map(size, size, true);
+
+		for (auto _ : state)
+		{
+			uint32_t count = 0;
+
+			for (uint32_t row = 0; row < size; row++)
+			{
+				for (uint32_t column = 0; column < size; column++)
+				{
+					count += map.GetValue(row, column);
+				}
+			}
+
+			benchmark::DoNotOptimize(count);
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+}
+
+BENCHMARK(BM_CellMapCopyConstructPerBit)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellMapCopyConstruct)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellMapCopyAssign)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellMapFillSpan)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellMapGetValue)->Apply(BenchmarkRegions::SizeRange);
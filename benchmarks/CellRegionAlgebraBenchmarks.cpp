@@ -0,0 +1,264 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRegions.h"
+#include "CellRegionAlgebra.h"
+#include <algorithm>
+
+namespace
+{
+	// The second region is offset by a number of cells that is not a multiple of 32,
+	// so its words have to be shifted into the target's grid.
+	constexpr int32_t MisalignedOffset = 13;
+
+	// The per-bit loops that the demolish hooks used before CellRegionAlgebra, every cell
+	// is read with GetValue and written with SetValue.
+	namespace PerBit
+	{
+		bool GetCell(const SC4CellRegion<int32_t>& region, int32_t x, int32_t z)
+		{
+			const SC4Rect<int32_t>& bounds = region.bounds;
+
+			if (x < bounds.topLeftX || x > bounds.bottomRightX || z < bounds.topLeftY || z > bounds.bottomRightY)
+			{
+				return false;
+			}
+
+			return region.cellMap.GetValue(
+				static_cast<uint32_t>(x - bounds.topLeftX),
+				static_cast<uint32_t>(z - bounds.topLeftY));
+		}
+
+		bool Combine(bool target, bool source, CellRegionAlgebra::Operation operation)
+		{
+			switch (operation)
+			{
+			case CellRegionAlgebra::Operation::Union:
+				return target || source;
+			case CellRegionAlgebra::Operation::Intersection:
+				return target && source;
+			case CellRegionAlgebra::Operation::Difference:
+				return target && !source;
+			case CellRegionAlgebra::Operation::SymmetricDifference:
+			default:
+				return target != source;
+			}
+		}
+
+		void Apply(SC4CellRegion<int32_t>& target, const SC4CellRegion<int32_t>& source, CellRegionAlgebra::Operation operation)
+		{
+			const uint32_t width = target.cellMap.GetRowCount();
+			const uint32_t height = target.cellMap.GetColumnCount();
+
+			for (uint32_t x = 0; x < width; x++)
+			{
+				for (uint32_t z = 0; z < height; z++)
+				{
+					const bool sourceValue = GetCell(
+						source,
+						target.bounds.topLeftX + static_cast<int32_t>(x),
+						target.bounds.topLeftY + static_cast<int32_t>(z));
+
+					target.cellMap.SetValue(x, z, Combine(target.cellMap.GetValue(x, z), sourceValue, operation));
+				}
+			}
+		}
+
+		SC4CellRegion<int32_t> Union(const SC4CellRegion<int32_t>& first, const SC4CellRegion<int32_t>& second)
+		{
+			SC4CellRegion<int32_t> result(
+				(std::min)(first.bounds.topLeftX, second.bounds.topLeftX),
+				(std::min)(first.bounds.topLeftY, second.bounds.topLeftY),
+				(std::max)(first.bounds.bottomRightX, second.bounds.bottomRightX),
+				(std::max)(first.bounds.bottomRightY, second.bounds.bottomRightY),
+				false);
+
+			PerBit::Apply(result, first, CellRegionAlgebra::Operation::Union);
+			PerBit::Apply(result, second, CellRegionAlgebra::Operation::Union);
+
+			return result;
+		}
+
+		uint32_t CountCells(const SC4CellRegion<int32_t>& region)
+		{
+			const uint32_t width = region.cellMap.GetRowCount();
+			const uint32_t height = region.cellMap.GetColumnCount();
+			uint32_t count = 0;
+
+			for (uint32_t x = 0; x < width; x++)
+			{
+				for (uint32_t z = 0; z < height; z++)
+				{
+					if (region.cellMap.GetValue(x, z))
+					{
+						count++;
+					}
+				}
+			}
+
+			return count;
+		}
+
+		bool AnyCellInRect(const SC4CellRegion<int32_t>& region, const SC4Rect<int32_t>& rect)
+		{
+			for (int32_t x = rect.topLeftX; x <= rect.bottomRightX; x++)
+			{
+				for (int32_t z = rect.topLeftY; z <= rect.bottomRightY; z++)
+				{
+					if (GetCell(region, x, z))
+					{
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+	}
+
+	void BM_CellRegionUnion(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4CellRegion<int32_t> first = BenchmarkRegions::CreateDiagonal(0, size, 5);
+		const SC4CellRegion<int32_t> second = BenchmarkRegions::CreateDiagonal(MisalignedOffset, size, -5);
+
+		for (auto _ : state)
+		{
+			SC4CellRegion<int32_t> result = CellRegionAlgebra::Union(first, second);
+			benchmark::DoNotOptimize(result.cellMap.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size + MisalignedOffset) * (size + MisalignedOffset));
+	}
+
+	void BM_CellRegionUnionPerBit(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4CellRegion<int32_t> first = BenchmarkRegions::CreateDiagonal(0, size, 5);
+		const SC4CellRegion<int32_t> second = BenchmarkRegions::CreateDiagonal(MisalignedOffset, size, -5);
+
+		for (auto _ : state)
+		{
+			SC4CellRegion<int32_t> result = PerBit::Union(first, second);
+			benchmark::DoNotOptimize(result.cellMap.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size + MisalignedOffset) * (size + MisalignedOffset));
+	}
+
+	void BM_CellRegionApply(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const auto operation = static_cast<CellRegionAlgebra::Operation>(state.range(1));
+		const SC4CellRegion<int32_t> source = BenchmarkRegions::CreateDiagonal(MisalignedOffset, size, 9);
+		SC4CellRegion<int32_t> target(0, 0, size - 1, size - 1, true);
+
+		for (auto _ : state)
+		{
+			CellRegionAlgebra::Apply(target, source, operation);
+			benchmark::DoNotOptimize(target.cellMap.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	void BM_CellRegionApplyPerBit(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const auto operation = static_cast<CellRegionAlgebra::Operation>(state.range(1));
+		const SC4CellRegion<int32_t> source = BenchmarkRegions::CreateDiagonal(MisalignedOffset, size, 9);
+		SC4CellRegion<int32_t> target(0, 0, size - 1, size - 1, true);
+
+		for (auto _ : state)
+		{
+			PerBit::Apply(target, source, operation);
+			benchmark::DoNotOptimize(target.cellMap.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	void BM_CellRegionCountCells(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4CellRegion<int32_t> region = BenchmarkRegions::CreateDiagonal(0, size, 9);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CellRegionAlgebra::CountCells(region));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	void BM_CellRegionCountCellsPerBit(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4CellRegion<int32_t> region = BenchmarkRegions::CreateDiagonal(0, size, 9);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(PerBit::CountCells(region));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	// The rectangle is the empty corner of the diagonal, so every word is tested.
+	void BM_CellRegionAnyCellInRect(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4CellRegion<int32_t> region = BenchmarkRegions::CreateDiagonal(0, size, 1);
+		const SC4Rect<int32_t> rect(size / 2 + 2, 0, size - 1, size / 2 - 2);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CellRegionAlgebra::AnyCellInRect(region, rect));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size / 2) * (size / 2));
+	}
+
+	void BM_CellRegionAnyCellInRectPerBit(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4CellRegion<int32_t> region = BenchmarkRegions::CreateDiagonal(0, size, 1);
+		const SC4Rect<int32_t> rect(size / 2 + 2, 0, size - 1, size / 2 - 2);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(PerBit::AnyCellInRect(region, rect));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size / 2) * (size / 2));
+	}
+}
+
+BENCHMARK(BM_CellRegionUnion)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellRegionUnionPerBit)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellRegionApply)
+	->ArgsProduct({ benchmark::CreateRange(8, 1024, 4), benchmark::CreateDenseRange(0, 3, 1) });
+BENCHMARK(BM_CellRegionApplyPerBit)
+	->ArgsProduct({ benchmark::CreateRange(8, 1024, 4), benchmark::CreateDenseRange(0, 3, 1) });
+BENCHMARK(BM_CellRegionCountCells)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellRegionCountCellsPerBit)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellRegionAnyCellInRect)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_CellRegionAnyCellInRectPerBit)->Apply(BenchmarkRegions::SizeRange);
@@ -0,0 +1,105 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRegions.h"
+#include "DiagonalRegion.h"
+#include "DiagonalRegionBuilder.h"
+
+namespace
+{
+	void BM_DiagonalRegionCreate(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const int32_t thickness = static_cast<int32_t>(state.range(1));
+
+		for (auto _ : state)
+		{
+			SC4CellRegion<int32_t> region = DiagonalRegion::Create(0, 0, size - 1, size - 1, thickness);
+			benchmark::DoNotOptimize(region.cellMap.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	// A drag that grows the selection by one cell on each axis per update, which is
+	// what the builder sees while the mouse moves.
+	void BM_DiagonalRegionBuilderDrag(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		DiagonalRegionBuilder builder;
+
+		for (auto _ : state)
+		{
+			builder.Reset();
+
+			for (int32_t end = 0; end < size; end++)
+			{
+				builder.Update(SC4Rect<int32_t>(0, 0, end, end), 0, 0, 3);
+				benchmark::DoNotOptimize(builder.GetRegion().cellMap.GetRowWords(0));
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * size);
+	}
+
+	// Thickness changes from the mouse wheel, the selection bounds do not change.
+	void BM_DiagonalRegionBuilderThickness(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4Rect<int32_t> bounds(0, 0, size - 1, size - 1);
+		DiagonalRegionBuilder builder;
+		int32_t thickness = 1;
+
+		for (auto _ : state)
+		{
+			thickness = thickness == 9 ? 1 : thickness + 1;
+
+			builder.Update(bounds, 0, 0, thickness);
+			benchmark::DoNotOptimize(builder.GetRegion().cellMap.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	// Writes the pattern into a region that the game owns, as the preview does.
+	void BM_DiagonalRegionBuilderWriteTo(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4Rect<int32_t> bounds(0, 0, size - 1, size - 1);
+		SC4CellRegion<int32_t> target(0, 0, size - 1, size - 1, false);
+		DiagonalRegionBuilder builder;
+
+		builder.Update(bounds, 0, 0, 5);
+
+		for (auto _ : state)
+		{
+			builder.WriteTo(target);
+			benchmark::DoNotOptimize(target.cellMap.GetRowWords(0));
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+}
+
+BENCHMARK(BM_DiagonalRegionCreate)->Apply(BenchmarkRegions::SizeAndThicknessRange);
+BENCHMARK(BM_DiagonalRegionBuilderDrag)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_DiagonalRegionBuilderThickness)->Apply(BenchmarkRegions::SizeRange);
+BENCHMARK(BM_DiagonalRegionBuilderWriteTo)->Apply(BenchmarkRegions::SizeRange);
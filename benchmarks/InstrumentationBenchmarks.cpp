@@ -0,0 +1,71 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The instrumentation macros in a build without BULLDOZE_EXTENSIONS_INSTRUMENTATION,
+// InstrumentationEnabledBenchmarks.cpp measures the same code with it.
+#include "Instrumentation.h"
+#include "InstrumentationBenchmarks.h"
+#include <benchmark/benchmark.h>
+
+#ifdef BULLDOZE_EXTENSIONS_INSTRUMENTATION
+#error The instrumentation must be disabled in this file.
+#endif
+
+namespace
+{
+	int32_t StepThicknessInstrumented(int32_t thickness, int32_t wheelDelta)
+	{
+		INSTRUMENTATION_SCOPE(DiagonalRegion);
+		INSTRUMENTATION_COUNT(MouseWheelCalls, 1);
+
+		return InstrumentationBenchmarks::StepThickness(thickness, wheelDelta);
+	}
+}
+
+// The hook body without any instrumentation macros.
+static void BM_HookWithoutInstrumentation(benchmark::State& state)
+{
+	int32_t thickness = 1;
+	int32_t wheelDelta = 120;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(wheelDelta);
+		thickness = InstrumentationBenchmarks::StepThickness(thickness, wheelDelta);
+		benchmark::DoNotOptimize(thickness);
+	}
+}
+BENCHMARK(BM_HookWithoutInstrumentation);
+
+// The same hook body with the instrumentation macros compiled out.
+static void BM_HookWithInstrumentationDisabled(benchmark::State& state)
+{
+	int32_t thickness = 1;
+	int32_t wheelDelta = 120;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(wheelDelta);
+		thickness = StepThicknessInstrumented(thickness, wheelDelta);
+		benchmark::DoNotOptimize(thickness);
+	}
+}
+BENCHMARK(BM_HookWithInstrumentationDisabled);
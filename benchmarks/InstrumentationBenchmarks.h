@@ -0,0 +1,45 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+namespace InstrumentationBenchmarks
+{
+	// The diagonal thickness step of the mouse wheel hook, a hook body that is
+	// short enough for any instrumentation cost to show.
+	inline int32_t StepThickness(int32_t thickness, int32_t wheelDelta)
+	{
+		constexpr int32_t maxThickness = 9;
+
+		if (wheelDelta > 0)
+		{
+			return thickness == -1 ? 1 : (std::min)(thickness + 1, maxThickness);
+		}
+		else if (wheelDelta < 0)
+		{
+			return thickness == 1 ? -1 : (std::max)(thickness - 1, -maxThickness);
+		}
+
+		return thickness;
+	}
+}
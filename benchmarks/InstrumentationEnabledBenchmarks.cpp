@@ -0,0 +1,55 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The instrumentation macros in a build with BULLDOZE_EXTENSIONS_INSTRUMENTATION, the
+// CMake project compiles this file and Instrumentation.cpp with the definition.
+#include "Instrumentation.h"
+#include "InstrumentationBenchmarks.h"
+#include <benchmark/benchmark.h>
+
+#ifndef BULLDOZE_EXTENSIONS_INSTRUMENTATION
+#error The instrumentation must be enabled in this file.
+#endif
+
+namespace
+{
+	int32_t StepThicknessInstrumented(int32_t thickness, int32_t wheelDelta)
+	{
+		INSTRUMENTATION_SCOPE(DiagonalRegion);
+		INSTRUMENTATION_COUNT(MouseWheelCalls, 1);
+
+		return InstrumentationBenchmarks::StepThickness(thickness, wheelDelta);
+	}
+}
+
+static void BM_HookWithInstrumentationEnabled(benchmark::State& state)
+{
+	int32_t thickness = 1;
+	int32_t wheelDelta = 120;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(wheelDelta);
+		thickness = StepThicknessInstrumented(thickness, wheelDelta);
+		benchmark::DoNotOptimize(thickness);
+	}
+}
+BENCHMARK(BM_HookWithInstrumentationEnabled);
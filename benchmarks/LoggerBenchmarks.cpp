@@ -0,0 +1,243 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <string>
+
+namespace
+{
+	constexpr const char* Message = "Demolished the selection from (120, 84) to (143, 112), 672 cells.";
+
+	Logger& GetLogger()
+	{
+		static bool initialized = false;
+
+		Logger& logger = Logger::GetInstance();
+
+		if (!initialized)
+		{
+			initialized = true;
+			logger.Init(std::filesystem::temp_directory_path() / "BulldozeExtensionsBenchmarks.log", LogLevel::Info);
+		}
+
+		return logger;
+	}
+
+	// The formatting of the WriteLineFormatted version that measured the line with a
+	// first vsnprintf call and then formatted it into a zeroed stack buffer.
+	size_t FormatTwoPass(const char* format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+
+		const int length = std::vsnprintf(nullptr, 0, format, argsCopy);
+
+		va_end(argsCopy);
+
+		char buffer[1024]{};
+
+		std::vsnprintf(buffer, sizeof(buffer), format, args);
+		benchmark::DoNotOptimize(buffer);
+
+		va_end(args);
+
+		return static_cast<size_t>(length);
+	}
+
+	// The formatting of the current WriteLineFormatted, which formats into the stack
+	// buffer once and only formats again for lines that do not fit.
+	size_t FormatSinglePass(const char* format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+
+		char buffer[1024];
+
+		const int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+		benchmark::DoNotOptimize(buffer);
+
+		va_end(args);
+
+		return static_cast<size_t>(length);
+	}
+
+	// The formatting of the std::format style WriteLine, into a buffer that is reused.
+	template<typename... Args>
+	size_t FormatLogFormat(std::string& buffer, LogFormat::format_string<Args...> format, Args&&... args)
+	{
+		buffer.clear();
+		LogFormat::vformat_to(std::back_inserter(buffer), LogFormat::GetFormat<Args...>(format), LogFormat::make_format_args(args...));
+		benchmark::DoNotOptimize(buffer.data());
+
+		return buffer.size();
+	}
+}
+
+// The time that the calling thread spends in WriteLine when every line is written
+// and flushed to the file by the calling thread.
+static void BM_LoggerWriteLineSync(benchmark::State& state)
+{
+	Logger& logger = GetLogger();
+
+	for (auto _ : state)
+	{
+		logger.WriteLine(LogLevel::Info, Message);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerWriteLineSync);
+
+// The time that the calling thread spends in WriteLine when the lines are queued
+// for the background writer. The lines that are still queued when the loop ends
+// are written by Shutdown, outside of the measured time.
+static void BM_LoggerWriteLineAsync(benchmark::State& state)
+{
+	Logger& logger = GetLogger();
+	logger.StartAsyncWriter(static_cast<LogOverflowPolicy>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		logger.WriteLine(LogLevel::Info, Message);
+	}
+
+	logger.Shutdown();
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerWriteLineAsync)
+	->Arg(static_cast<int64_t>(LogOverflowPolicy::Drop))
+	->Arg(static_cast<int64_t>(LogOverflowPolicy::Block));
+
+// The number of lines per second that reach the file, the time includes the
+// Shutdown call that waits for the writer to finish the queued lines.
+static void BM_LoggerAsyncThroughput(benchmark::State& state)
+{
+	constexpr int64_t LinesPerIteration = 100000;
+
+	Logger& logger = GetLogger();
+
+	for (auto _ : state)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		logger.StartAsyncWriter(LogOverflowPolicy::Block);
+
+		for (int64_t i = 0; i < LinesPerIteration; i++)
+		{
+			logger.WriteLine(LogLevel::Info, Message);
+		}
+
+		logger.Shutdown();
+
+		const auto end = std::chrono::steady_clock::now();
+
+		state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+	}
+
+	state.SetItemsProcessed(state.iterations() * LinesPerIteration);
+}
+BENCHMARK(BM_LoggerAsyncThroughput)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+static void BM_FormatVsnprintfTwoPass(benchmark::State& state)
+{
+	int32_t cellCount = 672;
+	long long cost = 13440;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cellCount);
+		benchmark::DoNotOptimize(FormatTwoPass("Previewed %d cells, cost: %lld", cellCount, cost));
+	}
+}
+BENCHMARK(BM_FormatVsnprintfTwoPass);
+
+static void BM_FormatVsnprintfSinglePass(benchmark::State& state)
+{
+	int32_t cellCount = 672;
+	long long cost = 13440;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cellCount);
+		benchmark::DoNotOptimize(FormatSinglePass("Previewed %d cells, cost: %lld", cellCount, cost));
+	}
+}
+BENCHMARK(BM_FormatVsnprintfSinglePass);
+
+static void BM_FormatLogFormat(benchmark::State& state)
+{
+	int32_t cellCount = 672;
+	int64_t cost = 13440;
+	std::string buffer;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cellCount);
+		benchmark::DoNotOptimize(FormatLogFormat(buffer, "Previewed {} cells, cost: {}", cellCount, cost));
+	}
+}
+BENCHMARK(BM_FormatLogFormat);
+
+// A line below the log level, the arguments are not formatted.
+static void BM_LogLineDisabledLevel(benchmark::State& state)
+{
+	GetLogger();
+
+	int32_t cellCount = 672;
+	int64_t cost = 13440;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cellCount);
+		LOG_LINE(LogLevel::Debug, "Previewed {} cells, cost: {}", cellCount, cost);
+	}
+}
+BENCHMARK(BM_LogLineDisabledLevel);
+
+// A rate-limited line that is enabled, almost every call is rejected by the limiter.
+static void BM_LogLineRateLimited(benchmark::State& state)
+{
+	Logger& logger = GetLogger();
+	logger.SetLogLevel(LogLevel::Debug);
+
+	int32_t cellCount = 672;
+	int64_t cost = 13440;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(cellCount);
+		LOG_LINE_RATE_LIMITED(LogLevel::Debug, 1000, "Previewed {} cells, cost: {}", cellCount, cost);
+	}
+
+	logger.SetLogLevel(LogLevel::Info);
+}
+BENCHMARK(BM_LogLineRateLimited);
@@ -0,0 +1,323 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FloraOccupantFilter.h"
+#include "NetworkOccupantFilter.h"
+#include "OccupantGrid.h"
+#include "PredicateOccupantFilter.h"
+#include "cISC4NetworkOccupant.h"
+#include "cRZAutoRefCount.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	constexpr int32_t CitySize = 128;
+
+	// The occupants in the order that a DemolishRegion call over the whole city visits them,
+	// an occupant is visited once for each cell it covers.
+	class OccupantVisits
+	{
+	public:
+		OccupantVisits()
+			: grid(CitySize)
+		{
+			const SC4Rect<int32_t> city(0, 0, CitySize - 1, CitySize - 1);
+
+			grid.AddForest(city, 60, 7);
+			grid.AddRoadGrid(city, 16);
+			grid.AddRailLine(40, 0, CitySize - 1);
+			grid.AddBuildings(city, 12, 3);
+
+			for (int32_t x = 0; x < CitySize; x++)
+			{
+				for (int32_t z = 0; z < CitySize; z++)
+				{
+					for (MockOccupant* pOccupant : grid.GetOccupants(x, z))
+					{
+						visits.push_back(pOccupant);
+					}
+				}
+			}
+		}
+
+		const std::vector<cISC4Occupant*>& Get() const
+		{
+			return visits;
+		}
+
+	private:
+		OccupantGrid grid;
+		std::vector<cISC4Occupant*> visits;
+	};
+
+	const std::vector<cISC4Occupant*>& GetVisits()
+	{
+		static const OccupantVisits visits;
+
+		return visits.Get();
+	}
+
+	enum class Population : int64_t
+	{
+		// Trees and no networks.
+		Forest = 0,
+		// The city of GetVisits.
+		Town,
+		// Highway pieces that cover 2x2 cells between the trees.
+		Highways,
+		// A road on every other row and column.
+		DenseRoads,
+		Count
+	};
+
+	constexpr const char* PopulationNames[] = { "forest", "town", "highways", "dense roads" };
+
+	// The visits of a whole city DemolishRegion call for each population.
+	class PopulationVisits
+	{
+	public:
+		explicit PopulationVisits(Population population)
+			: grid(CitySize)
+		{
+			const SC4Rect<int32_t> city(0, 0, CitySize - 1, CitySize - 1);
+
+			switch (population)
+			{
+			case Population::Forest:
+				grid.AddForest(city, 80, 11);
+				break;
+			case Population::Town:
+				grid.AddForest(city, 60, 7);
+				grid.AddRoadGrid(city, 16);
+				grid.AddRailLine(40, 0, CitySize - 1);
+				grid.AddBuildings(city, 12, 3);
+				break;
+			case Population::Highways:
+				for (int32_t z = 0; z + 1 < CitySize; z += 8)
+				{
+					for (int32_t x = 0; x + 1 < CitySize; x += 2)
+					{
+						grid.AddNetwork(
+							SC4Rect<int32_t>(x, z, x + 1, z + 1),
+							static_cast<uint32_t>(NetworkTypeFlags::Highway),
+							100);
+					}
+				}
+				grid.AddForest(city, 50, 13);
+				break;
+			case Population::DenseRoads:
+				grid.AddRoadGrid(city, 2);
+				break;
+			case Population::Count:
+				break;
+			}
+
+			for (int32_t x = 0; x < CitySize; x++)
+			{
+				for (int32_t z = 0; z < CitySize; z++)
+				{
+					for (MockOccupant* pOccupant : grid.GetOccupants(x, z))
+					{
+						visits.push_back(pOccupant);
+					}
+				}
+			}
+		}
+
+		const std::vector<cISC4Occupant*>& Get() const
+		{
+			return visits;
+		}
+
+	private:
+		OccupantGrid grid;
+		std::vector<cISC4Occupant*> visits;
+	};
+
+	const std::vector<cISC4Occupant*>& GetPopulationVisits(benchmark::State& state)
+	{
+		static const std::array<PopulationVisits, static_cast<size_t>(Population::Count)> populations =
+		{
+			PopulationVisits(Population::Forest),
+			PopulationVisits(Population::Town),
+			PopulationVisits(Population::Highways),
+			PopulationVisits(Population::DenseRoads),
+		};
+
+		state.SetLabel(PopulationNames[state.range(0)]);
+
+		return populations[static_cast<size_t>(state.range(0))].Get();
+	}
+
+	// The earlier network filter, which queried the network interface of every occupant.
+	class QueryInterfaceNetworkFilter : public cSC4BaseOccupantFilter
+	{
+	public:
+		bool IsOccupantIncluded(cISC4Occupant* pOccupant) override
+		{
+			bool result = false;
+
+			if (pOccupant)
+			{
+				cRZAutoRefCount<cISC4NetworkOccupant> networkOccupant;
+
+				if (pOccupant->QueryInterface(GZIID_cISC4NetworkOccupant, networkOccupant.AsPPVoid()))
+				{
+					result = networkOccupant->HasAnyNetworkFlag(static_cast<uint32_t>(NetworkTypeFlags::AllTransportationNetworks));
+				}
+			}
+
+			return result;
+		}
+	};
+
+	template<typename Filter>
+	uint32_t CountIncluded(Filter& filter, const std::vector<cISC4Occupant*>& visits)
+	{
+		// The calls go through the interface, like the game's calls.
+		cISC4OccupantFilter& occupantFilter = filter;
+		uint32_t included = 0;
+
+		for (cISC4Occupant* pOccupant : visits)
+		{
+			included += occupantFilter.IsOccupantIncluded(pOccupant);
+		}
+
+		return included;
+	}
+
+	void SetVisitsProcessed(benchmark::State& state, const std::vector<cISC4Occupant*>& visits)
+	{
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(visits.size()));
+	}
+
+	void BM_FloraOccupantFilter(benchmark::State& state)
+	{
+		const std::vector<cISC4Occupant*>& visits = GetVisits();
+		FloraOccupantFilter filter;
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CountIncluded(filter, visits));
+		}
+
+		SetVisitsProcessed(state, visits);
+	}
+
+	void BM_PredicateFloraFilter(benchmark::State& state)
+	{
+		const std::vector<cISC4Occupant*>& visits = GetVisits();
+		PredicateOccupantFilter<OccupantFilterPredicates::OccupantTypeIs<OccupantFilterPredicates::kFloraOccupantType>> filter;
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CountIncluded(filter, visits));
+		}
+
+		SetVisitsProcessed(state, visits);
+	}
+
+	void BM_NetworkOccupantFilter(benchmark::State& state)
+	{
+		const std::vector<cISC4Occupant*>& visits = GetVisits();
+		NetworkOccupantFilter filter(NetworkTypeFlags::AllTransportationNetworks);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CountIncluded(filter, visits));
+		}
+
+		SetVisitsProcessed(state, visits);
+	}
+
+	void BM_PredicateNetworkFilter(benchmark::State& state)
+	{
+		const std::vector<cISC4Occupant*>& visits = GetVisits();
+		PredicateOccupantFilter<OccupantFilterPredicates::NetworkTypeIs<NetworkTypeFlags::AllTransportationNetworks>> filter;
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CountIncluded(filter, visits));
+		}
+
+		SetVisitsProcessed(state, visits);
+	}
+
+	// A combined filter that a hand-written class would need a new type for.
+	void BM_PredicateRailOrPropFilter(benchmark::State& state)
+	{
+		const std::vector<cISC4Occupant*>& visits = GetVisits();
+		PredicateOccupantFilter<
+			OccupantFilterPredicates::Or<
+				OccupantFilterPredicates::NetworkTypeIs<NetworkTypeFlags::AllRailNetworks>,
+				OccupantFilterPredicates::OccupantTypeIs<OccupantFilterPredicates::kPropOccupantType>>> filter;
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CountIncluded(filter, visits));
+		}
+
+		SetVisitsProcessed(state, visits);
+	}
+
+	void BM_NetworkFilterQueryInterface(benchmark::State& state)
+	{
+		const std::vector<cISC4Occupant*>& visits = GetPopulationVisits(state);
+		QueryInterfaceNetworkFilter filter;
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CountIncluded(filter, visits));
+		}
+
+		SetVisitsProcessed(state, visits);
+	}
+
+	// The plugin's filter, which checks the type before querying the network interface.
+	void BM_NetworkFilterTypeCheck(benchmark::State& state)
+	{
+		const std::vector<cISC4Occupant*>& visits = GetPopulationVisits(state);
+		NetworkOccupantFilter filter(NetworkTypeFlags::AllTransportationNetworks);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(CountIncluded(filter, visits));
+		}
+
+		SetVisitsProcessed(state, visits);
+	}
+
+	void PopulationRange(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->DenseRange(0, static_cast<int64_t>(Population::Count) - 1);
+	}
+}
+
+BENCHMARK(BM_FloraOccupantFilter);
+BENCHMARK(BM_PredicateFloraFilter);
+BENCHMARK(BM_NetworkOccupantFilter);
+BENCHMARK(BM_PredicateNetworkFilter);
+BENCHMARK(BM_PredicateRailOrPropFilter);
+BENCHMARK(BM_NetworkFilterQueryInterface)->Apply(PopulationRange);
+BENCHMARK(BM_NetworkFilterTypeCheck)->Apply(PopulationRange);
@@ -0,0 +1,95 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupantTypeSet.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+	// The IDs are spread out like the game's occupant type IDs, and half of the
+	// lookups are for types that are not in the set.
+	std::vector<uint32_t> CreateTypes(size_t count, uint32_t seed)
+	{
+		std::vector<uint32_t> types;
+		uint32_t value = seed;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			value = value * 1664525 + 1013904223;
+			types.push_back(value);
+		}
+
+		return types;
+	}
+
+	void BM_OccupantTypeSetContains(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		const std::vector<uint32_t> types = CreateTypes(count, 1);
+		const std::vector<uint32_t> missingTypes = CreateTypes(count, 2);
+		const OccupantTypeSet set(types.data(), types.size());
+
+		for (auto _ : state)
+		{
+			uint32_t matches = 0;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				matches += set.Contains(types[i]);
+				matches += set.Contains(missingTypes[i]);
+			}
+
+			benchmark::DoNotOptimize(matches);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count) * 2);
+	}
+
+	// The lookup that cSC4OccupantTypeFilter uses.
+	void BM_UnorderedSetContains(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		const std::vector<uint32_t> types = CreateTypes(count, 1);
+		const std::vector<uint32_t> missingTypes = CreateTypes(count, 2);
+		const std::unordered_set<uint32_t> set(types.begin(), types.end());
+
+		for (auto _ : state)
+		{
+			uint32_t matches = 0;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				matches += set.find(types[i]) != set.end();
+				matches += set.find(missingTypes[i]) != set.end();
+			}
+
+			benchmark::DoNotOptimize(matches);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count) * 2);
+	}
+}
+
+BENCHMARK(BM_OccupantTypeSetContains)->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK(BM_UnorderedSetContains)->RangeMultiplier(2)->Range(1, 64);
@@ -0,0 +1,69 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRegions.h"
+#include "RegionDecomposition.h"
+#include <vector>
+
+namespace
+{
+	void BM_RegionDecompositionPlan(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const int32_t thickness = static_cast<int32_t>(state.range(1));
+		const SC4CellRegion<int32_t> region = BenchmarkRegions::CreateDiagonal(0, size, thickness);
+		std::vector<SC4Rect<int32_t>> pieces;
+
+		for (auto _ : state)
+		{
+			RegionDecomposition::Plan(region, pieces);
+			benchmark::DoNotOptimize(pieces.data());
+		}
+
+		state.counters["pieces"] = static_cast<double>(pieces.size());
+		state.counters["scannedCells"] = static_cast<double>(RegionDecomposition::GetCellCount(pieces));
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(size) * size);
+	}
+
+	void BM_RegionDecompositionExtract(benchmark::State& state)
+	{
+		const int32_t size = static_cast<int32_t>(state.range(0));
+		const SC4CellRegion<int32_t> region = BenchmarkRegions::CreateDiagonal(0, size, 5);
+		std::vector<SC4Rect<int32_t>> pieces;
+
+		RegionDecomposition::Plan(region, pieces);
+
+		for (auto _ : state)
+		{
+			for (const SC4Rect<int32_t>& piece : pieces)
+			{
+				SC4CellRegion<int32_t> pieceRegion = RegionDecomposition::Extract(region, piece);
+				benchmark::DoNotOptimize(pieceRegion.cellMap.GetRowWords(0));
+			}
+		}
+
+		BenchmarkRegions::SetCellsProcessed(state, static_cast<int64_t>(RegionDecomposition::GetCellCount(pieces)));
+	}
+}
+
+BENCHMARK(BM_RegionDecompositionPlan)
+	->ArgsProduct({ benchmark::CreateRange(8, 1024, 4), { 1, 5, 9 } });
+BENCHMARK(BM_RegionDecompositionExtract)->Apply(BenchmarkRegions::SizeRange);
@@ -23,7 +23,10 @@
 #include "cGZPersistResourceKey.h"
 #include "cSC4ViewInputControlDemolishHooks.h"
 #include "FileSystem.h"
+#include "Instrumentation.h"
 #include "Logger.h"
+#include "Settings.h"
+#include "TickService.h"
 #include "cIGZApp.h"
 #include "cIGZCheatCodeManager.h"
 #include "cIGZCOM.h"
@@ -44,6 +47,7 @@
 #include "GZServPtrs.h"
 
 static constexpr uint32_t kBulldozeExtensionsDirectorID = 0x5B7D9E30;
+static constexpr uint32_t kBulldozeExtensionsTickServiceID = 0x4E1D5C27;
 
 static constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
 static constexpr uint32_t kSC4MessagePreCityShutdown = 0x26D31EC2;
@@ -60,7 +64,9 @@ class BulldozeExtensionsDllDirector final : public cRZMessage2COMDirector
 {
 public:
 	BulldozeExtensionsDllDirector()
-		: pView3D(nullptr)
+		: pView3D(nullptr),
+		  settings(),
+		  tickService(kBulldozeExtensionsTickServiceID, &cSC4ViewInputControlDemolishHooks::OnTick)
 	{
 		Logger& logger = Logger::GetInstance();
 		logger.Init(FileSystem::GetLogFilePath(), LogLevel::Info);
@@ -140,8 +146,24 @@ private:
 		}
 	}
 
+	bool UsesTickService() const
+	{
+		return settings.TimeSlicedDemolition() || settings.BackgroundSelectionGeometry();
+	}
+
 	void PostCityInit()
 	{
+		cSC4ViewInputControlDemolishHooks::CreateOccupantFilters();
+
+		if (UsesTickService())
+		{
+			mpFrameWork->AddSystemService(&tickService);
+			mpFrameWork->AddToTick(&tickService);
+			tickService.SetServiceRunning(true);
+		}
+
+		cSC4ViewInputControlDemolishHooks::StartSelectionWorker();
+
 		cISC4AppPtr pSC4App;
 		cIGZMessageServer2Ptr pMS2;
 
@@ -187,6 +209,21 @@ private:
 	{
 		UnregisterBulldozeShortcutNotifications();
 
+		if (UsesTickService())
+		{
+			tickService.SetServiceRunning(false);
+			mpFrameWork->RemoveFromTick(&tickService);
+			mpFrameWork->RemoveSystemService(&tickService);
+		}
+
+		cSC4ViewInputControlDemolishHooks::CancelScheduledDemolition();
+		cSC4ViewInputControlDemolishHooks::ClearPendingSelection();
+		cSC4ViewInputControlDemolishHooks::StopSelectionWorker();
+		cSC4ViewInputControlDemolishHooks::FlushInputRecording();
+		cSC4ViewInputControlDemolishHooks::WriteTrace();
+		INSTRUMENTATION_WRITE_SUMMARY();
+		cSC4ViewInputControlDemolishHooks::ReleaseOccupantFilters();
+
 		cISC4View3DWin* localView3D = pView3D;
 		pView3D = nullptr;
 
@@ -241,7 +278,30 @@ private:
 
 	bool PostAppInit()
 	{
-		if (cSC4ViewInputControlDemolishHooks::Install())
+		settings.Load(FileSystem::GetConfigFilePath());
+
+		if (settings.MappedLog())
+		{
+			Logger& logger = Logger::GetInstance();
+
+			if (logger.StartMappedLog(
+				FileSystem::GetMappedLogFilePath(),
+				static_cast<size_t>(settings.MappedLogSizeKilobytes()) * 1024))
+			{
+				logger.WriteLogFileHeader("SC4BulldozeExtensions v" PLUGIN_VERSION_STR);
+			}
+			else
+			{
+				logger.WriteLine(LogLevel::Error, "Failed to open the mapped log file.");
+			}
+		}
+
+		if (settings.AsyncLogging())
+		{
+			Logger::GetInstance().StartAsyncWriter(settings.AsyncLogOverflow());
+		}
+
+		if (cSC4ViewInputControlDemolishHooks::Install(settings))
 		{
 			cIGZMessageServer2Ptr pMS2;
 
@@ -255,7 +315,16 @@ private:
 		return true;
 	}
 
+	bool PostAppShutdown()
+	{
+		Logger::GetInstance().Shutdown();
+
+		return true;
+	}
+
 	cISC4View3DWin* pView3D;
+	Settings settings;
+	TickService tickService;
 };
 
 cRZCOMDllDirector* RZGetCOMDllDirector() {
@@ -0,0 +1,331 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CellRegionAlgebra.h"
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CELL_REGION_ALGEBRA_USE_SSE2 1
+#endif
+
+namespace
+{
+	using CellRegionAlgebra::Operation;
+
+	// The mask of the used bits in the last word of a row.
+	uint32_t GetLastWordMask(uint32_t columnCount)
+	{
+		return (columnCount & 31) != 0 ? (1U << (columnCount & 31)) - 1 : 0xffffffffU;
+	}
+
+	// Returns the mask of the bits in [firstBit, lastBit] that fall into the specified word.
+	uint32_t GetSpanMask(uint32_t word, uint32_t firstBit, uint32_t lastBit)
+	{
+		uint32_t mask = 0xffffffffU;
+
+		if (word == firstBit / 32)
+		{
+			mask &= 0xffffffffU << (firstBit & 31);
+		}
+
+		if (word == lastBit / 32)
+		{
+			mask &= 0xffffffffU >> (31 - (lastBit & 31));
+		}
+
+		return mask;
+	}
+
+	class SourceRow
+	{
+	public:
+		SourceRow(const uint32_t* words, uint32_t columnCount)
+			: words(words),
+			  wordCount((columnCount + 31) / 32),
+			  lastWordMask(GetLastWordMask(columnCount))
+		{
+		}
+
+		// Returns the source word at the specified index, the padding bits and
+		// the words outside of the row are zero.
+		uint32_t GetWord(int64_t index) const
+		{
+			if (index < 0 || index >= static_cast<int64_t>(wordCount))
+			{
+				return 0;
+			}
+
+			const uint32_t word = words[index];
+
+			return index == static_cast<int64_t>(wordCount) - 1 ? word & lastWordMask : word;
+		}
+
+	private:
+		const uint32_t* words;
+		uint32_t wordCount;
+		uint32_t lastWordMask;
+	};
+
+	// Writes the source row into the buffer using the target's column alignment.
+	// Source column 0 is placed at target column columnOffset.
+	void LoadShiftedRow(
+		const SourceRow& source,
+		int32_t columnOffset,
+		uint32_t* buffer,
+		uint32_t bufferWordCount,
+		uint32_t lastWordMask)
+	{
+		// The source bit that lands on bit 0 of the first buffer word.
+		const int64_t firstSourceBit = -static_cast<int64_t>(columnOffset);
+		// Floor division, the offset can be negative.
+		const int64_t firstSourceWord = firstSourceBit >= 0 ? firstSourceBit / 32 : -((-firstSourceBit + 31) / 32);
+		const uint32_t shift = static_cast<uint32_t>(firstSourceBit - (firstSourceWord * 32));
+
+		if (shift == 0)
+		{
+			for (uint32_t i = 0; i < bufferWordCount; i++)
+			{
+				buffer[i] = source.GetWord(firstSourceWord + i);
+			}
+		}
+		else
+		{
+			uint32_t low = source.GetWord(firstSourceWord);
+
+			for (uint32_t i = 0; i < bufferWordCount; i++)
+			{
+				const uint32_t high = source.GetWord(firstSourceWord + i + 1);
+
+				buffer[i] = (low >> shift) | (high << (32 - shift));
+				low = high;
+			}
+		}
+
+		// Source cells past the end of the target row must not reach its padding bits.
+		buffer[bufferWordCount - 1] &= lastWordMask;
+	}
+
+	template<Operation Op>
+	uint32_t CombineWord(uint32_t target, uint32_t source)
+	{
+		if constexpr (Op == Operation::Union)
+		{
+			return target | source;
+		}
+		else if constexpr (Op == Operation::Intersection)
+		{
+			return target & source;
+		}
+		else if constexpr (Op == Operation::Difference)
+		{
+			return target & ~source;
+		}
+		else
+		{
+			return target ^ source;
+		}
+	}
+
+#ifdef CELL_REGION_ALGEBRA_USE_SSE2
+	template<Operation Op>
+	__m128i CombineVector(__m128i target, __m128i source)
+	{
+		if constexpr (Op == Operation::Union)
+		{
+			return _mm_or_si128(target, source);
+		}
+		else if constexpr (Op == Operation::Intersection)
+		{
+			return _mm_and_si128(target, source);
+		}
+		else if constexpr (Op == Operation::Difference)
+		{
+			return _mm_andnot_si128(source, target);
+		}
+		else
+		{
+			return _mm_xor_si128(target, source);
+		}
+	}
+#endif // CELL_REGION_ALGEBRA_USE_SSE2
+
+	template<Operation Op>
+	void CombineWords(uint32_t* target, const uint32_t* source, uint32_t wordCount)
+	{
+		uint32_t i = 0;
+
+#ifdef CELL_REGION_ALGEBRA_USE_SSE2
+		for (; i + 4 <= wordCount; i += 4)
+		{
+			const __m128i targetWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(target + i));
+			const __m128i sourceWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), CombineVector<Op>(targetWords, sourceWords));
+		}
+#endif // CELL_REGION_ALGEBRA_USE_SSE2
+
+		for (; i < wordCount; i++)
+		{
+			target[i] = CombineWord<Op>(target[i], source[i]);
+		}
+	}
+
+	template<Operation Op>
+	void ApplyRows(SC4CellRegion<int32_t>& target, const SC4CellRegion<int32_t>& source)
+	{
+		cRZCellMap& targetMap = target.cellMap;
+		const cRZCellMap& sourceMap = source.cellMap;
+
+		const uint32_t targetRows = targetMap.GetRowCount();
+		const uint32_t wordCount = targetMap.GetRowWordCount();
+
+		if (targetRows == 0 || wordCount == 0)
+		{
+			return;
+		}
+
+		const int64_t rowOffset = static_cast<int64_t>(source.bounds.topLeftX) - target.bounds.topLeftX;
+		const int32_t columnOffset = source.bounds.topLeftY - target.bounds.topLeftY;
+		const uint32_t lastWordMask = GetLastWordMask(targetMap.GetColumnCount());
+		const uint32_t sourceRows = sourceMap.GetRowCount();
+		const uint32_t sourceColumns = sourceMap.GetColumnCount();
+
+		std::vector<uint32_t> buffer(wordCount);
+
+		for (uint32_t row = 0; row < targetRows; row++)
+		{
+			const int64_t sourceRow = row - rowOffset;
+
+			if (sourceRow >= 0 && sourceRow < static_cast<int64_t>(sourceRows))
+			{
+				const SourceRow sourceWords(sourceMap.GetRowWords(static_cast<uint32_t>(sourceRow)), sourceColumns);
+
+				LoadShiftedRow(sourceWords, columnOffset, buffer.data(), wordCount, lastWordMask);
+				CombineWords<Op>(targetMap.GetRowWords(row), buffer.data(), wordCount);
+			}
+			else if constexpr (Op == Operation::Intersection)
+			{
+				targetMap.ClearRow(row);
+			}
+		}
+	}
+}
+
+void CellRegionAlgebra::Apply(SC4CellRegion<int32_t>& target, const SC4CellRegion<int32_t>& source, Operation operation)
+{
+	switch (operation)
+	{
+	case Operation::Union:
+		ApplyRows<Operation::Union>(target, source);
+		break;
+	case Operation::Intersection:
+		ApplyRows<Operation::Intersection>(target, source);
+		break;
+	case Operation::Difference:
+		ApplyRows<Operation::Difference>(target, source);
+		break;
+	case Operation::SymmetricDifference:
+		ApplyRows<Operation::SymmetricDifference>(target, source);
+		break;
+	}
+}
+
+SC4CellRegion<int32_t> CellRegionAlgebra::Union(const SC4CellRegion<int32_t>& first, const SC4CellRegion<int32_t>& second)
+{
+	SC4CellRegion<int32_t> result(
+		(std::min)(first.bounds.topLeftX, second.bounds.topLeftX),
+		(std::min)(first.bounds.topLeftY, second.bounds.topLeftY),
+		(std::max)(first.bounds.bottomRightX, second.bounds.bottomRightX),
+		(std::max)(first.bounds.bottomRightY, second.bounds.bottomRightY),
+		false);
+
+	ApplyRows<Operation::Union>(result, first);
+	ApplyRows<Operation::Union>(result, second);
+
+	return result;
+}
+
+uint32_t CellRegionAlgebra::CountCells(const SC4CellRegion<int32_t>& region)
+{
+	const cRZCellMap& cellMap = region.cellMap;
+	const uint32_t rowCount = cellMap.GetRowCount();
+	const uint32_t wordCount = cellMap.GetRowWordCount();
+
+	if (wordCount == 0)
+	{
+		return 0;
+	}
+
+	const uint32_t lastWordMask = GetLastWordMask(cellMap.GetColumnCount());
+	uint32_t count = 0;
+
+	for (uint32_t row = 0; row < rowCount; row++)
+	{
+		const uint32_t* words = cellMap.GetRowWords(row);
+
+		for (uint32_t i = 0; i < wordCount - 1; i++)
+		{
+			count += static_cast<uint32_t>(std::popcount(words[i]));
+		}
+
+		count += static_cast<uint32_t>(std::popcount(words[wordCount - 1] & lastWordMask));
+	}
+
+	return count;
+}
+
+bool CellRegionAlgebra::AnyCellInRect(const SC4CellRegion<int32_t>& region, const SC4Rect<int32_t>& rect)
+{
+	const cRZCellMap& cellMap = region.cellMap;
+
+	const int32_t minX = (std::max)((std::min)(rect.topLeftX, rect.bottomRightX), region.bounds.topLeftX);
+	const int32_t maxX = (std::min)((std::max)(rect.topLeftX, rect.bottomRightX), region.bounds.topLeftX + static_cast<int32_t>(cellMap.GetRowCount()) - 1);
+	const int32_t minZ = (std::max)((std::min)(rect.topLeftY, rect.bottomRightY), region.bounds.topLeftY);
+	const int32_t maxZ = (std::min)((std::max)(rect.topLeftY, rect.bottomRightY), region.bounds.topLeftY + static_cast<int32_t>(cellMap.GetColumnCount()) - 1);
+
+	if (minX > maxX || minZ > maxZ)
+	{
+		return false;
+	}
+
+	const uint32_t firstColumn = static_cast<uint32_t>(minZ - region.bounds.topLeftY);
+	const uint32_t lastColumn = static_cast<uint32_t>(maxZ - region.bounds.topLeftY);
+	const uint32_t firstWord = firstColumn / 32;
+	const uint32_t lastWord = lastColumn / 32;
+
+	for (int32_t x = minX; x <= maxX; x++)
+	{
+		const uint32_t* words = cellMap.GetRowWords(static_cast<uint32_t>(x - region.bounds.topLeftX));
+
+		for (uint32_t i = firstWord; i <= lastWord; i++)
+		{
+			if ((words[i] & GetSpanMask(i, firstColumn, lastColumn)) != 0)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
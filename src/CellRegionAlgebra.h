@@ -0,0 +1,54 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4CellRegion.h"
+#include <cstdint>
+
+// Word level set operations on cell regions.
+//
+// The regions can have different bounds, the source cells are shifted into the
+// target's cell grid 32 cells at a time instead of being copied one by one.
+namespace CellRegionAlgebra
+{
+	enum class Operation : uint32_t
+	{
+		Union = 0,
+		Intersection,
+		Difference,
+		SymmetricDifference
+	};
+
+	// Combines the source cells into the target region.
+	// Source cells outside of the target bounds are ignored, and target cells outside
+	// of the source bounds are treated as if the source cell is not set.
+	void Apply(SC4CellRegion<int32_t>& target, const SC4CellRegion<int32_t>& source, Operation operation);
+
+	// Returns a region that covers the bounds of both regions and contains the cells of both.
+	SC4CellRegion<int32_t> Union(const SC4CellRegion<int32_t>& first, const SC4CellRegion<int32_t>& second);
+
+	// Returns the number of cells that are set.
+	uint32_t CountCells(const SC4CellRegion<int32_t>& region);
+
+	// Returns true if any cell in the specified rectangle is set.
+	// The rectangle uses the same coordinates as the region bounds.
+	bool AnyCellInRect(const SC4CellRegion<int32_t>& region, const SC4Rect<int32_t>& rect);
+}
@@ -37,33 +37,29 @@ void DebugUtil::PrintLineToDebugOutputFormatted(const char* const format, ...)
 	va_list argsCopy;
 	va_copy(argsCopy, args);
 
-	int formattedStringLength = std::vsnprintf(nullptr, 0, format, argsCopy);
+	constexpr size_t stackBufferSize = 1024;
+	char buffer[stackBufferSize];
 
-	va_end(argsCopy);
+	const int formattedStringLength = std::vsnprintf(buffer, stackBufferSize, format, args);
 
 	if (formattedStringLength > 0)
 	{
-		size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
-
-		constexpr size_t stackBufferSize = 1024;
-
-		if (formattedStringLengthWithNull >= stackBufferSize)
+		if (static_cast<size_t>(formattedStringLength) < stackBufferSize)
 		{
-			std::unique_ptr<char[]> buffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
-
-			std::vsnprintf(buffer.get(), formattedStringLengthWithNull, format, args);
-
-			PrintLineToDebugOutput(buffer.get());
+			PrintLineToDebugOutput(buffer);
 		}
 		else
 		{
-			char buffer[stackBufferSize]{};
+			const size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
 
-			std::vsnprintf(buffer, stackBufferSize, format, args);
+			std::unique_ptr<char[]> heapBuffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
 
-			PrintLineToDebugOutput(buffer);
+			std::vsnprintf(heapBuffer.get(), formattedStringLengthWithNull, format, argsCopy);
+
+			PrintLineToDebugOutput(heapBuffer.get());
 		}
 	}
 
+	va_end(argsCopy);
 	va_end(args);
 }
@@ -0,0 +1,136 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DemolitionScheduler.h"
+#include "CellRegionAlgebra.h"
+#include "RegionDecomposition.h"
+#include <algorithm>
+
+DemolitionScheduler::DemolitionScheduler()
+	: DemolitionScheduler(Clock::now)
+{
+}
+
+DemolitionScheduler::DemolitionScheduler(TimeFunction timeFunction)
+	: region(0, 0, 0, 0, false),
+	  tiles(),
+	  nextTile(0),
+	  totalCost(0),
+	  averageTileTime(Clock::duration::zero()),
+	  demolishTile(),
+	  now(std::move(timeFunction))
+{
+}
+
+void DemolitionScheduler::Start(const SC4CellRegion<int32_t>& newRegion, int32_t tileSize, TileFunction newDemolishTile)
+{
+	region = newRegion;
+	tiles.clear();
+	nextTile = 0;
+	totalCost = 0;
+	averageTileTime = Clock::duration::zero();
+	demolishTile = std::move(newDemolishTile);
+
+	const SC4Rect<int32_t>& bounds = region.bounds;
+	const int32_t step = (std::max)(tileSize, 1);
+
+	for (int32_t x = bounds.topLeftX; x <= bounds.bottomRightX; x += step)
+	{
+		for (int32_t z = bounds.topLeftY; z <= bounds.bottomRightY; z += step)
+		{
+			const SC4Rect<int32_t> tile(
+				x,
+				z,
+				(std::min)(x + step - 1, bounds.bottomRightX),
+				(std::min)(z + step - 1, bounds.bottomRightY));
+
+			// Tiles without any selected cells are skipped.
+			if (CellRegionAlgebra::AnyCellInRect(region, tile))
+			{
+				tiles.push_back(tile);
+			}
+		}
+	}
+}
+
+bool DemolitionScheduler::RunSlice(Clock::duration budget)
+{
+	const Clock::time_point start = now();
+	Clock::duration elapsed = Clock::duration::zero();
+
+	while (nextTile < tiles.size())
+	{
+		// Stop when the next tile is expected to overrun the budget, but always
+		// demolish one tile so that the demolition makes progress.
+		if (elapsed > Clock::duration::zero() && elapsed + averageTileTime > budget)
+		{
+			break;
+		}
+
+		const Clock::time_point tileStart = now();
+
+		totalCost += demolishTile(RegionDecomposition::Extract(region, tiles[nextTile]));
+		nextTile++;
+
+		const Clock::time_point tileEnd = now();
+		const Clock::duration tileTime = tileEnd - tileStart;
+
+		// An exponential moving average, tiles near each other usually have a similar cost.
+		averageTileTime = averageTileTime == Clock::duration::zero() ? tileTime : (averageTileTime * 3 + tileTime) / 4;
+		elapsed = tileEnd - start;
+	}
+
+	const bool remaining = nextTile < tiles.size();
+
+	if (!remaining)
+	{
+		demolishTile = nullptr;
+	}
+
+	return remaining;
+}
+
+void DemolitionScheduler::Cancel()
+{
+	tiles.clear();
+	nextTile = 0;
+	demolishTile = nullptr;
+}
+
+bool DemolitionScheduler::IsActive() const
+{
+	return nextTile < tiles.size();
+}
+
+size_t DemolitionScheduler::GetCompletedTileCount() const
+{
+	return nextTile;
+}
+
+size_t DemolitionScheduler::GetTileCount() const
+{
+	return tiles.size();
+}
+
+int64_t DemolitionScheduler::GetTotalCost() const
+{
+	return totalCost;
+}
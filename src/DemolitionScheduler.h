@@ -0,0 +1,69 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4CellRegion.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Demolishes a large selection over several frames.
+//
+// The selection is split into square tiles, and every frame demolishes as many
+// tiles as fit into the frame's time budget. The scheduler does not depend on the
+// game, the tiles are demolished by a callback.
+class DemolitionScheduler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Demolishes the cells of a tile and returns the cost.
+	using TileFunction = std::function<int64_t(const SC4CellRegion<int32_t>& tile)>;
+	// Returns the current time, the tests use a simulated clock.
+	using TimeFunction = std::function<Clock::time_point()>;
+
+	DemolitionScheduler();
+	explicit DemolitionScheduler(TimeFunction now);
+
+	// Replaces any demolition that is in progress.
+	void Start(const SC4CellRegion<int32_t>& region, int32_t tileSize, TileFunction demolishTile);
+
+	// Demolishes tiles until the budget is used, at least one tile is demolished per call.
+	// Returns true if there are tiles remaining.
+	bool RunSlice(Clock::duration budget);
+
+	void Cancel();
+
+	bool IsActive() const;
+	size_t GetCompletedTileCount() const;
+	size_t GetTileCount() const;
+	int64_t GetTotalCost() const;
+
+private:
+	SC4CellRegion<int32_t> region;
+	std::vector<SC4Rect<int32_t>> tiles;
+	size_t nextTile;
+	int64_t totalCost;
+	Clock::duration averageTileTime;
+	TileFunction demolishTile;
+	TimeFunction now;
+};
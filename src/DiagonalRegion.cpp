@@ -0,0 +1,247 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagonalRegion.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	using DiagonalRegion::CellSpan;
+
+	// Runs Bresenham's line algorithm from one corner of a width x height box to the
+	// opposite corner and records the Z range of the line in each X column.
+	// The line is monotonic on both axes, so every column is visited in a single
+	// contiguous run and the runs of neighboring columns are adjacent.
+	template<int32_t StepX, int32_t StepZ>
+	void TraceLine(int32_t width, int32_t height, CellSpan* runs)
+	{
+		const int32_t dx = width - 1;
+		const int32_t dz = height - 1;
+
+		int32_t x = StepX > 0 ? 0 : dx;
+		int32_t z = StepZ > 0 ? 0 : dz;
+		const int32_t endX = StepX > 0 ? dx : 0;
+		const int32_t endZ = StepZ > 0 ? dz : 0;
+
+		int32_t err = dx - dz;
+
+		for (int32_t i = 0; i < width; i++)
+		{
+			runs[i].first = dz;
+			runs[i].last = 0;
+		}
+
+		while (true)
+		{
+			runs[x].first = (std::min)(runs[x].first, z);
+			runs[x].last = (std::max)(runs[x].last, z);
+
+			if (x == endX && z == endZ)
+			{
+				break;
+			}
+
+			const int32_t e2 = 2 * err;
+
+			if (e2 > -dz)
+			{
+				err -= dz;
+				x += StepX;
+			}
+			if (e2 < dx)
+			{
+				err += dx;
+				z += StepZ;
+			}
+		}
+	}
+
+	// When the line is wider than it is tall the thickness offsets are applied on Z,
+	// so each row covers its own run extended by the offsets.
+	// Otherwise the offsets are applied on X, and a row covers the runs of every
+	// source column that the offsets move onto it. The runs are monotonic, so the
+	// union of that window is bounded by the runs at its two ends.
+	template<bool WiderThanTall>
+	void ComputeRowSpans(
+		int32_t width,
+		int32_t height,
+		const CellSpan* runs,
+		int32_t firstOffset,
+		int32_t lastOffset,
+		CellSpan* spans)
+	{
+		for (int32_t x = 0; x < width; x++)
+		{
+			CellSpan& span = spans[x];
+
+			if constexpr (WiderThanTall)
+			{
+				span.first = (std::max)(runs[x].first + firstOffset, 0);
+				span.last = (std::min)(runs[x].last + lastOffset, height - 1);
+			}
+			else
+			{
+				const int32_t windowStart = (std::max)(x - lastOffset, 0);
+				const int32_t windowEnd = (std::min)(x - firstOffset, width - 1);
+
+				if (windowStart <= windowEnd)
+				{
+					span.first = (std::min)(runs[windowStart].first, runs[windowEnd].first);
+					span.last = (std::max)(runs[windowStart].last, runs[windowEnd].last);
+				}
+				else
+				{
+					span.first = 0;
+					span.last = -1;
+				}
+			}
+		}
+	}
+}
+
+DiagonalRegion::Direction DiagonalRegion::GetDirection(const SC4Rect<int32_t>& bounds, int32_t startX, int32_t startZ)
+{
+	Direction direction = Direction::NorthwestToSoutheast;
+
+	if (startX != -1 && startZ != -1)
+	{
+		const int32_t centerX = (bounds.topLeftX + bounds.bottomRightX) / 2;
+		const int32_t centerZ = (bounds.topLeftY + bounds.bottomRightY) / 2;
+
+		if (startX <= centerX)
+		{
+			direction = startZ <= centerZ ? Direction::NorthwestToSoutheast : Direction::SouthwestToNortheast;
+		}
+		else
+		{
+			direction = startZ <= centerZ ? Direction::NortheastToSouthwest : Direction::SoutheastToNorthwest;
+		}
+	}
+
+	return direction;
+}
+
+void DiagonalRegion::TraceColumnRuns(
+	int32_t width,
+	int32_t height,
+	Direction direction,
+	std::vector<CellSpan>& runs)
+{
+	runs.resize(static_cast<size_t>(width));
+
+	switch (direction)
+	{
+	case Direction::NorthwestToSoutheast:
+		TraceLine<1, 1>(width, height, runs.data());
+		break;
+	case Direction::NortheastToSouthwest:
+		TraceLine<-1, 1>(width, height, runs.data());
+		break;
+	case Direction::SouthwestToNortheast:
+		TraceLine<1, -1>(width, height, runs.data());
+		break;
+	case Direction::SoutheastToNorthwest:
+		TraceLine<-1, -1>(width, height, runs.data());
+		break;
+	}
+}
+
+void DiagonalRegion::GetRowSpans(
+	int32_t width,
+	int32_t height,
+	const std::vector<CellSpan>& runs,
+	int32_t thickness,
+	std::vector<CellSpan>& spans)
+{
+	spans.resize(static_cast<size_t>(width));
+
+	if (thickness == 0)
+	{
+		std::fill(spans.begin(), spans.end(), CellSpan{ 0, -1 });
+		return;
+	}
+
+	// The thickness sign only selects the offset range, so the row loop does not need to test it.
+	const int32_t firstOffset = thickness > 0 ? 0 : thickness + 1;
+	const int32_t lastOffset = thickness > 0 ? thickness - 1 : 0;
+
+	if (width > height)
+	{
+		ComputeRowSpans<true>(width, height, runs.data(), firstOffset, lastOffset, spans.data());
+	}
+	else
+	{
+		ComputeRowSpans<false>(width, height, runs.data(), firstOffset, lastOffset, spans.data());
+	}
+}
+
+void DiagonalRegion::Rasterize(
+	cRZCellMap& cellMap,
+	const SC4Rect<int32_t>& bounds,
+	Direction direction,
+	int32_t thickness)
+{
+	const int32_t width = bounds.bottomRightX - bounds.topLeftX + 1;
+	const int32_t height = bounds.bottomRightY - bounds.topLeftY + 1;
+
+	if (width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	std::vector<CellSpan> runs;
+	std::vector<CellSpan> spans;
+
+	TraceColumnRuns(width, height, direction, runs);
+	GetRowSpans(width, height, runs, thickness, spans);
+
+	for (int32_t x = 0; x < width; x++)
+	{
+		const CellSpan& span = spans[x];
+
+		if (span.first <= span.last)
+		{
+			cellMap.FillSpan(static_cast<uint32_t>(x), static_cast<uint32_t>(span.first), static_cast<uint32_t>(span.last), true);
+		}
+	}
+}
+
+SC4CellRegion<int32_t> DiagonalRegion::Create(
+	int32_t x1,
+	int32_t z1,
+	int32_t x2,
+	int32_t z2,
+	int32_t thickness,
+	int32_t startX,
+	int32_t startZ)
+{
+	const int32_t minX = (std::min)(x1, x2);
+	const int32_t maxX = (std::max)(x1, x2);
+	const int32_t minZ = (std::min)(z1, z2);
+	const int32_t maxZ = (std::max)(z1, z2);
+
+	SC4CellRegion<int32_t> region(minX, minZ, maxX, maxZ, false);
+
+	Rasterize(region.cellMap, region.bounds, GetDirection(region.bounds, startX, startZ), thickness);
+
+	return region;
+}
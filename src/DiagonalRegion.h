@@ -0,0 +1,85 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4CellRegion.h"
+#include <cstdint>
+#include <vector>
+
+namespace DiagonalRegion
+{
+	enum class Direction : uint32_t
+	{
+		NorthwestToSoutheast = 0,
+		NortheastToSouthwest,
+		SouthwestToNortheast,
+		SoutheastToNorthwest
+	};
+
+	// An inclusive range of cells, the range is empty when first > last.
+	struct CellSpan
+	{
+		int32_t first;
+		int32_t last;
+	};
+
+	// Determines the diagonal direction from the cell the user clicked.
+	// The line is drawn from the bounding box corner nearest to the click point
+	// to the opposite corner, a start point of (-1, -1) selects the NW to SE diagonal.
+	Direction GetDirection(const SC4Rect<int32_t>& bounds, int32_t startX, int32_t startZ);
+
+	// Traces the one cell wide line through a width x height box and stores the
+	// range of Z cells that it covers in each X column.
+	void TraceColumnRuns(
+		int32_t width,
+		int32_t height,
+		Direction direction,
+		std::vector<CellSpan>& runs);
+
+	// Converts the column runs of a line into the range of Z cells that the
+	// thick line covers in each X row.
+	//
+	// A positive thickness extends the line towards increasing coordinates, a negative
+	// thickness extends it towards decreasing coordinates. The line is thickened along Z
+	// when it is wider than it is tall, and along X otherwise.
+	void GetRowSpans(
+		int32_t width,
+		int32_t height,
+		const std::vector<CellSpan>& runs,
+		int32_t thickness,
+		std::vector<CellSpan>& spans);
+
+	// Writes a thick diagonal line into a cleared cell map that covers the specified bounds.
+	void Rasterize(
+		cRZCellMap& cellMap,
+		const SC4Rect<int32_t>& bounds,
+		Direction direction,
+		int32_t thickness);
+
+	SC4CellRegion<int32_t> Create(
+		int32_t x1,
+		int32_t z1,
+		int32_t x2,
+		int32_t z2,
+		int32_t thickness,
+		int32_t startX = -1,
+		int32_t startZ = -1);
+}
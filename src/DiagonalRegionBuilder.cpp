@@ -0,0 +1,203 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagonalRegionBuilder.h"
+#include <algorithm>
+
+namespace
+{
+	void SetCells(cRZCellMap& cellMap, uint32_t row, int32_t first, int32_t last, bool value)
+	{
+		if (first <= last)
+		{
+			cellMap.FillSpan(row, static_cast<uint32_t>(first), static_cast<uint32_t>(last), value);
+		}
+	}
+}
+
+DiagonalRegionBuilder::DiagonalRegionBuilder()
+	: bounds(),
+	  width(0),
+	  height(0),
+	  direction(DiagonalRegion::Direction::NorthwestToSoutheast),
+	  thickness(0),
+	  valid(false),
+	  runs(),
+	  spans(),
+	  region(0, 0, 0, 0, false),
+	  regionSpans(),
+	  regionValid(false)
+{
+}
+
+void DiagonalRegionBuilder::Update(
+	const SC4Rect<int32_t>& newBounds,
+	int32_t startX,
+	int32_t startZ,
+	int32_t newThickness)
+{
+	const int32_t newWidth = newBounds.bottomRightX - newBounds.topLeftX + 1;
+	const int32_t newHeight = newBounds.bottomRightY - newBounds.topLeftY + 1;
+	const DiagonalRegion::Direction newDirection = DiagonalRegion::GetDirection(newBounds, startX, startZ);
+
+	// The spans are relative to the top left corner of the rectangle, so a
+	// rectangle with the same size, direction and thickness reuses them as-is.
+	const bool sameLine = valid
+		&& newWidth == width
+		&& newHeight == height
+		&& newDirection == direction;
+
+	if (!sameLine || newThickness != thickness)
+	{
+		if (!sameLine)
+		{
+			DiagonalRegion::TraceColumnRuns(newWidth, newHeight, newDirection, runs);
+		}
+
+		DiagonalRegion::GetRowSpans(newWidth, newHeight, runs, newThickness, spans);
+
+		width = newWidth;
+		height = newHeight;
+		direction = newDirection;
+		thickness = newThickness;
+		valid = true;
+	}
+
+	bounds = newBounds;
+}
+
+bool DiagonalRegionBuilder::WriteTo(SC4CellRegion<int32_t>& target) const
+{
+	cRZCellMap& cellMap = target.cellMap;
+
+	if (!valid
+		|| target.bounds.topLeftX != bounds.topLeftX
+		|| target.bounds.topLeftY != bounds.topLeftY
+		|| target.bounds.bottomRightX != bounds.bottomRightX
+		|| target.bounds.bottomRightY != bounds.bottomRightY
+		|| cellMap.GetRowCount() != static_cast<uint32_t>(width)
+		|| cellMap.GetColumnCount() != static_cast<uint32_t>(height))
+	{
+		return false;
+	}
+
+	for (int32_t x = 0; x < width; x++)
+	{
+		cellMap.ClearRow(static_cast<uint32_t>(x));
+		SetCells(cellMap, static_cast<uint32_t>(x), spans[x].first, spans[x].last, true);
+	}
+
+	return true;
+}
+
+const SC4CellRegion<int32_t>& DiagonalRegionBuilder::GetRegion()
+{
+	if (regionValid
+		&& region.cellMap.GetRowCount() == static_cast<uint32_t>(width)
+		&& region.cellMap.GetColumnCount() == static_cast<uint32_t>(height))
+	{
+		PatchRegionRows();
+	}
+	else
+	{
+		region = SC4CellRegion<int32_t>(
+			bounds.topLeftX,
+			bounds.topLeftY,
+			bounds.bottomRightX,
+			bounds.bottomRightY,
+			false);
+
+		for (int32_t x = 0; x < width; x++)
+		{
+			SetCells(region.cellMap, static_cast<uint32_t>(x), spans[x].first, spans[x].last, true);
+		}
+
+		regionValid = true;
+	}
+
+	regionSpans = spans;
+	region.bounds = bounds;
+
+	return region;
+}
+
+uint64_t DiagonalRegionBuilder::GetSpanHash() const
+{
+	// FNV-1a over the rectangle size and the row spans.
+	constexpr uint64_t FnvPrime = 0x100000001b3ULL;
+
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	const auto combine = [&hash](int32_t value)
+	{
+		hash ^= static_cast<uint32_t>(value);
+		hash *= FnvPrime;
+	};
+
+	combine(width);
+	combine(height);
+
+	if (valid)
+	{
+		for (const DiagonalRegion::CellSpan& span : spans)
+		{
+			// All empty spans are equivalent.
+			if (span.first <= span.last)
+			{
+				combine(span.first);
+				combine(span.last);
+			}
+			else
+			{
+				combine(0);
+				combine(-1);
+			}
+		}
+	}
+
+	return hash;
+}
+
+void DiagonalRegionBuilder::Reset()
+{
+	valid = false;
+	regionValid = false;
+}
+
+void DiagonalRegionBuilder::PatchRegionRows()
+{
+	cRZCellMap& cellMap = region.cellMap;
+	const uint32_t rowCount = static_cast<uint32_t>(spans.size());
+
+	for (uint32_t x = 0; x < rowCount; x++)
+	{
+		const DiagonalRegion::CellSpan& oldSpan = regionSpans[x];
+		const DiagonalRegion::CellSpan& newSpan = spans[x];
+
+		// Clear the old cells that are outside of the new span, then set the new
+		// cells that are outside of the old span. An empty span has no cells that
+		// can overlap the other span, so it does not need special handling.
+		SetCells(cellMap, x, oldSpan.first, (std::min)(oldSpan.last, newSpan.first - 1), false);
+		SetCells(cellMap, x, (std::max)(oldSpan.first, newSpan.last + 1), oldSpan.last, false);
+		SetCells(cellMap, x, newSpan.first, (std::min)(newSpan.last, oldSpan.first - 1), true);
+		SetCells(cellMap, x, (std::max)(newSpan.first, oldSpan.last + 1), newSpan.last, true);
+	}
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "DiagonalRegion.h"
+#include <vector>
+
+// Builds the diagonal selection region for a drag that is in progress.
+//
+// The builder keeps the traced line and the span of cells that is set in each row.
+// When the rectangle size and direction are unchanged only the thickness spans are
+// recomputed, and when nothing has changed the previous spans are reused.
+//
+// The spans can be written directly into a region that is owned by the game, or
+// into a region that is owned by the builder. The builder's region is patched with
+// the cells that differ from its previous contents, a new region is only allocated
+// when the rectangle size changes.
+class DiagonalRegionBuilder
+{
+public:
+	DiagonalRegionBuilder();
+
+	void Update(
+		const SC4Rect<int32_t>& bounds,
+		int32_t startX,
+		int32_t startZ,
+		int32_t thickness);
+
+	// Overwrites every cell of the target region with the diagonal pattern.
+	// Returns false without modifying the target if its bounds or cell map
+	// dimensions do not match the rectangle passed to Update.
+	bool WriteTo(SC4CellRegion<int32_t>& target) const;
+
+	const SC4CellRegion<int32_t>& GetRegion();
+
+	// Returns a hash of the cells that are set, relative to the top left corner
+	// of the rectangle. Two updates that produce the same cells have the same hash.
+	uint64_t GetSpanHash() const;
+
+	void Reset();
+
+private:
+	void PatchRegionRows();
+
+	SC4Rect<int32_t> bounds;
+	int32_t width;
+	int32_t height;
+	DiagonalRegion::Direction direction;
+	int32_t thickness;
+	bool valid;
+	std::vector<DiagonalRegion::CellSpan> runs;
+	std::vector<DiagonalRegion::CellSpan> spans;
+
+	SC4CellRegion<int32_t> region;
+	std::vector<DiagonalRegion::CellSpan> regionSpans;
+	bool regionValid;
+};
@@ -0,0 +1,210 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExecutableImage.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// The offsets of the fields that are used in the PE headers.
+	constexpr uint32_t DosSignatureOffset = 0;
+	constexpr uint32_t NtHeadersOffsetOffset = 0x3C;
+	constexpr uint32_t FileHeaderSize = 20;
+	constexpr uint32_t SectionHeaderSize = 40;
+	constexpr uint32_t SectionCharacteristicsCode = 0x20;
+	constexpr uint16_t OptionalHeaderMagicPE32 = 0x10B;
+	constexpr uint32_t MaxHeadersSize = 0x1000;
+
+	struct Headers
+	{
+		uint32_t ntHeadersOffset;
+		uint16_t sectionCount;
+		uint16_t optionalHeaderSize;
+		uint16_t optionalHeaderMagic;
+		uint32_t imageBase;
+		uint32_t imageSize;
+		uint32_t headersSize;
+	};
+
+	template<typename T> T Read(const uint8_t* data, uint32_t offset)
+	{
+		T value{};
+		std::memcpy(&value, data + offset, sizeof(value));
+		return value;
+	}
+
+	bool ReadHeaders(const uint8_t* image, Headers& headers)
+	{
+		if (Read<uint16_t>(image, DosSignatureOffset) != 0x5A4D) // MZ
+		{
+			return false;
+		}
+
+		headers.ntHeadersOffset = Read<uint32_t>(image, NtHeadersOffsetOffset);
+
+		// The headers are in the first page of the image.
+		if (headers.ntHeadersOffset > MaxHeadersSize - FileHeaderSize - 64
+			|| Read<uint32_t>(image, headers.ntHeadersOffset) != 0x4550) // PE\0\0
+		{
+			return false;
+		}
+
+		const uint32_t fileHeader = headers.ntHeadersOffset + 4;
+		const uint32_t optionalHeader = fileHeader + FileHeaderSize;
+
+		headers.sectionCount = Read<uint16_t>(image, fileHeader + 2);
+		headers.optionalHeaderSize = Read<uint16_t>(image, fileHeader + 16);
+		headers.optionalHeaderMagic = Read<uint16_t>(image, optionalHeader);
+
+		// The image base is only read from PE32 headers, the other fields that are used
+		// have the same offsets in the PE32 and PE32+ optional headers.
+		headers.imageBase = headers.optionalHeaderMagic == OptionalHeaderMagicPE32 ? Read<uint32_t>(image, optionalHeader + 28) : 0;
+		headers.imageSize = Read<uint32_t>(image, optionalHeader + 56);
+		headers.headersSize = (std::min)(Read<uint32_t>(image, optionalHeader + 60), MaxHeadersSize);
+
+		return true;
+	}
+
+	// FNV-1a over 64-bit words, the build key is computed at every start so it
+	// must be fast for an image with several megabytes of code.
+	uint64_t Hash(uint64_t hash, const uint8_t* data, size_t size)
+	{
+		constexpr uint64_t Prime = 0x100000001b3ULL;
+
+		size_t i = 0;
+
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+		{
+			uint64_t word = 0;
+			std::memcpy(&word, data + i, sizeof(word));
+
+			hash ^= word;
+			hash *= Prime;
+		}
+
+		for (; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= Prime;
+		}
+
+		return hash;
+	}
+}
+
+uint32_t ExecutableImage::GetImageSize(const uint8_t* image)
+{
+	Headers headers{};
+
+	return ReadHeaders(image, headers) ? headers.imageSize : 0;
+}
+
+uint32_t ExecutableImage::GetImageBase(const uint8_t* image)
+{
+	Headers headers{};
+
+	return ReadHeaders(image, headers) ? headers.imageBase : 0;
+}
+
+bool ExecutableImage::GetSections(const uint8_t* image, size_t imageSize, std::vector<Section>& sections)
+{
+	sections.clear();
+
+	Headers headers{};
+
+	if (!ReadHeaders(image, headers))
+	{
+		return false;
+	}
+
+	const uint32_t sectionTable = headers.ntHeadersOffset + 4 + FileHeaderSize + headers.optionalHeaderSize;
+
+	for (uint32_t i = 0; i < headers.sectionCount; i++)
+	{
+		const uint32_t sectionHeader = sectionTable + (i * SectionHeaderSize);
+
+		if (sectionHeader + SectionHeaderSize > imageSize)
+		{
+			break;
+		}
+
+		const uint32_t virtualSize = Read<uint32_t>(image, sectionHeader + 8);
+		const uint32_t virtualAddress = Read<uint32_t>(image, sectionHeader + 12);
+		const uint32_t characteristics = Read<uint32_t>(image, sectionHeader + 36);
+
+		if (virtualAddress < imageSize && virtualSize <= imageSize - virtualAddress)
+		{
+			sections.push_back(Section{ virtualAddress, virtualSize, (characteristics & SectionCharacteristicsCode) != 0 });
+		}
+	}
+
+	return !sections.empty();
+}
+
+bool ExecutableImage::GetCodeSection(const uint8_t* image, size_t imageSize, Section& section)
+{
+	std::vector<Section> sections;
+
+	if (GetSections(image, imageSize, sections))
+	{
+		for (const Section& item : sections)
+		{
+			if (item.code)
+			{
+				section = item;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+uint64_t ExecutableImage::GetBuildKey(const uint8_t* image)
+{
+	Headers headers{};
+
+	if (!ReadHeaders(image, headers))
+	{
+		return 0;
+	}
+
+	std::vector<Section> sections;
+
+	if (!GetSections(image, headers.imageSize, sections))
+	{
+		return 0;
+	}
+
+	uint64_t hash = Hash(0xcbf29ce484222325ULL, image, headers.headersSize);
+
+	// The data sections change while the game runs.
+	for (const Section& section : sections)
+	{
+		if (section.code)
+		{
+			hash = Hash(hash, image + section.offset, section.size);
+		}
+	}
+
+	return hash;
+}
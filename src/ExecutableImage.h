@@ -0,0 +1,55 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reads the headers of a PE executable that has been loaded into memory.
+namespace ExecutableImage
+{
+	struct Section
+	{
+		// The offset of the section from the image base.
+		uint32_t offset;
+		uint32_t size;
+		bool code;
+	};
+
+	// Returns the size of the loaded image, or 0 if the headers are not valid.
+	uint32_t GetImageSize(const uint8_t* image);
+
+	// Returns the address that the 32-bit image is loaded at according to its headers,
+	// or 0 if the image is not a 32-bit executable. The loader updates the headers
+	// when it relocates the image, so the absolute addresses in the image use this base.
+	uint32_t GetImageBase(const uint8_t* image);
+
+	bool GetSections(const uint8_t* image, size_t imageSize, std::vector<Section>& sections);
+
+	// Finds the first section that holds executable code.
+	bool GetCodeSection(const uint8_t* image, size_t imageSize, Section& section);
+
+	// Returns a hash of the headers and the code of the executable, or 0 if the
+	// headers are not valid. Any change to the code, including a patch that another
+	// plugin applied before this one, produces a different key.
+	uint64_t GetBuildKey(const uint8_t* image);
+}
@@ -27,7 +27,11 @@
 using namespace std::string_view_literals;
 
 static constexpr std::string_view PluginConfigFileName = "SC4BulldozeExtensions.ini"sv;
+static constexpr std::string_view PluginHookAddressCacheFileName = "SC4BulldozeExtensions.addresses"sv;
 static constexpr std::string_view PluginLogFileName = "SC4BulldozeExtensions.log"sv;
+static constexpr std::string_view PluginMappedLogFileName = "SC4BulldozeExtensions.ringlog"sv;
+static constexpr std::string_view PluginInputRecordingFileName = "SC4BulldozeExtensions.input"sv;
+static constexpr std::string_view PluginTraceFileName = "SC4BulldozeExtensions.trace.json"sv;
 
 namespace
 {
@@ -56,6 +60,22 @@ std::filesystem::path FileSystem::GetConfigFilePath()
 	return path;
 }
 
+std::filesystem::path FileSystem::GetHookAddressCacheFilePath()
+{
+	std::filesystem::path path = GetDllFolderPath();
+	path /= PluginHookAddressCacheFileName;
+
+	return path;
+}
+
+std::filesystem::path FileSystem::GetInputRecordingFilePath()
+{
+	std::filesystem::path path = GetDllFolderPath();
+	path /= PluginInputRecordingFileName;
+
+	return path;
+}
+
 std::filesystem::path FileSystem::GetLogFilePath()
 {
 	std::filesystem::path path = GetDllFolderPath();
@@ -63,3 +83,19 @@ std::filesystem::path FileSystem::GetLogFilePath()
 
 	return path;
 }
+
+std::filesystem::path FileSystem::GetMappedLogFilePath()
+{
+	std::filesystem::path path = GetDllFolderPath();
+	path /= PluginMappedLogFileName;
+
+	return path;
+}
+
+std::filesystem::path FileSystem::GetTraceFilePath()
+{
+	std::filesystem::path path = GetDllFolderPath();
+	path /= PluginTraceFileName;
+
+	return path;
+}
@@ -25,5 +25,9 @@
 namespace FileSystem
 {
 	std::filesystem::path GetConfigFilePath();
+	std::filesystem::path GetHookAddressCacheFilePath();
+	std::filesystem::path GetInputRecordingFilePath();
 	std::filesystem::path GetLogFilePath();
+	std::filesystem::path GetMappedLogFilePath();
+	std::filesystem::path GetTraceFilePath();
 }
\ No newline at end of file
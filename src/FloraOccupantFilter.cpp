@@ -21,6 +21,7 @@
 
 #include "FloraOccupantFilter.h"
 #include "cISC4Occupant.h"
+#include "Instrumentation.h"
 
 FloraOccupantFilter::FloraOccupantFilter()
 {
@@ -30,5 +31,7 @@ bool FloraOccupantFilter::IsOccupantTypeIncluded(uint32_t type)
 {
 	constexpr uint32_t kFloraOccupantType = 0x74758926;
 
+	INSTRUMENTATION_COUNT(FilterCalls, 1);
+
 	return type == kFloraOccupantType;
 }
@@ -0,0 +1,147 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HookAddressCache.h"
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	constexpr char FileSignature[8] = { 'S', 'C', '4', 'B', 'X', 'A', 'D', 'R' };
+	constexpr uint32_t FileVersion = 1;
+
+	// A damaged file must not make the loader allocate a large table.
+	constexpr uint32_t MaxEntryCount = 256;
+
+	struct Entry
+	{
+		uint32_t siteId;
+		uint32_t offset;
+	};
+}
+
+HookAddressCache::HookAddressCache()
+	: buildKey(0),
+	  entries(),
+	  modified(false)
+{
+}
+
+void HookAddressCache::Load(const std::filesystem::path& path, uint64_t buildKey)
+{
+	this->buildKey = buildKey;
+	entries.clear();
+	modified = false;
+
+	std::ifstream file(path, std::ifstream::in | std::ifstream::binary);
+
+	if (!file)
+	{
+		return;
+	}
+
+	char signature[sizeof(FileSignature)]{};
+	uint32_t version = 0;
+	uint64_t fileBuildKey = 0;
+	uint32_t count = 0;
+
+	file.read(signature, sizeof(signature));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	file.read(reinterpret_cast<char*>(&fileBuildKey), sizeof(fileBuildKey));
+	file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+	if (!file
+		|| std::memcmp(signature, FileSignature, sizeof(FileSignature)) != 0
+		|| version != FileVersion
+		|| fileBuildKey != buildKey
+		|| count > MaxEntryCount)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Entry entry{};
+
+		if (!file.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+		{
+			entries.clear();
+			return;
+		}
+
+		entries.emplace(entry.siteId, entry.offset);
+	}
+}
+
+bool HookAddressCache::Save(const std::filesystem::path& path) const
+{
+	std::ofstream file(path, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	const uint32_t count = static_cast<uint32_t>(entries.size());
+
+	file.write(FileSignature, sizeof(FileSignature));
+	file.write(reinterpret_cast<const char*>(&FileVersion), sizeof(FileVersion));
+	file.write(reinterpret_cast<const char*>(&buildKey), sizeof(buildKey));
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+	for (const auto& [siteId, offset] : entries)
+	{
+		const Entry entry{ siteId, offset };
+
+		file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+	}
+
+	return static_cast<bool>(file);
+}
+
+bool HookAddressCache::TryGet(uint32_t siteId, uint32_t& offset) const
+{
+	const auto it = entries.find(siteId);
+
+	if (it == entries.end())
+	{
+		return false;
+	}
+
+	offset = it->second;
+	return true;
+}
+
+void HookAddressCache::Set(uint32_t siteId, uint32_t offset)
+{
+	auto [it, inserted] = entries.try_emplace(siteId, offset);
+
+	if (inserted || it->second != offset)
+	{
+		it->second = offset;
+		modified = true;
+	}
+}
+
+bool HookAddressCache::IsModified() const
+{
+	return modified;
+}
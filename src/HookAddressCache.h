@@ -0,0 +1,51 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+
+// Stores the resolved hook addresses of an executable build, so that the hook sites
+// do not have to be found again when the same executable is started.
+//
+// The file has an 8 byte "SC4BXADR" signature, a 32-bit version, the 64-bit build
+// key, a 32-bit entry count and 8 byte entries that hold the site ID and its offset
+// from the image base.
+class HookAddressCache
+{
+public:
+	HookAddressCache();
+
+	// Loads the entries, a file from a different build is ignored.
+	void Load(const std::filesystem::path& path, uint64_t buildKey);
+	bool Save(const std::filesystem::path& path) const;
+
+	bool TryGet(uint32_t siteId, uint32_t& offset) const;
+	void Set(uint32_t siteId, uint32_t offset);
+
+	bool IsModified() const;
+
+private:
+	uint64_t buildKey;
+	std::unordered_map<uint32_t, uint32_t> entries;
+	bool modified;
+};
@@ -0,0 +1,434 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HookSiteResolver.h"
+#include "Logger.h"
+#include <cstring>
+
+namespace
+{
+	// The layout of the 32-bit MSVC run-time type information.
+	constexpr uint32_t TypeDescriptorNameOffset = 8;
+	constexpr uint32_t CompleteObjectLocatorOffsetOffset = 4;
+	constexpr uint32_t CompleteObjectLocatorTypeDescriptorOffset = 12;
+
+	constexpr uint8_t CallOpcode = 0xE8;
+	constexpr uint32_t CallInstructionSize = 5;
+
+	// Two matches are enough to know that a search is ambiguous.
+	constexpr size_t AmbiguousMatchCount = 2;
+}
+
+HookSiteResolver::HookSiteResolver(const uint8_t* image)
+	: image(image),
+	  imageSize(ExecutableImage::GetImageSize(image)),
+	  imageBase(ExecutableImage::GetImageBase(image)),
+	  sections(),
+	  codeSection(),
+	  hasCodeSection(false),
+	  cache(),
+	  vtableOffsets(),
+	  signature(),
+	  matches()
+{
+	if (imageSize > 0 && imageBase != 0)
+	{
+		ExecutableImage::GetSections(image, imageSize, sections);
+		hasCodeSection = ExecutableImage::GetCodeSection(image, imageSize, codeSection);
+	}
+}
+
+void HookSiteResolver::LoadCache(const std::filesystem::path& path)
+{
+	cache.Load(path, ExecutableImage::GetBuildKey(image));
+}
+
+bool HookSiteResolver::SaveCache(const std::filesystem::path& path) const
+{
+	return !cache.IsModified() || cache.Save(path);
+}
+
+bool HookSiteResolver::ResolveVirtualMethodSlot(uint32_t siteId, const char* typeName, uint32_t index, uintptr_t& address)
+{
+	if (!hasCodeSection)
+	{
+		return false;
+	}
+
+	uint32_t offset = 0;
+
+	if (!cache.TryGet(siteId, offset) || !IsValidVirtualMethodSlot(offset))
+	{
+		uint32_t vtableOffset = 0;
+
+		if (!FindVTable(typeName, vtableOffset))
+		{
+			LogNotFound(siteId, typeName);
+			return false;
+		}
+
+		offset = vtableOffset + (index * sizeof(uint32_t));
+
+		if (!IsValidVirtualMethodSlot(offset))
+		{
+			LogNotFound(siteId, "vtable entry");
+			return false;
+		}
+
+		cache.Set(siteId, offset);
+	}
+
+	address = OffsetToAddress(offset);
+	return true;
+}
+
+bool HookSiteResolver::ResolveSignature(uint32_t siteId, const char* pattern, uintptr_t scopeStart, size_t scopeSize, uintptr_t& address)
+{
+	uint32_t scopeOffset = 0;
+	uint32_t scopeEnd = 0;
+
+	if (!GetCodeScope(scopeStart, scopeSize, scopeOffset, scopeEnd) || !SignatureScanner::Parse(pattern, signature))
+	{
+		return false;
+	}
+
+	uint32_t offset = 0;
+
+	// The cached address is used if the site still matches its signature.
+	if (cache.TryGet(siteId, offset)
+		&& offset >= scopeOffset
+		&& offset < scopeEnd
+		&& SignatureScanner::Matches(image + offset, scopeEnd - offset, signature))
+	{
+		address = OffsetToAddress(offset);
+		return true;
+	}
+
+	SignatureScanner::FindAll(image + scopeOffset, scopeEnd - scopeOffset, signature, AmbiguousMatchCount, matches);
+
+	if (matches.size() != 1)
+	{
+		if (matches.empty())
+		{
+			LogNotFound(siteId, pattern);
+		}
+		else
+		{
+			LogAmbiguous(
+				siteId,
+				pattern,
+				scopeOffset + static_cast<uint32_t>(matches[0]),
+				scopeOffset + static_cast<uint32_t>(matches[1]));
+		}
+
+		return false;
+	}
+
+	offset = scopeOffset + static_cast<uint32_t>(matches[0]);
+
+	cache.Set(siteId, offset);
+	address = OffsetToAddress(offset);
+	return true;
+}
+
+bool HookSiteResolver::ResolveCall(uint32_t siteId, uintptr_t target, uintptr_t scopeStart, size_t scopeSize, uintptr_t& address)
+{
+	uint32_t scopeOffset = 0;
+	uint32_t scopeEnd = 0;
+
+	if (!GetCodeScope(scopeStart, scopeSize, scopeOffset, scopeEnd) || scopeEnd - scopeOffset < CallInstructionSize)
+	{
+		return false;
+	}
+
+	const uint32_t targetOffset = AddressToOffset(target);
+	uint32_t offset = 0;
+
+	if (cache.TryGet(siteId, offset)
+		&& offset >= scopeOffset
+		&& offset <= scopeEnd - CallInstructionSize
+		&& IsValidCall(offset, targetOffset))
+	{
+		address = OffsetToAddress(offset);
+		return true;
+	}
+
+	uint32_t firstMatch = 0;
+	size_t matchCount = 0;
+
+	for (uint32_t i = scopeOffset; i <= scopeEnd - CallInstructionSize; i++)
+	{
+		if (IsValidCall(i, targetOffset))
+		{
+			if (matchCount > 0)
+			{
+				LogAmbiguous(siteId, "call", firstMatch, i);
+				return false;
+			}
+
+			firstMatch = i;
+			matchCount++;
+		}
+	}
+
+	if (matchCount == 0)
+	{
+		LogNotFound(siteId, "call");
+		return false;
+	}
+
+	cache.Set(siteId, firstMatch);
+	address = OffsetToAddress(firstMatch);
+	return true;
+}
+
+uintptr_t HookSiteResolver::GetVirtualMethod(uintptr_t slotAddress) const
+{
+	return OffsetToAddress(VirtualAddressToOffset(ReadUInt32(AddressToOffset(slotAddress))));
+}
+
+bool HookSiteResolver::IsCodeOffset(uint32_t offset) const
+{
+	return hasCodeSection && offset >= codeSection.offset && offset - codeSection.offset < codeSection.size;
+}
+
+bool HookSiteResolver::IsValidVirtualMethodSlot(uint32_t offset) const
+{
+	return (offset % sizeof(uint32_t)) == 0
+		&& offset <= imageSize - sizeof(uint32_t)
+		&& !IsCodeOffset(offset)
+		&& IsCodeOffset(VirtualAddressToOffset(ReadUInt32(offset)));
+}
+
+bool HookSiteResolver::IsValidCall(uint32_t offset, uint32_t targetOffset) const
+{
+	if (image[offset] != CallOpcode)
+	{
+		return false;
+	}
+
+	// The displacement is relative to the end of the instruction.
+	const uint32_t displacement = ReadUInt32(offset + 1);
+
+	return offset + CallInstructionSize + displacement == targetOffset;
+}
+
+bool HookSiteResolver::GetCodeScope(uintptr_t scopeStart, size_t scopeSize, uint32_t& scopeOffset, uint32_t& scopeEnd) const
+{
+	if (!hasCodeSection)
+	{
+		return false;
+	}
+
+	const uint32_t codeEnd = codeSection.offset + codeSection.size;
+	const uint32_t start = AddressToOffset(scopeStart);
+
+	if (!IsCodeOffset(start))
+	{
+		return false;
+	}
+
+	scopeOffset = start;
+	scopeEnd = scopeSize < codeEnd - start ? start + static_cast<uint32_t>(scopeSize) : codeEnd;
+
+	return true;
+}
+
+bool HookSiteResolver::FindVTable(const char* typeName, uint32_t& vtableOffset)
+{
+	const auto it = vtableOffsets.find(typeName);
+
+	if (it != vtableOffsets.end())
+	{
+		vtableOffset = it->second;
+		return true;
+	}
+
+	uint32_t typeDescriptorOffset = 0;
+
+	if (!FindTypeDescriptor(typeName, typeDescriptorOffset))
+	{
+		return false;
+	}
+
+	// A class with several base classes has a locator for each of its vtables,
+	// the locator of the main vtable has an offset of 0.
+	std::vector<uint32_t> references;
+	FindAddressReferences(typeDescriptorOffset, 16, references);
+
+	uint32_t locatorOffset = 0;
+	size_t locatorCount = 0;
+
+	for (const uint32_t reference : references)
+	{
+		if (reference < CompleteObjectLocatorTypeDescriptorOffset)
+		{
+			continue;
+		}
+
+		const uint32_t candidate = reference - CompleteObjectLocatorTypeDescriptorOffset;
+
+		if (ReadUInt32(candidate) == 0 && ReadUInt32(candidate + CompleteObjectLocatorOffsetOffset) == 0)
+		{
+			locatorOffset = candidate;
+			locatorCount++;
+		}
+	}
+
+	if (locatorCount != 1)
+	{
+		Logger::GetInstance().WriteLine(
+			LogLevel::Error,
+			"Found {} object locators for {}.",
+			locatorCount,
+			typeName);
+		return false;
+	}
+
+	FindAddressReferences(locatorOffset, AmbiguousMatchCount, references);
+
+	if (references.size() != 1)
+	{
+		Logger::GetInstance().WriteLine(
+			LogLevel::Error,
+			"Found {} vtables for {}.",
+			references.size(),
+			typeName);
+		return false;
+	}
+
+	vtableOffset = references[0] + sizeof(uint32_t);
+
+	if (!IsValidVirtualMethodSlot(vtableOffset))
+	{
+		return false;
+	}
+
+	vtableOffsets.emplace(typeName, vtableOffset);
+	return true;
+}
+
+bool HookSiteResolver::FindTypeDescriptor(const char* typeName, uint32_t& typeDescriptorOffset)
+{
+	// The name is matched together with its terminating null.
+	const size_t nameLength = std::strlen(typeName) + 1;
+
+	signature.bytes.assign(typeName, typeName + nameLength);
+	signature.mask.assign(nameLength, 0xFF);
+
+	size_t matchCount = 0;
+
+	for (const ExecutableImage::Section& section : sections)
+	{
+		if (section.code)
+		{
+			continue;
+		}
+
+		SignatureScanner::FindAll(image + section.offset, section.size, signature, AmbiguousMatchCount, matches);
+
+		for (const size_t match : matches)
+		{
+			typeDescriptorOffset = section.offset + static_cast<uint32_t>(match) - TypeDescriptorNameOffset;
+			matchCount++;
+		}
+	}
+
+	if (matchCount > 1)
+	{
+		Logger::GetInstance().WriteLine(LogLevel::Error, "The type name {} is not unique.", typeName);
+	}
+
+	return matchCount == 1;
+}
+
+void HookSiteResolver::FindAddressReferences(uint32_t referencedOffset, size_t maxMatches, std::vector<uint32_t>& offsets) const
+{
+	offsets.clear();
+
+	const uint32_t virtualAddress = imageBase + referencedOffset;
+
+	for (const ExecutableImage::Section& section : sections)
+	{
+		if (section.code)
+		{
+			continue;
+		}
+
+		const uint32_t sectionEnd = section.offset + (section.size & ~3U);
+
+		for (uint32_t offset = section.offset; offset < sectionEnd; offset += sizeof(uint32_t))
+		{
+			if (ReadUInt32(offset) == virtualAddress)
+			{
+				offsets.push_back(offset);
+
+				if (offsets.size() == maxMatches)
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+uint32_t HookSiteResolver::ReadUInt32(uint32_t offset) const
+{
+	uint32_t value = 0;
+	std::memcpy(&value, image + offset, sizeof(value));
+	return value;
+}
+
+uint32_t HookSiteResolver::VirtualAddressToOffset(uint32_t virtualAddress) const
+{
+	// An address below the image base wraps to an offset that is outside the image.
+	return virtualAddress - imageBase;
+}
+
+uint32_t HookSiteResolver::AddressToOffset(uintptr_t address) const
+{
+	return static_cast<uint32_t>(address - reinterpret_cast<uintptr_t>(image));
+}
+
+uintptr_t HookSiteResolver::OffsetToAddress(uint32_t offset) const
+{
+	return reinterpret_cast<uintptr_t>(image) + offset;
+}
+
+void HookSiteResolver::LogAmbiguous(uint32_t siteId, const char* what, uint32_t firstOffset, uint32_t secondOffset) const
+{
+	Logger::GetInstance().WriteLine(
+		LogLevel::Error,
+		"Hook site {} is ambiguous, {} matches at 0x{:x} and 0x{:x}.",
+		siteId,
+		what,
+		imageBase + firstOffset,
+		imageBase + secondOffset);
+}
+
+void HookSiteResolver::LogNotFound(uint32_t siteId, const char* what) const
+{
+	Logger::GetInstance().WriteLine(
+		LogLevel::Error,
+		"Hook site {} was not found, no match for {}.",
+		siteId,
+		what);
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "ExecutableImage.h"
+#include "HookAddressCache.h"
+#include "SignatureScanner.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Finds the locations that the plugin patches in the running executable, without
+// depending on the addresses of a particular game version.
+//
+// A vtable entry is found from the MSVC run-time type information of its class: the
+// type name leads to the type descriptor, the type descriptor to the complete object
+// locator, and the pointer to the locator is stored just before the vtable. A code
+// site is found by a signature, or by the call instruction that targets a known
+// function, within a range of code that the caller takes from a resolved vtable.
+//
+// Every search must find exactly one location. A site that is missing or ambiguous
+// is logged and not resolved. The offsets of the resolved sites are stored in a
+// cache that is keyed by a hash of the executable's code, later starts of the same
+// build only verify the cached sites.
+class HookSiteResolver
+{
+public:
+	explicit HookSiteResolver(const uint8_t* image);
+
+	void LoadCache(const std::filesystem::path& path);
+	bool SaveCache(const std::filesystem::path& path) const;
+
+	// Finds the vtable entry with the specified index, the class is identified
+	// by its MSVC type name, for example ".?AVcSC4Demolition@@".
+	bool ResolveVirtualMethodSlot(uint32_t siteId, const char* typeName, uint32_t index, uintptr_t& address);
+
+	// Finds the signature in the code between the scope start and the scope size.
+	bool ResolveSignature(uint32_t siteId, const char* signature, uintptr_t scopeStart, size_t scopeSize, uintptr_t& address);
+
+	// Finds the relative call instruction (E8) to the target function in the code
+	// between the scope start and the scope size.
+	bool ResolveCall(uint32_t siteId, uintptr_t target, uintptr_t scopeStart, size_t scopeSize, uintptr_t& address);
+
+	// Returns the address of the function that a resolved vtable entry points to.
+	uintptr_t GetVirtualMethod(uintptr_t slotAddress) const;
+
+private:
+	bool IsCodeOffset(uint32_t offset) const;
+	bool IsValidVirtualMethodSlot(uint32_t offset) const;
+	bool IsValidCall(uint32_t offset, uint32_t targetOffset) const;
+	bool GetCodeScope(uintptr_t scopeStart, size_t scopeSize, uint32_t& scopeOffset, uint32_t& scopeEnd) const;
+
+	bool FindVTable(const char* typeName, uint32_t& vtableOffset);
+	bool FindTypeDescriptor(const char* typeName, uint32_t& typeDescriptorOffset);
+	// Stores the offsets of up to maxMatches aligned 32-bit words in the data sections
+	// that hold the address of the specified image offset.
+	void FindAddressReferences(uint32_t referencedOffset, size_t maxMatches, std::vector<uint32_t>& offsets) const;
+
+	uint32_t ReadUInt32(uint32_t offset) const;
+	// The image stores absolute addresses relative to the image base in its headers.
+	uint32_t VirtualAddressToOffset(uint32_t virtualAddress) const;
+	uint32_t AddressToOffset(uintptr_t address) const;
+	uintptr_t OffsetToAddress(uint32_t offset) const;
+
+	void LogAmbiguous(uint32_t siteId, const char* what, uint32_t firstOffset, uint32_t secondOffset) const;
+	void LogNotFound(uint32_t siteId, const char* what) const;
+
+	const uint8_t* image;
+	uint32_t imageSize;
+	uint32_t imageBase;
+	std::vector<ExecutableImage::Section> sections;
+	ExecutableImage::Section codeSection;
+	bool hasCodeSection;
+	HookAddressCache cache;
+	std::unordered_map<std::string, uint32_t> vtableOffsets;
+	SignatureScanner::Signature signature;
+	std::vector<size_t> matches;
+};
@@ -0,0 +1,112 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HookSites.h"
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+	constexpr const char* ViewInputControlDemolishTypeName = ".?AVcSC4ViewInputControlDemolish@@";
+	constexpr const char* DemolitionTypeName = ".?AVcSC4Demolition@@";
+
+	// The cISC4ViewInputControl vtable indexes.
+	constexpr uint32_t OnKeyDownIndex = 14;
+	constexpr uint32_t OnMouseUpLIndex = 18;
+	constexpr uint32_t OnMouseWheelIndex = 21;
+	constexpr uint32_t ActivateIndex = 23;
+
+	// The cISC4Demolition vtable index of DemolishRegion.
+	constexpr uint32_t DemolishRegionIndex = 6;
+
+	// OnMouseUpL calls the cSC4Demolition::DemolishRegion implementation directly,
+	// the call is searched for in the start of the function.
+	constexpr size_t OnMouseUpLScopeSize = 0x800;
+
+	// UpdateSelectedRegion calls DemolishRegion through the vtable, the call is
+	// searched for in the code of the cSC4ViewInputControlDemolish methods that are
+	// compiled around OnMouseUpL.
+	constexpr const char* UpdateSelectedRegionDemolishRegionSignature = "6A 01 50 FF 52 18";
+	constexpr size_t UpdateSelectedRegionScopeSize = 0x2000;
+
+	[[noreturn]] void ThrowNotFound(HookSites::HookSiteId id)
+	{
+		char message[64]{};
+		std::snprintf(message, sizeof(message), "Failed to find hook site %u.", static_cast<uint32_t>(id));
+
+		throw std::runtime_error(message);
+	}
+
+	uintptr_t ResolveVirtualMethodSlot(HookSiteResolver& resolver, HookSites::HookSiteId id, const char* typeName, uint32_t index)
+	{
+		uintptr_t address = 0;
+
+		if (!resolver.ResolveVirtualMethodSlot(id, typeName, index, address))
+		{
+			ThrowNotFound(id);
+		}
+
+		return address;
+	}
+}
+
+HookSites::Addresses HookSites::Resolve(HookSiteResolver& resolver)
+{
+	Addresses addresses{};
+
+	addresses.onKeyDown = ResolveVirtualMethodSlot(resolver, HookSiteOnKeyDown, ViewInputControlDemolishTypeName, OnKeyDownIndex);
+	addresses.onMouseWheel = ResolveVirtualMethodSlot(resolver, HookSiteOnMouseWheel, ViewInputControlDemolishTypeName, OnMouseWheelIndex);
+	addresses.activate = ResolveVirtualMethodSlot(resolver, HookSiteActivate, ViewInputControlDemolishTypeName, ActivateIndex);
+	addresses.onKeyDownFunction = resolver.GetVirtualMethod(addresses.onKeyDown);
+	addresses.onMouseWheelFunction = resolver.GetVirtualMethod(addresses.onMouseWheel);
+	addresses.activateFunction = resolver.GetVirtualMethod(addresses.activate);
+
+	const uintptr_t onMouseUpL = resolver.GetVirtualMethod(
+		ResolveVirtualMethodSlot(resolver, HookSiteOnMouseUpL, ViewInputControlDemolishTypeName, OnMouseUpLIndex));
+	addresses.demolishRegionFunction = resolver.GetVirtualMethod(
+		ResolveVirtualMethodSlot(resolver, HookSiteDemolishRegion, DemolitionTypeName, DemolishRegionIndex));
+
+	if (!resolver.ResolveCall(
+		HookSiteOnMouseUpLDemolishRegion,
+		addresses.demolishRegionFunction,
+		onMouseUpL,
+		OnMouseUpLScopeSize,
+		addresses.onMouseUpLDemolishRegion))
+	{
+		ThrowNotFound(HookSiteOnMouseUpLDemolishRegion);
+	}
+
+	const uintptr_t updateSelectedRegionScopeStart = onMouseUpL > UpdateSelectedRegionScopeSize / 2
+		? onMouseUpL - (UpdateSelectedRegionScopeSize / 2)
+		: onMouseUpL;
+
+	if (!resolver.ResolveSignature(
+		HookSiteUpdateSelectedRegionDemolishRegion,
+		UpdateSelectedRegionDemolishRegionSignature,
+		updateSelectedRegionScopeStart,
+		UpdateSelectedRegionScopeSize,
+		addresses.updateSelectedRegionDemolishRegion))
+	{
+		ThrowNotFound(HookSiteUpdateSelectedRegionDemolishRegion);
+	}
+
+	return addresses;
+}
@@ -0,0 +1,62 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "HookSiteResolver.h"
+#include <cstdint>
+
+// The locations in the game executable that the bulldoze tool hooks patch.
+namespace HookSites
+{
+	enum HookSiteId : uint32_t
+	{
+		HookSiteOnKeyDown = 1,
+		HookSiteOnMouseWheel = 2,
+		HookSiteActivate = 3,
+		HookSiteUpdateSelectedRegionDemolishRegion = 4,
+		HookSiteOnMouseUpLDemolishRegion = 5,
+		// The vtable entries that lead to the code sites, they are not patched.
+		HookSiteOnMouseUpL = 6,
+		HookSiteDemolishRegion = 7,
+	};
+
+	struct Addresses
+	{
+		// The cSC4ViewInputControlDemolish vtable entries.
+		uintptr_t onKeyDown;
+		uintptr_t onMouseWheel;
+		uintptr_t activate;
+		// The push instructions before the DemolishRegion call that previews the selection.
+		uintptr_t updateSelectedRegionDemolishRegion;
+		// The DemolishRegion call that demolishes the selection.
+		uintptr_t onMouseUpLDemolishRegion;
+
+		// The functions that the patched vtable entries and call point to, the
+		// patches check that the game code still holds them.
+		uintptr_t onKeyDownFunction;
+		uintptr_t onMouseWheelFunction;
+		uintptr_t activateFunction;
+		uintptr_t demolishRegionFunction;
+	};
+
+	// Finds every hook site, a std::runtime_error is thrown if one of them is not found.
+	Addresses Resolve(HookSiteResolver& resolver);
+}
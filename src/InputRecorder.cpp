@@ -0,0 +1,206 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InputRecorder.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+	constexpr char FileSignature[8] = { 'S', 'C', '4', 'B', 'X', 'I', 'N', 'P' };
+	constexpr uint32_t FileVersion = 2;
+
+	// The records are written in batches to keep file I/O out of most hook calls.
+	constexpr size_t RecordsPerBatch = 1024;
+}
+
+InputRecorder::ScopedEvent::ScopedEvent(
+	InputRecorder& recorder,
+	EventType type,
+	const ToolState& state,
+	int32_t value0,
+	int32_t value1,
+	int32_t value2,
+	int32_t value3,
+	int32_t value4,
+	int32_t value5)
+	: recorder(recorder),
+	  recording(recorder.IsRecording()),
+	  recordIndex(0),
+	  start()
+{
+	if (recording)
+	{
+		start = std::chrono::steady_clock::now();
+
+		Record record{};
+		record.type = type;
+		record.diagonalThickness = static_cast<int8_t>(state.diagonalThickness);
+		record.cellPicked = state.cellPicked ? 1 : 0;
+		record.shiftDown = state.shiftDown ? 1 : 0;
+		record.modeFlags = state.modeFlags;
+		record.timestampMicroseconds = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::microseconds>(start - recorder.startTime).count());
+		record.values[0] = value0;
+		record.values[1] = value1;
+		record.values[2] = value2;
+		record.values[3] = value3;
+		record.values[4] = value4;
+		record.values[5] = value5;
+
+		recordIndex = recorder.BeginEvent(record);
+	}
+}
+
+InputRecorder::ScopedEvent::~ScopedEvent()
+{
+	if (recording)
+	{
+		const auto duration = std::chrono::steady_clock::now() - start;
+
+		recorder.EndEvent(
+			recordIndex,
+			static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+	}
+}
+
+InputRecorder::InputRecorder()
+	: file(),
+	  pendingRecords(),
+	  startTime(),
+	  eventDepth(0),
+	  recording(false)
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+	Stop();
+}
+
+bool InputRecorder::Start(const std::filesystem::path& path)
+{
+	Stop();
+
+	file.open(path, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+	if (file)
+	{
+		file.write(FileSignature, sizeof(FileSignature));
+		file.write(reinterpret_cast<const char*>(&FileVersion), sizeof(FileVersion));
+
+		pendingRecords.reserve(RecordsPerBatch);
+		startTime = std::chrono::steady_clock::now();
+		recording = true;
+	}
+
+	return recording;
+}
+
+void InputRecorder::Stop()
+{
+	if (recording)
+	{
+		eventDepth = 0;
+		Flush();
+		file.close();
+		recording = false;
+	}
+}
+
+void InputRecorder::Flush()
+{
+	// The records of the events that are still running are written when they end.
+	if (recording && eventDepth == 0 && !pendingRecords.empty())
+	{
+		file.write(
+			reinterpret_cast<const char*>(pendingRecords.data()),
+			static_cast<std::streamsize>(pendingRecords.size() * sizeof(Record)));
+		file.flush();
+
+		pendingRecords.clear();
+	}
+}
+
+bool InputRecorder::IsRecording() const
+{
+	return recording;
+}
+
+bool InputRecorder::Read(const std::filesystem::path& path, std::vector<Record>& records)
+{
+	records.clear();
+
+	std::ifstream input(path, std::ifstream::in | std::ifstream::binary);
+
+	char signature[sizeof(FileSignature)]{};
+	uint32_t version = 0;
+
+	if (!input.read(signature, sizeof(signature))
+		|| !std::equal(std::begin(signature), std::end(signature), std::begin(FileSignature))
+		|| !input.read(reinterpret_cast<char*>(&version), sizeof(version)))
+	{
+		return false;
+	}
+
+	if (version != FileVersion)
+	{
+		return false;
+	}
+
+	Record record{};
+
+	while (input.read(reinterpret_cast<char*>(&record), sizeof(record)))
+	{
+		records.push_back(record);
+	}
+
+	// A partial record at the end of the file is left by a crash, it is ignored.
+	return true;
+}
+
+size_t InputRecorder::BeginEvent(const Record& record)
+{
+	const size_t recordIndex = pendingRecords.size();
+
+	pendingRecords.push_back(record);
+	pendingRecords.back().nested = eventDepth > 0 ? 1 : 0;
+	eventDepth++;
+
+	return recordIndex;
+}
+
+void InputRecorder::EndEvent(size_t recordIndex, uint32_t durationMicroseconds)
+{
+	// The recording was stopped while the event was running.
+	if (!recording || eventDepth == 0)
+	{
+		return;
+	}
+
+	pendingRecords[recordIndex].durationMicroseconds = durationMicroseconds;
+	eventDepth--;
+
+	if (pendingRecords.size() >= RecordsPerBatch)
+	{
+		Flush();
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+// Records the input events that the bulldoze hooks receive to a compact binary file.
+//
+// The file starts with an 8 byte "SC4BXINP" signature and a 32-bit version, followed
+// by fixed size little endian records. Each record stores the event type, the time
+// since the recording started, up to six event values, the bulldoze tool state when
+// the event arrived and the time that the hook took to handle the event, so the
+// session can be replayed and the latency of each event type can be analyzed later.
+//
+// The records are stored in the order that the events started. An event that a hook
+// raises while it handles another event, such as the preview that a wheel event
+// refreshes, is marked as nested.
+class InputRecorder
+{
+public:
+	enum class EventType : uint8_t
+	{
+		Activate = 1,
+		KeyDown = 2,
+		MouseWheel = 3,
+		PreviewRegion = 4,
+		DemolishRegion = 5,
+	};
+
+	// The bulldoze tool state when an event arrived.
+	struct ToolState
+	{
+		// The occupant filter type, with 0x100 set in diagonal mode.
+		uint32_t modeFlags;
+		int32_t diagonalThickness;
+		bool cellPicked;
+		bool shiftDown;
+	};
+
+#pragma pack(push, 1)
+	struct Record
+	{
+		EventType type;
+		int8_t diagonalThickness;
+		uint8_t cellPicked;
+		uint8_t shiftDown;
+		uint32_t durationMicroseconds;
+		uint64_t timestampMicroseconds;
+		uint32_t modeFlags;
+		uint8_t nested;
+		uint8_t reserved[3];
+		int32_t values[6];
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(Record) == 48);
+
+	// Measures the duration of a hook and records it when the scope ends.
+	class ScopedEvent
+	{
+	public:
+		ScopedEvent(
+			InputRecorder& recorder,
+			EventType type,
+			const ToolState& state,
+			int32_t value0 = 0,
+			int32_t value1 = 0,
+			int32_t value2 = 0,
+			int32_t value3 = 0,
+			int32_t value4 = 0,
+			int32_t value5 = 0);
+		~ScopedEvent();
+
+		ScopedEvent(const ScopedEvent&) = delete;
+		ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+	private:
+		InputRecorder& recorder;
+		bool recording;
+		size_t recordIndex;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	InputRecorder();
+	~InputRecorder();
+
+	bool Start(const std::filesystem::path& path);
+	void Stop();
+	void Flush();
+
+	bool IsRecording() const;
+
+	// Reads the records of a recording file.
+	// Returns false if the file is missing or is not a recording.
+	static bool Read(const std::filesystem::path& path, std::vector<Record>& records);
+
+private:
+	size_t BeginEvent(const Record& record);
+	void EndEvent(size_t recordIndex, uint32_t durationMicroseconds);
+
+	std::ofstream file;
+	std::vector<Record> pendingRecords;
+	std::chrono::steady_clock::time_point startTime;
+	uint32_t eventDepth;
+	bool recording;
+};
@@ -0,0 +1,188 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Instrumentation.h"
+
+#ifdef BULLDOZE_EXTENSIONS_INSTRUMENTATION
+#include "Logger.h"
+#include <array>
+#include <atomic>
+#include <bit>
+
+namespace
+{
+	// Log-linear buckets in the style of an HDR histogram: each power of two range
+	// of nanoseconds is split into 8 linear sub-buckets, which keeps the relative
+	// error of the reported percentiles below 12.5%.
+	constexpr uint32_t SubBucketBits = 3;
+	constexpr uint32_t SubBucketCount = 1U << SubBucketBits;
+	constexpr uint32_t BucketCount = 64 * SubBucketCount;
+
+	struct Histogram
+	{
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> totalNanoseconds;
+		std::atomic<uint64_t> maxNanoseconds;
+		std::array<std::atomic<uint32_t>, BucketCount> buckets;
+	};
+
+	constexpr const char* CounterNames[] =
+	{
+		"Preview calls",
+		"Demolish calls",
+		"Diagonal region updates",
+		"Cells processed",
+		"Filter calls",
+		"Key down calls",
+		"Mouse wheel calls",
+		"Activate calls",
+	};
+
+	constexpr const char* TimerNames[] =
+	{
+		"Preview region",
+		"Demolish region",
+		"Diagonal region",
+	};
+
+	static_assert(std::size(CounterNames) == static_cast<size_t>(Instrumentation::Counter::Count));
+	static_assert(std::size(TimerNames) == static_cast<size_t>(Instrumentation::Timer::Count));
+
+	std::array<std::atomic<uint64_t>, static_cast<size_t>(Instrumentation::Counter::Count)> counters;
+	std::array<Histogram, static_cast<size_t>(Instrumentation::Timer::Count)> histograms;
+
+	uint64_t GetHistogramPercentile(const Histogram& histogram, uint64_t count, uint32_t percentile)
+	{
+		const uint64_t target = ((count * percentile) + 99) / 100;
+		uint64_t seen = 0;
+
+		for (uint32_t i = 0; i < BucketCount; i++)
+		{
+			seen += histogram.buckets[i].load(std::memory_order_relaxed);
+
+			if (seen >= target)
+			{
+				return Instrumentation::GetBucketValue(i);
+			}
+		}
+
+		return histogram.maxNanoseconds.load(std::memory_order_relaxed);
+	}
+}
+
+uint32_t Instrumentation::GetBucketIndex(uint64_t nanoseconds)
+{
+	if (nanoseconds < SubBucketCount)
+	{
+		return static_cast<uint32_t>(nanoseconds);
+	}
+
+	const uint32_t magnitude = 63 - static_cast<uint32_t>(std::countl_zero(nanoseconds));
+	const uint32_t subBucket = static_cast<uint32_t>(nanoseconds >> (magnitude - SubBucketBits)) & (SubBucketCount - 1);
+
+	return ((magnitude - SubBucketBits + 1) * SubBucketCount) + subBucket;
+}
+
+uint64_t Instrumentation::GetBucketValue(uint32_t index)
+{
+	if (index < SubBucketCount)
+	{
+		return index;
+	}
+
+	const uint32_t magnitude = (index / SubBucketCount) + SubBucketBits - 1;
+	const uint64_t subBucket = index & (SubBucketCount - 1);
+
+	return (uint64_t(1) << magnitude) | (subBucket << (magnitude - SubBucketBits));
+}
+
+uint64_t Instrumentation::GetPercentile(Timer timer, uint32_t percentile)
+{
+	const Histogram& histogram = histograms[static_cast<size_t>(timer)];
+	const uint64_t count = histogram.count.load(std::memory_order_relaxed);
+
+	return count > 0 ? GetHistogramPercentile(histogram, count, percentile) : 0;
+}
+
+void Instrumentation::Increment(Counter counter, uint64_t amount)
+{
+	counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void Instrumentation::RecordDuration(Timer timer, uint64_t nanoseconds)
+{
+	Histogram& histogram = histograms[static_cast<size_t>(timer)];
+
+	histogram.count.fetch_add(1, std::memory_order_relaxed);
+	histogram.totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+	histogram.buckets[GetBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+	uint64_t previousMax = histogram.maxNanoseconds.load(std::memory_order_relaxed);
+
+	while (nanoseconds > previousMax
+		&& !histogram.maxNanoseconds.compare_exchange_weak(previousMax, nanoseconds, std::memory_order_relaxed))
+	{
+	}
+}
+
+void Instrumentation::WriteSummary()
+{
+	Logger& logger = Logger::GetInstance();
+
+	for (size_t i = 0; i < counters.size(); i++)
+	{
+		logger.WriteLineFormatted(
+			LogLevel::Info,
+			"%s: %llu",
+			CounterNames[i],
+			static_cast<unsigned long long>(counters[i].exchange(0, std::memory_order_relaxed)));
+	}
+
+	for (size_t i = 0; i < histograms.size(); i++)
+	{
+		Histogram& histogram = histograms[i];
+		const uint64_t count = histogram.count.load(std::memory_order_relaxed);
+
+		if (count > 0)
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Info,
+				"%s: count=%llu, mean=%llu ns, p50=%llu ns, p90=%llu ns, p99=%llu ns, max=%llu ns",
+				TimerNames[i],
+				static_cast<unsigned long long>(count),
+				static_cast<unsigned long long>(histogram.totalNanoseconds.load(std::memory_order_relaxed) / count),
+				static_cast<unsigned long long>(GetHistogramPercentile(histogram, count, 50)),
+				static_cast<unsigned long long>(GetHistogramPercentile(histogram, count, 90)),
+				static_cast<unsigned long long>(GetHistogramPercentile(histogram, count, 99)),
+				static_cast<unsigned long long>(histogram.maxNanoseconds.load(std::memory_order_relaxed)));
+		}
+
+		histogram.count.store(0, std::memory_order_relaxed);
+		histogram.totalNanoseconds.store(0, std::memory_order_relaxed);
+		histogram.maxNanoseconds.store(0, std::memory_order_relaxed);
+
+		for (std::atomic<uint32_t>& bucket : histogram.buckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+#endif // BULLDOZE_EXTENSIONS_INSTRUMENTATION
@@ -0,0 +1,108 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Hot path counters and latency histograms for the bulldoze hooks.
+//
+// The instrumentation is compiled in when BULLDOZE_EXTENSIONS_INSTRUMENTATION is added
+// to the project's preprocessor definitions. Otherwise the INSTRUMENTATION_ macros
+// expand to nothing, and the hooks contain no instrumentation code.
+//
+// Recording uses relaxed atomic increments on fixed size arrays, it never locks
+// or allocates. The summary is written to the log when a city shuts down.
+namespace Instrumentation
+{
+	enum class Counter : uint32_t
+	{
+		PreviewCalls = 0,
+		DemolishCalls,
+		DiagonalRegionUpdates,
+		CellsProcessed,
+		FilterCalls,
+		KeyDownCalls,
+		MouseWheelCalls,
+		ActivateCalls,
+		Count
+	};
+
+	enum class Timer : uint32_t
+	{
+		PreviewRegion = 0,
+		DemolishRegion,
+		DiagonalRegion,
+		Count
+	};
+
+	void Increment(Counter counter, uint64_t amount);
+	void RecordDuration(Timer timer, uint64_t nanoseconds);
+
+	// Writes the counters and the latency percentiles to the log, and resets them.
+	void WriteSummary();
+
+	// Returns the histogram bucket that stores a duration.
+	uint32_t GetBucketIndex(uint64_t nanoseconds);
+
+	// Returns the lowest duration that is stored in a histogram bucket.
+	uint64_t GetBucketValue(uint32_t index);
+
+	// Returns the percentile of the durations recorded since the last summary,
+	// rounded down to the lowest duration of its bucket, or 0 if there are none.
+	uint64_t GetPercentile(Timer timer, uint32_t percentile);
+
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(Timer timer)
+			: timer(timer),
+			  start(std::chrono::steady_clock::now())
+		{
+		}
+
+		~ScopedTimer()
+		{
+			const auto duration = std::chrono::steady_clock::now() - start;
+
+			RecordDuration(timer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		Timer timer;
+		std::chrono::steady_clock::time_point start;
+	};
+}
+
+#ifdef BULLDOZE_EXTENSIONS_INSTRUMENTATION
+#define INSTRUMENTATION_CONCAT_CORE(a, b) a##b
+#define INSTRUMENTATION_CONCAT(a, b) INSTRUMENTATION_CONCAT_CORE(a, b)
+#define INSTRUMENTATION_COUNT(counter, amount) Instrumentation::Increment(Instrumentation::Counter::counter, (amount))
+#define INSTRUMENTATION_SCOPE(timer) Instrumentation::ScopedTimer INSTRUMENTATION_CONCAT(instrumentationTimer, __LINE__)(Instrumentation::Timer::timer)
+#define INSTRUMENTATION_WRITE_SUMMARY() Instrumentation::WriteSummary()
+#else
+#define INSTRUMENTATION_COUNT(counter, amount) ((void)0)
+#define INSTRUMENTATION_SCOPE(timer) ((void)0)
+#define INSTRUMENTATION_WRITE_SUMMARY() ((void)0)
+#endif // BULLDOZE_EXTENSIONS_INSTRUMENTATION
@@ -0,0 +1,66 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <version>
+
+// The plugin uses std::format, the tests and benchmarks fall back to the {fmt}
+// library when they are built with a standard library that does not have it.
+#ifdef __cpp_lib_format
+#include <format>
+#include <string_view>
+
+namespace LogFormat
+{
+	template<typename... Args>
+	using format_string = std::format_string<Args...>;
+
+	using std::format_args;
+	using std::make_format_args;
+	using std::vformat_to;
+	using string_view = std::string_view;
+
+	template<typename... Args>
+	string_view GetFormat(format_string<Args...> format)
+	{
+		return format.get();
+	}
+}
+#else
+#include <fmt/format.h>
+
+namespace LogFormat
+{
+	template<typename... Args>
+	using format_string = fmt::format_string<Args...>;
+
+	using fmt::format_args;
+	using fmt::make_format_args;
+	using fmt::vformat_to;
+	using string_view = fmt::string_view;
+
+	template<typename... Args>
+	string_view GetFormat(format_string<Args...> format)
+	{
+		return format;
+	}
+}
+#endif
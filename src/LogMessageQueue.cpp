@@ -0,0 +1,136 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogMessageQueue.h"
+#include <bit>
+#include <cstring>
+
+LogMessageQueue::LogMessageQueue(size_t capacity)
+	: slots(),
+	  mask(0),
+	  enqueuePosition(0),
+	  dequeuePosition(0)
+{
+	const size_t slotCount = std::bit_ceil((capacity < 2 ? 2 : capacity));
+
+	slots = std::make_unique<Slot[]>(slotCount);
+	mask = slotCount - 1;
+
+	for (size_t i = 0; i < slotCount; i++)
+	{
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+		slots[i].length = 0;
+		slots[i].overflowText = nullptr;
+	}
+}
+
+LogMessageQueue::~LogMessageQueue()
+{
+	for (size_t i = 0; i <= mask; i++)
+	{
+		delete[] slots[i].overflowText;
+	}
+}
+
+bool LogMessageQueue::TryPush(const char* message, size_t length)
+{
+	Slot* slot = nullptr;
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		slot = &slots[position & mask];
+
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+		if (difference == 0)
+		{
+			// The slot is free, try to claim it.
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (difference < 0)
+		{
+			// The consumer has not freed the slot yet, the queue is full.
+			return false;
+		}
+		else
+		{
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->length = static_cast<uint32_t>(length);
+
+	if (length <= SlotTextCapacity)
+	{
+		std::memcpy(slot->text, message, length);
+	}
+	else
+	{
+		slot->overflowText = new char[length];
+		std::memcpy(slot->overflowText, message, length);
+	}
+
+	slot->sequence.store(position + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool LogMessageQueue::TryPopAppend(std::string& output)
+{
+	Slot& slot = slots[dequeuePosition & mask];
+
+	const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+	if (sequence != dequeuePosition + 1)
+	{
+		return false;
+	}
+
+	if (slot.overflowText)
+	{
+		output.append(slot.overflowText, slot.length);
+
+		delete[] slot.overflowText;
+		slot.overflowText = nullptr;
+	}
+	else
+	{
+		output.append(slot.text, slot.length);
+	}
+
+	output.push_back('\n');
+
+	// Release the slot for the producer that wraps around to it.
+	slot.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+	dequeuePosition++;
+
+	return true;
+}
+
+size_t LogMessageQueue::GetUnreadCount() const
+{
+	return enqueuePosition.load(std::memory_order_acquire) - dequeuePosition;
+}
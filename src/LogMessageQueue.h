@@ -0,0 +1,70 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// A bounded multiple producer, single consumer queue of log lines.
+//
+// Each slot has a sequence number that tells the producers and the consumer
+// whether it is free or holds a message (Dmitry Vyukov's bounded queue), so the
+// queue does not use any locks. Lines that do not fit in a slot are copied into
+// a heap allocation that is owned by the slot until the consumer takes it.
+class LogMessageQueue
+{
+public:
+	explicit LogMessageQueue(size_t capacity);
+	~LogMessageQueue();
+
+	LogMessageQueue(const LogMessageQueue&) = delete;
+	LogMessageQueue& operator=(const LogMessageQueue&) = delete;
+
+	// Returns false if the queue is full.
+	bool TryPush(const char* message, size_t length);
+
+	// Appends the next message and a new line to the output, called by the consumer thread.
+	// Returns false if the queue is empty.
+	bool TryPopAppend(std::string& output);
+
+	// Returns the number of slots that producers have claimed and the consumer has not
+	// taken, including the ones whose line is still being copied. Called by the consumer thread.
+	size_t GetUnreadCount() const;
+
+private:
+	static constexpr size_t SlotTextCapacity = 240;
+
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		uint32_t length;
+		char* overflowText;
+		char text[SlotTextCapacity];
+	};
+
+	std::unique_ptr<Slot[]> slots;
+	size_t mask;
+	alignas(64) std::atomic<size_t> enqueuePosition;
+	alignas(64) size_t dequeuePosition;
+};
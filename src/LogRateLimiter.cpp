@@ -0,0 +1,57 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogRateLimiter.h"
+#include <Windows.h>
+#include <utility>
+
+LogRateLimiter::LogRateLimiter(uint32_t intervalMilliseconds)
+	: LogRateLimiter(intervalMilliseconds, []() { return static_cast<uint64_t>(GetTickCount64()); })
+{
+}
+
+LogRateLimiter::LogRateLimiter(uint32_t intervalMilliseconds, TimeFunction timeFunction)
+	: intervalMilliseconds(intervalMilliseconds),
+	  nextAllowedTime(0),
+	  suppressedCount(0),
+	  now(std::move(timeFunction))
+{
+}
+
+bool LogRateLimiter::TryAcquire(uint32_t& suppressedCount)
+{
+	const uint64_t currentTime = now();
+	uint64_t allowedTime = nextAllowedTime.load(std::memory_order_relaxed);
+
+	// Only one of the threads that reach the call site in the same interval claims it.
+	if (currentTime < allowedTime
+		|| !nextAllowedTime.compare_exchange_strong(
+			allowedTime,
+			currentTime + intervalMilliseconds,
+			std::memory_order_relaxed))
+	{
+		this->suppressedCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	suppressedCount = this->suppressedCount.exchange(0, std::memory_order_relaxed);
+	return true;
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// Limits a log call site to one line per interval.
+class LogRateLimiter
+{
+public:
+	// Returns the current time in milliseconds, the tests use a simulated clock.
+	using TimeFunction = std::function<uint64_t()>;
+
+	explicit LogRateLimiter(uint32_t intervalMilliseconds);
+	LogRateLimiter(uint32_t intervalMilliseconds, TimeFunction timeFunction);
+
+	// Returns true if a line can be written now, suppressedCount receives the
+	// number of lines that were rejected since the last line that was written.
+	bool TryAcquire(uint32_t& suppressedCount);
+
+private:
+	const uint64_t intervalMilliseconds;
+	std::atomic<uint64_t> nextAllowedTime;
+	std::atomic<uint32_t> suppressedCount;
+	const TimeFunction now;
+};
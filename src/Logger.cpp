@@ -20,10 +20,17 @@
  */
 
 #include "Logger.h"
+#include "LogMessageQueue.h"
 #include <Windows.h>
+#include <cstdarg>
+#include <cstring>
+#include <iterator>
 
 namespace
 {
+	// The number of lines that can be waiting for the writer thread.
+	constexpr size_t AsyncQueueCapacity = 1024;
+
 #ifdef _DEBUG
 	void PrintLineToDebugOutput(const char* line)
 	{
@@ -43,12 +50,32 @@ Logger& Logger::GetInstance()
 Logger::Logger()
 	: initialized(false),
 	  logFile(),
-	  logLevel(LogLevel::Error)
+	  ringLog(),
+	  logLevel(LogLevel::Error),
+	  queue(),
+	  writerThread(),
+	  overflowPolicy(LogOverflowPolicy::Drop),
+	  asyncWriterRunning(false),
+	  stopWriter(false),
+	  wakePending(false),
+	  wakeCount(0),
+	  droppedLineCount(0)
 {
 }
 
 Logger::~Logger()
 {
+	// The writer thread is stopped by the Shutdown call in PostAppShutdown. Static
+	// objects are destroyed while the loader lock is held, so a writer thread that
+	// is still running is detached instead of joined. It keeps its queue, because
+	// the thread may still be reading it.
+	if (writerThread.joinable())
+	{
+		asyncWriterRunning.store(false, std::memory_order_release);
+		writerThread.detach();
+		static_cast<void>(queue.release());
+	}
+
 	initialized = false;
 }
 
@@ -77,9 +104,11 @@ void Logger::SetLogLevel(LogLevel level)
 
 void Logger::WriteLogFileHeader(const char* const text)
 {
-	if (initialized && logFile)
+	if (initialized && IsOutputOpen())
 	{
-		logFile << text << std::endl;
+		WriteOutput(text, std::strlen(text));
+		WriteOutput("\n", 1);
+		FlushOutput();
 	}
 }
 
@@ -106,45 +135,239 @@ void Logger::WriteLineFormatted(LogLevel level, const char* const format, ...)
 	va_list argsCopy;
 	va_copy(argsCopy, args);
 
-	int formattedStringLength = std::vsnprintf(nullptr, 0, format, argsCopy);
+	// Most lines fit in the stack buffer, so the line is formatted directly into it
+	// and only formatted a second time when it was truncated.
+	constexpr size_t stackBufferSize = 1024;
+	char buffer[stackBufferSize];
 
-	va_end(argsCopy);
+	const int formattedStringLength = std::vsnprintf(buffer, stackBufferSize, format, args);
 
 	if (formattedStringLength > 0)
 	{
-		size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
-
-		constexpr size_t stackBufferSize = 1024;
-
-		if (formattedStringLengthWithNull >= stackBufferSize)
+		if (static_cast<size_t>(formattedStringLength) < stackBufferSize)
 		{
-			std::unique_ptr<char[]> buffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
-
-			std::vsnprintf(buffer.get(), formattedStringLengthWithNull, format, args);
-
-			WriteLineCore(buffer.get());
+			WriteLineCore(buffer);
 		}
 		else
 		{
-			char buffer[stackBufferSize]{};
+			const size_t formattedStringLengthWithNull = static_cast<size_t>(formattedStringLength) + 1;
 
-			std::vsnprintf(buffer, stackBufferSize, format, args);
+			std::unique_ptr<char[]> heapBuffer = std::make_unique_for_overwrite<char[]>(formattedStringLengthWithNull);
 
-			WriteLineCore(buffer);
+			std::vsnprintf(heapBuffer.get(), formattedStringLengthWithNull, format, argsCopy);
+
+			WriteLineCore(heapBuffer.get());
 		}
 	}
 
+	va_end(argsCopy);
 	va_end(args);
 }
 
+void Logger::WriteLineFormatArgs(LogFormat::string_view format, LogFormat::format_args args)
+{
+	// Each thread reuses its buffer, so formatting does not allocate once the
+	// buffer has grown to fit the longest line.
+	thread_local std::string buffer;
+
+	buffer.clear();
+	LogFormat::vformat_to(std::back_inserter(buffer), format, args);
+
+	WriteLineCore(buffer.c_str());
+}
+
+bool Logger::StartMappedLog(const std::filesystem::path& path, size_t capacity)
+{
+	if (!initialized || ringLog.IsOpen() || writerThread.joinable())
+	{
+		return false;
+	}
+
+	if (!ringLog.Open(path, capacity))
+	{
+		return false;
+	}
+
+	if (logFile.is_open())
+	{
+		logFile << "Continuing the log in " << path.filename().string() << '.' << std::endl;
+		logFile.close();
+	}
+
+	return true;
+}
+
+void Logger::StartAsyncWriter(LogOverflowPolicy policy)
+{
+	if (initialized && IsOutputOpen() && !writerThread.joinable())
+	{
+		queue = std::make_unique<LogMessageQueue>(AsyncQueueCapacity);
+		overflowPolicy = policy;
+		stopWriter.store(false, std::memory_order_relaxed);
+		droppedLineCount.store(0, std::memory_order_relaxed);
+
+		writerThread = std::thread(&Logger::AsyncWriterThread, this);
+		asyncWriterRunning.store(true, std::memory_order_release);
+	}
+}
+
+void Logger::Shutdown()
+{
+	if (writerThread.joinable())
+	{
+		stopWriter.store(true, std::memory_order_release);
+		wakeCount.fetch_add(1, std::memory_order_release);
+		wakeCount.notify_one();
+		writerThread.join();
+
+		// The lines are still queued until the queue is empty, so no other thread
+		// writes to the file while the remaining lines are written.
+		std::string batch;
+		DrainQueue(batch);
+
+		// New lines are written directly to the file from this point. A line that
+		// was queued while the flag changed is counted as dropped, writing it could
+		// interleave with a line that another thread writes directly.
+		asyncWriterRunning.store(false, std::memory_order_release);
+
+		while (queue->TryPopAppend(batch))
+		{
+			droppedLineCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// A producer that claimed a slot before the flag changed may still be copying
+		// its line, the line is never read, so it is counted as dropped too.
+		droppedLineCount.fetch_add(queue->GetUnreadCount(), std::memory_order_relaxed);
+
+		const uint64_t droppedLines = droppedLineCount.load(std::memory_order_relaxed);
+
+		if (droppedLines > 0)
+		{
+			WriteLineFormatted(
+				LogLevel::Error,
+				"%llu log lines were dropped because the log queue was full.",
+				static_cast<unsigned long long>(droppedLines));
+		}
+	}
+
+	if (ringLog.IsOpen())
+	{
+		ringLog.Flush();
+		ringLog.Close();
+	}
+}
+
 void Logger::WriteLineCore(const char* const message)
 {
-	if (initialized && logFile)
+	if (initialized && IsOutputOpen())
 	{
 #ifdef _DEBUG
 		PrintLineToDebugOutput(message);
 #endif // _DEBUG
 
-		logFile << message << std::endl;
+		if (asyncWriterRunning.load(std::memory_order_acquire))
+		{
+			EnqueueLine(message);
+		}
+		else
+		{
+			WriteOutput(message, std::strlen(message));
+			WriteOutput("\n", 1);
+			FlushOutput();
+		}
+	}
+}
+
+bool Logger::IsOutputOpen() const
+{
+	return ringLog.IsOpen() || (logFile.is_open() && logFile.good());
+}
+
+void Logger::WriteOutput(const char* data, size_t length)
+{
+	if (ringLog.IsOpen())
+	{
+		ringLog.Write(data, length);
+	}
+	else
+	{
+		logFile.write(data, static_cast<std::streamsize>(length));
+	}
+}
+
+void Logger::FlushOutput()
+{
+	// The ring log is a memory store, the OS writes it to the file.
+	if (!ringLog.IsOpen())
+	{
+		logFile.flush();
+	}
+}
+
+void Logger::EnqueueLine(const char* const message)
+{
+	const size_t length = std::strlen(message);
+
+	while (!queue->TryPush(message, length))
+	{
+		if (overflowPolicy == LogOverflowPolicy::Drop || !asyncWriterRunning.load(std::memory_order_acquire))
+		{
+			droppedLineCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		WakeAsyncWriter();
+		std::this_thread::yield();
+	}
+
+	WakeAsyncWriter();
+}
+
+void Logger::WakeAsyncWriter()
+{
+	// Only the first line that is queued after the writer starts draining wakes it,
+	// the writer picks up every line that follows in the same batch.
+	if (!wakePending.exchange(true, std::memory_order_acq_rel))
+	{
+		wakeCount.fetch_add(1, std::memory_order_release);
+		wakeCount.notify_one();
+	}
+}
+
+void Logger::DrainQueue(std::string& batch)
+{
+	batch.clear();
+
+	while (queue->TryPopAppend(batch))
+	{
+	}
+
+	if (!batch.empty())
+	{
+		WriteOutput(batch.data(), batch.size());
+		FlushOutput();
+	}
+}
+
+void Logger::AsyncWriterThread()
+{
+	std::string batch;
+
+	while (true)
+	{
+		// Clearing the flag before reading the queue ensures that a line queued after
+		// this point either lands in this batch or wakes the writer again.
+		wakePending.exchange(false, std::memory_order_acq_rel);
+
+		const uint32_t observedWakeCount = wakeCount.load(std::memory_order_acquire);
+
+		DrainQueue(batch);
+
+		if (stopWriter.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		wakeCount.wait(observedWakeCount, std::memory_order_acquire);
 	}
 }
\ No newline at end of file
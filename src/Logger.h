@@ -20,8 +20,18 @@
  */
 
 #pragma once
+#include "LogFormat.h"
+#include "LogRateLimiter.h"
+#include "RingLog.h"
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+class LogMessageQueue;
 
 enum class LogLevel : int32_t
 {
@@ -31,6 +41,15 @@ enum class LogLevel : int32_t
 	Trace = 3
 };
 
+// Controls what the asynchronous writer does when its queue is full.
+enum class LogOverflowPolicy : int32_t
+{
+	// The line is discarded and counted, the calling thread never waits.
+	Drop = 0,
+	// The calling thread waits until the writer thread frees a queue slot.
+	Block = 1
+};
+
 class Logger
 {
 public:
@@ -49,16 +68,98 @@ public:
 
 	void WriteLineFormatted(LogLevel level, const char* const format, ...);
 
+	// Writes a line using std::format syntax, the format string is checked at compile time.
+	template<typename Arg, typename... Args>
+	void WriteLine(LogLevel level, LogFormat::format_string<Arg, Args...> format, Arg&& arg, Args&&... args)
+	{
+		if (IsEnabled(level))
+		{
+			WriteLineFormatArgs(LogFormat::GetFormat<Arg, Args...>(format), LogFormat::make_format_args(arg, args...));
+		}
+	}
+
+	// Writes the following lines to a memory-mapped ring log file instead of the text
+	// log file, which is closed after a line that points to the ring log.
+	bool StartMappedLog(const std::filesystem::path& path, size_t capacity);
+
+	// Moves the file writes to a background thread, the lines are queued by the
+	// calling thread and written to the file in batches.
+	void StartAsyncWriter(LogOverflowPolicy policy);
+
+	// Stops the background writer, writes any lines that are still queued and
+	// closes the mapped log after starting to write its pages to the file.
+	void Shutdown();
+
 private:
 
 	Logger();
 	~Logger();
 
+	void WriteLineFormatArgs(LogFormat::string_view format, LogFormat::format_args args);
 	void WriteLineCore(const char* const message);
+	bool IsOutputOpen() const;
+	void WriteOutput(const char* data, size_t length);
+	void FlushOutput();
+	void EnqueueLine(const char* const message);
+	void WakeAsyncWriter();
+	void DrainQueue(std::string& batch);
+	void AsyncWriterThread();
 
 	bool initialized;
 	bool writeTimeStamp;
 	LogLevel logLevel;
 	std::ofstream logFile;
+	RingLog ringLog;
+	std::unique_ptr<LogMessageQueue> queue;
+	std::thread writerThread;
+	LogOverflowPolicy overflowPolicy;
+	std::atomic<bool> asyncWriterRunning;
+	std::atomic<bool> stopWriter;
+	std::atomic<bool> wakePending;
+	std::atomic<uint32_t> wakeCount;
+	std::atomic<uint64_t> droppedLineCount;
 };
 
+
+// The most detailed log level that is compiled into the plugin, the log macros for
+// more detailed levels expand to nothing, including their argument evaluation.
+#ifndef BULLDOZE_EXTENSIONS_MAX_LOG_LEVEL
+#define BULLDOZE_EXTENSIONS_MAX_LOG_LEVEL 3
+#endif
+
+#define LOG_LINE(level, ...)															\
+	do																					\
+	{																					\
+		if constexpr (static_cast<int32_t>(level) <= BULLDOZE_EXTENSIONS_MAX_LOG_LEVEL)	\
+		{																				\
+			Logger& logger_ = Logger::GetInstance();									\
+			if (logger_.IsEnabled(level))												\
+			{																			\
+				logger_.WriteLine(level, __VA_ARGS__);									\
+			}																			\
+		}																				\
+	} while (0)
+
+// Writes at most one line per interval from the call site, the number of lines that
+// were skipped is written before the next line that is allowed through.
+#define LOG_LINE_RATE_LIMITED(level, intervalMilliseconds, ...)						\
+	do																					\
+	{																					\
+		if constexpr (static_cast<int32_t>(level) <= BULLDOZE_EXTENSIONS_MAX_LOG_LEVEL)	\
+		{																				\
+			Logger& logger_ = Logger::GetInstance();									\
+			if (logger_.IsEnabled(level))												\
+			{																			\
+				static LogRateLimiter rateLimiter_(intervalMilliseconds);				\
+				uint32_t suppressedCount_ = 0;											\
+				if (rateLimiter_.TryAcquire(suppressedCount_))							\
+				{																		\
+					if (suppressedCount_ > 0)											\
+					{																	\
+						logger_.WriteLine(level, "Skipped {} similar lines.", suppressedCount_); \
+					}																	\
+					logger_.WriteLine(level, __VA_ARGS__);								\
+				}																		\
+			}																			\
+		}																				\
+	} while (0)
@@ -0,0 +1,201 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryMappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+MemoryMappedFile::MemoryMappedFile()
+#ifdef _WIN32
+	: fileHandle(INVALID_HANDLE_VALUE),
+	  mappingHandle(nullptr),
+#else
+	: fileDescriptor(-1),
+#endif // _WIN32
+	  data(nullptr),
+	  size(0)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MemoryMappedFile::Open(const std::filesystem::path& path, size_t size)
+{
+	Close();
+
+	fileHandle = CreateFileW(
+		path.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	// Mapping a size that is larger than the file extends it with zeros.
+	const uint64_t mappingSize = size;
+
+	mappingHandle = CreateFileMappingW(
+		fileHandle,
+		nullptr,
+		PAGE_READWRITE,
+		static_cast<DWORD>(mappingSize >> 32),
+		static_cast<DWORD>(mappingSize & 0xffffffff),
+		nullptr);
+
+	if (mappingHandle)
+	{
+		data = static_cast<uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_WRITE, 0, 0, size));
+	}
+
+	if (!data)
+	{
+		Close();
+		return false;
+	}
+
+	this->size = size;
+	return true;
+}
+
+void MemoryMappedFile::Close()
+{
+	if (data)
+	{
+		UnmapViewOfFile(data);
+		data = nullptr;
+	}
+
+	if (mappingHandle)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+
+	size = 0;
+}
+
+void MemoryMappedFile::Flush()
+{
+	if (data)
+	{
+		FlushViewOfFile(data, 0);
+	}
+}
+
+#else
+
+bool MemoryMappedFile::Open(const std::filesystem::path& path, size_t size)
+{
+	Close();
+
+	fileDescriptor = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+
+	if (fileDescriptor == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStatus {};
+
+	if (fstat(fileDescriptor, &fileStatus) != 0
+		|| (static_cast<uint64_t>(fileStatus.st_size) < size && ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0))
+	{
+		Close();
+		return false;
+	}
+
+	void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+
+	if (mapping == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	data = static_cast<uint8_t*>(mapping);
+	this->size = size;
+	return true;
+}
+
+void MemoryMappedFile::Close()
+{
+	if (data)
+	{
+		munmap(data, size);
+		data = nullptr;
+	}
+
+	if (fileDescriptor != -1)
+	{
+		close(fileDescriptor);
+		fileDescriptor = -1;
+	}
+
+	size = 0;
+}
+
+void MemoryMappedFile::Flush()
+{
+	if (data)
+	{
+		msync(data, size, MS_ASYNC);
+	}
+}
+
+#endif // _WIN32
+
+bool MemoryMappedFile::IsOpen() const
+{
+	return data != nullptr;
+}
+
+uint8_t* MemoryMappedFile::GetData() const
+{
+	return data;
+}
+
+size_t MemoryMappedFile::GetSize() const
+{
+	return size;
+}
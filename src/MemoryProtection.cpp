@@ -0,0 +1,167 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryProtection.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cinttypes>
+#include <cstdio>
+#endif // _WIN32
+
+#ifdef _WIN32
+
+size_t MemoryProtection::GetPageSize()
+{
+	SYSTEM_INFO systemInfo{};
+	GetSystemInfo(&systemInfo);
+
+	return systemInfo.dwPageSize;
+}
+
+bool MemoryProtection::GetProtection(uintptr_t address, uint32_t& protection)
+{
+	MEMORY_BASIC_INFORMATION info{};
+
+	if (VirtualQuery(reinterpret_cast<const void*>(address), &info, sizeof(info)) != sizeof(info))
+	{
+		return false;
+	}
+
+	protection = info.Protect;
+	return true;
+}
+
+bool MemoryProtection::MakeWritable(uintptr_t address, size_t size, uint32_t& oldProtection)
+{
+	DWORD previousProtection = 0;
+
+	if (!VirtualProtect(reinterpret_cast<void*>(address), size, PAGE_EXECUTE_READWRITE, &previousProtection))
+	{
+		return false;
+	}
+
+	oldProtection = previousProtection;
+	return true;
+}
+
+bool MemoryProtection::Restore(uintptr_t address, size_t size, uint32_t protection)
+{
+	DWORD previousProtection = 0;
+
+	return VirtualProtect(reinterpret_cast<void*>(address), size, protection, &previousProtection) != FALSE;
+}
+
+void MemoryProtection::FlushInstructionCache(uintptr_t address, size_t size)
+{
+	::FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<const void*>(address), size);
+}
+
+#else
+
+namespace
+{
+	uintptr_t GetPageStart(uintptr_t address)
+	{
+		return address & ~(static_cast<uintptr_t>(MemoryProtection::GetPageSize()) - 1);
+	}
+}
+
+size_t MemoryProtection::GetPageSize()
+{
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+bool MemoryProtection::GetProtection(uintptr_t address, uint32_t& protection)
+{
+	// mprotect cannot report the current protection, so it is read from the
+	// mapping list of the process.
+	FILE* maps = std::fopen("/proc/self/maps", "r");
+
+	if (!maps)
+	{
+		return false;
+	}
+
+	bool found = false;
+	char line[512]{};
+
+	while (!found && std::fgets(line, sizeof(line), maps))
+	{
+		uintmax_t start = 0;
+		uintmax_t end = 0;
+		char permissions[5]{};
+
+		if (std::sscanf(line, "%" SCNxMAX "-%" SCNxMAX " %4s", &start, &end, permissions) == 3
+			&& address >= start
+			&& address < end)
+		{
+			protection = (permissions[0] == 'r' ? PROT_READ : 0)
+				| (permissions[1] == 'w' ? PROT_WRITE : 0)
+				| (permissions[2] == 'x' ? PROT_EXEC : 0);
+			found = true;
+		}
+	}
+
+	std::fclose(maps);
+	return found;
+}
+
+bool MemoryProtection::MakeWritable(uintptr_t address, size_t size, uint32_t& oldProtection)
+{
+	uint32_t previousProtection = 0;
+
+	if (!GetProtection(address, previousProtection))
+	{
+		return false;
+	}
+
+	const uintptr_t pageStart = GetPageStart(address);
+
+	if (mprotect(reinterpret_cast<void*>(pageStart), (address - pageStart) + size, PROT_READ | PROT_WRITE | PROT_EXEC) != 0)
+	{
+		// mprotect changes the mappings in order and stops at the first one that fails,
+		// the mappings before it keep the new protection.
+		mprotect(reinterpret_cast<void*>(pageStart), (address - pageStart) + size, static_cast<int>(previousProtection));
+		return false;
+	}
+
+	oldProtection = previousProtection;
+	return true;
+}
+
+bool MemoryProtection::Restore(uintptr_t address, size_t size, uint32_t protection)
+{
+	const uintptr_t pageStart = GetPageStart(address);
+
+	return mprotect(reinterpret_cast<void*>(pageStart), (address - pageStart) + size, static_cast<int>(protection)) == 0;
+}
+
+void MemoryProtection::FlushInstructionCache(uintptr_t address, size_t size)
+{
+	char* const start = reinterpret_cast<char*>(address);
+
+	__builtin___clear_cache(start, start + size);
+}
+
+#endif // _WIN32
@@ -0,0 +1,45 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Changes the protection of the process memory pages, using VirtualProtect on
+// Windows and mprotect on other platforms.
+namespace MemoryProtection
+{
+	size_t GetPageSize();
+
+	// Gets the protection of the page that contains the address.
+	bool GetProtection(uintptr_t address, uint32_t& protection);
+
+	// Makes the pages that contain the range writable and executable, the previous
+	// protection of the range is stored in oldProtection.
+	// All of the pages in the range must have the same protection.
+	bool MakeWritable(uintptr_t address, size_t size, uint32_t& oldProtection);
+
+	// Restores the protection that MakeWritable returned.
+	bool Restore(uintptr_t address, size_t size, uint32_t protection);
+
+	// Discards any stale instructions for the range that the CPU may have cached.
+	void FlushInstructionCache(uintptr_t address, size_t size);
+}
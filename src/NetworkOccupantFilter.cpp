@@ -23,6 +23,7 @@
 #include "cISC4NetworkOccupant.h"
 #include "cISC4Occupant.h"
 #include "cRZAutoRefCount.h"
+#include "Instrumentation.h"
 
 NetworkOccupantFilter::NetworkOccupantFilter(NetworkTypeFlags networkTypeFlags)
 	: networkFlags(static_cast<uint32_t>(networkTypeFlags))
@@ -31,9 +32,13 @@ NetworkOccupantFilter::NetworkOccupantFilter(NetworkTypeFlags networkTypeFlags)
 
 bool NetworkOccupantFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
 {
+	INSTRUMENTATION_COUNT(FilterCalls, 1);
+
 	bool result = false;
 
-	if (pOccupant)
+	// Checking the type first avoids the QueryInterface call for the flora, props and
+	// buildings that make up most of the occupants in a typical selection.
+	if (pOccupant && IsOccupantTypeIncluded(static_cast<uint32_t>(pOccupant->GetType())))
 	{
 		cRZAutoRefCount<cISC4NetworkOccupant> networkOccupant;
 
@@ -45,3 +50,8 @@ bool NetworkOccupantFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
 
 	return result;
 }
+
+bool NetworkOccupantFilter::IsOccupantTypeIncluded(uint32_t type)
+{
+	return type == kNetworkOccupantType;
+}
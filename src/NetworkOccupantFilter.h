@@ -72,14 +72,18 @@ inline NetworkTypeFlags& operator&=(NetworkTypeFlags& lhs, NetworkTypeFlags rhs)
 	return reinterpret_cast<NetworkTypeFlags&>(reinterpret_cast<T&>(lhs) &= static_cast<T>(rhs));
 }
 
+// The type ID that cISC4Occupant::GetType returns for every network piece,
+// including roads, rail, pipes and power poles.
+inline constexpr uint32_t kNetworkOccupantType = 0x088E1962;
+
 class NetworkOccupantFilter : public cSC4BaseOccupantFilter
 {
 public:
 	NetworkOccupantFilter(NetworkTypeFlags networkFlags);
 
 	bool IsOccupantIncluded(cISC4Occupant* pOccupant) override;
+	bool IsOccupantTypeIncluded(uint32_t type) override;
 
 private:
 	uint32_t networkFlags;
 };
-
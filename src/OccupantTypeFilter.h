@@ -0,0 +1,37 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cSC4BaseOccupantFilter.h"
+#include "OccupantTypeSet.h"
+
+// Includes the occupants whose type is in a fixed set of occupant type IDs.
+// The set scans up to 32 IDs and uses a hash lookup for more.
+class OccupantTypeFilter : public cSC4BaseOccupantFilter
+{
+public:
+	OccupantTypeFilter(const OccupantTypeSet& types);
+
+	bool IsOccupantTypeIncluded(uint32_t type) override;
+
+private:
+	OccupantTypeSet types;
+};
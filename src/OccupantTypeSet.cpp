@@ -0,0 +1,131 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupantTypeSet.h"
+#include <algorithm>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OCCUPANT_TYPE_SET_USE_SSE2 1
+#endif
+
+namespace
+{
+	constexpr size_t SimdWidth = 4;
+
+	// The largest set that is scanned, the benchmarks measure a hash lookup as
+	// faster above it.
+	constexpr size_t LinearScanLimit = 32;
+}
+
+OccupantTypeSet::OccupantTypeSet()
+	: sortedTypes(),
+	  hashedTypes(),
+	  count(0)
+{
+}
+
+OccupantTypeSet::OccupantTypeSet(std::initializer_list<uint32_t> types)
+	: sortedTypes(),
+	  hashedTypes(),
+	  count(0)
+{
+	Init(types.begin(), types.size());
+}
+
+OccupantTypeSet::OccupantTypeSet(const uint32_t* types, size_t typeCount)
+	: sortedTypes(),
+	  hashedTypes(),
+	  count(0)
+{
+	Init(types, typeCount);
+}
+
+bool OccupantTypeSet::Contains(uint32_t type) const
+{
+	if (count == 0)
+	{
+		return false;
+	}
+
+	if (count > LinearScanLimit)
+	{
+		return hashedTypes.contains(type);
+	}
+
+	const uint32_t* const types = sortedTypes.data();
+	const size_t paddedCount = sortedTypes.size();
+
+#ifdef OCCUPANT_TYPE_SET_USE_SSE2
+	const __m128i needle = _mm_set1_epi32(static_cast<int>(type));
+	__m128i matches = _mm_setzero_si128();
+
+	for (size_t i = 0; i < paddedCount; i += SimdWidth)
+	{
+		const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(types + i));
+
+		matches = _mm_or_si128(matches, _mm_cmpeq_epi32(values, needle));
+	}
+
+	return _mm_movemask_epi8(matches) != 0;
+#else
+	bool found = false;
+
+	for (size_t i = 0; i < paddedCount; i++)
+	{
+		found |= types[i] == type;
+	}
+
+	return found;
+#endif // OCCUPANT_TYPE_SET_USE_SSE2
+}
+
+bool OccupantTypeSet::IsEmpty() const
+{
+	return count == 0;
+}
+
+size_t OccupantTypeSet::GetCount() const
+{
+	return count;
+}
+
+void OccupantTypeSet::Init(const uint32_t* types, size_t typeCount)
+{
+	sortedTypes.assign(types, types + typeCount);
+	std::sort(sortedTypes.begin(), sortedTypes.end());
+	sortedTypes.erase(std::unique(sortedTypes.begin(), sortedTypes.end()), sortedTypes.end());
+
+	count = sortedTypes.size();
+	hashedTypes.clear();
+
+	if (count > LinearScanLimit)
+	{
+		hashedTypes.insert(sortedTypes.begin(), sortedTypes.end());
+	}
+
+	if (count > 0)
+	{
+		const size_t paddedCount = ((count + SimdWidth - 1) / SimdWidth) * SimdWidth;
+
+		sortedTypes.resize(paddedCount, sortedTypes.back());
+	}
+}
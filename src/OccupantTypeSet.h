@@ -0,0 +1,55 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_set>
+#include <vector>
+
+// An immutable set of occupant type IDs that is optimized for lookups.
+//
+// The IDs are stored in a sorted array. Sets of up to 32 IDs, which are the common
+// case for occupant filters, are searched with a branch-free SSE2 scan that compares
+// four IDs at a time. The scan and a hash lookup take about the same time at 32 IDs,
+// so larger sets are looked up in a hash set instead.
+class OccupantTypeSet
+{
+public:
+	OccupantTypeSet();
+	OccupantTypeSet(std::initializer_list<uint32_t> types);
+	OccupantTypeSet(const uint32_t* types, size_t typeCount);
+
+	bool Contains(uint32_t type) const;
+
+	bool IsEmpty() const;
+	size_t GetCount() const;
+
+private:
+	void Init(const uint32_t* types, size_t typeCount);
+
+	// The array is padded to a multiple of the SIMD width by repeating the last ID.
+	std::vector<uint32_t> sortedTypes;
+	// Only used for the sets that are too large to scan.
+	std::unordered_set<uint32_t> hashedTypes;
+	size_t count;
+};
@@ -0,0 +1,269 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PatchSet.h"
+#include "MemoryProtection.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	std::runtime_error CreateError(const char* message, uintptr_t address)
+	{
+		char buffer[128]{};
+
+		std::snprintf(buffer, sizeof(buffer), "%s at 0x%08llx.", message, static_cast<unsigned long long>(address));
+
+		return std::runtime_error(buffer);
+	}
+}
+
+void PatchSet::AddJump(uintptr_t address, uintptr_t destination, const std::vector<uint8_t>& expectedBytes)
+{
+	AddRelativeBranch(0xE9, address, destination, expectedBytes);
+}
+
+void PatchSet::AddCallHook(uintptr_t address, uintptr_t function, const std::vector<uint8_t>& expectedBytes)
+{
+	AddRelativeBranch(0xE8, address, function, expectedBytes);
+}
+
+void PatchSet::AddJumpTableHook(uintptr_t address, uintptr_t newValue, const std::vector<uint8_t>& expectedBytes)
+{
+	Patch& patch = patches.emplace_back();
+	patch.address = address;
+	patch.bytes = GetJumpTableBytes(newValue);
+	patch.expectedBytes = expectedBytes;
+}
+
+void PatchSet::AddBytes(uintptr_t address, std::initializer_list<uint8_t> bytes, const std::vector<uint8_t>& expectedBytes)
+{
+	Patch& patch = patches.emplace_back();
+	patch.address = address;
+	patch.bytes = bytes;
+	patch.expectedBytes = expectedBytes;
+}
+
+std::vector<uint8_t> PatchSet::GetJumpTableBytes(uintptr_t function)
+{
+	std::vector<uint8_t> bytes(sizeof(function));
+	std::memcpy(bytes.data(), &function, sizeof(function));
+
+	return bytes;
+}
+
+std::vector<uint8_t> PatchSet::GetCallBytes(uintptr_t address, uintptr_t function)
+{
+	return GetRelativeBranchBytes(0xE8, address, function);
+}
+
+size_t PatchSet::GetPatchCount() const
+{
+	return patches.size();
+}
+
+void PatchSet::Apply()
+{
+	Verify();
+
+	for (Patch& patch : patches)
+	{
+		patch.originalBytes.resize(patch.bytes.size());
+		std::memcpy(patch.originalBytes.data(), reinterpret_cast<const void*>(patch.address), patch.bytes.size());
+	}
+
+	std::vector<PageRange> pageRanges = GetPageRanges();
+
+	for (PageRange& range : pageRanges)
+	{
+		range.writable = MemoryProtection::MakeWritable(range.start, range.size, range.oldProtection);
+
+		if (!range.writable)
+		{
+			RestoreProtection(pageRanges);
+			throw CreateError("Failed to make the code writable", range.start);
+		}
+	}
+
+	WritePatches(false);
+
+	if (!RestoreProtection(pageRanges))
+	{
+		// The pages that could not be restored are still writable, so the
+		// original bytes can be put back before giving up.
+		for (PageRange& range : pageRanges)
+		{
+			if (!range.writable)
+			{
+				range.writable = MemoryProtection::MakeWritable(range.start, range.size, range.oldProtection);
+			}
+		}
+
+		WritePatches(true);
+		RestoreProtection(pageRanges);
+
+		throw std::runtime_error("Failed to restore the code protection, the patches were reverted.");
+	}
+
+	for (const Patch& patch : patches)
+	{
+		MemoryProtection::FlushInstructionCache(patch.address, patch.bytes.size());
+	}
+}
+
+void PatchSet::AddRelativeBranch(
+	uint8_t opcode,
+	uintptr_t address,
+	uintptr_t destination,
+	const std::vector<uint8_t>& expectedBytes)
+{
+	Patch& patch = patches.emplace_back();
+	patch.address = address;
+	patch.bytes = GetRelativeBranchBytes(opcode, address, destination);
+	patch.expectedBytes = expectedBytes;
+}
+
+std::vector<uint8_t> PatchSet::GetRelativeBranchBytes(uint8_t opcode, uintptr_t address, uintptr_t destination)
+{
+	// The displacement is relative to the end of the 5 byte instruction.
+	const uint32_t displacement = static_cast<uint32_t>(destination - address - 5);
+
+	std::vector<uint8_t> bytes(5);
+	bytes[0] = opcode;
+	std::memcpy(&bytes[1], &displacement, sizeof(displacement));
+
+	return bytes;
+}
+
+void PatchSet::Verify() const
+{
+	for (size_t i = 0; i < patches.size(); i++)
+	{
+		const Patch& patch = patches[i];
+
+		if (patch.expectedBytes.size() > patch.bytes.size())
+		{
+			throw CreateError("The expected bytes are longer than the patch", patch.address);
+		}
+
+		if (!patch.expectedBytes.empty()
+			&& std::memcmp(reinterpret_cast<const void*>(patch.address), patch.expectedBytes.data(), patch.expectedBytes.size()) != 0)
+		{
+			throw CreateError("The code does not match the expected bytes", patch.address);
+		}
+
+		for (size_t j = i + 1; j < patches.size(); j++)
+		{
+			const Patch& other = patches[j];
+
+			if (patch.address < other.address + other.bytes.size() && other.address < patch.address + patch.bytes.size())
+			{
+				throw CreateError("Two patches overlap", (std::max)(patch.address, other.address));
+			}
+		}
+	}
+}
+
+std::vector<PatchSet::PageRange> PatchSet::GetPageRanges() const
+{
+	const size_t pageSize = MemoryProtection::GetPageSize();
+	const uintptr_t pageMask = ~(static_cast<uintptr_t>(pageSize) - 1);
+
+	std::vector<uintptr_t> pages;
+
+	for (const Patch& patch : patches)
+	{
+		const uintptr_t first = patch.address & pageMask;
+		const uintptr_t last = (patch.address + patch.bytes.size() - 1) & pageMask;
+
+		for (uintptr_t page = first; page <= last; page += pageSize)
+		{
+			pages.push_back(page);
+		}
+	}
+
+	std::sort(pages.begin(), pages.end());
+	pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+	// Adjacent pages are merged when they have the same protection, because a
+	// single protection is restored for each range.
+	std::vector<PageRange> ranges;
+	uint32_t previousProtection = 0;
+
+	for (const uintptr_t page : pages)
+	{
+		uint32_t protection = 0;
+
+		if (!MemoryProtection::GetProtection(page, protection))
+		{
+			throw CreateError("Failed to get the code protection", page);
+		}
+
+		if (!ranges.empty()
+			&& ranges.back().start + ranges.back().size == page
+			&& protection == previousProtection)
+		{
+			ranges.back().size += pageSize;
+		}
+		else
+		{
+			ranges.push_back(PageRange{ page, pageSize, 0, false });
+		}
+
+		previousProtection = protection;
+	}
+
+	return ranges;
+}
+
+void PatchSet::WritePatches(bool original)
+{
+	for (const Patch& patch : patches)
+	{
+		const std::vector<uint8_t>& bytes = original ? patch.originalBytes : patch.bytes;
+
+		std::memcpy(reinterpret_cast<void*>(patch.address), bytes.data(), bytes.size());
+	}
+}
+
+bool PatchSet::RestoreProtection(std::vector<PageRange>& pageRanges)
+{
+	bool result = true;
+
+	for (PageRange& range : pageRanges)
+	{
+		if (range.writable)
+		{
+			if (MemoryProtection::Restore(range.start, range.size, range.oldProtection))
+			{
+				range.writable = false;
+			}
+			else
+			{
+				result = false;
+			}
+		}
+	}
+
+	return result;
+}
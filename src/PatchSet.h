@@ -0,0 +1,79 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+// Collects a group of code patches and applies all of them or none of them.
+//
+// Apply checks that the patched memory still holds the bytes each patch expects,
+// changes the protection of each group of adjacent pages once, writes the patches,
+// restores the original protection and flushes the instruction cache. If any step
+// fails the patches that were written are reverted and a std::runtime_error is thrown.
+class PatchSet
+{
+public:
+	// The expected bytes are compared with the start of the patched memory, they can
+	// be shorter than the patch or empty when the original bytes are not known.
+	void AddJump(uintptr_t address, uintptr_t destination, const std::vector<uint8_t>& expectedBytes = {});
+	void AddCallHook(uintptr_t address, uintptr_t function, const std::vector<uint8_t>& expectedBytes = {});
+	void AddJumpTableHook(uintptr_t address, uintptr_t newValue, const std::vector<uint8_t>& expectedBytes = {});
+	void AddBytes(uintptr_t address, std::initializer_list<uint8_t> bytes, const std::vector<uint8_t>& expectedBytes = {});
+
+	// Returns the bytes of a jump table entry that points to the function.
+	static std::vector<uint8_t> GetJumpTableBytes(uintptr_t function);
+	// Returns the bytes of a relative call instruction at the address.
+	static std::vector<uint8_t> GetCallBytes(uintptr_t address, uintptr_t function);
+
+	size_t GetPatchCount() const;
+
+	void Apply();
+
+private:
+	struct Patch
+	{
+		uintptr_t address;
+		std::vector<uint8_t> bytes;
+		std::vector<uint8_t> expectedBytes;
+		std::vector<uint8_t> originalBytes;
+	};
+
+	// A run of adjacent pages that is unprotected with a single call.
+	struct PageRange
+	{
+		uintptr_t start;
+		size_t size;
+		uint32_t oldProtection;
+		bool writable;
+	};
+
+	void AddRelativeBranch(uint8_t opcode, uintptr_t address, uintptr_t destination, const std::vector<uint8_t>& expectedBytes);
+	static std::vector<uint8_t> GetRelativeBranchBytes(uint8_t opcode, uintptr_t address, uintptr_t destination);
+	void Verify() const;
+	std::vector<PageRange> GetPageRanges() const;
+	void WritePatches(bool original);
+	static bool RestoreProtection(std::vector<PageRange>& pageRanges);
+
+	std::vector<Patch> patches;
+};
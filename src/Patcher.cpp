@@ -20,31 +20,22 @@
  */
 
 #include "Patcher.h"
-#include <Windows.h>
-#include "wil/resource.h"
-#include "wil/win32_helpers.h"
+#include "PatchSet.h"
+
+// Each function applies a single patch, use PatchSet to apply a group of patches together.
 
 void Patcher::InstallJump(uintptr_t address, uintptr_t destination)
 {
-	DWORD oldProtect;
-	THROW_IF_WIN32_BOOL_FALSE(VirtualProtect(reinterpret_cast<void*>(address), 5, PAGE_EXECUTE_READWRITE, &oldProtect));
-
-	*((uint8_t*)address) = 0xE9;
-	*((uintptr_t*)(address + 1)) = destination - address - 5;
+	PatchSet patchSet;
+	patchSet.AddJump(address, destination);
+	patchSet.Apply();
 }
 
 void Patcher::InstallJumpTableHook(uintptr_t targetAddress, uintptr_t newValue)
 {
-	// Allow the executable memory to be written to.
-	DWORD oldProtect = 0;
-	THROW_IF_WIN32_BOOL_FALSE(VirtualProtect(
-		reinterpret_cast<LPVOID>(targetAddress),
-		sizeof(uintptr_t),
-		PAGE_EXECUTE_READWRITE,
-		&oldProtect));
-
-	// Patch the memory at the specified address.
-	*reinterpret_cast<uintptr_t*>(targetAddress) = newValue;
+	PatchSet patchSet;
+	patchSet.AddJumpTableHook(targetAddress, newValue);
+	patchSet.Apply();
 }
 
 void Patcher::InstallCallHook(uintptr_t address, void(*pfnFunc)(void))
@@ -54,23 +45,14 @@ void Patcher::InstallCallHook(uintptr_t address, void(*pfnFunc)(void))
 
 void Patcher::InstallCallHook(uintptr_t address, uintptr_t pfnFunc)
 {
-	DWORD oldProtect;
-	THROW_IF_WIN32_BOOL_FALSE(VirtualProtect(reinterpret_cast<void*>(address), 5, PAGE_EXECUTE_READWRITE, &oldProtect));
-
-	*((uint8_t*)address) = 0xE8;
-	*((uintptr_t*)(address + 1)) = pfnFunc - address - 5;
+	PatchSet patchSet;
+	patchSet.AddCallHook(address, pfnFunc);
+	patchSet.Apply();
 }
 
 void Patcher::OverwriteMemory(uintptr_t address, uint8_t newValue)
 {
-	DWORD oldProtect;
-	// Allow the executable memory to be written to.
-	THROW_IF_WIN32_BOOL_FALSE(VirtualProtect(
-		reinterpret_cast<void*>(address),
-		sizeof(newValue),
-		PAGE_EXECUTE_READWRITE,
-		&oldProtect));
-
-	// Patch the memory at the specified address.
-	*((uint8_t*)address) = newValue;
+	PatchSet patchSet;
+	patchSet.AddBytes(address, { newValue });
+	patchSet.Apply();
 }
@@ -0,0 +1,104 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PendingSelection.h"
+#include "CellRegionAlgebra.h"
+
+PendingSelection::PendingSelection()
+	: region(),
+	  parameters(),
+	  selectionCount(0),
+	  cellCount(0)
+{
+}
+
+bool PendingSelection::Add(const SC4CellRegion<int32_t>& region, const Parameters& parameters)
+{
+	if (!IsCompatible(parameters))
+	{
+		return false;
+	}
+
+	if (this->region)
+	{
+		const SC4Rect<int32_t>& bounds = this->region->bounds;
+
+		if (region.bounds.topLeftX >= bounds.topLeftX
+			&& region.bounds.topLeftY >= bounds.topLeftY
+			&& region.bounds.bottomRightX <= bounds.bottomRightX
+			&& region.bounds.bottomRightY <= bounds.bottomRightY)
+		{
+			// The merged region already covers the new bounds.
+			CellRegionAlgebra::Apply(*this->region, region, CellRegionAlgebra::Operation::Union);
+		}
+		else
+		{
+			this->region = CellRegionAlgebra::Union(*this->region, region);
+		}
+	}
+	else
+	{
+		this->region = region;
+		this->parameters = parameters;
+	}
+
+	selectionCount++;
+	cellCount = CellRegionAlgebra::CountCells(*this->region);
+
+	return true;
+}
+
+bool PendingSelection::IsCompatible(const Parameters& parameters) const
+{
+	return !region || this->parameters == parameters;
+}
+
+void PendingSelection::Clear()
+{
+	region.reset();
+	selectionCount = 0;
+	cellCount = 0;
+}
+
+bool PendingSelection::IsEmpty() const
+{
+	return !region;
+}
+
+size_t PendingSelection::GetSelectionCount() const
+{
+	return selectionCount;
+}
+
+uint32_t PendingSelection::GetCellCount() const
+{
+	return cellCount;
+}
+
+const SC4CellRegion<int32_t>& PendingSelection::GetRegion() const
+{
+	return *region;
+}
+
+const PendingSelection::Parameters& PendingSelection::GetParameters() const
+{
+	return parameters;
+}
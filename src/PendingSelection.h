@@ -0,0 +1,70 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4CellRegion.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// The selections that have been queued to be demolished together.
+//
+// The queued selections are merged into a single region as they are added, so
+// overlapping selections are demolished once and the whole area can be passed
+// to the game in one batch.
+class PendingSelection
+{
+public:
+	// The demolition options of a selection, only selections with the same
+	// options can be demolished together.
+	struct Parameters
+	{
+		uint32_t filterType;
+		uint32_t flags;
+		bool clearZonedArea;
+
+		bool operator==(const Parameters& other) const = default;
+	};
+
+	PendingSelection();
+
+	// Returns false if the pending selections use different parameters.
+	bool Add(const SC4CellRegion<int32_t>& region, const Parameters& parameters);
+
+	// Returns true if a selection with the specified parameters can be added.
+	bool IsCompatible(const Parameters& parameters) const;
+
+	void Clear();
+
+	bool IsEmpty() const;
+	size_t GetSelectionCount() const;
+	uint32_t GetCellCount() const;
+
+	// The merged region, only valid when the pending selection is not empty.
+	const SC4CellRegion<int32_t>& GetRegion() const;
+	const Parameters& GetParameters() const;
+
+private:
+	std::optional<SC4CellRegion<int32_t>> region;
+	Parameters parameters;
+	size_t selectionCount;
+	uint32_t cellCount;
+};
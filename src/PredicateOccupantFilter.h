@@ -0,0 +1,179 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cISC4NetworkOccupant.h"
+#include "cISC4Occupant.h"
+#include "cRZAutoRefCount.h"
+#include "cSC4BaseOccupantFilter.h"
+#include "NetworkOccupantFilter.h"
+#include <cstdint>
+
+// Compile-time composable occupant filter predicates.
+//
+// A predicate is a type with two static members:
+//
+// IncludesType(type) returns false when no occupant of that type can be included,
+// it is used for the filter's IsOccupantTypeIncluded method.
+//
+// IncludesOccupant(pOccupant, type) makes the final decision for an occupant,
+// the occupant type is passed in so that it is only queried once per occupant.
+//
+// The predicates are combined with templates, so PredicateOccupantFilter compiles
+// the whole expression into its IsOccupantIncluded method without any nested
+// virtual calls. For example, a filter that includes rail networks and props:
+//
+// PredicateOccupantFilter<
+//     OccupantFilterPredicates::Or<
+//         OccupantFilterPredicates::NetworkTypeIs<NetworkTypeFlags::AllRailNetworks>,
+//         OccupantFilterPredicates::OccupantTypeIs<OccupantFilterPredicates::kPropOccupantType>>>
+namespace OccupantFilterPredicates
+{
+	// The type IDs that cISC4Occupant::GetType returns. The prop type covers the props
+	// of lots and the props that are placed with the prop tool, it is also the prop ID
+	// in the OccupantTypes example of the README. The network type is defined with
+	// NetworkOccupantFilter.
+	static constexpr uint32_t kBuildingOccupantType = 0x278128A0;
+	static constexpr uint32_t kFloraOccupantType = 0x74758926;
+	using ::kNetworkOccupantType;
+	static constexpr uint32_t kPropOccupantType = 0x2A499F85;
+
+	// Includes occupants whose type is one of the listed type IDs.
+	template<uint32_t... Types>
+	struct OccupantTypeIs
+	{
+		// The decision only depends on the occupant type.
+		static constexpr bool TypeOnly = true;
+
+		static constexpr bool IncludesType(uint32_t type)
+		{
+			return ((type == Types) || ...);
+		}
+
+		static bool IncludesOccupant(cISC4Occupant*, uint32_t type)
+		{
+			return IncludesType(type);
+		}
+	};
+
+	// Includes network occupants that have any of the specified network flags.
+	template<NetworkTypeFlags Flags>
+	struct NetworkTypeIs
+	{
+		static constexpr bool TypeOnly = false;
+
+		static constexpr bool IncludesType(uint32_t type)
+		{
+			return type == kNetworkOccupantType;
+		}
+
+		static bool IncludesOccupant(cISC4Occupant* pOccupant, uint32_t type)
+		{
+			bool result = false;
+
+			if (IncludesType(type))
+			{
+				cRZAutoRefCount<cISC4NetworkOccupant> networkOccupant;
+
+				if (pOccupant->QueryInterface(GZIID_cISC4NetworkOccupant, networkOccupant.AsPPVoid()))
+				{
+					result = networkOccupant->HasAnyNetworkFlag(static_cast<uint32_t>(Flags));
+				}
+			}
+
+			return result;
+		}
+	};
+
+	template<typename... Predicates>
+	struct And
+	{
+		static constexpr bool TypeOnly = (Predicates::TypeOnly && ...);
+
+		static constexpr bool IncludesType(uint32_t type)
+		{
+			return (Predicates::IncludesType(type) && ...);
+		}
+
+		static bool IncludesOccupant(cISC4Occupant* pOccupant, uint32_t type)
+		{
+			// The type checks are evaluated first so that an occupant that is excluded by
+			// its type never reaches the more expensive per-occupant checks.
+			return IncludesType(type) && (Predicates::IncludesOccupant(pOccupant, type) && ...);
+		}
+	};
+
+	template<typename... Predicates>
+	struct Or
+	{
+		static constexpr bool TypeOnly = (Predicates::TypeOnly && ...);
+
+		static constexpr bool IncludesType(uint32_t type)
+		{
+			return (Predicates::IncludesType(type) || ...);
+		}
+
+		static bool IncludesOccupant(cISC4Occupant* pOccupant, uint32_t type)
+		{
+			return (Predicates::IncludesOccupant(pOccupant, type) || ...);
+		}
+	};
+
+	template<typename Predicate>
+	struct Not
+	{
+		static constexpr bool TypeOnly = Predicate::TypeOnly;
+
+		static constexpr bool IncludesType(uint32_t type)
+		{
+			// A type can only be excluded up front when the inner predicate's
+			// decision depends on nothing but the type.
+			if constexpr (Predicate::TypeOnly)
+			{
+				return !Predicate::IncludesType(type);
+			}
+			else
+			{
+				return true;
+			}
+		}
+
+		static bool IncludesOccupant(cISC4Occupant* pOccupant, uint32_t type)
+		{
+			return !Predicate::IncludesOccupant(pOccupant, type);
+		}
+	};
+}
+
+template<typename Predicate>
+class PredicateOccupantFilter final : public cSC4BaseOccupantFilter
+{
+public:
+	bool IsOccupantIncluded(cISC4Occupant* pOccupant) override
+	{
+		return pOccupant && Predicate::IncludesOccupant(pOccupant, static_cast<uint32_t>(pOccupant->GetType()));
+	}
+
+	bool IsOccupantTypeIncluded(uint32_t type) override
+	{
+		return Predicate::IncludesType(type);
+	}
+};
@@ -0,0 +1,308 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PreviewCostDelta.h"
+#include "SC4CellRegion.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+
+namespace
+{
+	uint64_t GetCellCount(const SC4Rect<int32_t>& rect)
+	{
+		return static_cast<uint64_t>(rect.bottomRightX - rect.topLeftX + 1)
+			* static_cast<uint64_t>(rect.bottomRightY - rect.topLeftY + 1);
+	}
+
+	bool Intersect(const SC4Rect<int32_t>& a, const SC4Rect<int32_t>& b, SC4Rect<int32_t>& intersection)
+	{
+		intersection.topLeftX = (std::max)(a.topLeftX, b.topLeftX);
+		intersection.topLeftY = (std::max)(a.topLeftY, b.topLeftY);
+		intersection.bottomRightX = (std::min)(a.bottomRightX, b.bottomRightX);
+		intersection.bottomRightY = (std::min)(a.bottomRightY, b.bottomRightY);
+
+		return intersection.topLeftX <= intersection.bottomRightX
+			&& intersection.topLeftY <= intersection.bottomRightY;
+	}
+
+	// Splits the cells of rect that are outside of the intersection into up to 4 strips
+	// that do not overlap. Returns the number of strips.
+	size_t GetStrips(const SC4Rect<int32_t>& rect, const SC4Rect<int32_t>& intersection, SC4Rect<int32_t>(&strips)[4])
+	{
+		size_t count = 0;
+
+		if (rect.topLeftX < intersection.topLeftX)
+		{
+			strips[count++] = SC4Rect<int32_t>(rect.topLeftX, rect.topLeftY, intersection.topLeftX - 1, rect.bottomRightY);
+		}
+
+		if (rect.bottomRightX > intersection.bottomRightX)
+		{
+			strips[count++] = SC4Rect<int32_t>(intersection.bottomRightX + 1, rect.topLeftY, rect.bottomRightX, rect.bottomRightY);
+		}
+
+		if (rect.topLeftY < intersection.topLeftY)
+		{
+			strips[count++] = SC4Rect<int32_t>(
+				intersection.topLeftX,
+				rect.topLeftY,
+				intersection.bottomRightX,
+				intersection.topLeftY - 1);
+		}
+
+		if (rect.bottomRightY > intersection.bottomRightY)
+		{
+			strips[count++] = SC4Rect<int32_t>(
+				intersection.topLeftX,
+				intersection.bottomRightY + 1,
+				intersection.bottomRightX,
+				rect.bottomRightY);
+		}
+
+		return count;
+	}
+
+	uint64_t GetCellCount(const SC4Rect<int32_t>(&strips)[4], size_t count)
+	{
+		uint64_t cellCount = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			cellCount += GetCellCount(strips[i]);
+		}
+
+		return cellCount;
+	}
+}
+
+PreviewCostDelta::CountingFilter::CountingFilter()
+	: mode(Mode::Add),
+	  pModeFilter(nullptr),
+	  bounds(),
+	  countedOccupants(),
+	  callOccupants()
+{
+}
+
+bool PreviewCostDelta::CountingFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
+{
+	if (callOccupants.contains(pOccupant))
+	{
+		return true;
+	}
+
+	if (mode == Mode::Remove)
+	{
+		// The counted occupants were included by the mode filter when they were added.
+		if (!countedOccupants.contains(pOccupant) || TouchesBounds(pOccupant))
+		{
+			return false;
+		}
+	}
+	else if (countedOccupants.contains(pOccupant)
+		|| (pModeFilter && !pModeFilter->IsOccupantIncluded(pOccupant)))
+	{
+		return false;
+	}
+
+	callOccupants.insert(pOccupant);
+	return true;
+}
+
+bool PreviewCostDelta::CountingFilter::IsOccupantTypeIncluded(uint32_t type)
+{
+	return pModeFilter ? pModeFilter->IsOccupantTypeIncluded(type) : true;
+}
+
+bool PreviewCostDelta::CountingFilter::IsPropertyHolderIncluded(cISCPropertyHolder* pProperties)
+{
+	return pModeFilter ? pModeFilter->IsPropertyHolderIncluded(pProperties) : true;
+}
+
+void PreviewCostDelta::CountingFilter::Begin(Mode mode, cISC4OccupantFilter* pModeFilter, const SC4Rect<int32_t>& bounds)
+{
+	this->mode = mode;
+	this->pModeFilter = pModeFilter;
+	this->bounds = bounds;
+	callOccupants.clear();
+}
+
+void PreviewCostDelta::CountingFilter::End()
+{
+	if (mode == Mode::Remove)
+	{
+		for (cISC4Occupant* pOccupant : callOccupants)
+		{
+			countedOccupants.erase(pOccupant);
+		}
+	}
+	else
+	{
+		countedOccupants.insert(callOccupants.begin(), callOccupants.end());
+	}
+
+	callOccupants.clear();
+	pModeFilter = nullptr;
+}
+
+void PreviewCostDelta::CountingFilter::Clear()
+{
+	countedOccupants.clear();
+	callOccupants.clear();
+}
+
+bool PreviewCostDelta::CountingFilter::IsEmpty() const
+{
+	return countedOccupants.empty();
+}
+
+bool PreviewCostDelta::CountingFilter::TouchesBounds(cISC4Occupant* pOccupant) const
+{
+	SC4Rect<long> cells;
+
+	if (!pOccupant->GetBoundingCityCells(cells))
+	{
+		// Keep the occupant when its cells are not known.
+		return true;
+	}
+
+	return cells.topLeftX <= bounds.bottomRightX
+		&& cells.bottomRightX >= bounds.topLeftX
+		&& cells.topLeftY <= bounds.bottomRightY
+		&& cells.bottomRightY >= bounds.topLeftY;
+}
+
+PreviewCostDelta::PreviewCostDelta()
+	: filter(new CountingFilter(), cRZAutoRefCount<CountingFilter>::kAddRef),
+	  hasPrevious(false),
+	  previousKey(),
+	  previousBounds(),
+	  cost(0),
+	  lastScannedCellCount(0)
+{
+}
+
+bool PreviewCostDelta::Update(
+	cISC4Demolition* pDemolition,
+	const Key& key,
+	const SC4Rect<int32_t>& bounds,
+	cISC4OccupantFilter* pModeFilter,
+	int64_t* totalCost,
+	intptr_t demolishedOccupantSet)
+{
+	lastScannedCellCount = 0;
+
+	SC4Rect<int32_t> intersection;
+	SC4Rect<int32_t> removedStrips[4];
+	SC4Rect<int32_t> addedStrips[4];
+	size_t removedStripCount = 0;
+	size_t addedStripCount = 0;
+	bool useDelta = false;
+
+	if (hasPrevious && previousKey == key && Intersect(previousBounds, bounds, intersection))
+	{
+		removedStripCount = GetStrips(previousBounds, intersection, removedStrips);
+		addedStripCount = GetStrips(bounds, intersection, addedStrips);
+
+		useDelta = GetCellCount(removedStrips, removedStripCount) + GetCellCount(addedStrips, addedStripCount)
+			< GetCellCount(bounds);
+	}
+
+	if (useDelta)
+	{
+		for (size_t i = 0; i < removedStripCount; i++)
+		{
+			cost -= Preview(pDemolition, key, bounds, CountingFilter::Mode::Remove, removedStrips[i], pModeFilter, 0);
+		}
+
+		for (size_t i = 0; i < addedStripCount; i++)
+		{
+			cost += Preview(pDemolition, key, bounds, CountingFilter::Mode::Add, addedStrips[i], pModeFilter, demolishedOccupantSet);
+		}
+	}
+	else
+	{
+		filter->Clear();
+		cost = Preview(pDemolition, key, bounds, CountingFilter::Mode::Add, bounds, pModeFilter, demolishedOccupantSet);
+	}
+
+	hasPrevious = true;
+	previousKey = key;
+	previousBounds = bounds;
+
+	if (totalCost)
+	{
+		*totalCost += cost;
+	}
+
+	return !filter->IsEmpty();
+}
+
+void PreviewCostDelta::Reset()
+{
+	hasPrevious = false;
+	cost = 0;
+	filter->Clear();
+}
+
+uint64_t PreviewCostDelta::GetLastScannedCellCount() const
+{
+	return lastScannedCellCount;
+}
+
+int64_t PreviewCostDelta::Preview(
+	cISC4Demolition* pDemolition,
+	const Key& key,
+	const SC4Rect<int32_t>& bounds,
+	CountingFilter::Mode mode,
+	const SC4Rect<int32_t>& rect,
+	cISC4OccupantFilter* pModeFilter,
+	intptr_t demolishedOccupantSet)
+{
+	const SC4CellRegion<int32_t> region(rect.topLeftX, rect.topLeftY, rect.bottomRightX, rect.bottomRightY, true);
+	const uint64_t cellCount = GetCellCount(rect);
+	int64_t regionCost = 0;
+
+	lastScannedCellCount += cellCount;
+
+	TraceRecorder::ScopedEvent traceEvent(
+		"cISC4Demolition::DemolishRegion",
+		static_cast<int32_t>(cellCount),
+		static_cast<int32_t>(key.mode));
+
+	filter->Begin(mode, pModeFilter, bounds);
+	pDemolition->DemolishRegion(
+		false, // demolish
+		region,
+		1, // privilegeType
+		key.flags,
+		key.clearZonedArea,
+		filter,
+		&regionCost,
+		demolishedOccupantSet,
+		nullptr,
+		0,
+		0);
+	filter->End();
+
+	return regionCost;
+}
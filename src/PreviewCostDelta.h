@@ -0,0 +1,132 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cISC4Demolition.h"
+#include "cISC4Occupant.h"
+#include "cISC4OccupantFilter.h"
+#include "cRZAutoRefCount.h"
+#include "cSC4BaseOccupantFilter.h"
+#include "SC4Rect.h"
+#include <cstdint>
+#include <unordered_set>
+
+// Updates the cost of a rectangular preview from the strips that were added to or
+// removed from the previous rectangle, instead of previewing the whole rectangle.
+//
+// Each mouse move of a drag changes the rectangle by a few rows or columns, but the
+// game scans every cell of a region that is passed to cISC4Demolition::DemolishRegion.
+// The delta only passes the changed strips to the game. The game's demolished occupant
+// set is rebuilt for every preview and its layout is not known, so the occupants that
+// the preview counts are recorded by a filter that wraps the mode's filter: an added
+// strip only includes the occupants that are not counted yet, and a removed strip only
+// includes the counted occupants that no longer touch the new rectangle.
+class PreviewCostDelta
+{
+public:
+	// The options of a preview, a delta is only used between previews with the same key.
+	struct Key
+	{
+		uint32_t mode;
+		uint32_t flags;
+		bool clearZonedArea;
+		int32_t clickX;
+		int32_t clickZ;
+
+		bool operator==(const Key& other) const = default;
+	};
+
+	PreviewCostDelta();
+
+	// Previews the rectangle and adds its cost to totalCost.
+	// The whole rectangle is previewed when there is no previous rectangle with the
+	// same key, or when the changed strips are not smaller than the rectangle.
+	// The demolished occupant set is only passed to the calls for added cells.
+	// Returns true if the rectangle includes an occupant.
+	bool Update(
+		cISC4Demolition* pDemolition,
+		const Key& key,
+		const SC4Rect<int32_t>& bounds,
+		cISC4OccupantFilter* pModeFilter,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet);
+
+	// Forgets the previous rectangle, the occupants it counted may have changed.
+	void Reset();
+
+	// The number of cells in the regions that the last update passed to the game.
+	uint64_t GetLastScannedCellCount() const;
+
+private:
+	class CountingFilter : public cSC4BaseOccupantFilter
+	{
+	public:
+		enum class Mode
+		{
+			Add,
+			Remove
+		};
+
+		CountingFilter();
+
+		bool IsOccupantIncluded(cISC4Occupant* pOccupant) override;
+		bool IsOccupantTypeIncluded(uint32_t type) override;
+		bool IsPropertyHolderIncluded(cISCPropertyHolder* pProperties) override;
+
+		// Prepares the filter for a DemolishRegion call, bounds is the new preview rectangle.
+		void Begin(Mode mode, cISC4OccupantFilter* pModeFilter, const SC4Rect<int32_t>& bounds);
+		// Moves the occupants that the call included into or out of the counted set.
+		void End();
+
+		void Clear();
+		bool IsEmpty() const;
+
+	private:
+		bool TouchesBounds(cISC4Occupant* pOccupant) const;
+
+		Mode mode;
+		cISC4OccupantFilter* pModeFilter;
+		SC4Rect<int32_t> bounds;
+		// The occupants that the current preview counts.
+		std::unordered_set<cISC4Occupant*> countedOccupants;
+		// The occupants that the current call included, the game visits an occupant
+		// once for each selected cell that it covers.
+		std::unordered_set<cISC4Occupant*> callOccupants;
+	};
+
+	// Previews a rectangle of the new preview and returns the cost that the game reports.
+	int64_t Preview(
+		cISC4Demolition* pDemolition,
+		const Key& key,
+		const SC4Rect<int32_t>& bounds,
+		CountingFilter::Mode mode,
+		const SC4Rect<int32_t>& rect,
+		cISC4OccupantFilter* pModeFilter,
+		intptr_t demolishedOccupantSet);
+
+	cRZAutoRefCount<CountingFilter> filter;
+	bool hasPrevious;
+	Key previousKey;
+	SC4Rect<int32_t> previousBounds;
+	int64_t cost;
+	uint64_t lastScannedCellCount;
+};
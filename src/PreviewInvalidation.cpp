@@ -0,0 +1,94 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreviewInvalidation.h"
+
+namespace
+{
+	constexpr uint64_t FnvOffsetBasis = 0xcbf29ce484222325ULL;
+	constexpr uint64_t FnvPrime = 0x100000001b3ULL;
+
+	uint64_t HashValue(uint64_t hash, uint32_t value)
+	{
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			hash ^= (value >> (i * 8)) & 0xff;
+			hash *= FnvPrime;
+		}
+
+		return hash;
+	}
+}
+
+PreviewInvalidation::PreviewInvalidation()
+	: changes(ChangeNone),
+	  previewHash(0),
+	  previewValid(false)
+{
+}
+
+void PreviewInvalidation::Invalidate(uint32_t newChanges)
+{
+	changes |= newChanges;
+}
+
+bool PreviewInvalidation::IsDirty() const
+{
+	return changes != ChangeNone;
+}
+
+bool PreviewInvalidation::BeginFlush(uint64_t stateHash)
+{
+	changes = ChangeNone;
+
+	return !previewValid || stateHash != previewHash;
+}
+
+void PreviewInvalidation::RecordPreview(uint64_t stateHash)
+{
+	previewHash = stateHash;
+	previewValid = true;
+}
+
+void PreviewInvalidation::Reset()
+{
+	changes = ChangeNone;
+	previewHash = 0;
+	previewValid = false;
+}
+
+uint64_t PreviewInvalidation::HashState(
+	uint32_t mode,
+	const SC4Rect<int32_t>& bounds,
+	uint64_t regionHash)
+{
+	uint64_t hash = FnvOffsetBasis;
+
+	hash = HashValue(hash, mode);
+	hash = HashValue(hash, static_cast<uint32_t>(bounds.topLeftX));
+	hash = HashValue(hash, static_cast<uint32_t>(bounds.topLeftY));
+	hash = HashValue(hash, static_cast<uint32_t>(bounds.bottomRightX));
+	hash = HashValue(hash, static_cast<uint32_t>(bounds.bottomRightY));
+	hash = HashValue(hash, static_cast<uint32_t>(regionHash));
+	hash = HashValue(hash, static_cast<uint32_t>(regionHash >> 32));
+
+	return hash;
+}
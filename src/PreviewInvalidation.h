@@ -0,0 +1,70 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4Rect.h"
+#include <cstdint>
+
+// Tracks the state that the bulldoze preview depends on, so that the preview
+// is recomputed at most once per input event.
+//
+// Input handlers mark the parts of the state that they changed, and the preview
+// is flushed once after the event has been handled. Selection bounds and click
+// point changes come from the game's own preview pass, which records its state.
+// The flush is skipped when the effective preview state matches the state of the
+// last preview that was computed, e.g. when a thickness change does not alter the
+// diagonal cells.
+class PreviewInvalidation
+{
+public:
+	enum Change : uint32_t
+	{
+		ChangeNone = 0,
+		ChangeMode = 0x1,
+		ChangeThickness = 0x2,
+	};
+
+	PreviewInvalidation();
+
+	void Invalidate(uint32_t changes);
+
+	bool IsDirty() const;
+
+	// Clears the pending changes and returns true if the specified state
+	// differs from the state of the last computed preview.
+	bool BeginFlush(uint64_t stateHash);
+
+	// Records the state of a preview that was computed by the game.
+	void RecordPreview(uint64_t stateHash);
+
+	// Forgets the last computed preview, the next flush always recomputes it.
+	void Reset();
+
+	static uint64_t HashState(
+		uint32_t mode,
+		const SC4Rect<int32_t>& bounds,
+		uint64_t regionHash);
+
+private:
+	uint32_t changes;
+	uint64_t previewHash;
+	bool previewValid;
+};
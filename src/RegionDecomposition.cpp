@@ -0,0 +1,198 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RegionDecomposition.h"
+#include "CellRegionAlgebra.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace
+{
+	// The inclusive range of set columns in a row, the range is empty when first > last.
+	struct RowExtent
+	{
+		int32_t first;
+		int32_t last;
+	};
+
+	void GetRowExtents(const cRZCellMap& cellMap, std::vector<RowExtent>& extents)
+	{
+		const uint32_t rowCount = cellMap.GetRowCount();
+		const uint32_t wordCount = cellMap.GetRowWordCount();
+		const uint32_t columnCount = cellMap.GetColumnCount();
+		const uint32_t lastWordMask = (columnCount & 31) != 0 ? (1U << (columnCount & 31)) - 1 : 0xffffffffU;
+
+		extents.resize(rowCount);
+
+		for (uint32_t row = 0; row < rowCount; row++)
+		{
+			const uint32_t* words = cellMap.GetRowWords(row);
+			RowExtent& extent = extents[row];
+
+			extent.first = 0;
+			extent.last = -1;
+
+			for (uint32_t i = 0; i < wordCount; i++)
+			{
+				const uint32_t word = i == wordCount - 1 ? words[i] & lastWordMask : words[i];
+
+				if (word != 0)
+				{
+					extent.first = static_cast<int32_t>((i * 32) + std::countr_zero(word));
+					break;
+				}
+			}
+
+			for (uint32_t i = wordCount; i-- > 0;)
+			{
+				const uint32_t word = i == wordCount - 1 ? words[i] & lastWordMask : words[i];
+
+				if (word != 0)
+				{
+					extent.last = static_cast<int32_t>((i * 32) + 31 - std::countl_zero(word));
+					break;
+				}
+			}
+		}
+	}
+}
+
+void RegionDecomposition::Plan(
+	const SC4CellRegion<int32_t>& region,
+	std::vector<SC4Rect<int32_t>>& pieces,
+	uint64_t pieceOverhead)
+{
+	pieces.clear();
+
+	std::vector<RowExtent> extents;
+	GetRowExtents(region.cellMap, extents);
+
+	const size_t rowCount = extents.size();
+
+	// bestCost[i] is the lowest cost that covers rows [0, i), and pieceStart[i] is the
+	// first row of the last piece in that plan, or i - 1 when row i - 1 is skipped.
+	constexpr uint64_t Unreachable = (std::numeric_limits<uint64_t>::max)();
+	std::vector<uint64_t> bestCost(rowCount + 1, Unreachable);
+	std::vector<size_t> pieceStart(rowCount + 1, 0);
+	std::vector<bool> skipped(rowCount + 1, false);
+
+	bestCost[0] = 0;
+
+	for (size_t end = 1; end <= rowCount; end++)
+	{
+		const RowExtent& lastRow = extents[end - 1];
+
+		if (lastRow.first > lastRow.last)
+		{
+			// An empty row does not need to be covered.
+			bestCost[end] = bestCost[end - 1];
+			pieceStart[end] = end - 1;
+			skipped[end] = true;
+			continue;
+		}
+
+		// Extend the piece upwards from the last row, the Z range of the piece
+		// grows monotonically as rows are added.
+		int32_t first = lastRow.first;
+		int32_t last = lastRow.last;
+
+		for (size_t start = end; start-- > 0;)
+		{
+			const RowExtent& extent = extents[start];
+
+			if (extent.first <= extent.last)
+			{
+				first = (std::min)(first, extent.first);
+				last = (std::max)(last, extent.last);
+			}
+
+			// A piece that starts on an empty row is never better than starting on the next row.
+			if (extent.first > extent.last || bestCost[start] == Unreachable)
+			{
+				continue;
+			}
+
+			const uint64_t cellCount = static_cast<uint64_t>(end - start) * static_cast<uint64_t>(last - first + 1);
+			const uint64_t cost = bestCost[start] + pieceOverhead + cellCount;
+
+			if (cost < bestCost[end])
+			{
+				bestCost[end] = cost;
+				pieceStart[end] = start;
+				skipped[end] = false;
+			}
+		}
+	}
+
+	// Walk the plan backwards to build the piece list.
+	for (size_t end = rowCount; end > 0;)
+	{
+		const size_t start = pieceStart[end];
+
+		if (!skipped[end])
+		{
+			int32_t first = (std::numeric_limits<int32_t>::max)();
+			int32_t last = (std::numeric_limits<int32_t>::min)();
+
+			for (size_t row = start; row < end; row++)
+			{
+				if (extents[row].first <= extents[row].last)
+				{
+					first = (std::min)(first, extents[row].first);
+					last = (std::max)(last, extents[row].last);
+				}
+			}
+
+			pieces.emplace_back(
+				region.bounds.topLeftX + static_cast<int32_t>(start),
+				region.bounds.topLeftY + first,
+				region.bounds.topLeftX + static_cast<int32_t>(end - 1),
+				region.bounds.topLeftY + last);
+		}
+
+		end = start;
+	}
+
+	std::reverse(pieces.begin(), pieces.end());
+}
+
+uint64_t RegionDecomposition::GetCellCount(const std::vector<SC4Rect<int32_t>>& pieces)
+{
+	uint64_t count = 0;
+
+	for (const SC4Rect<int32_t>& piece : pieces)
+	{
+		count += static_cast<uint64_t>(piece.bottomRightX - piece.topLeftX + 1)
+			* static_cast<uint64_t>(piece.bottomRightY - piece.topLeftY + 1);
+	}
+
+	return count;
+}
+
+SC4CellRegion<int32_t> RegionDecomposition::Extract(const SC4CellRegion<int32_t>& region, const SC4Rect<int32_t>& rect)
+{
+	SC4CellRegion<int32_t> piece(rect.topLeftX, rect.topLeftY, rect.bottomRightX, rect.bottomRightY, false);
+
+	CellRegionAlgebra::Apply(piece, region, CellRegionAlgebra::Operation::Union);
+
+	return piece;
+}
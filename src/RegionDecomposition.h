@@ -0,0 +1,51 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4CellRegion.h"
+#include <cstdint>
+#include <vector>
+
+// Splits a sparse region into a few tight rectangles that cover all of its set cells.
+//
+// The game scans every cell inside the bounds of a region that is passed to
+// cISC4Demolition::DemolishRegion, so a thin diagonal band in a large rectangle
+// costs as much as the whole rectangle. The planner groups consecutive rows into
+// pieces and picks the grouping with the lowest cost, where the cost of a piece
+// is the number of cells in its bounds plus a fixed per-call overhead.
+namespace RegionDecomposition
+{
+	// The cost of a DemolishRegion call, expressed as a number of scanned cells.
+	constexpr uint64_t DefaultPieceOverhead = 64;
+
+	// Fills pieces with rectangles that together cover every set cell of the region.
+	// The rectangles use the same coordinates as the region bounds and do not overlap.
+	void Plan(
+		const SC4CellRegion<int32_t>& region,
+		std::vector<SC4Rect<int32_t>>& pieces,
+		uint64_t pieceOverhead = DefaultPieceOverhead);
+
+	// Returns the number of cells inside the piece bounds.
+	uint64_t GetCellCount(const std::vector<SC4Rect<int32_t>>& pieces);
+
+	// Copies the region cells that fall inside the specified rectangle.
+	SC4CellRegion<int32_t> Extract(const SC4CellRegion<int32_t>& region, const SC4Rect<int32_t>& rect);
+}
@@ -0,0 +1,188 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RingLog.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+	constexpr char FileSignature[8] = { 'S', 'C', '4', 'B', 'X', 'L', 'O', 'G' };
+	constexpr uint32_t FileVersion = 1;
+
+	struct Header
+	{
+		char signature[8];
+		uint32_t version;
+		uint32_t headerSize;
+		uint64_t capacity;
+		// The total number of bytes that have been written, the ring offset of
+		// the next byte is writePosition % capacity.
+		uint64_t writePosition;
+		uint8_t reserved[32];
+	};
+
+	static_assert(sizeof(Header) == RingLog::HeaderSize);
+
+	bool IsValidHeader(const Header& header, size_t fileSize)
+	{
+		return std::memcmp(header.signature, FileSignature, sizeof(FileSignature)) == 0
+			&& header.version == FileVersion
+			&& header.headerSize == RingLog::HeaderSize
+			&& header.capacity > 0
+			&& header.capacity <= fileSize - RingLog::HeaderSize;
+	}
+}
+
+RingLog::RingLog()
+	: file(),
+	  writePosition(nullptr),
+	  ring(nullptr),
+	  capacity(0)
+{
+}
+
+bool RingLog::Open(const std::filesystem::path& path, size_t capacity)
+{
+	Close();
+
+	if (capacity == 0 || !file.Open(path, HeaderSize + capacity))
+	{
+		return false;
+	}
+
+	Header* header = reinterpret_cast<Header*>(file.GetData());
+
+	if (!IsValidHeader(*header, file.GetSize()) || header->capacity != capacity)
+	{
+		std::memset(file.GetData(), 0, file.GetSize());
+		std::memcpy(header->signature, FileSignature, sizeof(FileSignature));
+		header->version = FileVersion;
+		header->headerSize = HeaderSize;
+		header->capacity = capacity;
+		header->writePosition = 0;
+	}
+
+	writePosition = &header->writePosition;
+	ring = file.GetData() + HeaderSize;
+	this->capacity = capacity;
+
+	return true;
+}
+
+void RingLog::Close()
+{
+	file.Close();
+	writePosition = nullptr;
+	ring = nullptr;
+	capacity = 0;
+}
+
+bool RingLog::IsOpen() const
+{
+	return file.IsOpen();
+}
+
+void RingLog::Write(const char* text, size_t length)
+{
+	if (!ring || length == 0)
+	{
+		return;
+	}
+
+	std::atomic_ref<uint64_t> position(*writePosition);
+
+	uint64_t start = position.load(std::memory_order_relaxed);
+
+	// Only the end of text that is longer than the ring is kept. The position still
+	// advances past the skipped text, so the reader knows that the oldest line was cut.
+	if (length > capacity)
+	{
+		const size_t skipped = length - capacity;
+
+		text += skipped;
+		length = capacity;
+		start += skipped;
+	}
+
+	const size_t offset = static_cast<size_t>(start % capacity);
+	const size_t firstPart = (std::min)(length, capacity - offset);
+
+	std::memcpy(ring + offset, text, firstPart);
+
+	if (firstPart < length)
+	{
+		std::memcpy(ring, text + firstPart, length - firstPart);
+	}
+
+	// The position is advanced after the text is in place, so a crash during the
+	// copy leaves the previous position pointing at complete text.
+	position.store(start + length, std::memory_order_release);
+}
+
+void RingLog::Flush()
+{
+	file.Flush();
+}
+
+bool RingLog::Decode(const uint8_t* fileData, size_t fileSize, std::string& output)
+{
+	if (fileSize < HeaderSize)
+	{
+		return false;
+	}
+
+	Header header{};
+	std::memcpy(&header, fileData, sizeof(header));
+
+	if (!IsValidHeader(header, fileSize))
+	{
+		return false;
+	}
+
+	const uint8_t* ringData = fileData + HeaderSize;
+	const size_t ringCapacity = static_cast<size_t>(header.capacity);
+
+	if (header.writePosition <= header.capacity)
+	{
+		output.append(reinterpret_cast<const char*>(ringData), static_cast<size_t>(header.writePosition));
+	}
+	else
+	{
+		const size_t offset = static_cast<size_t>(header.writePosition % header.capacity);
+
+		std::string text;
+		text.reserve(ringCapacity);
+		text.append(reinterpret_cast<const char*>(ringData + offset), ringCapacity - offset);
+		text.append(reinterpret_cast<const char*>(ringData), offset);
+
+		// The oldest line was partly overwritten.
+		const size_t firstLineEnd = text.find('\n');
+
+		if (firstLineEnd != std::string::npos)
+		{
+			output.append(text, firstLineEnd + 1, std::string::npos);
+		}
+	}
+
+	return true;
+}
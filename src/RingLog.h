@@ -0,0 +1,67 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "MemoryMappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// A fixed size log file that is written through a memory mapping.
+//
+// The file starts with a 64 byte header followed by the text ring. Writing a line
+// only copies it into the ring and then advances the write position in the header,
+// so the lines that were completed before a crash are in the file without flushing
+// after every line. When the ring is full the oldest text is overwritten.
+//
+// The file is reused across sessions, so the log of a session that crashed is kept
+// until it is overwritten by newer text.
+class RingLog
+{
+public:
+	static constexpr size_t HeaderSize = 64;
+
+	RingLog();
+
+	RingLog(const RingLog&) = delete;
+	RingLog& operator=(const RingLog&) = delete;
+
+	// Opens the log with room for capacity bytes of text, an existing log with a
+	// different capacity is cleared.
+	bool Open(const std::filesystem::path& path, size_t capacity);
+	void Close();
+
+	bool IsOpen() const;
+
+	void Write(const char* text, size_t length);
+	void Flush();
+
+	// Appends the complete lines of a ring log file to the output, oldest first.
+	// Returns false if the data is not a ring log.
+	static bool Decode(const uint8_t* fileData, size_t fileSize, std::string& output);
+
+private:
+	MemoryMappedFile file;
+	uint64_t* writePosition;
+	uint8_t* ring;
+	size_t capacity;
+};
@@ -0,0 +1,146 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SelectionWorker.h"
+#include "DiagonalRegionBuilder.h"
+#include "TraceRecorder.h"
+
+SelectionWorker::SelectionWorker()
+	: pendingRequest(nullptr),
+	  completedResult(nullptr),
+	  latestRequestId(0),
+	  wakeCount(0),
+	  stopRequested(false),
+	  thread()
+{
+}
+
+SelectionWorker::~SelectionWorker()
+{
+	Stop();
+}
+
+void SelectionWorker::Start()
+{
+	if (!thread.joinable())
+	{
+		stopRequested.store(false, std::memory_order_relaxed);
+		thread = std::thread(&SelectionWorker::Run, this);
+	}
+}
+
+void SelectionWorker::Stop()
+{
+	if (thread.joinable())
+	{
+		stopRequested.store(true, std::memory_order_release);
+		wakeCount.fetch_add(1, std::memory_order_release);
+		wakeCount.notify_one();
+
+		thread.join();
+	}
+
+	delete pendingRequest.exchange(nullptr, std::memory_order_acq_rel);
+	delete completedResult.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+bool SelectionWorker::IsRunning() const
+{
+	return thread.joinable();
+}
+
+uint64_t SelectionWorker::Post(const SC4Rect<int32_t>& bounds, int32_t startX, int32_t startZ, int32_t thickness)
+{
+	const uint64_t id = latestRequestId.load(std::memory_order_relaxed) + 1;
+
+	// The id is published first, so the worker can drop the older request
+	// even if it has already taken it from the mailbox.
+	latestRequestId.store(id, std::memory_order_release);
+
+	Request* previous = pendingRequest.exchange(
+		new Request{ id, bounds, startX, startZ, thickness },
+		std::memory_order_acq_rel);
+
+	// The worker had not started the previous request.
+	delete previous;
+
+	wakeCount.fetch_add(1, std::memory_order_release);
+	wakeCount.notify_one();
+
+	return id;
+}
+
+std::unique_ptr<SelectionWorker::Result> SelectionWorker::TakeResult()
+{
+	std::unique_ptr<Result> result(completedResult.exchange(nullptr, std::memory_order_acq_rel));
+
+	if (result && !IsLatest(result->request.id))
+	{
+		result.reset();
+	}
+
+	return result;
+}
+
+void SelectionWorker::Run()
+{
+	// The builder is only used by the worker thread.
+	DiagonalRegionBuilder builder;
+	uint32_t observedWakeCount = wakeCount.load(std::memory_order_acquire);
+
+	while (!stopRequested.load(std::memory_order_acquire))
+	{
+		std::unique_ptr<Request> request(pendingRequest.exchange(nullptr, std::memory_order_acq_rel));
+
+		if (request && IsLatest(request->id))
+		{
+			// The worker only builds diagonal selections, so the mode only has the diagonal flag set.
+			TraceRecorder::ScopedEvent traceEvent(
+				"SelectionWorker::BuildRegion",
+				(request->bounds.bottomRightX - request->bounds.topLeftX + 1) * (request->bounds.bottomRightY - request->bounds.topLeftY + 1),
+				0x100,
+				request->thickness);
+
+			builder.Update(request->bounds, request->startX, request->startZ, request->thickness);
+
+			const uint64_t spanHash = builder.GetSpanHash();
+			const SC4CellRegion<int32_t>& region = builder.GetRegion();
+
+			// A newer request may have arrived while the region was being built.
+			if (IsLatest(request->id))
+			{
+				delete completedResult.exchange(
+					new Result{ *request, spanHash, region },
+					std::memory_order_acq_rel);
+			}
+		}
+		else
+		{
+			wakeCount.wait(observedWakeCount, std::memory_order_acquire);
+			observedWakeCount = wakeCount.load(std::memory_order_acquire);
+		}
+	}
+}
+
+bool SelectionWorker::IsLatest(uint64_t id) const
+{
+	return id == latestRequestId.load(std::memory_order_acquire);
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4CellRegion.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Computes diagonal selection regions on a background thread.
+//
+// The UI thread posts a request and later takes the newest completed result.
+// Requests and results are passed through single slot mailboxes, a request that
+// the worker has not started is replaced by a newer one, and a result that is
+// older than the newest request is dropped. The worker only uses the geometry
+// code, all game calls stay on the thread that owns the worker.
+class SelectionWorker
+{
+public:
+	struct Request
+	{
+		uint64_t id;
+		SC4Rect<int32_t> bounds;
+		int32_t startX;
+		int32_t startZ;
+		int32_t thickness;
+	};
+
+	struct Result
+	{
+		Request request;
+		uint64_t spanHash;
+		SC4CellRegion<int32_t> region;
+	};
+
+	SelectionWorker();
+	~SelectionWorker();
+
+	SelectionWorker(const SelectionWorker&) = delete;
+	SelectionWorker& operator=(const SelectionWorker&) = delete;
+
+	void Start();
+	void Stop();
+
+	bool IsRunning() const;
+
+	// Posts a new request and returns its id.
+	uint64_t Post(const SC4Rect<int32_t>& bounds, int32_t startX, int32_t startZ, int32_t thickness);
+
+	// Returns the result of the newest request if it has been completed, or nullptr.
+	std::unique_ptr<Result> TakeResult();
+
+private:
+	void Run();
+	bool IsLatest(uint64_t id) const;
+
+	std::atomic<Request*> pendingRequest;
+	std::atomic<Result*> completedResult;
+	std::atomic<uint64_t> latestRequestId;
+	std::atomic<uint32_t> wakeCount;
+	std::atomic<bool> stopRequested;
+	std::thread thread;
+};
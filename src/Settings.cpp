@@ -0,0 +1,236 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Settings.h"
+#include "Logger.h"
+#include <Windows.h>
+#include <algorithm>
+#include <cwchar>
+
+namespace
+{
+	constexpr const wchar_t* SectionName = L"BulldozeExtensions";
+
+	bool ReadBool(const std::filesystem::path& path, const wchar_t* key, bool defaultValue)
+	{
+		wchar_t buffer[16]{};
+
+		GetPrivateProfileStringW(SectionName, key, L"", buffer, static_cast<DWORD>(std::size(buffer)), path.c_str());
+
+		if (_wcsicmp(buffer, L"true") == 0 || _wcsicmp(buffer, L"1") == 0)
+		{
+			return true;
+		}
+		else if (_wcsicmp(buffer, L"false") == 0 || _wcsicmp(buffer, L"0") == 0)
+		{
+			return false;
+		}
+
+		return defaultValue;
+	}
+
+	uint32_t ReadUInt32(const std::filesystem::path& path, const wchar_t* key, uint32_t defaultValue)
+	{
+		return GetPrivateProfileIntW(SectionName, key, static_cast<int>(defaultValue), path.c_str());
+	}
+
+	// Reads a list of numbers that are separated by commas, hexadecimal numbers use a 0x prefix.
+	std::vector<uint32_t> ReadUInt32List(const std::filesystem::path& path, const wchar_t* key)
+	{
+		wchar_t buffer[1024]{};
+
+		GetPrivateProfileStringW(SectionName, key, L"", buffer, static_cast<DWORD>(std::size(buffer)), path.c_str());
+
+		std::vector<uint32_t> values;
+		const wchar_t* position = buffer;
+
+		while (*position != L'\0')
+		{
+			wchar_t* end = nullptr;
+			const unsigned long value = wcstoul(position, &end, 0);
+
+			if (end == position)
+			{
+				// Skip the separators and any text that is not a number.
+				position++;
+			}
+			else
+			{
+				values.push_back(static_cast<uint32_t>(value));
+				position = end;
+			}
+		}
+
+		return values;
+	}
+
+	LogOverflowPolicy ReadLogOverflowPolicy(
+		const std::filesystem::path& path,
+		const wchar_t* key,
+		LogOverflowPolicy defaultValue)
+	{
+		wchar_t buffer[16]{};
+
+		GetPrivateProfileStringW(SectionName, key, L"", buffer, static_cast<DWORD>(std::size(buffer)), path.c_str());
+
+		if (_wcsicmp(buffer, L"drop") == 0)
+		{
+			return LogOverflowPolicy::Drop;
+		}
+		else if (_wcsicmp(buffer, L"block") == 0)
+		{
+			return LogOverflowPolicy::Block;
+		}
+
+		return defaultValue;
+	}
+}
+
+Settings::Settings()
+	: timeSlicedDemolition(false),
+	  timeSliceBudgetMilliseconds(8),
+	  timeSlicedDemolitionMinimumCells(16384),
+	  backgroundSelectionGeometry(false),
+	  recordInput(false),
+	  asyncLogging(false),
+	  asyncLogOverflow(LogOverflowPolicy::Drop),
+	  mappedLog(false),
+	  mappedLogSizeKilobytes(1024),
+	  traceEvents(false),
+	  splitSparseDemolition(false),
+	  incrementalPreviewCost(false),
+	  occupantTypes()
+{
+}
+
+void Settings::Load(const std::filesystem::path& path)
+{
+	// A missing file or key leaves the default value in place.
+	timeSlicedDemolition = ReadBool(path, L"TimeSlicedDemolition", timeSlicedDemolition);
+	timeSliceBudgetMilliseconds = std::clamp(
+		ReadUInt32(path, L"TimeSliceBudgetMilliseconds", timeSliceBudgetMilliseconds),
+		1U,
+		100U);
+	timeSlicedDemolitionMinimumCells = ReadUInt32(
+		path,
+		L"TimeSlicedDemolitionMinimumCells",
+		timeSlicedDemolitionMinimumCells);
+	backgroundSelectionGeometry = ReadBool(path, L"BackgroundSelectionGeometry", backgroundSelectionGeometry);
+	recordInput = ReadBool(path, L"RecordInput", recordInput);
+	asyncLogging = ReadBool(path, L"AsyncLogging", asyncLogging);
+	asyncLogOverflow = ReadLogOverflowPolicy(path, L"AsyncLogOverflow", asyncLogOverflow);
+	mappedLog = ReadBool(path, L"MappedLog", mappedLog);
+	mappedLogSizeKilobytes = std::clamp(
+		ReadUInt32(path, L"MappedLogSizeKilobytes", mappedLogSizeKilobytes),
+		64U,
+		65536U);
+	traceEvents = ReadBool(path, L"TraceEvents", traceEvents);
+	splitSparseDemolition = ReadBool(path, L"SplitSparseDemolition", splitSparseDemolition);
+	incrementalPreviewCost = ReadBool(path, L"IncrementalPreviewCost", incrementalPreviewCost);
+	occupantTypes = ReadUInt32List(path, L"OccupantTypes");
+
+	Logger& logger = Logger::GetInstance();
+
+	if (logger.IsEnabled(LogLevel::Debug))
+	{
+		logger.WriteLineFormatted(
+			LogLevel::Debug,
+			"Time-sliced demolition: %s, budget: %u ms, minimum cells: %u, background geometry: %s, record input: %s, async logging: %s (%s), mapped log: %s (%u KiB), trace events: %s, split sparse demolition: %s, incremental preview cost: %s, occupant types: %zu",
+			timeSlicedDemolition ? "true" : "false",
+			timeSliceBudgetMilliseconds,
+			timeSlicedDemolitionMinimumCells,
+			backgroundSelectionGeometry ? "true" : "false",
+			recordInput ? "true" : "false",
+			asyncLogging ? "true" : "false",
+			asyncLogOverflow == LogOverflowPolicy::Block ? "block" : "drop",
+			mappedLog ? "true" : "false",
+			mappedLogSizeKilobytes,
+			traceEvents ? "true" : "false",
+			splitSparseDemolition ? "true" : "false",
+			incrementalPreviewCost ? "true" : "false",
+			occupantTypes.size());
+	}
+}
+
+bool Settings::TimeSlicedDemolition() const
+{
+	return timeSlicedDemolition;
+}
+
+uint32_t Settings::TimeSliceBudgetMilliseconds() const
+{
+	return timeSliceBudgetMilliseconds;
+}
+
+uint32_t Settings::TimeSlicedDemolitionMinimumCells() const
+{
+	return timeSlicedDemolitionMinimumCells;
+}
+
+bool Settings::BackgroundSelectionGeometry() const
+{
+	return backgroundSelectionGeometry;
+}
+
+bool Settings::RecordInput() const
+{
+	return recordInput;
+}
+
+bool Settings::AsyncLogging() const
+{
+	return asyncLogging;
+}
+
+LogOverflowPolicy Settings::AsyncLogOverflow() const
+{
+	return asyncLogOverflow;
+}
+
+bool Settings::MappedLog() const
+{
+	return mappedLog;
+}
+
+uint32_t Settings::MappedLogSizeKilobytes() const
+{
+	return mappedLogSizeKilobytes;
+}
+
+bool Settings::TraceEvents() const
+{
+	return traceEvents;
+}
+
+bool Settings::SplitSparseDemolition() const
+{
+	return splitSparseDemolition;
+}
+
+bool Settings::IncrementalPreviewCost() const
+{
+	return incrementalPreviewCost;
+}
+
+const std::vector<uint32_t>& Settings::OccupantTypes() const
+{
+	return occupantTypes;
+}
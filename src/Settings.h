@@ -0,0 +1,77 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Logger.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+class Settings
+{
+public:
+	Settings();
+
+	void Load(const std::filesystem::path& path);
+
+	// Large selections are demolished over several frames instead of all at once.
+	// The progress is written to the log file, it is not shown in the game.
+	bool TimeSlicedDemolition() const;
+	// The time that time-sliced demolition can use per frame.
+	uint32_t TimeSliceBudgetMilliseconds() const;
+	// The minimum number of selected cells that uses time-sliced demolition.
+	uint32_t TimeSlicedDemolitionMinimumCells() const;
+	// The diagonal selection regions are built on a background thread.
+	bool BackgroundSelectionGeometry() const;
+	// The input events that the bulldoze tool receives are recorded to a file.
+	bool RecordInput() const;
+	// The log file is written by a background thread.
+	bool AsyncLogging() const;
+	// What the background log writer does when its queue is full.
+	LogOverflowPolicy AsyncLogOverflow() const;
+	// The log is written to a memory-mapped ring log file.
+	bool MappedLog() const;
+	// The size of the mapped ring log text, in KiB.
+	uint32_t MappedLogSizeKilobytes() const;
+	// A timeline of the hook calls is recorded and written as a Chrome trace.
+	bool TraceEvents() const;
+	// A sparse selection is demolished as a few tight pieces instead of one masked region.
+	bool SplitSparseDemolition() const;
+	// A rectangular preview only passes the strips that changed since the previous preview to the game.
+	bool IncrementalPreviewCost() const;
+	// The occupant type IDs that the occupant type bulldoze mode demolishes.
+	const std::vector<uint32_t>& OccupantTypes() const;
+
+private:
+	bool timeSlicedDemolition;
+	uint32_t timeSliceBudgetMilliseconds;
+	uint32_t timeSlicedDemolitionMinimumCells;
+	bool backgroundSelectionGeometry;
+	bool recordInput;
+	bool asyncLogging;
+	LogOverflowPolicy asyncLogOverflow;
+	bool mappedLog;
+	uint32_t mappedLogSizeKilobytes;
+	bool traceEvents;
+	bool splitSparseDemolition;
+	bool incrementalPreviewCost;
+	std::vector<uint32_t> occupantTypes;
+};
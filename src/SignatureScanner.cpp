@@ -0,0 +1,204 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SignatureScanner.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SIGNATURE_SCANNER_USE_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	int HexDigitValue(char c)
+	{
+		if (c >= '0' && c <= '9')
+		{
+			return c - '0';
+		}
+		else if (c >= 'a' && c <= 'f')
+		{
+			return c - 'a' + 10;
+		}
+		else if (c >= 'A' && c <= 'F')
+		{
+			return c - 'A' + 10;
+		}
+
+		return -1;
+	}
+
+	bool MatchesAt(const uint8_t* data, const SignatureScanner::Signature& signature)
+	{
+		const size_t length = signature.bytes.size();
+
+		for (size_t i = 0; i < length; i++)
+		{
+			if ((data[i] & signature.mask[i]) != signature.bytes[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+#ifdef SIGNATURE_SCANNER_USE_SSE2
+	uint32_t CountTrailingZeros(uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanForward(&index, value);
+		return index;
+#else
+		return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+	}
+#endif // SIGNATURE_SCANNER_USE_SSE2
+}
+
+bool SignatureScanner::Parse(std::string_view pattern, Signature& signature)
+{
+	signature.bytes.clear();
+	signature.mask.clear();
+
+	bool hasFixedByte = false;
+	size_t i = 0;
+
+	while (i < pattern.size())
+	{
+		if (pattern[i] == ' ')
+		{
+			i++;
+			continue;
+		}
+
+		if (i + 1 >= pattern.size() || (i + 2 < pattern.size() && pattern[i + 2] != ' '))
+		{
+			return false;
+		}
+
+		if (pattern[i] == '?' && pattern[i + 1] == '?')
+		{
+			signature.bytes.push_back(0);
+			signature.mask.push_back(0);
+		}
+		else
+		{
+			const int high = HexDigitValue(pattern[i]);
+			const int low = HexDigitValue(pattern[i + 1]);
+
+			if (high < 0 || low < 0)
+			{
+				return false;
+			}
+
+			signature.bytes.push_back(static_cast<uint8_t>((high << 4) | low));
+			signature.mask.push_back(0xFF);
+			hasFixedByte = true;
+		}
+
+		i += 2;
+	}
+
+	return hasFixedByte;
+}
+
+bool SignatureScanner::Matches(const uint8_t* data, size_t size, const Signature& signature)
+{
+	return !signature.bytes.empty() && signature.bytes.size() <= size && MatchesAt(data, signature);
+}
+
+void SignatureScanner::FindAll(
+	const uint8_t* data,
+	size_t size,
+	const Signature& signature,
+	size_t maxMatches,
+	std::vector<size_t>& matches)
+{
+	matches.clear();
+
+	const size_t length = signature.bytes.size();
+
+	if (length == 0 || length > size || maxMatches == 0)
+	{
+		return;
+	}
+
+	// The candidates are filtered on the first fixed byte, a leading wildcard
+	// only shifts the position that is compared.
+	size_t anchor = 0;
+
+	while (signature.mask[anchor] == 0)
+	{
+		anchor++;
+	}
+
+	const uint8_t anchorByte = signature.bytes[anchor];
+	const size_t lastStart = size - length;
+	size_t start = 0;
+
+#ifdef SIGNATURE_SCANNER_USE_SSE2
+	const __m128i anchorVector = _mm_set1_epi8(static_cast<char>(anchorByte));
+
+	while (start + 16 <= lastStart + 1)
+	{
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + start + anchor));
+		uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, anchorVector)));
+
+		while (candidates != 0)
+		{
+			const size_t offset = start + CountTrailingZeros(candidates);
+
+			if (MatchesAt(data + offset, signature))
+			{
+				matches.push_back(offset);
+
+				if (matches.size() == maxMatches)
+				{
+					return;
+				}
+			}
+
+			candidates &= candidates - 1;
+		}
+
+		start += 16;
+	}
+#endif // SIGNATURE_SCANNER_USE_SSE2
+
+	for (; start <= lastStart; start++)
+	{
+		if (data[start + anchor] == anchorByte && MatchesAt(data + start, signature))
+		{
+			matches.push_back(start);
+
+			if (matches.size() == maxMatches)
+			{
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Finds byte patterns with wildcards in a block of code.
+namespace SignatureScanner
+{
+	struct Signature
+	{
+		std::vector<uint8_t> bytes;
+		// 0xFF for the bytes that must match, 0 for wildcards.
+		std::vector<uint8_t> mask;
+	};
+
+	// Parses a pattern of space separated hex bytes, ?? is a wildcard byte.
+	// For example: "6A 01 50 FF 52 ??".
+	// Returns false if the pattern is invalid or only has wildcards.
+	bool Parse(std::string_view pattern, Signature& signature);
+
+	// Returns true if the signature matches the start of the data.
+	bool Matches(const uint8_t* data, size_t size, const Signature& signature);
+
+	// Stores the offsets of up to maxMatches matches in the matches vector.
+	// Candidates are found by comparing the first fixed byte of the signature
+	// with 16 bytes of the data at a time.
+	void FindAll(
+		const uint8_t* data,
+		size_t size,
+		const Signature& signature,
+		size_t maxMatches,
+		std::vector<size_t>& matches);
+}
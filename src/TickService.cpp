@@ -0,0 +1,125 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TickService.h"
+
+TickService::TickService(uint32_t serviceID, std::function<void()> onTick)
+	: refCount(0),
+	  serviceID(serviceID),
+	  serviceRunning(false),
+	  onTick(std::move(onTick))
+{
+}
+
+bool TickService::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == kGZIID_cIGZSystemService)
+	{
+		*ppvObj = static_cast<cIGZSystemService*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	*ppvObj = nullptr;
+	return false;
+}
+
+uint32_t TickService::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t TickService::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	return refCount;
+}
+
+uint32_t TickService::GetServiceID()
+{
+	return serviceID;
+}
+
+cIGZSystemService* TickService::SetServiceID(uint32_t id)
+{
+	serviceID = id;
+	return this;
+}
+
+int32_t TickService::GetServicePriority()
+{
+	return 0;
+}
+
+bool TickService::IsServiceRunning()
+{
+	return serviceRunning;
+}
+
+cIGZSystemService* TickService::SetServiceRunning(bool running)
+{
+	serviceRunning = running;
+	return this;
+}
+
+bool TickService::Init()
+{
+	serviceRunning = true;
+	return true;
+}
+
+bool TickService::Shutdown()
+{
+	serviceRunning = false;
+	return true;
+}
+
+bool TickService::OnTick(uint32_t unknown1)
+{
+	if (serviceRunning && onTick)
+	{
+		onTick();
+	}
+
+	return true;
+}
+
+bool TickService::OnIdle(uint32_t unknown1)
+{
+	return true;
+}
+
+int32_t TickService::GetServiceTickPriority()
+{
+	return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace
+{
+	uint64_t PackState(size_t writtenCount, size_t count)
+	{
+		return (static_cast<uint64_t>(writtenCount) << 32) | static_cast<uint64_t>(count);
+	}
+
+	size_t GetWrittenCount(uint64_t state)
+	{
+		return static_cast<size_t>(state >> 32);
+	}
+
+	size_t GetCount(uint64_t state)
+	{
+		return static_cast<size_t>(state & 0xffffffffU);
+	}
+}
+
+TraceRecorder::ScopedEvent::ScopedEvent(const char* name, int32_t cellCount, int32_t mode, int32_t thickness)
+	: name(nullptr),
+	  cellCount(cellCount),
+	  mode(mode),
+	  thickness(thickness),
+	  start()
+{
+	if (TraceRecorder::GetInstance().IsRecording())
+	{
+		this->name = name;
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+TraceRecorder::ScopedEvent::~ScopedEvent()
+{
+	if (name)
+	{
+		TraceRecorder& recorder = TraceRecorder::GetInstance();
+
+		const auto end = std::chrono::steady_clock::now();
+
+		Event event{};
+		event.name = name;
+		event.startNanoseconds = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(start - recorder.startTime).count());
+		event.durationNanoseconds = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		event.cellCount = cellCount;
+		event.mode = mode;
+		event.thickness = thickness;
+
+		recorder.Record(event);
+	}
+}
+
+TraceRecorder& TraceRecorder::GetInstance()
+{
+	static TraceRecorder instance;
+
+	return instance;
+}
+
+TraceRecorder::TraceRecorder()
+	: recording(false),
+	  eventsPerThread(0),
+	  startTime(),
+	  threadBuffersMutex(),
+	  threadBuffers(),
+	  nextThreadId(1)
+{
+}
+
+TraceRecorder::ThreadBufferOwner::ThreadBufferOwner()
+	: pBuffer(nullptr)
+{
+}
+
+TraceRecorder::ThreadBufferOwner::~ThreadBufferOwner()
+{
+	if (pBuffer)
+	{
+		pBuffer->threadExited.store(true, std::memory_order_release);
+	}
+}
+
+void TraceRecorder::Start(size_t eventsPerThread)
+{
+	if (!recording.load(std::memory_order_relaxed) && eventsPerThread > 0)
+	{
+		// The event counts are packed into 32 bits.
+		this->eventsPerThread = (std::min)(eventsPerThread, static_cast<size_t>((std::numeric_limits<uint32_t>::max)()));
+		startTime = std::chrono::steady_clock::now();
+		recording.store(true, std::memory_order_release);
+	}
+}
+
+bool TraceRecorder::IsRecording() const
+{
+	return recording.load(std::memory_order_acquire);
+}
+
+bool TraceRecorder::Write(const std::filesystem::path& path)
+{
+	if (!IsRecording())
+	{
+		return false;
+	}
+
+	std::ofstream file(path, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	// The state and dropped count of each buffer when its events were written.
+	struct WrittenBuffer
+	{
+		ThreadBuffer* pBuffer;
+		uint64_t state;
+		uint64_t droppedCount;
+	};
+
+	char line[256]{};
+	bool first = true;
+	uint64_t droppedCount = 0;
+
+	std::scoped_lock lock(threadBuffersMutex);
+
+	std::vector<WrittenBuffer> writtenBuffers;
+	writtenBuffers.reserve(threadBuffers.size());
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : threadBuffers)
+	{
+		// The events below the published count are no longer written by their thread.
+		const uint64_t state = buffer->state.load(std::memory_order_acquire);
+		const size_t count = GetCount(state);
+
+		for (size_t i = GetWrittenCount(state); i < count; i++)
+		{
+			const Event& event = buffer->events[i];
+
+			// Chrome trace timestamps and durations are in microseconds.
+			const int length = std::snprintf(
+				line,
+				sizeof(line),
+				"%s{\"name\":\"%s\",\"cat\":\"bulldoze\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32
+				",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"cells\":%" PRId32 ",\"mode\":%" PRId32 ",\"thickness\":%" PRId32 "}}",
+				first ? "" : ",\n",
+				event.name,
+				buffer->threadId,
+				static_cast<double>(event.startNanoseconds) / 1000.0,
+				static_cast<double>(event.durationNanoseconds) / 1000.0,
+				event.cellCount,
+				event.mode,
+				event.thickness);
+
+			if (length > 0)
+			{
+				file.write(line, (std::min)(static_cast<size_t>(length), sizeof(line) - 1));
+				first = false;
+			}
+		}
+
+		const uint64_t bufferDroppedCount = buffer->droppedCount.load(std::memory_order_relaxed);
+
+		droppedCount += bufferDroppedCount;
+		writtenBuffers.push_back(WrittenBuffer{ buffer.get(), state, bufferDroppedCount });
+	}
+
+	file << "\n],\"otherData\":{\"droppedEvents\":" << droppedCount << "}}\n";
+	file.flush();
+
+	if (!file)
+	{
+		// The events are kept for the next write.
+		return false;
+	}
+
+	for (const WrittenBuffer& written : writtenBuffers)
+	{
+		ThreadBuffer* pBuffer = written.pBuffer;
+		const size_t writtenCount = GetCount(written.state);
+		uint64_t expected = written.state;
+
+		// The buffer is emptied if its thread has not recorded any events since it was read,
+		// otherwise the written events are skipped by the next write.
+		while (!pBuffer->state.compare_exchange_weak(
+			expected,
+			GetCount(expected) == writtenCount ? 0 : PackState(writtenCount, GetCount(expected)),
+			std::memory_order_acq_rel,
+			std::memory_order_relaxed))
+		{
+		}
+
+		pBuffer->droppedCount.fetch_sub(written.droppedCount, std::memory_order_relaxed);
+	}
+
+	return true;
+}
+
+size_t TraceRecorder::GetThreadBufferCount()
+{
+	std::scoped_lock lock(threadBuffersMutex);
+
+	return threadBuffers.size();
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::GetThreadBuffer()
+{
+	thread_local ThreadBufferOwner owner;
+
+	if (!owner.pBuffer)
+	{
+		std::scoped_lock lock(threadBuffersMutex);
+
+		// The buffer of an exited thread is reused once all of its events have been written.
+		for (const std::unique_ptr<ThreadBuffer>& buffer : threadBuffers)
+		{
+			if (buffer->threadExited.load(std::memory_order_acquire)
+				&& buffer->state.load(std::memory_order_acquire) == 0)
+			{
+				owner.pBuffer = buffer.get();
+				break;
+			}
+		}
+
+		if (!owner.pBuffer)
+		{
+			std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+			buffer->events = std::make_unique<Event[]>(eventsPerThread);
+			buffer->state.store(0, std::memory_order_relaxed);
+			buffer->droppedCount.store(0, std::memory_order_relaxed);
+
+			owner.pBuffer = buffer.get();
+			threadBuffers.push_back(std::move(buffer));
+		}
+
+		owner.pBuffer->threadId = nextThreadId++;
+		owner.pBuffer->threadExited.store(false, std::memory_order_relaxed);
+	}
+
+	return owner.pBuffer;
+}
+
+void TraceRecorder::Record(const Event& event)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	uint64_t state = buffer->state.load(std::memory_order_acquire);
+
+	for (;;)
+	{
+		const size_t count = GetCount(state);
+
+		if (count >= eventsPerThread)
+		{
+			buffer->droppedCount.fetch_add(1, std::memory_order_relaxed);
+			break;
+		}
+
+		// Write only reads the events below the published count, so this slot is free.
+		buffer->events[count] = event;
+
+		// Write changes the state after it has read the events. The slot is stored again
+		// if that happens, at the start of the buffer when Write emptied it.
+		if (buffer->state.compare_exchange_weak(
+			state,
+			PackState(GetWrittenCount(state), count + 1),
+			std::memory_order_release,
+			std::memory_order_acquire))
+		{
+			break;
+		}
+	}
+}
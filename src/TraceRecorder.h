@@ -0,0 +1,119 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Records a timeline of the hook calls and the game calls that they make, and
+// writes it in the Chrome trace event JSON format that chrome://tracing and the
+// Perfetto UI can open.
+//
+// Each thread records into its own preallocated buffer, so recording an event
+// does not lock or allocate. The events that do not fit in a full buffer are
+// counted and discarded. A write empties the buffers, and the buffer of a thread
+// that has exited is reused by the next thread once its events are written.
+class TraceRecorder
+{
+public:
+	// Records the time that a scope takes as a single complete event.
+	// The name must be a string literal.
+	class ScopedEvent
+	{
+	public:
+		ScopedEvent(const char* name, int32_t cellCount = 0, int32_t mode = 0, int32_t thickness = 0);
+		~ScopedEvent();
+
+		ScopedEvent(const ScopedEvent&) = delete;
+		ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+	private:
+		const char* name;
+		int32_t cellCount;
+		int32_t mode;
+		int32_t thickness;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	static TraceRecorder& GetInstance();
+
+	// Allocates the buffers on first use of each thread and enables recording.
+	void Start(size_t eventsPerThread);
+
+	bool IsRecording() const;
+
+	// Writes the events that have been recorded since the previous write, recording
+	// continues afterwards.
+	bool Write(const std::filesystem::path& path);
+
+	// Returns the number of thread buffers, including the ones that are waiting to be reused.
+	size_t GetThreadBufferCount();
+
+private:
+	struct Event
+	{
+		const char* name;
+		uint64_t startNanoseconds;
+		uint64_t durationNanoseconds;
+		int32_t cellCount;
+		int32_t mode;
+		int32_t thickness;
+	};
+
+	// The state packs the number of events that have been written to a file in the high
+	// 32 bits and the number of recorded events in the low 32 bits, so the recording
+	// thread and Write can update them together without a lock.
+	struct ThreadBuffer
+	{
+		uint32_t threadId;
+		std::unique_ptr<Event[]> events;
+		std::atomic<uint64_t> state;
+		std::atomic<uint64_t> droppedCount;
+		std::atomic<bool> threadExited;
+	};
+
+	// Marks the buffer of the current thread as unused when the thread exits.
+	class ThreadBufferOwner
+	{
+	public:
+		ThreadBufferOwner();
+		~ThreadBufferOwner();
+
+		ThreadBuffer* pBuffer;
+	};
+
+	TraceRecorder();
+
+	ThreadBuffer* GetThreadBuffer();
+	void Record(const Event& event);
+
+	std::atomic<bool> recording;
+	size_t eventsPerThread;
+	std::chrono::steady_clock::time_point startTime;
+	std::mutex threadBuffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+	uint32_t nextThreadId;
+};
@@ -0,0 +1,73 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cSC4ViewInputControlDemolish.h"
+#include "cIGZAllocatorService.h"
+#include "GZServPtrs.h"
+
+namespace
+{
+	typedef cSC4ViewInputControlDemolish* (__thiscall* PFN_cSC4ViewInputControlDemolish_ctor)(cSC4ViewInputControlDemolish* pThis);
+	static const PFN_cSC4ViewInputControlDemolish_ctor cSC4ViewInputControlDemolish_ctor = reinterpret_cast<PFN_cSC4ViewInputControlDemolish_ctor>(0x4b9070);
+
+	typedef bool(__thiscall* cSC4ViewInputControl_IsOnTop)(cISC4ViewInputControl* pThis);
+
+	static const cSC4ViewInputControl_IsOnTop IsOnTop = reinterpret_cast<cSC4ViewInputControl_IsOnTop>(0x5fb190);
+
+	typedef void(__thiscall* cSC4ViewInputControlDemolish_ThiscallFn)(cSC4ViewInputControlDemolish* pThis);
+
+	static const cSC4ViewInputControlDemolish_ThiscallFn EndInput = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b9040);
+	static const cSC4ViewInputControlDemolish_ThiscallFn UpdateSelectedRegion = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b93b0);
+}
+
+cSC4ViewInputControlDemolish* cSC4ViewInputControlDemolish::Create()
+{
+	cSC4ViewInputControlDemolish* pControl = nullptr;
+
+	cIGZAllocatorServicePtr pAllocatorService;
+
+	if (pAllocatorService)
+	{
+		pControl = static_cast<cSC4ViewInputControlDemolish*>(pAllocatorService->Allocate(sizeof(cSC4ViewInputControlDemolish)));
+
+		if (pControl)
+		{
+			cSC4ViewInputControlDemolish_ctor(pControl);
+		}
+	}
+
+	return pControl;
+}
+
+bool cSC4ViewInputControlDemolish::IsOnTop()
+{
+	return ::IsOnTop(this);
+}
+
+void cSC4ViewInputControlDemolish::EndInput()
+{
+	::EndInput(this);
+}
+
+void cSC4ViewInputControlDemolish::UpdateSelectedRegion()
+{
+	::UpdateSelectedRegion(this);
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cISC4ViewInputControl.h"
+#include "SC4CellRegion.h"
+#include <cstddef>
+#include <cstdint>
+
+class cISC4Demolition;
+class cISC4OccupantFilter;
+
+struct S3DColorFloat
+{
+	float r;
+	float g;
+	float b;
+	float a;
+};
+
+// The game's bulldoze tool control.
+// The non-virtual methods call the game's own code, they are defined in
+// cSC4ViewInputControlDemolish.cpp.
+struct cSC4ViewInputControlDemolish : public cISC4ViewInputControl
+{
+	// Allocates a control with the game's allocator and runs its constructor.
+	static cSC4ViewInputControlDemolish* Create();
+
+	bool IsOnTop();
+	void EndInput();
+	void UpdateSelectedRegion();
+
+	uint8_t bInitialized;
+	uint32_t refCount;
+	uint32_t id;
+	uint32_t cursorIID;
+	void* pCursor;										// cIGZCursor*
+	void* pWindow;										// cIGZWin*
+	void* pView3DWin;									// cISC4View3DWin *
+	void* pWM;											// cIGZWinMgr*
+	intptr_t unknown1;
+	void* pBudgetSim;									// cISC4BudgetSimulator*
+	void* pCity;										// cISC4City*
+	cISC4Demolition* pDemolition;
+	void* pLotDeveloper;								// cISC4LotDeveloper*
+	void* pLotManager;									// cISC4LotManager*
+	cISC4OccupantFilter* pDemolishableOccupantFilter;
+	void* pOccupantManager;								// cISC4OccupantManager*
+	uint8_t bCellPicked;
+	uint8_t unknown2[3];								// I have seen (very rarely) values here, but usually 00 00 00
+	int32_t lotMinX;									// Lot bounding box min X for lot bulldoze, drag start X otherwise
+	int32_t lotMinZ;									// Lot bounding box min Z for lot bulldoze, drag start Z otherwise
+	int32_t lotMaxX;									// Lot bounding box max X for lot bulldoze, drag start X otherwise
+	int32_t lotMaxZ;									// Lot bounding box max Z for lot bulldoze, drag start Z otherwise
+	int32_t clickX;										// X cell where the user clicked
+	int32_t clickZ;										// Z cell where the user clicked
+	int32_t cellPointX;
+	int32_t cellPointZ;
+	SC4CellRegion<int32_t>* pCellRegion;
+	uint8_t bValidDemolitionTarget;
+	void* pSelectedOccupant;							// cISC4Occupant*
+	uint8_t unknown3[28];
+	void* pMarkedCellView;
+	uint8_t bSignPostOccupant;
+	S3DColorFloat destroyOK;
+	S3DColorFloat destroyNotOK;
+	S3DColorFloat demolishOK;
+	S3DColorFloat demolishNotOK;
+};
+
+// The layout only matches the game in 32-bit builds.
+static_assert(sizeof(void*) != 4 || sizeof(cSC4ViewInputControlDemolish) == 0xd8);
+static_assert(sizeof(void*) != 4 || offsetof(cSC4ViewInputControlDemolish, id) == 0xc);
+static_assert(sizeof(void*) != 4 || offsetof(cSC4ViewInputControlDemolish, pBudgetSim) == 0x28);
+static_assert(sizeof(void*) != 4 || offsetof(cSC4ViewInputControlDemolish, pOccupantManager) == 0x40);
+static_assert(sizeof(void*) != 4 || offsetof(cSC4ViewInputControlDemolish, bCellPicked) == 0x44);
+static_assert(sizeof(void*) != 4 || offsetof(cSC4ViewInputControlDemolish, cellPointX) == 0x60);
+static_assert(sizeof(void*) != 4 || offsetof(cSC4ViewInputControlDemolish, pCellRegion) == 0x68);
+static_assert(sizeof(void*) != 4 || offsetof(cSC4ViewInputControlDemolish, pMarkedCellView) == 0x90);
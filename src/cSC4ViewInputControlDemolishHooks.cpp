@@ -20,91 +20,53 @@
  */
 
 #include "cSC4ViewInputControlDemolishHooks.h"
-#include "cIGZAllocatorService.h"
 #include "cISC4Demolition.h"
+#include "cISC4Occupant.h"
 #include "cISC4OccupantFilter.h"
 #include "cRZAutoRefCount.h"
+#include "CellRegionAlgebra.h"
+#include "DemolitionScheduler.h"
+#include "DiagonalRegionBuilder.h"
+#include "FileSystem.h"
 #include "FloraOccupantFilter.h"
-#include "GZServPtrs.h"
+#include "HookSiteResolver.h"
+#include "HookSites.h"
+#include "InputRecorder.h"
+#include "Instrumentation.h"
 #include "Logger.h"
 #include "NetworkOccupantFilter.h"
-#include "Patcher.h"
+#include "OccupantTypeFilter.h"
+#include "OccupantTypeSet.h"
+#include "PendingSelection.h"
+#include "PredicateOccupantFilter.h"
+#include "PatchSet.h"
+#include "PreviewCostDelta.h"
+#include "PreviewInvalidation.h"
+#include "RegionDecomposition.h"
 #include "SC4CellRegion.h"
 #include "SC4List.h"
 #include "SC4VersionDetection.h"
+#include "SelectionWorker.h"
+#include "Settings.h"
+#include "TraceRecorder.h"
 #include <Windows.h>
-#include "wil/result.h"
 #include <cstdint>
 #include <algorithm>
-#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <memory>
+#include <vector>
 
 namespace
 {
-	struct S3DColorFloat
-	{
-		float r;
-		float g;
-		float b;
-		float a;
-	};
-
-	struct cSC4ViewInputControlDemolish : public cISC4ViewInputControl
-	{
-		uint8_t bInitialized;
-		uint32_t refCount;
-		uint32_t id;
-		uint32_t cursorIID;
-		void* pCursor;										// cIGZCursor*
-		void* pWindow;										// cIGZWin*
-		void* pView3DWin;									// cISC4View3DWin *
-		void* pWM;											// cIGZWinMgr*
-		intptr_t unknown1;
-		void* pBudgetSim;									// cISC4BudgetSimulator*
-		void* pCity;										// cISC4City*
-		cISC4Demolition* pDemolition;
-		void* pLotDeveloper;								// cISC4LotDeveloper*
-		void* pLotManager;									// cISC4LotManager*
-		cISC4OccupantFilter* pDemolishableOccupantFilter;
-		void* pOccupantManager;								// cISC4OccupantManager*
-		uint8_t bCellPicked;
-		uint8_t unknown2[3];								// I have seen (very rarely) values here, but usually 00 00 00
-		int32_t lotMinX;									// Lot bounding box min X for lot bulldoze, drag start X otherwise
-		int32_t lotMinZ;									// Lot bounding box min Z for lot bulldoze, drag start Z otherwise
-		int32_t lotMaxX;									// Lot bounding box max X for lot bulldoze, drag start X otherwise
-		int32_t lotMaxZ;									// Lot bounding box max Z for lot bulldoze, drag start Z otherwise
-		int32_t clickX;										// X cell where the user clicked
-		int32_t clickZ;										// Z cell where the user clicked
-		int32_t cellPointX;
-		int32_t cellPointZ;
-		SC4CellRegion<int32_t>* pCellRegion;
-		uint8_t bValidDemolitionTarget;
-		void* pSelectedOccupant;							// cISC4Occupant*
-		uint8_t unknown3[28];
-		void* pMarkedCellView;
-		uint8_t bSignPostOccupant;
-		S3DColorFloat destroyOK;
-		S3DColorFloat destroyNotOK;
-		S3DColorFloat demolishOK;
-		S3DColorFloat demolishNotOK;
-	};
-
-	static_assert(sizeof(cSC4ViewInputControlDemolish) == 0xd8);
-	static_assert(offsetof(cSC4ViewInputControlDemolish, id) == 0xc);
-	static_assert(offsetof(cSC4ViewInputControlDemolish, pBudgetSim) == 0x28);
-	static_assert(offsetof(cSC4ViewInputControlDemolish, pOccupantManager) == 0x40);
-	static_assert(offsetof(cSC4ViewInputControlDemolish, bCellPicked) == 0x44);
-	static_assert(offsetof(cSC4ViewInputControlDemolish, cellPointX) == 0x60);
-	static_assert(offsetof(cSC4ViewInputControlDemolish, pCellRegion) == 0x68);
-	static_assert(offsetof(cSC4ViewInputControlDemolish, pMarkedCellView) == 0x90);
-
-	typedef cSC4ViewInputControlDemolish* (__thiscall* PFN_cSC4ViewInputControlDemolish_ctor)(cSC4ViewInputControlDemolish* pThis);
-	static const PFN_cSC4ViewInputControlDemolish_ctor cSC4ViewInputControlDemolish_ctor = reinterpret_cast<PFN_cSC4ViewInputControlDemolish_ctor>(0x4b9070);
-
 	enum class OccupantFilterType
 	{
 		None = 0,
 		Flora = 1,
-		Network = 2
+		Network = 2,
+		OccupantTypes = 3,
+		Props = 4,
+		Rail = 5
 	};
 
 	static OccupantFilterType occupantFilterType = OccupantFilterType::None;
@@ -112,137 +74,178 @@ namespace
 	static int32_t diagonalThickness = 1; // Default thickness is 1 (single line)
 	static int32_t maxDiagonalThickness = 9;
 	static cSC4ViewInputControlDemolish* currentViewControl = nullptr;
+	static DiagonalRegionBuilder diagonalRegionBuilder;
+	static PreviewInvalidation previewInvalidation;
+	static DemolitionScheduler demolitionScheduler;
+	static bool timeSlicedDemolition = false;
+	static uint32_t timeSliceBudgetMilliseconds = 8;
+	static uint32_t timeSlicedDemolitionMinimumCells = 16384;
+	static constexpr int32_t TimeSlicedDemolitionTileSize = 32;
+	static SelectionWorker selectionWorker;
+	static bool backgroundSelectionGeometry = false;
+	// The newest region that was built by the worker thread.
+	static std::unique_ptr<SelectionWorker::Result> workerGeometry;
+	// The control that is waiting for the worker, it is kept alive until the result arrives.
+	static cRZAutoRefCount<cISC4ViewInputControl> workerGeometryControl;
+	static InputRecorder inputRecorder;
+	static constexpr size_t TraceEventsPerThread = 65536;
+	// The lines that are written for each preview or wheel step of a drag are limited to one per interval.
+	static constexpr uint32_t DragLogIntervalMilliseconds = 1000;
+	static PendingSelection pendingSelection;
+	// The demolish effect of the newest queued selection, it is played once when the queue is demolished.
+	static cRZAutoRefCount<cISC4Occupant> pendingDemolishEffectOccupant;
+	static long pendingDemolishEffectX = 0;
+	static long pendingDemolishEffectZ = 0;
+	static bool splitSparseDemolition = false;
+	// The pieces of the sparse region that is being passed to the game.
+	static std::vector<SC4Rect<int32_t>> demolitionPieces;
+	static bool incrementalPreviewCost = false;
+	// The rectangle and the counted occupants of the previous rectangular preview of the drag.
+	static PreviewCostDelta previewCostDelta;
 
 
-	// Helper function to create a diagonal region from two points with drag direction detection and thickness
-	SC4CellRegion<int32_t> CreateDiagonalRegion(int32_t x1, int32_t z1, int32_t x2, int32_t z2, int32_t startX = -1, int32_t startZ = -1)
+	// Returns true if the worker thread has built the diagonal region for the current thickness
+	// and the specified selection.
+	bool WorkerGeometryMatches(const SC4Rect<int32_t>& bounds, int32_t clickX, int32_t clickZ)
 	{
-		// Calculate bounding box for the region
-		int32_t minX = (std::min)(x1, x2);
-		int32_t maxX = (std::max)(x1, x2);
-		int32_t minZ = (std::min)(z1, z2);
-		int32_t maxZ = (std::max)(z1, z2);
-
-		// Create region with all cells initially false
-		SC4CellRegion<int32_t> region(minX, minZ, maxX, maxZ, false);
-
-		// Determine diagonal direction based on click position relative to bounding box
-		int32_t diagStartX, diagStartZ, diagEndX, diagEndZ;
-		
-		if (startX != -1 && startZ != -1)
-		{
-			// Use the reliable click coordinates to determine diagonal direction
-			// Simply draw from the click point to the opposite corner
-			int32_t centerX = (minX + maxX) / 2;
-			int32_t centerZ = (minZ + maxZ) / 2;
-			
-			if (startX <= centerX && startZ <= centerZ)
-			{
-				// Click in northwest area -> draw NW to SE
-				diagStartX = minX; diagStartZ = minZ;
-				diagEndX = maxX; diagEndZ = maxZ;
-			}
-			else if (startX > centerX && startZ <= centerZ)
-			{
-				// Click in northeast area -> draw NE to SW
-				diagStartX = maxX; diagStartZ = minZ;
-				diagEndX = minX; diagEndZ = maxZ;
-			}
-			else if (startX <= centerX && startZ > centerZ)
-			{
-				// Click in southwest area -> draw SW to NE
-				diagStartX = minX; diagStartZ = maxZ;
-				diagEndX = maxX; diagEndZ = minZ;
-			}
-			else
-			{
-				// Click in southeast area -> draw SE to NW
-				diagStartX = maxX; diagStartZ = maxZ;
-				diagEndX = minX; diagEndZ = minZ;
-			}
-		}
-		else
+		if (!workerGeometry)
 		{
-			// No start point provided - use default NW-to-SE diagonal
-			diagStartX = minX; diagStartZ = minZ;
-			diagEndX = maxX; diagEndZ = maxZ;
+			return false;
 		}
 
-		// Use Bresenham's line algorithm to mark diagonal cells
-		int32_t dx = abs(diagEndX - diagStartX);
-		int32_t dz = abs(diagEndZ - diagStartZ);
-		int32_t sx = diagStartX < diagEndX ? 1 : -1;
-		int32_t sz = diagStartZ < diagEndZ ? 1 : -1;
-		int32_t err = dx - dz;
+		const SelectionWorker::Request& request = workerGeometry->request;
+
+		return request.bounds.topLeftX == bounds.topLeftX
+			&& request.bounds.topLeftY == bounds.topLeftY
+			&& request.bounds.bottomRightX == bounds.bottomRightX
+			&& request.bounds.bottomRightY == bounds.bottomRightY
+			&& request.startX == clickX
+			&& request.startZ == clickZ
+			&& request.thickness == diagonalThickness;
+	}
+
+	// Returns the occupant filter type, with 0x100 set in diagonal mode.
+	uint32_t GetModeFlags()
+	{
+		return static_cast<uint32_t>(occupantFilterType) | (diagonalMode ? 0x100 : 0);
+	}
+
+	// Returns the tool state that is stored with a recorded input event.
+	// The state is captured before the hook changes it.
+	InputRecorder::ToolState GetRecordedToolState(const cSC4ViewInputControlDemolish* pControl)
+	{
+		return inputRecorder.IsRecording() ? cSC4ViewInputControlDemolishHooks::GetToolState(pControl) : InputRecorder::ToolState{};
+	}
+
+	int32_t GetCellCount(const SC4CellRegion<int32_t>& region)
+	{
+		return static_cast<int32_t>(region.cellMap.GetRowCount() * region.cellMap.GetColumnCount());
+	}
 
+	int32_t GetSelectionCellCount(const cSC4ViewInputControlDemolish* pThis)
+	{
+		return pThis->bCellPicked && pThis->pCellRegion ? GetCellCount(*pThis->pCellRegion) : 0;
+	}
 
-		int32_t currentX = diagStartX;
-		int32_t currentZ = diagStartZ;
-		int32_t tileCount = 0;
+	// Updates the diagonal pattern for the specified bounds and writes it into the target region.
+	// Returns the target if the pattern was written in place, or the builder's own region when
+	// there is no target or its shape does not match the bounds.
+	const SC4CellRegion<int32_t>& UpdateDiagonalRegion(
+		const SC4Rect<int32_t>& bounds,
+		int32_t clickX,
+		int32_t clickZ,
+		SC4CellRegion<int32_t>* pTarget)
+	{
+		INSTRUMENTATION_SCOPE(DiagonalRegion);
+		INSTRUMENTATION_COUNT(DiagonalRegionUpdates, 1);
+		TraceRecorder::ScopedEvent traceEvent(
+			"UpdateDiagonalRegion",
+			(bounds.bottomRightX - bounds.topLeftX + 1) * (bounds.bottomRightY - bounds.topLeftY + 1),
+			static_cast<int32_t>(GetModeFlags()),
+			diagonalThickness);
 
-		while (true)
+		if (WorkerGeometryMatches(bounds, clickX, clickZ))
 		{
-			// Set the current cell and perpendicular cells for thickness
-			// Handle positive/negative thickness values (skip 0)
-			int32_t startOffset, endOffset;
-			if (diagonalThickness > 0) {
-				startOffset = 0;
-				endOffset = diagonalThickness - 1;
-			}
-			else {
-				startOffset = diagonalThickness + 1;
-				endOffset = 0;
-			}
-			
-			for (int32_t thickOffset = startOffset; thickOffset <= endOffset; thickOffset++)
+			const SC4CellRegion<int32_t>& region = workerGeometry->region;
+
+			// The target's map may be owned by the game, so the cells are copied into its
+			// existing rows, the copy fails instead of reallocating when the shapes differ.
+			if (pTarget && pTarget->cellMap.CopyCellsFrom(region.cellMap))
 			{
-				// Calculate perpendicular offset based on line direction
-				int32_t perpX, perpZ;
-				if (abs(dx) > abs(dz)) {
-					// More horizontal line - add thickness vertically
-					perpX = currentX;
-					perpZ = currentZ + thickOffset;
-				} else {
-					// More vertical line - add thickness horizontally  
-					perpX = currentX + thickOffset;
-					perpZ = currentZ;
-				}
-				
-				int32_t cellX = perpX - minX;
-				int32_t cellZ = perpZ - minZ;
-				if (cellX >= 0 && cellX < (maxX - minX + 1) && cellZ >= 0 && cellZ < (maxZ - minZ + 1))
-				{
-					region.cellMap.SetValue(cellX, cellZ, true);
-					tileCount++;
-				}
+				pTarget->bounds = region.bounds;
+				return *pTarget;
 			}
 
-			if (currentX == diagEndX && currentZ == diagEndZ) break;
+			return region;
+		}
+
+		diagonalRegionBuilder.Update(bounds, clickX, clickZ, diagonalThickness);
+
+		if (pTarget && diagonalRegionBuilder.WriteTo(*pTarget))
+		{
+			return *pTarget;
+		}
+
+		return diagonalRegionBuilder.GetRegion();
+	}
+
+	// Returns the hash of the preview that the current mode produces for the specified selection.
+	// In diagonal mode the builder is updated, so the hash covers the cells that are selected.
+	uint64_t GetPreviewStateHash(const SC4Rect<int32_t>& bounds, int32_t clickX, int32_t clickZ)
+	{
+		const uint32_t mode = GetModeFlags();
+		uint64_t regionHash = 0;
 
-			int32_t e2 = 2 * err;
-			if (e2 > -dz)
+		if (diagonalMode)
+		{
+			if (WorkerGeometryMatches(bounds, clickX, clickZ))
 			{
-				err -= dz;
-				currentX += sx;
+				regionHash = workerGeometry->spanHash;
 			}
-			if (e2 < dx)
+			else
 			{
-				err += dx;
-				currentZ += sz;
+				diagonalRegionBuilder.Update(bounds, clickX, clickZ, diagonalThickness);
+				regionHash = diagonalRegionBuilder.GetSpanHash();
 			}
 		}
 
-		return region;
+		return PreviewInvalidation::HashState(mode, bounds, regionHash);
 	}
 
-	typedef bool(__thiscall* cSC4ViewInputControl_IsOnTop)(cISC4ViewInputControl* pThis);
+	// Recomputes the preview once if the input event changed the preview state.
+	void FlushPreview(cSC4ViewInputControlDemolish* pThis)
+	{
+		if (!previewInvalidation.IsDirty())
+		{
+			return;
+		}
 
-	static const cSC4ViewInputControl_IsOnTop IsOnTop = reinterpret_cast<cSC4ViewInputControl_IsOnTop>(0x5fb190);
+		if (pThis->bCellPicked && pThis->pCellRegion)
+		{
+			const SC4Rect<int32_t> bounds = pThis->pCellRegion->bounds;
 
-	typedef void(__thiscall* cSC4ViewInputControlDemolish_ThiscallFn)(cSC4ViewInputControlDemolish* pThis);
+			if (previewInvalidation.BeginFlush(GetPreviewStateHash(bounds, pThis->clickX, pThis->clickZ)))
+			{
+				// Write the diagonal pattern directly into the existing pCellRegion cell map
+				if (diagonalMode)
+				{
+					UpdateDiagonalRegion(bounds, pThis->clickX, pThis->clickZ, pThis->pCellRegion);
+				}
 
-	static const cSC4ViewInputControlDemolish_ThiscallFn EndInput = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b9040);
-	static const cSC4ViewInputControlDemolish_ThiscallFn UpdateSelectedRegion = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b93b0);
+				TraceRecorder::ScopedEvent traceEvent(
+					"UpdateSelectedRegion",
+					GetSelectionCellCount(pThis),
+					static_cast<int32_t>(GetModeFlags()),
+					diagonalThickness);
+				pThis->UpdateSelectedRegion();
+			}
+		}
+		else
+		{
+			// There is no preview to update.
+			previewInvalidation.Reset();
+		}
+	}
 
 
 	void SetOccupantFilterOption(cSC4ViewInputControlDemolish* pThis, OccupantFilterType type, bool diagonal)
@@ -255,19 +258,24 @@ namespace
 			occupantFilterType = type;
 			diagonalMode = diagonal;
 
-			// Set cursor based on occupant filter type and diagonal mode
+			// Set cursor based on occupant filter type and diagonal mode.
+			// The plugin's DAT only has flora and network cursors, so the prop and rail
+			// modes share them and are told apart by their preview colors.
 			switch (occupantFilterType)
 			{
 			case OccupantFilterType::Flora:
+			case OccupantFilterType::Props:
 				pThis->SetCursor(diagonalMode ? 
 					cSC4ViewInputControlDemolishHooks::BulldozeCursorFloraDiagonal : 
 					cSC4ViewInputControlDemolishHooks::BulldozeCursorFlora);
 				break;
 			case OccupantFilterType::Network:
+			case OccupantFilterType::Rail:
 				pThis->SetCursor(diagonalMode ? 
 					cSC4ViewInputControlDemolishHooks::BulldozeCursorNetworkDiagonal : 
 					cSC4ViewInputControlDemolishHooks::BulldozeCursorNetwork);
 				break;
+			case OccupantFilterType::OccupantTypes:
 			case OccupantFilterType::None:
 			default:
 				pThis->SetCursor(diagonalMode ? 
@@ -276,56 +284,17 @@ namespace
 				break;
 			}
 
-			if (pThis->bCellPicked)
-			{
-				// Safely modify existing pCellRegion contents
-				if (diagonal && pThis->pCellRegion)
-				{
-					// Get current rectangular bounds
-					const auto& bounds = pThis->pCellRegion->bounds;
-
-					// Create diagonal region using reliable click coordinates
-					SC4CellRegion<int32_t> diagonalRegion = CreateDiagonalRegion(
-						bounds.topLeftX, bounds.topLeftY,
-						bounds.bottomRightX, bounds.bottomRightY,
-						pThis->clickX, pThis->clickZ
-					);
-					
-					// Only modify the cellMap contents, not the structure
-					// Copy diagonal pattern into existing cellMap without changing pointers
-					auto& existingCellMap = pThis->pCellRegion->cellMap;
-					const auto& diagonalCellMap = diagonalRegion.cellMap;
-					
-					// Calculate dimensions from bounds (both regions should have same bounds)
-					const auto& existingBounds = pThis->pCellRegion->bounds;
-					const auto& diagonalBounds = diagonalRegion.bounds;
-					
-					uint32_t width = static_cast<uint32_t>(bounds.bottomRightX - bounds.topLeftX + 1);
-					uint32_t height = static_cast<uint32_t>(bounds.bottomRightY - bounds.topLeftY + 1);
-					
-					// Verify bounds match before copying
-					if (existingBounds.topLeftX == diagonalBounds.topLeftX &&
-						existingBounds.topLeftY == diagonalBounds.topLeftY &&
-						existingBounds.bottomRightX == diagonalBounds.bottomRightX &&
-						existingBounds.bottomRightY == diagonalBounds.bottomRightY)
-					{
-						// Copy cell values from diagonal pattern to existing map
-						for (uint32_t x = 0; x < width; x++)
-						{
-							for (uint32_t z = 0; z < height; z++)
-							{
-								bool diagonalValue = diagonalCellMap.GetValue(x, z);
-								existingCellMap.SetValue(x, z, diagonalValue);
-							}
-						}
-					}
-				}
-				
-				UpdateSelectedRegion(pThis);
-			}
+			previewInvalidation.Invalidate(PreviewInvalidation::ChangeMode);
 		}
 	}
 
+	// Returns the second mode when the first one is already active with the same diagonal option,
+	// so pressing a shortcut again switches between the two modes.
+	OccupantFilterType GetNextOccupantFilterType(OccupantFilterType first, OccupantFilterType second, bool diagonal)
+	{
+		return occupantFilterType == first && diagonalMode == diagonal ? second : first;
+	}
+
 	enum ModifierKeysFlags : int32_t
 	{
 		ModifierKeyFlagNone = 0,
@@ -335,136 +304,78 @@ namespace
 		ModifierKeyFlagAll = ModifierKeyFlagShift | ModifierKeyFlagControl | ModifierKeyFlagAlt,
 	};
 
-	bool __fastcall OnMouseWheelHook(
-		cSC4ViewInputControlDemolish* pThis,
-		void* edxUnused,
-		int32_t x,
-		int32_t z,
-		uint32_t modifiers,
-		int32_t wheelDelta)
-	{
-		// Check if we're in diagonal mode and Alt is held
-		if (diagonalMode && (modifiers & ModifierKeyFlagAlt))
-		{
-			// Adjust diagonal thickness based on wheel direction
-			int32_t oldThickness = diagonalThickness;
-			
-			if (wheelDelta > 0)
-			{
-				// Scroll up - increase thickness (skip 0)
-				if (diagonalThickness == -1) diagonalThickness = 1;
-				else diagonalThickness = (std::min)(diagonalThickness + 1, maxDiagonalThickness);
-			}
-			else if (wheelDelta < 0)
-			{
-				// Scroll down - decrease thickness (skip 0)
-				if (diagonalThickness == 1) diagonalThickness = -1;
-				else diagonalThickness = (std::max)(diagonalThickness - 1, -maxDiagonalThickness);
-			}
-			
-			if (diagonalThickness != oldThickness)
-			{			
-				// Update preview if we have an active selection
-				if (pThis->bCellPicked && pThis->pCellRegion)
-				{
-					// Trigger preview update by calling SetOccupantFilterOption
-					SetOccupantFilterOption(pThis, occupantFilterType, diagonalMode);
-					
-					// Force immediate visual update of the preview
-					UpdateSelectedRegion(pThis);
-				}
-			}
-			
-			// Return true to indicate we handled the event (prevents zooming)
-			return true;
-		}
-		
-		// Let default behavior handle normal zoom
-		return false;
-	}
+	// The filters are shared by every DemolishRegion call instead of being allocated per call.
+	// They are created when a city is loaded and released when it shuts down.
+	static cRZAutoRefCount<FloraOccupantFilter> floraOccupantFilter;
+	static cRZAutoRefCount<NetworkOccupantFilter> networkOccupantFilter;
+	static cRZAutoRefCount<OccupantTypeFilter> occupantTypeFilter;
+
+	typedef PredicateOccupantFilter<
+		OccupantFilterPredicates::OccupantTypeIs<OccupantFilterPredicates::kPropOccupantType>> PropOccupantFilter;
+	typedef PredicateOccupantFilter<
+		OccupantFilterPredicates::NetworkTypeIs<NetworkTypeFlags::AllRailNetworks>> RailOccupantFilter;
+
+	static cRZAutoRefCount<PropOccupantFilter> propOccupantFilter;
+	static cRZAutoRefCount<RailOccupantFilter> railOccupantFilter;
+	// The occupant types from the settings file, the occupant type mode is only available when it is not empty.
+	static OccupantTypeSet occupantTypes;
 
-	bool __fastcall OnKeyDownHook(
-		cSC4ViewInputControlDemolish* pThis,
-		void* edxUnused,
-		int32_t vkCode,
-		int32_t modifiers)
+	// Returns the filter for a single DemolishRegion call.
+	cISC4OccupantFilter* GetOccupantFilter(OccupantFilterType type)
 	{
-		bool handled = false;
+		cISC4OccupantFilter* pOccupantFilter = nullptr;
 
-		if (IsOnTop(pThis))
+		switch (type)
 		{
-			if (vkCode == VK_ESCAPE)
+		case OccupantFilterType::Flora:
+			if (!floraOccupantFilter)
 			{
-				if (pThis->bCellPicked)
-				{
-					EndInput(pThis);
-					handled = true;
-				}
+				floraOccupantFilter = new FloraOccupantFilter();
 			}
-			else
+			pOccupantFilter = floraOccupantFilter;
+			break;
+		case OccupantFilterType::Network:
+			if (!networkOccupantFilter)
 			{
-				// Configure bulldoze modes using the B key with modifiers.
-				// Alt acts as a diagonal modifier on top of the base modes.
-				if (vkCode == 'B')
-				{
-					handled = true;
-					const uint32_t activeModifiers = modifiers & ModifierKeyFlagAll;
-					const bool isDiagonal = (activeModifiers & ModifierKeyFlagAlt) == ModifierKeyFlagAlt;
-
-					if (activeModifiers == ModifierKeyFlagNone)
-					{
-						SetOccupantFilterOption(pThis, OccupantFilterType::None, false);
-					}
-					else if (activeModifiers == ModifierKeyFlagAlt)
-					{
-						SetOccupantFilterOption(pThis, OccupantFilterType::None, true);
-					}
-					else if ((activeModifiers & ModifierKeyFlagControl) == ModifierKeyFlagControl)
-					{
-						SetOccupantFilterOption(pThis, OccupantFilterType::Flora, isDiagonal);
-					}
-					else if ((activeModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift)
-					{
-						SetOccupantFilterOption(pThis, OccupantFilterType::Network, isDiagonal);
-					}
-				}
+				networkOccupantFilter = new NetworkOccupantFilter(NetworkTypeFlags::AllTransportationNetworks);
 			}
-		}
-
-		return handled;
-	}
-
-	void __fastcall Activate(cSC4ViewInputControlDemolish* pThis, void* edxUnused)
-	{
-		occupantFilterType = OccupantFilterType::None;
-		diagonalMode = false;
-		diagonalThickness = 1; // Reset thickness to default
-		currentViewControl = pThis;
-
-		switch (pThis->cursorIID)
-		{
-		case cSC4ViewInputControlDemolishHooks::BulldozeCursorFlora:
-			occupantFilterType = OccupantFilterType::Flora;
+			pOccupantFilter = networkOccupantFilter;
 			break;
-		case cSC4ViewInputControlDemolishHooks::BulldozeCursorFloraDiagonal:
-			occupantFilterType = OccupantFilterType::Flora;
-			diagonalMode = true;
+		case OccupantFilterType::OccupantTypes:
+			if (!occupantTypeFilter)
+			{
+				occupantTypeFilter = new OccupantTypeFilter(occupantTypes);
+			}
+			pOccupantFilter = occupantTypeFilter;
 			break;
-		case cSC4ViewInputControlDemolishHooks::BulldozeCursorNetwork:
-			occupantFilterType = OccupantFilterType::Network;
+		case OccupantFilterType::Props:
+			if (!propOccupantFilter)
+			{
+				propOccupantFilter = new PropOccupantFilter();
+			}
+			pOccupantFilter = propOccupantFilter;
 			break;
-		case cSC4ViewInputControlDemolishHooks::BulldozeCursorNetworkDiagonal:
-			occupantFilterType = OccupantFilterType::Network;
-			diagonalMode = true;
+		case OccupantFilterType::Rail:
+			if (!railOccupantFilter)
+			{
+				railOccupantFilter = new RailOccupantFilter();
+			}
+			pOccupantFilter = railOccupantFilter;
 			break;
-		case cSC4ViewInputControlDemolishHooks::BulldozeCursorDefaultDiagonal:
-			diagonalMode = true;
+		case OccupantFilterType::None:
+		default:
 			break;
 		}
+
+		return pOccupantFilter;
 	}
 
+	// Demolishes or previews a region with the specified occupant filter.
+	// A sparse region is passed to the game as a few tight pieces.
 	bool DemolishRegion(
 		cISC4Demolition* pDemolition,
+		OccupantFilterType filterType,
+		bool sparseRegion,
 		bool demolish,
 		const SC4CellRegion<int32_t>& cellRegion,
 		uint32_t privilegeType,
@@ -476,28 +387,84 @@ namespace
 		long demolishEffectX,
 		long demolishEffectZ)
 	{
-		cRZAutoRefCount<cISC4OccupantFilter> occupantFilter;
+		INSTRUMENTATION_COUNT(
+			CellsProcessed,
+			static_cast<uint64_t>(cellRegion.cellMap.GetRowCount()) * cellRegion.cellMap.GetColumnCount());
 
-		switch (occupantFilterType)
+		// A diagonal selection only sets a thin band of cells in its bounding box, so it can be
+		// passed to the game as a few tight pieces instead of letting it scan every cell.
+		// The split is only used when it is enabled in the settings, it has only been measured
+		// against the mock demolition. The pieces of a preview share the demolished occupant set,
+		// a preview without one is not split because an occupant that spans two pieces would be
+		// counted twice.
+		if (sparseRegion && splitSparseDemolition && (demolish || demolishedOccupantSet != 0))
 		{
-		case OccupantFilterType::Flora:
-			occupantFilter = new FloraOccupantFilter();
-			break;
-		case OccupantFilterType::Network:
-			occupantFilter = new NetworkOccupantFilter(NetworkTypeFlags::AllTransportationNetworks);
-			break;
-		case OccupantFilterType::None:
-		default:
-			break;
+			RegionDecomposition::Plan(cellRegion, demolitionPieces);
+
+			const SC4Rect<int32_t>& bounds = cellRegion.bounds;
+			const bool coversBounds = demolitionPieces.size() == 1
+				&& demolitionPieces[0].topLeftX == bounds.topLeftX
+				&& demolitionPieces[0].topLeftY == bounds.topLeftY
+				&& demolitionPieces[0].bottomRightX == bounds.bottomRightX
+				&& demolitionPieces[0].bottomRightY == bounds.bottomRightY;
+
+			if (!demolitionPieces.empty() && !coversBounds)
+			{
+				bool result = false;
+				int64_t piecesCost = 0;
+
+				for (size_t i = 0; i < demolitionPieces.size(); i++)
+				{
+					const SC4CellRegion<int32_t> pieceRegion = RegionDecomposition::Extract(cellRegion, demolitionPieces[i]);
+					int64_t pieceCost = 0;
+
+					TraceRecorder::ScopedEvent traceEvent(
+						"cISC4Demolition::DemolishRegion",
+						GetCellCount(pieceRegion),
+						static_cast<int32_t>(GetModeFlags()),
+						diagonalThickness);
+
+					// The demolish effect is played once for the whole selection.
+					const bool firstPiece = i == 0;
+
+					result |= pDemolition->DemolishRegion(
+						demolish,
+						pieceRegion,
+						privilegeType,
+						flags,
+						clearZonedArea,
+						GetOccupantFilter(filterType),
+						&pieceCost,
+						demolishedOccupantSet,
+						firstPiece ? pDemolishEffectOccupant : nullptr,
+						firstPiece ? demolishEffectX : 0,
+						firstPiece ? demolishEffectZ : 0);
+
+					piecesCost += pieceCost;
+				}
+
+				if (totalCost)
+				{
+					*totalCost += piecesCost;
+				}
+
+				return result;
+			}
 		}
 
+		TraceRecorder::ScopedEvent traceEvent(
+			"cISC4Demolition::DemolishRegion",
+			GetCellCount(cellRegion),
+			static_cast<int32_t>(GetModeFlags()),
+			diagonalThickness);
+
 		return pDemolition->DemolishRegion(
 			demolish,
 			cellRegion,
 			privilegeType,
 			flags,
 			clearZonedArea,
-			occupantFilter,
+			GetOccupantFilter(filterType),
 			totalCost,
 			demolishedOccupantSet,
 			pDemolishEffectOccupant,
@@ -505,114 +472,52 @@ namespace
 			demolishEffectZ);
 	}
 
-	bool __fastcall UpdateSelectedRegionDemolishRegion(
+	bool DemolishRegion(
 		cISC4Demolition* pDemolition,
-		void* edxUnused,
-		SC4CellRegion<int32_t> const& cellRegion,
-		intptr_t unused, // Originally the privilege type, but our patch overwrote it with a placeholder value.
+		bool demolish,
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t privilegeType,
 		uint32_t flags,
 		bool clearZonedArea,
-		cISC4OccupantFilter* pOccupantFilter,
 		int64_t* totalCost,
 		intptr_t demolishedOccupantSet,
 		cISC4Occupant* pDemolishEffectOccupant,
 		long demolishEffectX,
 		long demolishEffectZ)
 	{
-		// Set preview colors based on bulldoze mode
-		if (currentViewControl)
-		{
-			float floraColor[4] = { 0.38f, 0.69f, 0.38f, 0.5f };   // Green for flora/nature
-			float networkColor[4] = { 0.98f, 0.60f, 0.20f, 0.5f }; // Orange for networks/infrastructure
-			float normalColor[4] = { 0.30f, 0.60f, 0.85f, 0.5f };   // Blue for standard
-			
-			float* colorToUse = nullptr;
-			
-			switch (occupantFilterType)
-			{
-			case OccupantFilterType::Flora:
-				colorToUse = floraColor;
-				break;
-			case OccupantFilterType::Network:
-				colorToUse = networkColor;
-				break;
-			case OccupantFilterType::None:
-			default:
-				colorToUse = normalColor;
-				break;
-			}
-			
-			if (colorToUse != nullptr)
-			{
-				S3DColorFloat* previewColor = &(currentViewControl->demolishOK);
-				previewColor->r = colorToUse[0];
-				previewColor->g = colorToUse[1];
-				previewColor->b = colorToUse[2];
-				previewColor->a = colorToUse[3];
-			}
-		}
-		
-		// Apply diagonal modification if enabled and we have valid view control
-		if (diagonalMode && currentViewControl && currentViewControl->pCellRegion)
-		{
-			cSC4ViewInputControlDemolish* pViewControl = currentViewControl;
-			const auto& bounds = cellRegion.bounds;
-			
-			// Create diagonal region using reliable click coordinates
-			SC4CellRegion<int32_t> diagonalRegion = CreateDiagonalRegion(
-				bounds.topLeftX, bounds.topLeftY,
-				bounds.bottomRightX, bounds.bottomRightY,
-				pViewControl->clickX, pViewControl->clickZ
-			);
-			
-			// Update view control's cellMap contents without changing structure
-			auto& existingCellMap = pViewControl->pCellRegion->cellMap;
-			const auto& diagonalCellMap = diagonalRegion.cellMap;
-			
-			// Calculate dimensions from bounds
-			const auto& existingBounds = pViewControl->pCellRegion->bounds;
-			const auto& diagonalBounds = diagonalRegion.bounds;
-			
-			uint32_t width = static_cast<uint32_t>(bounds.bottomRightX - bounds.topLeftX + 1);
-			uint32_t height = static_cast<uint32_t>(bounds.bottomRightY - bounds.topLeftY + 1);
-			
-			// Verify bounds match and update cellMap safely
-			if (existingBounds.topLeftX == diagonalBounds.topLeftX &&
-				existingBounds.topLeftY == diagonalBounds.topLeftY &&
-				existingBounds.bottomRightX == diagonalBounds.bottomRightX &&
-				existingBounds.bottomRightY == diagonalBounds.bottomRightY)
-			{
-				// Copy diagonal pattern into existing cellMap
-				for (uint32_t x = 0; x < width; x++)
-				{
-					for (uint32_t z = 0; z < height; z++)
-					{
-						bool diagonalValue = diagonalCellMap.GetValue(x, z);
-						existingCellMap.SetValue(x, z, diagonalValue);
-					}
-				}
-			}
-			
-			// Call demolish with diagonal region for preview calculation
-			bool result = DemolishRegion(
-				pDemolition,
-				false, // demolish
-				diagonalRegion,
-				1, // privilegeType
-				flags,
-				clearZonedArea,
-				totalCost,
-				demolishedOccupantSet,
-				pDemolishEffectOccupant,
-				demolishEffectX,
-				demolishEffectZ);
-			
-			return result;
-		}
-
-		// Normal rectangular bulldoze preview
 		return DemolishRegion(
 			pDemolition,
+			occupantFilterType,
+			diagonalMode,
+			demolish,
+			cellRegion,
+			privilegeType,
+			flags,
+			clearZonedArea,
+			totalCost,
+			demolishedOccupantSet,
+			pDemolishEffectOccupant,
+			demolishEffectX,
+			demolishEffectZ);
+	}
+
+	// Runs the preview pass for the specified region.
+	bool PreviewDemolishRegionCore(
+		cISC4Demolition* pDemolition,
+		const SC4CellRegion<int32_t>& cellRegion,
+		bool sparseRegion,
+		uint32_t flags,
+		bool clearZonedArea,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ)
+	{
+		const bool result = DemolishRegion(
+			pDemolition,
+			occupantFilterType,
+			sparseRegion,
 			false, // demolish
 			cellRegion,
 			1, // privilegeType
@@ -623,41 +528,55 @@ namespace
 			pDemolishEffectOccupant,
 			demolishEffectX,
 			demolishEffectZ);
+
+		// The preview runs for every mouse move of a drag.
+		LOG_LINE_RATE_LIMITED(
+			LogLevel::Debug,
+			DragLogIntervalMilliseconds,
+			"Previewed {} cells, cost: {}",
+			GetCellCount(cellRegion),
+			totalCost ? *totalCost : 0);
+
+		return result;
+	}
+
+	PendingSelection::Parameters GetPendingSelectionParameters(
+		OccupantFilterType filterType,
+		uint32_t flags,
+		bool clearZonedArea)
+	{
+		return PendingSelection::Parameters{ static_cast<uint32_t>(filterType), flags, clearZonedArea };
+	}
+
+	// Returns true if the preview is merged with the queued selections.
+	bool PreviewMergesPendingSelection(uint32_t flags, bool clearZonedArea)
+	{
+		return !pendingSelection.IsEmpty()
+			&& pendingSelection.IsCompatible(GetPendingSelectionParameters(occupantFilterType, flags, clearZonedArea));
 	}
 
-	bool __fastcall OnMouseUpLDemolishRegion(
+	// Previews the selection, merged with the queued selections when they can be demolished
+	// together, so the cost and the highlighted occupants cover the whole batch.
+	bool PreviewDemolishRegion(
 		cISC4Demolition* pDemolition,
-		void* edxUnused,
-		SC4CellRegion<int32_t> const& cellRegion,
-		intptr_t unused, // Originally the privilege type, but our patch overwrote it with a placeholder value.
+		const SC4CellRegion<int32_t>& cellRegion,
+		bool sparseRegion,
 		uint32_t flags,
 		bool clearZonedArea,
-		cISC4OccupantFilter* pOccupantFilter,
 		int64_t* totalCost,
 		intptr_t demolishedOccupantSet,
 		cISC4Occupant* pDemolishEffectOccupant,
 		long demolishEffectX,
 		long demolishEffectZ)
 	{
-		
-		// Apply diagonal modification if enabled
-		if (diagonalMode)
+		if (PreviewMergesPendingSelection(flags, clearZonedArea))
 		{
-			const auto& bounds = cellRegion.bounds;
-			
-			// Create diagonal region using reliable click coordinates
-			SC4CellRegion<int32_t> diagonalRegion = CreateDiagonalRegion(
-				bounds.topLeftX, bounds.topLeftY,
-				bounds.bottomRightX, bounds.bottomRightY,
-				currentViewControl ? currentViewControl->clickX : -1,
-				currentViewControl ? currentViewControl->clickZ : -1
-			);
-			
-			return DemolishRegion(
+			const SC4CellRegion<int32_t> mergedRegion = CellRegionAlgebra::Union(pendingSelection.GetRegion(), cellRegion);
+
+			return PreviewDemolishRegionCore(
 				pDemolition,
-				true, // demolish
-				diagonalRegion,
-				1, // privilegeType
+				mergedRegion,
+				true, // sparseRegion
 				flags,
 				clearZonedArea,
 				totalCost,
@@ -667,13 +586,10 @@ namespace
 				demolishEffectZ);
 		}
 
-		// Normal rectangular bulldoze execution
-
-		return DemolishRegion(
+		return PreviewDemolishRegionCore(
 			pDemolition,
-			true, // demolish
 			cellRegion,
-			1, // privilegeType
+			sparseRegion,
 			flags,
 			clearZonedArea,
 			totalCost,
@@ -683,89 +599,913 @@ namespace
 			demolishEffectZ);
 	}
 
-	void InstallUpdateSelectedRegionDemolishRegionHook()
-	{
-		// Original code:
-		// 0x4b97ed-0x4b97ee = push 0x1
-		// 0x4b97ef			 = push eax
-		// 0x4b97f0			 = call dword ptr [EDX + 0x18]
-		//
-		// New code:
-		// 0x4b97ed = push esi - padding to replace the push we overwrote
-		// 0x4b97ee = push eax
-		// 0x4b97ef = call <our hook>
-		Patcher::OverwriteMemory(0x4b97ed, 0x56); // push esi
-		Patcher::OverwriteMemory(0x4b97ee, 0x50); // push eax
-		Patcher::InstallCallHook(0x4b97ef, reinterpret_cast<uintptr_t>(&UpdateSelectedRegionDemolishRegion));
-	}
-
-	void InstallOnMouseUpLDemolishRegionHook()
+	// Previews a rectangle of a drag from the strips that changed since the previous preview.
+	bool PreviewRectangleDelta(
+		cISC4Demolition* pDemolition,
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t flags,
+		bool clearZonedArea,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet)
 	{
-		Patcher::InstallCallHook(0x4b9d02, reinterpret_cast<uintptr_t>(&OnMouseUpLDemolishRegion));
-	}
-}
-
-cRZAutoRefCount<cISC4ViewInputControl> cSC4ViewInputControlDemolishHooks::CreateViewInputControl(BulldozeCursor cursor)
-{
-	cRZAutoRefCount<cISC4ViewInputControl> instance;
-
-	cIGZAllocatorServicePtr pAllocatorService;
+		const PreviewCostDelta::Key key
+		{
+			GetModeFlags(),
+			flags,
+			clearZonedArea,
+			currentViewControl->clickX,
+			currentViewControl->clickZ
+		};
 
-	if (pAllocatorService)
-	{
-		auto pControl = static_cast<cSC4ViewInputControlDemolish*>(pAllocatorService->Allocate(sizeof(cSC4ViewInputControlDemolish)));
+		const bool result = previewCostDelta.Update(
+			pDemolition,
+			key,
+			cellRegion.bounds,
+			GetOccupantFilter(occupantFilterType),
+			totalCost,
+			demolishedOccupantSet);
 
-		if (pControl)
-		{
-			cSC4ViewInputControlDemolish_ctor(pControl);
+		INSTRUMENTATION_COUNT(CellsProcessed, previewCostDelta.GetLastScannedCellCount());
 
-			instance = pControl;
+		// The preview runs for every mouse move of a drag.
+		LOG_LINE_RATE_LIMITED(
+			LogLevel::Debug,
+			DragLogIntervalMilliseconds,
+			"Previewed {} cells from {} changed cells, cost: {}",
+			GetCellCount(cellRegion),
+			previewCostDelta.GetLastScannedCellCount(),
+			totalCost ? *totalCost : 0);
 
-			// We first call Init to let SC4 set its default cursor, then we set the correct one.
-			instance->Init();
-			instance->SetCursor(cursor);
-		}
+		return result;
+	}
+
+	// Queues a large selection for time-sliced demolition.
+	// Returns false if the selection should be demolished immediately.
+	bool ScheduleDemolition(
+		cISC4Demolition* pDemolition,
+		OccupantFilterType filterType,
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t flags,
+		bool clearZonedArea)
+	{
+		if (!timeSlicedDemolition
+			|| demolitionScheduler.IsActive()
+			|| CellRegionAlgebra::CountCells(cellRegion) < timeSlicedDemolitionMinimumCells)
+		{
+			return false;
+		}
+
+		// The mode is captured when the selection is made, the user can switch
+		// modes while the demolition is running.
+		demolitionScheduler.Start(
+			cellRegion,
+			TimeSlicedDemolitionTileSize,
+			[pDemolition, filterType, flags, clearZonedArea](const SC4CellRegion<int32_t>& tile)
+			{
+				int64_t cost = 0;
+
+				TraceRecorder::ScopedEvent traceEvent(
+					"cISC4Demolition::DemolishRegion",
+					GetCellCount(tile),
+					static_cast<int32_t>(filterType));
+
+				pDemolition->DemolishRegion(
+					true, // demolish
+					tile,
+					1, // privilegeType
+					flags,
+					clearZonedArea,
+					GetOccupantFilter(filterType),
+					&cost,
+					0,
+					nullptr,
+					0,
+					0);
+
+				return cost;
+			});
+
+		LOG_LINE(
+			LogLevel::Info,
+			"Demolishing the selection in {} tiles, press Esc to cancel.",
+			demolitionScheduler.GetTileCount());
+
+		return true;
+	}
+
+	void ClearPendingSelection()
+	{
+		pendingSelection.Clear();
+		pendingDemolishEffectOccupant.Reset();
+		pendingDemolishEffectX = 0;
+		pendingDemolishEffectZ = 0;
+	}
+
+	// Adds the selection to the pending selection when Shift is held.
+	// Returns false if the selection should be demolished now.
+	bool QueueSelection(
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t flags,
+		bool clearZonedArea,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ)
+	{
+		if ((GetKeyState(VK_SHIFT) & 0x8000) == 0)
+		{
+			return false;
+		}
+
+		if (pendingSelection.Add(cellRegion, GetPendingSelectionParameters(occupantFilterType, flags, clearZonedArea)))
+		{
+			pendingDemolishEffectOccupant = pDemolishEffectOccupant;
+			pendingDemolishEffectX = demolishEffectX;
+			pendingDemolishEffectZ = demolishEffectZ;
+
+			LOG_LINE(
+				LogLevel::Info,
+				"Queued {} selections with {} cells, press Enter to demolish them or Esc to clear them.",
+				pendingSelection.GetSelectionCount(),
+				pendingSelection.GetCellCount());
+		}
+		else
+		{
+			LOG_LINE(
+				LogLevel::Info,
+				"The queued selections use a different bulldoze mode, press Enter to demolish them first.");
+		}
+
+		return true;
+	}
+
+	// Demolishes the queued selections as one merged region.
+	void CommitPendingSelection(cISC4Demolition* pDemolition)
+	{
+		const PendingSelection::Parameters& parameters = pendingSelection.GetParameters();
+		const OccupantFilterType filterType = static_cast<OccupantFilterType>(parameters.filterType);
+		const SC4CellRegion<int32_t>& region = pendingSelection.GetRegion();
+
+		TraceRecorder::ScopedEvent traceEvent(
+			"CommitPendingSelection",
+			GetCellCount(region),
+			static_cast<int32_t>(parameters.filterType));
+
+		if (!ScheduleDemolition(pDemolition, filterType, region, parameters.flags, parameters.clearZonedArea))
+		{
+			int64_t cost = 0;
+
+			// The merged region is demolished in one call with the effect of the newest selection.
+			DemolishRegion(
+				pDemolition,
+				filterType,
+				true, // sparseRegion
+				true, // demolish
+				region,
+				1, // privilegeType
+				parameters.flags,
+				parameters.clearZonedArea,
+				&cost,
+				0,
+				pendingDemolishEffectOccupant,
+				pendingDemolishEffectX,
+				pendingDemolishEffectZ);
+
+			LOG_LINE(
+				LogLevel::Info,
+				"Demolished {} queued selections, cost: {}",
+				pendingSelection.GetSelectionCount(),
+				cost);
+		}
+
+		ClearPendingSelection();
+	}
+
+	void InstallUpdateSelectedRegionDemolishRegionHook(PatchSet& patchSet, uintptr_t address)
+	{
+		// Original code:
+		// 0x4b97ed-0x4b97ee = push 0x1
+		// 0x4b97ef			 = push eax
+		// 0x4b97f0			 = call dword ptr [EDX + 0x18]
+		//
+		// New code:
+		// 0x4b97ed = push esi - padding to replace the push we overwrote
+		// 0x4b97ee = push eax
+		// 0x4b97ef = call <our hook>
+		patchSet.AddBytes(address, { 0x56 }, { 0x6A }); // push esi
+		patchSet.AddBytes(address + 1, { 0x50 }, { 0x01 }); // push eax
+		patchSet.AddCallHook(
+			address + 2,
+			reinterpret_cast<uintptr_t>(&cSC4ViewInputControlDemolishHooks::UpdateSelectedRegionDemolishRegion),
+			{ 0x50, 0xFF, 0x52, 0x18 });
+	}
+
+	void InstallOnMouseUpLDemolishRegionHook(PatchSet& patchSet, uintptr_t address, uintptr_t demolishRegion)
+	{
+		// Original code:
+		// 0x4b9d02 = call cSC4Demolition::DemolishRegion
+		patchSet.AddCallHook(
+			address,
+			reinterpret_cast<uintptr_t>(&cSC4ViewInputControlDemolishHooks::OnMouseUpLDemolishRegion),
+			PatchSet::GetCallBytes(address, demolishRegion));
+	}
+}
+
+bool __fastcall cSC4ViewInputControlDemolishHooks::OnMouseWheelHook(
+	cSC4ViewInputControlDemolish* pThis,
+	void* edxUnused,
+	int32_t x,
+	int32_t z,
+	uint32_t modifiers,
+	int32_t wheelDelta)
+{
+	InputRecorder::ScopedEvent recordEvent(
+		inputRecorder,
+		InputRecorder::EventType::MouseWheel,
+		GetRecordedToolState(pThis),
+		x,
+		z,
+		static_cast<int32_t>(modifiers),
+		wheelDelta);
+	INSTRUMENTATION_COUNT(MouseWheelCalls, 1);
+	TraceRecorder::ScopedEvent traceEvent(
+		"OnMouseWheel",
+		GetSelectionCellCount(pThis),
+		static_cast<int32_t>(GetModeFlags()),
+		diagonalThickness);
+
+	// Check if we're in diagonal mode and Alt is held
+	if (diagonalMode && (modifiers & ModifierKeyFlagAlt))
+	{
+		// Adjust diagonal thickness based on wheel direction
+		int32_t oldThickness = diagonalThickness;
+		
+		if (wheelDelta > 0)
+		{
+			// Scroll up - increase thickness (skip 0)
+			if (diagonalThickness == -1) diagonalThickness = 1;
+			else diagonalThickness = (std::min)(diagonalThickness + 1, maxDiagonalThickness);
+		}
+		else if (wheelDelta < 0)
+		{
+			// Scroll down - decrease thickness (skip 0)
+			if (diagonalThickness == 1) diagonalThickness = -1;
+			else diagonalThickness = (std::max)(diagonalThickness - 1, -maxDiagonalThickness);
+		}
+		
+		if (diagonalThickness != oldThickness)
+		{
+			LOG_LINE_RATE_LIMITED(LogLevel::Debug, DragLogIntervalMilliseconds, "Diagonal thickness: {}", diagonalThickness);
+
+			// Update preview if we have an active selection
+			previewInvalidation.Invalidate(PreviewInvalidation::ChangeThickness);
+
+			if (selectionWorker.IsRunning() && pThis->bCellPicked && pThis->pCellRegion)
+			{
+				// The region is built on the worker thread, and the preview is
+				// flushed by OnTick once the result is available.
+				selectionWorker.Post(pThis->pCellRegion->bounds, pThis->clickX, pThis->clickZ, diagonalThickness);
+				workerGeometryControl = pThis;
+			}
+			else
+			{
+				FlushPreview(pThis);
+			}
+		}
+		
+		// Return true to indicate we handled the event (prevents zooming)
+		return true;
+	}
+	
+	// Let default behavior handle normal zoom
+	return false;
+}
+
+bool __fastcall cSC4ViewInputControlDemolishHooks::OnKeyDownHook(
+	cSC4ViewInputControlDemolish* pThis,
+	void* edxUnused,
+	int32_t vkCode,
+	int32_t modifiers)
+{
+	InputRecorder::ScopedEvent recordEvent(
+		inputRecorder,
+		InputRecorder::EventType::KeyDown,
+		GetRecordedToolState(pThis),
+		vkCode,
+		modifiers);
+	INSTRUMENTATION_COUNT(KeyDownCalls, 1);
+	TraceRecorder::ScopedEvent traceEvent(
+		"OnKeyDown",
+		GetSelectionCellCount(pThis),
+		static_cast<int32_t>(GetModeFlags()),
+		diagonalThickness);
+	bool handled = false;
+
+	if (pThis->IsOnTop())
+	{
+		if (vkCode == VK_ESCAPE)
+		{
+			if (demolitionScheduler.IsActive())
+			{
+				LOG_LINE(
+					LogLevel::Info,
+					"Canceled the demolition after {} of {} tiles.",
+					demolitionScheduler.GetCompletedTileCount(),
+					demolitionScheduler.GetTileCount());
+				demolitionScheduler.Cancel();
+				handled = true;
+			}
+			else if (pThis->bCellPicked)
+			{
+				TraceRecorder::ScopedEvent endInputTraceEvent("EndInput", GetSelectionCellCount(pThis));
+				pThis->EndInput();
+				previewInvalidation.Reset();
+				previewCostDelta.Reset();
+				handled = true;
+			}
+			else if (!pendingSelection.IsEmpty())
+			{
+				LOG_LINE(LogLevel::Info, "Cleared {} queued selections.", pendingSelection.GetSelectionCount());
+				ClearPendingSelection();
+				handled = true;
+			}
+		}
+		else if (vkCode == VK_RETURN && !pendingSelection.IsEmpty() && !pThis->bCellPicked)
+		{
+			CommitPendingSelection(pThis->pDemolition);
+			handled = true;
+		}
+		else if (vkCode == 'T'
+			&& (modifiers & ModifierKeyFlagAll) == (ModifierKeyFlagControl | ModifierKeyFlagShift)
+			&& TraceRecorder::GetInstance().IsRecording())
+		{
+			// Control + Shift + T writes the trace without waiting for the city to close.
+			cSC4ViewInputControlDemolishHooks::WriteTrace();
+			handled = true;
+		}
+		else
+		{
+			// Configure bulldoze modes using the B key with modifiers.
+			// Alt acts as a diagonal modifier on top of the base modes.
+			if (vkCode == 'B')
+			{
+				handled = true;
+				const uint32_t activeModifiers = modifiers & ModifierKeyFlagAll;
+				const bool isDiagonal = (activeModifiers & ModifierKeyFlagAlt) == ModifierKeyFlagAlt;
+
+				if ((activeModifiers & (ModifierKeyFlagControl | ModifierKeyFlagShift)) == (ModifierKeyFlagControl | ModifierKeyFlagShift))
+				{
+					if (occupantTypes.IsEmpty())
+					{
+						LOG_LINE(LogLevel::Info, "The occupant type mode requires an OccupantTypes list in the settings file.");
+					}
+					else
+					{
+						SetOccupantFilterOption(pThis, OccupantFilterType::OccupantTypes, isDiagonal);
+					}
+				}
+				else if (activeModifiers == ModifierKeyFlagNone)
+				{
+					SetOccupantFilterOption(pThis, OccupantFilterType::None, false);
+				}
+				else if (activeModifiers == ModifierKeyFlagAlt)
+				{
+					SetOccupantFilterOption(pThis, OccupantFilterType::None, true);
+				}
+				else if ((activeModifiers & ModifierKeyFlagControl) == ModifierKeyFlagControl)
+				{
+					SetOccupantFilterOption(
+						pThis,
+						GetNextOccupantFilterType(OccupantFilterType::Flora, OccupantFilterType::Props, isDiagonal),
+						isDiagonal);
+				}
+				else if ((activeModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift)
+				{
+					SetOccupantFilterOption(
+						pThis,
+						GetNextOccupantFilterType(OccupantFilterType::Network, OccupantFilterType::Rail, isDiagonal),
+						isDiagonal);
+				}
+
+				FlushPreview(pThis);
+			}
+		}
+	}
+
+	return handled;
+}
+
+void __fastcall cSC4ViewInputControlDemolishHooks::Activate(cSC4ViewInputControlDemolish* pThis, void* edxUnused)
+{
+	InputRecorder::ScopedEvent recordEvent(
+		inputRecorder,
+		InputRecorder::EventType::Activate,
+		GetRecordedToolState(pThis),
+		static_cast<int32_t>(pThis->cursorIID));
+	INSTRUMENTATION_COUNT(ActivateCalls, 1);
+	TraceRecorder::ScopedEvent traceEvent("Activate");
+
+	occupantFilterType = OccupantFilterType::None;
+	diagonalMode = false;
+	diagonalThickness = 1; // Reset thickness to default
+	diagonalRegionBuilder.Reset();
+	previewInvalidation.Reset();
+	previewCostDelta.Reset();
+	ClearPendingSelection();
+	workerGeometry.reset();
+	currentViewControl = pThis;
+
+	switch (pThis->cursorIID)
+	{
+	case cSC4ViewInputControlDemolishHooks::BulldozeCursorFlora:
+		occupantFilterType = OccupantFilterType::Flora;
+		break;
+	case cSC4ViewInputControlDemolishHooks::BulldozeCursorFloraDiagonal:
+		occupantFilterType = OccupantFilterType::Flora;
+		diagonalMode = true;
+		break;
+	case cSC4ViewInputControlDemolishHooks::BulldozeCursorNetwork:
+		occupantFilterType = OccupantFilterType::Network;
+		break;
+	case cSC4ViewInputControlDemolishHooks::BulldozeCursorNetworkDiagonal:
+		occupantFilterType = OccupantFilterType::Network;
+		diagonalMode = true;
+		break;
+	case cSC4ViewInputControlDemolishHooks::BulldozeCursorDefaultDiagonal:
+		diagonalMode = true;
+		break;
+	}
+}
+
+bool __fastcall cSC4ViewInputControlDemolishHooks::UpdateSelectedRegionDemolishRegion(
+	cISC4Demolition* pDemolition,
+	void* edxUnused,
+	SC4CellRegion<int32_t> const& cellRegion,
+	intptr_t unused, // Originally the privilege type, but our patch overwrote it with a placeholder value.
+	uint32_t flags,
+	bool clearZonedArea,
+	cISC4OccupantFilter* pOccupantFilter,
+	int64_t* totalCost,
+	intptr_t demolishedOccupantSet,
+	cISC4Occupant* pDemolishEffectOccupant,
+	long demolishEffectX,
+	long demolishEffectZ)
+{
+	InputRecorder::ScopedEvent recordEvent(
+		inputRecorder,
+		InputRecorder::EventType::PreviewRegion,
+		GetRecordedToolState(currentViewControl),
+		cellRegion.bounds.topLeftX,
+		cellRegion.bounds.topLeftY,
+		cellRegion.bounds.bottomRightX,
+		cellRegion.bounds.bottomRightY,
+		currentViewControl ? currentViewControl->clickX : -1,
+		currentViewControl ? currentViewControl->clickZ : -1);
+	INSTRUMENTATION_SCOPE(PreviewRegion);
+	INSTRUMENTATION_COUNT(PreviewCalls, 1);
+	TraceRecorder::ScopedEvent traceEvent(
+		"PreviewRegion",
+		GetCellCount(cellRegion),
+		static_cast<int32_t>(GetModeFlags()),
+		diagonalThickness);
+
+	// Set preview colors based on bulldoze mode
+	if (currentViewControl)
+	{
+		float floraColor[4] = { 0.38f, 0.69f, 0.38f, 0.5f };   // Green for flora/nature
+		float propColor[4] = { 0.66f, 0.45f, 0.82f, 0.5f };    // Purple for props
+		float networkColor[4] = { 0.98f, 0.60f, 0.20f, 0.5f }; // Orange for networks/infrastructure
+		float railColor[4] = { 0.80f, 0.27f, 0.24f, 0.5f };    // Red for rail
+		float normalColor[4] = { 0.30f, 0.60f, 0.85f, 0.5f };   // Blue for standard
+		
+		float* colorToUse = nullptr;
+		
+		switch (occupantFilterType)
+		{
+		case OccupantFilterType::Flora:
+			colorToUse = floraColor;
+			break;
+		case OccupantFilterType::Props:
+			colorToUse = propColor;
+			break;
+		case OccupantFilterType::Network:
+			colorToUse = networkColor;
+			break;
+		case OccupantFilterType::Rail:
+			colorToUse = railColor;
+			break;
+		case OccupantFilterType::None:
+		default:
+			colorToUse = normalColor;
+			break;
+		}
+		
+		if (colorToUse != nullptr)
+		{
+			S3DColorFloat* previewColor = &(currentViewControl->demolishOK);
+			previewColor->r = colorToUse[0];
+			previewColor->g = colorToUse[1];
+			previewColor->b = colorToUse[2];
+			previewColor->a = colorToUse[3];
+		}
+	}
+	
+	// Apply diagonal modification if enabled and we have valid view control
+	if (diagonalMode && currentViewControl && currentViewControl->pCellRegion)
+	{
+		cSC4ViewInputControlDemolish* pViewControl = currentViewControl;
+
+		// The pattern is written in place into the view control's region, which is also
+		// used to draw the preview. The builder's own region is only used if the game's
+		// region does not match the bounds we were given.
+		previewInvalidation.RecordPreview(GetPreviewStateHash(
+			cellRegion.bounds,
+			pViewControl->clickX,
+			pViewControl->clickZ));
+
+		const SC4CellRegion<int32_t>& diagonalRegion = UpdateDiagonalRegion(
+			cellRegion.bounds,
+			pViewControl->clickX,
+			pViewControl->clickZ,
+			pViewControl->pCellRegion);
+
+		// Call demolish with diagonal region for preview calculation
+		return PreviewDemolishRegion(
+			pDemolition,
+			diagonalRegion,
+			true, // sparseRegion
+			flags,
+			clearZonedArea,
+			totalCost,
+			demolishedOccupantSet,
+			pDemolishEffectOccupant,
+			demolishEffectX,
+			demolishEffectZ);
+	}
+
+	// Normal rectangular bulldoze preview
+	previewInvalidation.RecordPreview(PreviewInvalidation::HashState(
+		static_cast<uint32_t>(occupantFilterType),
+		cellRegion.bounds,
+		0));
+
+	if (incrementalPreviewCost && currentViewControl && !PreviewMergesPendingSelection(flags, clearZonedArea))
+	{
+		return PreviewRectangleDelta(
+			pDemolition,
+			cellRegion,
+			flags,
+			clearZonedArea,
+			totalCost,
+			demolishedOccupantSet);
+	}
+
+	return PreviewDemolishRegion(
+		pDemolition,
+		cellRegion,
+		false, // sparseRegion
+		flags,
+		clearZonedArea,
+		totalCost,
+		demolishedOccupantSet,
+		pDemolishEffectOccupant,
+		demolishEffectX,
+		demolishEffectZ);
+}
+
+bool __fastcall cSC4ViewInputControlDemolishHooks::OnMouseUpLDemolishRegion(
+	cISC4Demolition* pDemolition,
+	void* edxUnused,
+	SC4CellRegion<int32_t> const& cellRegion,
+	intptr_t unused, // Originally the privilege type, but our patch overwrote it with a placeholder value.
+	uint32_t flags,
+	bool clearZonedArea,
+	cISC4OccupantFilter* pOccupantFilter,
+	int64_t* totalCost,
+	intptr_t demolishedOccupantSet,
+	cISC4Occupant* pDemolishEffectOccupant,
+	long demolishEffectX,
+	long demolishEffectZ)
+{
+	InputRecorder::ScopedEvent recordEvent(
+		inputRecorder,
+		InputRecorder::EventType::DemolishRegion,
+		GetRecordedToolState(currentViewControl),
+		cellRegion.bounds.topLeftX,
+		cellRegion.bounds.topLeftY,
+		cellRegion.bounds.bottomRightX,
+		cellRegion.bounds.bottomRightY,
+		currentViewControl ? currentViewControl->clickX : -1,
+		currentViewControl ? currentViewControl->clickZ : -1);
+	INSTRUMENTATION_SCOPE(DemolishRegion);
+	INSTRUMENTATION_COUNT(DemolishCalls, 1);
+	TraceRecorder::ScopedEvent traceEvent(
+		"DemolishSelection",
+		GetCellCount(cellRegion),
+		static_cast<int32_t>(GetModeFlags()),
+		diagonalThickness);
+
+	// The selection is cleared after it is demolished.
+	previewInvalidation.Reset();
+	previewCostDelta.Reset();
+
+	// Apply diagonal modification if enabled
+	if (diagonalMode)
+	{
+		// The game's region is only reused when it is the region that is being demolished.
+		SC4CellRegion<int32_t>* pTarget = nullptr;
+
+		if (currentViewControl && currentViewControl->pCellRegion == &cellRegion)
+		{
+			pTarget = currentViewControl->pCellRegion;
+		}
+
+		const SC4CellRegion<int32_t>& diagonalRegion = UpdateDiagonalRegion(
+			cellRegion.bounds,
+			currentViewControl ? currentViewControl->clickX : -1,
+			currentViewControl ? currentViewControl->clickZ : -1,
+			pTarget);
+
+		if (QueueSelection(diagonalRegion, flags, clearZonedArea, pDemolishEffectOccupant, demolishEffectX, demolishEffectZ)
+			|| ScheduleDemolition(pDemolition, occupantFilterType, diagonalRegion, flags, clearZonedArea))
+		{
+			return true;
+		}
+
+		return DemolishRegion(
+			pDemolition,
+			true, // demolish
+			diagonalRegion,
+			1, // privilegeType
+			flags,
+			clearZonedArea,
+			totalCost,
+			demolishedOccupantSet,
+			pDemolishEffectOccupant,
+			demolishEffectX,
+			demolishEffectZ);
+	}
+
+	// Normal rectangular bulldoze execution
+	if (QueueSelection(cellRegion, flags, clearZonedArea, pDemolishEffectOccupant, demolishEffectX, demolishEffectZ)
+		|| ScheduleDemolition(pDemolition, occupantFilterType, cellRegion, flags, clearZonedArea))
+	{
+		return true;
+	}
+
+	return DemolishRegion(
+		pDemolition,
+		true, // demolish
+		cellRegion,
+		1, // privilegeType
+		flags,
+		clearZonedArea,
+		totalCost,
+		demolishedOccupantSet,
+		pDemolishEffectOccupant,
+		demolishEffectX,
+		demolishEffectZ);
+}
+
+cRZAutoRefCount<cISC4ViewInputControl> cSC4ViewInputControlDemolishHooks::CreateViewInputControl(BulldozeCursor cursor)
+{
+	cRZAutoRefCount<cISC4ViewInputControl> instance;
+
+	cSC4ViewInputControlDemolish* pControl = cSC4ViewInputControlDemolish::Create();
+
+	if (pControl)
+	{
+		instance = pControl;
+
+		// We first call Init to let SC4 set its default cursor, then we set the correct one.
+		instance->Init();
+		instance->SetCursor(cursor);
 	}
 
 	return instance;
 }
 
-bool cSC4ViewInputControlDemolishHooks::Install()
+void cSC4ViewInputControlDemolishHooks::CreateOccupantFilters()
 {
-	bool installed = false;
+	GetOccupantFilter(OccupantFilterType::Flora);
+	GetOccupantFilter(OccupantFilterType::Network);
+	GetOccupantFilter(OccupantFilterType::OccupantTypes);
+	GetOccupantFilter(OccupantFilterType::Props);
+	GetOccupantFilter(OccupantFilterType::Rail);
+}
 
-	Logger& logger = Logger::GetInstance();
-	const uint16_t gameVersion = SC4VersionDetection::GetInstance().GetGameVersion();
+void cSC4ViewInputControlDemolishHooks::OnTick()
+{
+	if (selectionWorker.IsRunning())
+	{
+		std::unique_ptr<SelectionWorker::Result> result = selectionWorker.TakeResult();
+
+		if (result)
+		{
+			workerGeometry = std::move(result);
+
+			if (workerGeometryControl)
+			{
+				FlushPreview(static_cast<cSC4ViewInputControlDemolish*>(static_cast<cISC4ViewInputControl*>(workerGeometryControl)));
+				workerGeometryControl.Reset();
+			}
+		}
+	}
+
+	RunScheduledDemolition();
+}
 
-	if (gameVersion == 641)
+void cSC4ViewInputControlDemolishHooks::StartSelectionWorker()
+{
+	if (backgroundSelectionGeometry)
+	{
+		selectionWorker.Start();
+	}
+}
+
+void cSC4ViewInputControlDemolishHooks::StopSelectionWorker()
+{
+	selectionWorker.Stop();
+	workerGeometry.reset();
+	workerGeometryControl.Reset();
+}
+
+void cSC4ViewInputControlDemolishHooks::RunScheduledDemolition()
+{
+	if (!demolitionScheduler.IsActive())
+	{
+		return;
+	}
+
+	TraceRecorder::ScopedEvent traceEvent("RunScheduledDemolition");
+
+	const size_t tileCount = demolitionScheduler.GetTileCount();
+	const size_t previousPercent = (demolitionScheduler.GetCompletedTileCount() * 100) / tileCount;
+
+	const bool remaining = demolitionScheduler.RunSlice(std::chrono::milliseconds(timeSliceBudgetMilliseconds));
+
+	const size_t percent = (demolitionScheduler.GetCompletedTileCount() * 100) / tileCount;
+
+	// The progress is only reported in the log file, the plugin does not draw it in the game.
+	if (!remaining)
+	{
+		LOG_LINE(LogLevel::Info, "Finished demolishing the selection, cost: {}", demolitionScheduler.GetTotalCost());
+	}
+	else if ((percent / 25) != (previousPercent / 25))
 	{
-		try
+		LOG_LINE(LogLevel::Info, "Demolishing the selection: {}%", percent);
+	}
+}
+
+InputRecorder::ToolState cSC4ViewInputControlDemolishHooks::GetToolState(const cSC4ViewInputControlDemolish* pControl)
+{
+	InputRecorder::ToolState state{};
+	state.modeFlags = GetModeFlags();
+	state.diagonalThickness = diagonalThickness;
+	state.cellPicked = pControl && pControl->bCellPicked != 0;
+	state.shiftDown = (GetKeyState(VK_SHIFT) & 0x8000) != 0;
+
+	return state;
+}
+
+void cSC4ViewInputControlDemolishHooks::FlushInputRecording()
+{
+	inputRecorder.Flush();
+}
+
+void cSC4ViewInputControlDemolishHooks::WriteTrace()
+{
+	TraceRecorder& traceRecorder = TraceRecorder::GetInstance();
+
+	if (traceRecorder.IsRecording())
+	{
+		if (traceRecorder.Write(FileSystem::GetTraceFilePath()))
 		{
-			Patcher::InstallJumpTableHook(0xa901d8, reinterpret_cast<uintptr_t>(&OnKeyDownHook));
-			Patcher::InstallJumpTableHook(0xa901f4, reinterpret_cast<uintptr_t>(&OnMouseWheelHook));
-			Patcher::InstallJumpTableHook(0xa901fc, reinterpret_cast<uintptr_t>(&Activate));
-			InstallUpdateSelectedRegionDemolishRegionHook();
-			InstallOnMouseUpLDemolishRegionHook();
+			LOG_LINE(LogLevel::Info, "Wrote the hook trace to {}.", FileSystem::GetTraceFilePath().filename().string());
+		}
+		else
+		{
+			Logger::GetInstance().WriteLine(LogLevel::Error, "Failed to write the hook trace file.");
+		}
+	}
+}
+
+void cSC4ViewInputControlDemolishHooks::CancelScheduledDemolition()
+{
+	demolitionScheduler.Cancel();
+}
+
+void cSC4ViewInputControlDemolishHooks::ClearPendingSelection()
+{
+	::ClearPendingSelection();
+}
+
+void cSC4ViewInputControlDemolishHooks::ReleaseOccupantFilters()
+{
+	// The counted occupants belong to the city that is being closed.
+	previewCostDelta.Reset();
+	floraOccupantFilter.Reset();
+	networkOccupantFilter.Reset();
+	occupantTypeFilter.Reset();
+	propOccupantFilter.Reset();
+	railOccupantFilter.Reset();
+}
+
+void cSC4ViewInputControlDemolishHooks::Configure(const Settings& settings)
+{
+	timeSlicedDemolition = settings.TimeSlicedDemolition();
+	timeSliceBudgetMilliseconds = settings.TimeSliceBudgetMilliseconds();
+	timeSlicedDemolitionMinimumCells = settings.TimeSlicedDemolitionMinimumCells();
+	backgroundSelectionGeometry = settings.BackgroundSelectionGeometry();
+	splitSparseDemolition = settings.SplitSparseDemolition();
+	incrementalPreviewCost = settings.IncrementalPreviewCost();
+	previewCostDelta.Reset();
+
+	const std::vector<uint32_t>& types = settings.OccupantTypes();
 
-			logger.WriteLine(LogLevel::Info, "Installed the bulldozer extensions.");
-			installed = true;
+	// The filter keeps a copy of the set, it is created again when the mode is next used.
+	occupantTypes = OccupantTypeSet(types.data(), types.size());
+	occupantTypeFilter.Reset();
+
+	Logger& logger = Logger::GetInstance();
+
+	if (settings.RecordInput() && !inputRecorder.IsRecording())
+	{
+		if (inputRecorder.Start(FileSystem::GetInputRecordingFilePath()))
+		{
+			logger.WriteLine(LogLevel::Info, "Recording the bulldoze tool input.");
 		}
-		catch (const wil::ResultException& e)
+		else
 		{
-			logger.WriteLineFormatted(
-				LogLevel::Error,
-				"Failed to install the bulldozer extensions.\n%s",
-				e.what());
+			logger.WriteLine(LogLevel::Error, "Failed to create the input recording file.");
 		}
 	}
-	else
+	else if (!settings.RecordInput() && inputRecorder.IsRecording())
 	{
-		logger.WriteLineFormatted(
+		inputRecorder.Stop();
+	}
+
+	if (settings.TraceEvents() && !TraceRecorder::GetInstance().IsRecording())
+	{
+		TraceRecorder::GetInstance().Start(TraceEventsPerThread);
+		logger.WriteLine(LogLevel::Info, "Recording a trace of the bulldoze tool hooks.");
+	}
+}
+
+bool cSC4ViewInputControlDemolishHooks::Install(const Settings& settings)
+{
+	bool installed = false;
+
+	Logger& logger = Logger::GetInstance();
+
+	try
+	{
+		// The hook sites are found in the executable instead of using the addresses of a
+		// particular game version, the hooks are only installed if every site is found.
+		HookSiteResolver resolver(reinterpret_cast<const uint8_t*>(GetModuleHandleW(nullptr)));
+		resolver.LoadCache(FileSystem::GetHookAddressCacheFilePath());
+
+		const HookSites::Addresses addresses = HookSites::Resolve(resolver);
+
+		// The hooks are installed together, if any of them fails none of them are installed.
+		PatchSet patchSet;
+
+		patchSet.AddJumpTableHook(
+			addresses.onKeyDown,
+			reinterpret_cast<uintptr_t>(&OnKeyDownHook),
+			PatchSet::GetJumpTableBytes(addresses.onKeyDownFunction));
+		patchSet.AddJumpTableHook(
+			addresses.onMouseWheel,
+			reinterpret_cast<uintptr_t>(&OnMouseWheelHook),
+			PatchSet::GetJumpTableBytes(addresses.onMouseWheelFunction));
+		patchSet.AddJumpTableHook(
+			addresses.activate,
+			reinterpret_cast<uintptr_t>(&Activate),
+			PatchSet::GetJumpTableBytes(addresses.activateFunction));
+		InstallUpdateSelectedRegionDemolishRegionHook(patchSet, addresses.updateSelectedRegionDemolishRegion);
+		InstallOnMouseUpLDemolishRegionHook(
+			patchSet,
+			addresses.onMouseUpLDemolishRegion,
+			addresses.demolishRegionFunction);
+		patchSet.Apply();
+
+		if (!resolver.SaveCache(FileSystem::GetHookAddressCacheFilePath()))
+		{
+			logger.WriteLine(LogLevel::Error, "Failed to write the hook address cache file.");
+		}
+
+		logger.WriteLine(LogLevel::Info, "Installed the bulldozer extensions.");
+		installed = true;
+
+		Configure(settings);
+	}
+	catch (const std::exception& e)
+	{
+		logger.WriteLine(
 			LogLevel::Error,
-			"Unsupported game version: %d",
-			gameVersion);
+			"Failed to install the bulldozer extensions on game version {}.\n{}",
+			SC4VersionDetection::GetInstance().GetGameVersion(),
+			e.what());
 	}
 
 	return installed;
 }
-
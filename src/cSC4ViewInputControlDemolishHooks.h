@@ -22,8 +22,16 @@
 #pragma once
 #include "cISC4ViewInputControl.h"
 #include "cRZAutoRefCount.h"
+#include "cSC4ViewInputControlDemolish.h"
+#include "InputRecorder.h"
+#include "SC4CellRegion.h"
+#include "Settings.h"
 #include <cstdint>
 
+class cISC4Demolition;
+class cISC4Occupant;
+class cISC4OccupantFilter;
+
 namespace cSC4ViewInputControlDemolishHooks
 {
 	enum BulldozeCursor : uint32_t
@@ -38,5 +46,83 @@ namespace cSC4ViewInputControlDemolishHooks
 
 	cRZAutoRefCount<cISC4ViewInputControl> CreateViewInputControl(BulldozeCursor cursor);
 
-	bool Install();
+	void CreateOccupantFilters();
+	void ReleaseOccupantFilters();
+
+	// Called once per game tick to pick up the worker thread results and run
+	// the next part of a time-sliced demolition.
+	void OnTick();
+
+	// Writes the buffered input events to the recording file.
+	void FlushInputRecording();
+
+	// Returns the tool state that is stored with each recorded input event, the
+	// replay tool compares it with the recording to check that it has not diverged.
+	InputRecorder::ToolState GetToolState(const cSC4ViewInputControlDemolish* pControl);
+
+	// Writes the hook timeline to the trace file when tracing is enabled.
+	void WriteTrace();
+
+	void StartSelectionWorker();
+	void StopSelectionWorker();
+
+	// Demolishes the next part of a time-sliced demolition and logs the progress.
+	void RunScheduledDemolition();
+	void CancelScheduledDemolition();
+
+	// Discards the selections that were queued with Shift.
+	void ClearPendingSelection();
+
+	// Applies the settings that change how the hooks behave, Install calls this
+	// after the hooks are installed.
+	void Configure(const Settings& settings);
+
+	bool Install(const Settings& settings);
+
+	// The functions that the game calls through the patched vtable entries and call sites.
+	// They are declared here so the tests can drive them without the game.
+
+	bool __fastcall OnKeyDownHook(
+		cSC4ViewInputControlDemolish* pThis,
+		void* edxUnused,
+		int32_t vkCode,
+		int32_t modifiers);
+
+	bool __fastcall OnMouseWheelHook(
+		cSC4ViewInputControlDemolish* pThis,
+		void* edxUnused,
+		int32_t x,
+		int32_t z,
+		uint32_t modifiers,
+		int32_t wheelDelta);
+
+	void __fastcall Activate(cSC4ViewInputControlDemolish* pThis, void* edxUnused);
+
+	bool __fastcall UpdateSelectedRegionDemolishRegion(
+		cISC4Demolition* pDemolition,
+		void* edxUnused,
+		SC4CellRegion<int32_t> const& cellRegion,
+		intptr_t unused,
+		uint32_t flags,
+		bool clearZonedArea,
+		cISC4OccupantFilter* pOccupantFilter,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ);
+
+	bool __fastcall OnMouseUpLDemolishRegion(
+		cISC4Demolition* pDemolition,
+		void* edxUnused,
+		SC4CellRegion<int32_t> const& cellRegion,
+		intptr_t unused,
+		uint32_t flags,
+		bool clearZonedArea,
+		cISC4OccupantFilter* pOccupantFilter,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ);
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "cRZCellMap.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <utility>
+
+namespace
+{
+	// Sizes that end in the middle of a word, on a word boundary and past it.
+	constexpr uint32_t Sizes[] = { 1, 31, 32, 33, 70 };
+
+	void FillRandom(cRZCellMap& map, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::bernoulli_distribution cellSet(0.5);
+
+		for (uint32_t row = 0; row < map.GetRowCount(); row++)
+		{
+			for (uint32_t column = 0; column < map.GetColumnCount(); column++)
+			{
+				map.SetValue(row, column, cellSet(random));
+			}
+		}
+	}
+
+	void ExpectSameCells(const cRZCellMap& actual, const cRZCellMap& expected)
+	{
+		ASSERT_EQ(actual.GetRowCount(), expected.GetRowCount());
+		ASSERT_EQ(actual.GetColumnCount(), expected.GetColumnCount());
+		ASSERT_EQ(actual.GetRowWordCount(), expected.GetRowWordCount());
+
+		for (uint32_t row = 0; row < expected.GetRowCount(); row++)
+		{
+			for (uint32_t column = 0; column < expected.GetColumnCount(); column++)
+			{
+				ASSERT_EQ(actual.GetValue(row, column), expected.GetValue(row, column))
+					<< "row: " << row << ", column: " << column;
+			}
+		}
+	}
+}
+
+TEST(CellMapTests, RowWordCountCoversThePartialWord)
+{
+	EXPECT_EQ(cRZCellMap(3, 1, false).GetRowWordCount(), 1u);
+	EXPECT_EQ(cRZCellMap(3, 32, false).GetRowWordCount(), 1u);
+	EXPECT_EQ(cRZCellMap(3, 33, false).GetRowWordCount(), 2u);
+	EXPECT_EQ(cRZCellMap(3, 70, false).GetRowWordCount(), 3u);
+}
+
+TEST(CellMapTests, CellsAreStoredInTheRowWords)
+{
+	cRZCellMap map(4, 70, false);
+
+	map.SetValue(2, 0, true);
+	map.SetValue(2, 33, true);
+	map.SetValue(3, 69, true);
+
+	EXPECT_EQ(map.GetRowWords(2)[0], 1u);
+	EXPECT_EQ(map.GetRowWords(2)[1], 2u);
+	EXPECT_EQ(map.GetRowWords(3)[2], 1u << 5);
+
+	map.GetRowWords(1)[1] = 1u << 31;
+
+	EXPECT_TRUE(map.GetValue(1, 63));
+	EXPECT_FALSE(map.GetValue(1, 62));
+
+	map.SetValue(2, 33, false);
+
+	EXPECT_EQ(map.GetRowWords(2)[1], 0u);
+}
+
+TEST(CellMapTests, CopyConstructorCopiesEveryCell)
+{
+	for (const uint32_t rows : Sizes)
+	{
+		for (const uint32_t columns : Sizes)
+		{
+			cRZCellMap source(rows, columns, false);
+			FillRandom(source, rows * 100 + columns);
+
+			const cRZCellMap copy(source);
+
+			ExpectSameCells(copy, source);
+			EXPECT_NE(copy.GetRowWords(0), source.GetRowWords(0));
+		}
+	}
+}
+
+TEST(CellMapTests, CopyAssignmentReusesTheRowsWhenTheDimensionsMatch)
+{
+	cRZCellMap source(33, 70, false);
+	FillRandom(source, 1);
+
+	cRZCellMap target(33, 70, true);
+	const uint32_t* const rowWords = target.GetRowWords(0);
+
+	target = source;
+
+	ExpectSameCells(target, source);
+	EXPECT_EQ(target.GetRowWords(0), rowWords);
+}
+
+TEST(CellMapTests, CopyAssignmentResizesTheMap)
+{
+	for (const uint32_t rows : Sizes)
+	{
+		for (const uint32_t columns : Sizes)
+		{
+			cRZCellMap source(rows, columns, false);
+			FillRandom(source, rows * 100 + columns);
+
+			cRZCellMap target(5, 40, true);
+
+			target = source;
+
+			ExpectSameCells(target, source);
+		}
+	}
+}
+
+TEST(CellMapTests, MoveLeavesTheSourceEmpty)
+{
+	cRZCellMap source(10, 40, false);
+	FillRandom(source, 2);
+
+	const cRZCellMap expected(source);
+	const uint32_t* const rowWords = source.GetRowWords(0);
+
+	cRZCellMap moved(std::move(source));
+
+	ExpectSameCells(moved, expected);
+	EXPECT_EQ(moved.GetRowWords(0), rowWords);
+	EXPECT_EQ(source.GetRowCount(), 0u);
+
+	cRZCellMap target(3, 3, true);
+
+	target = std::move(moved);
+
+	ExpectSameCells(target, expected);
+	EXPECT_EQ(moved.GetRowCount(), 0u);
+}
+
+TEST(CellMapTests, CopyCellsFromNeverReallocates)
+{
+	cRZCellMap source(33, 70, false);
+	FillRandom(source, 3);
+
+	cRZCellMap target(33, 70, true);
+	const uint32_t* const rowWords = target.GetRowWords(0);
+
+	ASSERT_TRUE(target.CopyCellsFrom(source));
+	ExpectSameCells(target, source);
+	EXPECT_EQ(target.GetRowWords(0), rowWords);
+
+	// A map with other dimensions is left unchanged.
+	const cRZCellMap expected(target);
+
+	EXPECT_FALSE(target.CopyCellsFrom(cRZCellMap(33, 69, false)));
+	EXPECT_FALSE(target.CopyCellsFrom(cRZCellMap(32, 70, false)));
+	ExpectSameCells(target, expected);
+	EXPECT_EQ(target.GetRowWords(0), rowWords);
+}
+
+TEST(CellMapTests, FillSpanSetsTheInclusiveRange)
+{
+	for (const uint32_t columns : Sizes)
+	{
+		for (uint32_t first = 0; first < columns; first += 7)
+		{
+			for (uint32_t last = first; last < columns; last += 5)
+			{
+				cRZCellMap map(2, columns, false);
+
+				map.FillSpan(1, first, last, true);
+
+				for (uint32_t column = 0; column < columns; column++)
+				{
+					ASSERT_EQ(map.GetValue(1, column), column >= first && column <= last)
+						<< "columns: " << columns << ", span: " << first << "-" << last << ", column: " << column;
+					ASSERT_FALSE(map.GetValue(0, column));
+				}
+
+				map.Fill(true);
+				map.FillSpan(1, first, last, false);
+
+				for (uint32_t column = 0; column < columns; column++)
+				{
+					ASSERT_EQ(map.GetValue(1, column), column < first || column > last);
+					ASSERT_TRUE(map.GetValue(0, column));
+				}
+			}
+		}
+	}
+}
+
+TEST(CellMapTests, ClearRowOnlyClearsThatRow)
+{
+	cRZCellMap map(3, 70, true);
+
+	map.ClearRow(1);
+
+	for (uint32_t column = 0; column < 70; column++)
+	{
+		EXPECT_TRUE(map.GetValue(0, column));
+		EXPECT_FALSE(map.GetValue(1, column));
+		EXPECT_TRUE(map.GetValue(2, column));
+	}
+}
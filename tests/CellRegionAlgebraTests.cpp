@@ -0,0 +1,277 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CellRegionAlgebra.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// The cell maps store 32 cells per word along the columns, so the column offsets and
+	// counts are picked to start and end in the middle of a word.
+	constexpr int32_t Offsets[] = { 0, 3, 31, 32, 45, -7 };
+	constexpr int32_t Sizes[] = { 1, 5, 31, 32, 33, 70 };
+
+	constexpr CellRegionAlgebra::Operation Operations[] =
+	{
+		CellRegionAlgebra::Operation::Union,
+		CellRegionAlgebra::Operation::Intersection,
+		CellRegionAlgebra::Operation::Difference,
+		CellRegionAlgebra::Operation::SymmetricDifference,
+	};
+
+	SC4CellRegion<int32_t> CreateRandomRegion(int32_t x, int32_t z, int32_t width, int32_t height, std::mt19937& random)
+	{
+		SC4CellRegion<int32_t> region(x, z, x + width - 1, z + height - 1, false);
+		std::bernoulli_distribution cellSet(0.5);
+
+		for (int32_t row = 0; row < width; row++)
+		{
+			for (int32_t column = 0; column < height; column++)
+			{
+				region.cellMap.SetValue(row, column, cellSet(random));
+			}
+		}
+
+		return region;
+	}
+
+	bool GetCell(const SC4CellRegion<int32_t>& region, int32_t x, int32_t z)
+	{
+		const SC4Rect<int32_t>& bounds = region.bounds;
+
+		if (x < bounds.topLeftX || x > bounds.bottomRightX || z < bounds.topLeftY || z > bounds.bottomRightY)
+		{
+			return false;
+		}
+
+		return region.cellMap.GetValue(x - bounds.topLeftX, z - bounds.topLeftY);
+	}
+
+	bool Combine(bool target, bool source, CellRegionAlgebra::Operation operation)
+	{
+		switch (operation)
+		{
+		case CellRegionAlgebra::Operation::Union:
+			return target || source;
+		case CellRegionAlgebra::Operation::Intersection:
+			return target && source;
+		case CellRegionAlgebra::Operation::Difference:
+			return target && !source;
+		case CellRegionAlgebra::Operation::SymmetricDifference:
+		default:
+			return target != source;
+		}
+	}
+
+	uint32_t CountCellsPerBit(const SC4CellRegion<int32_t>& region)
+	{
+		uint32_t count = 0;
+
+		for (uint32_t row = 0; row < region.cellMap.GetRowCount(); row++)
+		{
+			for (uint32_t column = 0; column < region.cellMap.GetColumnCount(); column++)
+			{
+				count += region.cellMap.GetValue(row, column) ? 1 : 0;
+			}
+		}
+
+		return count;
+	}
+
+	void ExpectSameCells(const SC4CellRegion<int32_t>& actual, const SC4CellRegion<int32_t>& expected)
+	{
+		ASSERT_EQ(actual.bounds.topLeftX, expected.bounds.topLeftX);
+		ASSERT_EQ(actual.bounds.topLeftY, expected.bounds.topLeftY);
+		ASSERT_EQ(actual.bounds.bottomRightX, expected.bounds.bottomRightX);
+		ASSERT_EQ(actual.bounds.bottomRightY, expected.bounds.bottomRightY);
+
+		for (uint32_t row = 0; row < expected.cellMap.GetRowCount(); row++)
+		{
+			for (uint32_t column = 0; column < expected.cellMap.GetColumnCount(); column++)
+			{
+				ASSERT_EQ(actual.cellMap.GetValue(row, column), expected.cellMap.GetValue(row, column))
+					<< "row: " << row << ", column: " << column;
+			}
+		}
+
+		// The unused bits of the last word must not be counted.
+		EXPECT_EQ(CellRegionAlgebra::CountCells(actual), CountCellsPerBit(expected));
+	}
+}
+
+TEST(CellRegionAlgebraTests, ApplyMatchesThePerBitReference)
+{
+	std::mt19937 random(11);
+
+	for (const CellRegionAlgebra::Operation operation : Operations)
+	{
+		for (const int32_t sourceOffset : Offsets)
+		{
+			for (const int32_t sourceSize : Sizes)
+			{
+				SCOPED_TRACE(testing::Message()
+					<< "operation: " << static_cast<uint32_t>(operation)
+					<< ", source offset: " << sourceOffset
+					<< ", source size: " << sourceSize);
+
+				SC4CellRegion<int32_t> target = CreateRandomRegion(2, 5, 40, 70, random);
+				const SC4CellRegion<int32_t> source = CreateRandomRegion(
+					sourceOffset / 2,
+					sourceOffset,
+					sourceSize,
+					sourceSize,
+					random);
+
+				SC4CellRegion<int32_t> expected = target;
+
+				for (uint32_t row = 0; row < expected.cellMap.GetRowCount(); row++)
+				{
+					for (uint32_t column = 0; column < expected.cellMap.GetColumnCount(); column++)
+					{
+						const bool sourceValue = GetCell(
+							source,
+							expected.bounds.topLeftX + static_cast<int32_t>(row),
+							expected.bounds.topLeftY + static_cast<int32_t>(column));
+
+						expected.cellMap.SetValue(
+							row,
+							column,
+							Combine(expected.cellMap.GetValue(row, column), sourceValue, operation));
+					}
+				}
+
+				CellRegionAlgebra::Apply(target, source, operation);
+
+				ExpectSameCells(target, expected);
+			}
+		}
+	}
+}
+
+TEST(CellRegionAlgebraTests, UnionMatchesThePerBitReference)
+{
+	std::mt19937 random(12);
+
+	for (const int32_t firstOffset : Offsets)
+	{
+		for (const int32_t secondOffset : Offsets)
+		{
+			for (const int32_t size : Sizes)
+			{
+				SCOPED_TRACE(testing::Message()
+					<< "first offset: " << firstOffset
+					<< ", second offset: " << secondOffset
+					<< ", size: " << size);
+
+				const SC4CellRegion<int32_t> first = CreateRandomRegion(firstOffset, firstOffset, size, 37, random);
+				const SC4CellRegion<int32_t> second = CreateRandomRegion(-secondOffset, secondOffset, 29, size, random);
+
+				SC4CellRegion<int32_t> expected(
+					(std::min)(first.bounds.topLeftX, second.bounds.topLeftX),
+					(std::min)(first.bounds.topLeftY, second.bounds.topLeftY),
+					(std::max)(first.bounds.bottomRightX, second.bounds.bottomRightX),
+					(std::max)(first.bounds.bottomRightY, second.bounds.bottomRightY),
+					false);
+
+				for (uint32_t row = 0; row < expected.cellMap.GetRowCount(); row++)
+				{
+					for (uint32_t column = 0; column < expected.cellMap.GetColumnCount(); column++)
+					{
+						const int32_t x = expected.bounds.topLeftX + static_cast<int32_t>(row);
+						const int32_t z = expected.bounds.topLeftY + static_cast<int32_t>(column);
+
+						expected.cellMap.SetValue(row, column, GetCell(first, x, z) || GetCell(second, x, z));
+					}
+				}
+
+				ExpectSameCells(CellRegionAlgebra::Union(first, second), expected);
+			}
+		}
+	}
+}
+
+TEST(CellRegionAlgebraTests, CountCellsMatchesThePerBitReference)
+{
+	std::mt19937 random(13);
+
+	for (const int32_t offset : Offsets)
+	{
+		for (const int32_t width : Sizes)
+		{
+			for (const int32_t height : Sizes)
+			{
+				const SC4CellRegion<int32_t> region = CreateRandomRegion(offset, offset, width, height, random);
+
+				EXPECT_EQ(CellRegionAlgebra::CountCells(region), CountCellsPerBit(region))
+					<< "offset: " << offset << ", width: " << width << ", height: " << height;
+			}
+		}
+	}
+
+	const SC4CellRegion<int32_t> full(3, 3, 3 + 69, 3 + 44, true);
+
+	EXPECT_EQ(CellRegionAlgebra::CountCells(full), 70u * 45u);
+}
+
+TEST(CellRegionAlgebraTests, AnyCellInRectMatchesThePerBitReference)
+{
+	std::mt19937 random(14);
+	std::uniform_int_distribution<int32_t> coordinate(-10, 80);
+
+	for (const int32_t height : Sizes)
+	{
+		// A single set cell finds the word boundary bugs that a dense region hides.
+		SC4CellRegion<int32_t> region(4, 9, 4 + 20, 9 + height - 1, false);
+		std::uniform_int_distribution<int32_t> setColumn(0, height - 1);
+
+		region.cellMap.SetValue(7, setColumn(random), true);
+
+		for (int32_t i = 0; i < 2000; i++)
+		{
+			const int32_t x1 = coordinate(random);
+			const int32_t z1 = coordinate(random);
+			const SC4Rect<int32_t> rect(
+				x1,
+				z1,
+				x1 + std::uniform_int_distribution<int32_t>(0, 40)(random),
+				z1 + std::uniform_int_distribution<int32_t>(0, 40)(random));
+
+			bool expected = false;
+
+			for (int32_t x = rect.topLeftX; x <= rect.bottomRightX && !expected; x++)
+			{
+				for (int32_t z = rect.topLeftY; z <= rect.bottomRightY && !expected; z++)
+				{
+					expected = GetCell(region, x, z);
+				}
+			}
+
+			ASSERT_EQ(CellRegionAlgebra::AnyCellInRect(region, rect), expected)
+				<< "height: " << height
+				<< ", rect: " << rect.topLeftX << ", " << rect.topLeftY
+				<< ", " << rect.bottomRightX << ", " << rect.bottomRightY;
+		}
+	}
+}
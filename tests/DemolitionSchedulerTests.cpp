@@ -0,0 +1,349 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CellRegionAlgebra.h"
+#include "DemolitionScheduler.h"
+#include "DiagonalRegion.h"
+#include "MockDemolition.h"
+#include "OccupantGrid.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+	using namespace std::chrono_literals;
+
+	constexpr int32_t CitySize = 256;
+	constexpr int32_t TileSize = 32;
+
+	// Demolishes the tiles with a MockDemolition and advances a simulated clock by a
+	// fixed time for each selected cell, so the budget checks do not depend on the
+	// speed of the machine.
+	class SimulatedDemolitionBackend
+	{
+	public:
+		explicit SimulatedDemolitionBackend(DemolitionScheduler::Clock::duration timePerCell)
+			: grid(CitySize),
+			  demolition(grid),
+			  timePerCell(timePerCell),
+			  currentTime()
+		{
+			const SC4Rect<int32_t> city(0, 0, CitySize - 1, CitySize - 1);
+
+			grid.AddForest(city, 50, 1234);
+			grid.AddBuildings(city, 7, 3);
+		}
+
+		DemolitionScheduler::TimeFunction GetTimeFunction()
+		{
+			return [this]() { return currentTime; };
+		}
+
+		DemolitionScheduler::TileFunction GetTileFunction()
+		{
+			return [this](const SC4CellRegion<int32_t>& tile)
+			{
+				int64_t cost = 0;
+
+				demolition.DemolishRegion(true, tile, 1, 0, false, nullptr, &cost, 0, nullptr, 0, 0);
+				currentTime += timePerCell * CellRegionAlgebra::CountCells(tile);
+
+				return cost;
+			};
+		}
+
+		DemolitionScheduler::Clock::time_point GetCurrentTime() const
+		{
+			return currentTime;
+		}
+
+		const OccupantGrid& GetGrid() const
+		{
+			return grid;
+		}
+
+		const MockDemolition& GetDemolition() const
+		{
+			return demolition;
+		}
+
+	private:
+		OccupantGrid grid;
+		MockDemolition demolition;
+		DemolitionScheduler::Clock::duration timePerCell;
+		DemolitionScheduler::Clock::time_point currentTime;
+	};
+
+	SC4CellRegion<int32_t> CreateSquare(int32_t left, int32_t top, int32_t size)
+	{
+		return SC4CellRegion<int32_t>(left, top, left + size - 1, top + size - 1, true);
+	}
+
+	// Runs the slices until the demolition is finished and returns the number of slices.
+	size_t RunToCompletion(DemolitionScheduler& scheduler, DemolitionScheduler::Clock::duration budget)
+	{
+		size_t slices = 0;
+
+		while (scheduler.IsActive())
+		{
+			scheduler.RunSlice(budget);
+			slices++;
+		}
+
+		return slices;
+	}
+}
+
+TEST(DemolitionSchedulerTests, TilesCoverEverySelectedCellOnce)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+	const SC4CellRegion<int32_t> region = DiagonalRegion::Create(5, 9, 204, 208, 7);
+
+	scheduler.Start(region, TileSize, backend.GetTileFunction());
+	RunToCompletion(scheduler, 1s);
+
+	const std::vector<MockDemolition::DemolishRegionCall>& calls = backend.GetDemolition().GetDemolishRegionCalls();
+	SC4CellRegion<int32_t> demolished(region.bounds.topLeftX, region.bounds.topLeftY, region.bounds.bottomRightX, region.bounds.bottomRightY, false);
+	uint64_t selectedCells = 0;
+
+	ASSERT_EQ(calls.size(), scheduler.GetTileCount());
+
+	for (const MockDemolition::DemolishRegionCall& call : calls)
+	{
+		const SC4Rect<int32_t>& tile = call.bounds;
+
+		// The tiles are aligned to the selection, and tiles without selected cells are skipped.
+		EXPECT_EQ((tile.topLeftX - region.bounds.topLeftX) % TileSize, 0);
+		EXPECT_EQ((tile.topLeftY - region.bounds.topLeftY) % TileSize, 0);
+		EXPECT_LE(tile.bottomRightX - tile.topLeftX, TileSize - 1);
+		EXPECT_LE(tile.bottomRightY - tile.topLeftY, TileSize - 1);
+		EXPECT_GT(call.selectedCellCount, 0u);
+
+		selectedCells += call.selectedCellCount;
+	}
+
+	// The tile regions do not exist after the calls, so the covered cells are rebuilt
+	// from the tile bounds.
+	for (const MockDemolition::DemolishRegionCall& call : calls)
+	{
+		SC4CellRegion<int32_t> tile(call.bounds.topLeftX, call.bounds.topLeftY, call.bounds.bottomRightX, call.bounds.bottomRightY, true);
+
+		CellRegionAlgebra::Apply(tile, region, CellRegionAlgebra::Operation::Intersection);
+		CellRegionAlgebra::Apply(demolished, tile, CellRegionAlgebra::Operation::Union);
+	}
+
+	EXPECT_EQ(selectedCells, CellRegionAlgebra::CountCells(region));
+
+	CellRegionAlgebra::Apply(demolished, region, CellRegionAlgebra::Operation::SymmetricDifference);
+	EXPECT_EQ(CellRegionAlgebra::CountCells(demolished), 0u);
+}
+
+TEST(DemolitionSchedulerTests, DemolishesEveryOccupantInTheSelection)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+	const SC4CellRegion<int32_t> region = CreateSquare(10, 20, 150);
+
+	scheduler.Start(region, TileSize, backend.GetTileFunction());
+	RunToCompletion(scheduler, 4ms);
+
+	for (int32_t x = 10; x < 160; x++)
+	{
+		for (int32_t z = 20; z < 170; z++)
+		{
+			EXPECT_TRUE(backend.GetGrid().GetOccupants(x, z).empty()) << "x: " << x << ", z: " << z;
+		}
+	}
+
+	// The buildings that cross a tile edge are only paid for once.
+	EXPECT_GT(scheduler.GetTotalCost(), 0);
+	EXPECT_EQ(scheduler.GetTotalCost(), backend.GetDemolition().GetDemolishedCost());
+}
+
+TEST(DemolitionSchedulerTests, SlicesStayWithinTheBudget)
+{
+	// A 128x128 selection has 16 full tiles that take 1024 µs each.
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+	const auto budget = 3ms;
+
+	scheduler.Start(CreateSquare(0, 0, 128), TileSize, backend.GetTileFunction());
+	ASSERT_EQ(scheduler.GetTileCount(), 16u);
+
+	size_t slices = 0;
+
+	while (scheduler.IsActive())
+	{
+		const DemolitionScheduler::Clock::time_point start = backend.GetCurrentTime();
+		const size_t completedTiles = scheduler.GetCompletedTileCount();
+
+		scheduler.RunSlice(budget);
+		slices++;
+
+		EXPECT_LE(backend.GetCurrentTime() - start, budget);
+		EXPECT_EQ(scheduler.GetCompletedTileCount() - completedTiles, 2u);
+	}
+
+	EXPECT_EQ(slices, 8u);
+}
+
+TEST(DemolitionSchedulerTests, SlicesShrinkWhenTheTilesGetSlower)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+	DemolitionScheduler::TileFunction demolishTile = backend.GetTileFunction();
+	size_t demolishedTiles = 0;
+
+	// The second half of the tiles take four times as long, as if they were full of buildings.
+	scheduler.Start(
+		CreateSquare(0, 0, 128),
+		TileSize,
+		[&](const SC4CellRegion<int32_t>& tile)
+		{
+			int64_t cost = 0;
+			const size_t repeats = demolishedTiles++ < 8 ? 1 : 4;
+
+			for (size_t i = 0; i < repeats; i++)
+			{
+				cost += demolishTile(tile);
+			}
+
+			return cost;
+		});
+
+	std::vector<size_t> tilesPerSlice;
+
+	while (scheduler.IsActive())
+	{
+		const size_t completedTiles = scheduler.GetCompletedTileCount();
+
+		scheduler.RunSlice(5ms);
+		tilesPerSlice.push_back(scheduler.GetCompletedTileCount() - completedTiles);
+	}
+
+	ASSERT_GE(tilesPerSlice.size(), 2u);
+	EXPECT_EQ(tilesPerSlice.front(), 4u);
+	EXPECT_EQ(tilesPerSlice.back(), 1u);
+}
+
+TEST(DemolitionSchedulerTests, EverySliceDemolishesAtLeastOneTile)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+
+	scheduler.Start(CreateSquare(0, 0, 128), TileSize, backend.GetTileFunction());
+
+	for (size_t i = 1; i <= 16; i++)
+	{
+		EXPECT_EQ(scheduler.RunSlice(1us), i < 16);
+		EXPECT_EQ(scheduler.GetCompletedTileCount(), i);
+	}
+
+	EXPECT_FALSE(scheduler.IsActive());
+}
+
+TEST(DemolitionSchedulerTests, ResumesWhereThePreviousSliceStopped)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+
+	scheduler.Start(CreateSquare(0, 0, 128), TileSize, backend.GetTileFunction());
+
+	EXPECT_TRUE(scheduler.RunSlice(3ms));
+
+	const std::vector<MockDemolition::DemolishRegionCall>& calls = backend.GetDemolition().GetDemolishRegionCalls();
+	const int64_t firstSliceCost = scheduler.GetTotalCost();
+
+	ASSERT_EQ(calls.size(), 2u);
+
+	EXPECT_TRUE(scheduler.RunSlice(3ms));
+	ASSERT_EQ(calls.size(), 4u);
+
+	// The second slice continues with the next tiles, none of them are demolished twice.
+	for (size_t i = 0; i < calls.size(); i++)
+	{
+		for (size_t j = i + 1; j < calls.size(); j++)
+		{
+			EXPECT_FALSE(
+				calls[i].bounds.topLeftX == calls[j].bounds.topLeftX
+				&& calls[i].bounds.topLeftY == calls[j].bounds.topLeftY);
+		}
+	}
+
+	EXPECT_GT(scheduler.GetTotalCost(), firstSliceCost);
+	EXPECT_EQ(scheduler.GetTotalCost(), backend.GetDemolition().GetDemolishedCost());
+}
+
+TEST(DemolitionSchedulerTests, CancelStopsTheDemolition)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+
+	scheduler.Start(CreateSquare(0, 0, 128), TileSize, backend.GetTileFunction());
+	scheduler.RunSlice(3ms);
+	scheduler.Cancel();
+
+	EXPECT_FALSE(scheduler.IsActive());
+	EXPECT_FALSE(scheduler.RunSlice(3ms));
+	EXPECT_EQ(backend.GetDemolition().GetDemolishRegionCalls().size(), 2u);
+	EXPECT_FALSE(backend.GetGrid().GetOccupants(127, 127).empty());
+}
+
+TEST(DemolitionSchedulerTests, StartReplacesTheDemolitionInProgress)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+
+	scheduler.Start(CreateSquare(0, 0, 128), TileSize, backend.GetTileFunction());
+	scheduler.RunSlice(3ms);
+	scheduler.Start(CreateSquare(200, 200, 40), TileSize, backend.GetTileFunction());
+
+	EXPECT_EQ(scheduler.GetTileCount(), 4u);
+	EXPECT_EQ(scheduler.GetCompletedTileCount(), 0u);
+	EXPECT_EQ(scheduler.GetTotalCost(), 0);
+
+	RunToCompletion(scheduler, 1s);
+
+	const std::vector<MockDemolition::DemolishRegionCall>& calls = backend.GetDemolition().GetDemolishRegionCalls();
+
+	ASSERT_EQ(calls.size(), 6u);
+
+	for (size_t i = 2; i < calls.size(); i++)
+	{
+		EXPECT_GE(calls[i].bounds.topLeftX, 200);
+		EXPECT_GE(calls[i].bounds.topLeftY, 200);
+	}
+}
+
+TEST(DemolitionSchedulerTests, EmptySelectionHasNoTiles)
+{
+	SimulatedDemolitionBackend backend(1us);
+	DemolitionScheduler scheduler(backend.GetTimeFunction());
+
+	scheduler.Start(SC4CellRegion<int32_t>(0, 0, 99, 99, false), TileSize, backend.GetTileFunction());
+
+	EXPECT_FALSE(scheduler.IsActive());
+	EXPECT_EQ(scheduler.GetTileCount(), 0u);
+	EXPECT_FALSE(scheduler.RunSlice(3ms));
+	EXPECT_TRUE(backend.GetDemolition().GetDemolishRegionCalls().empty());
+}
@@ -0,0 +1,169 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagonalRegionBuilder.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace
+{
+	bool RegionsMatch(const SC4CellRegion<int32_t>& expected, const SC4CellRegion<int32_t>& actual)
+	{
+		if (expected.bounds.topLeftX != actual.bounds.topLeftX
+			|| expected.bounds.topLeftY != actual.bounds.topLeftY
+			|| expected.bounds.bottomRightX != actual.bounds.bottomRightX
+			|| expected.bounds.bottomRightY != actual.bounds.bottomRightY)
+		{
+			return false;
+		}
+
+		const cRZCellMap& expectedMap = expected.cellMap;
+		const cRZCellMap& actualMap = actual.cellMap;
+
+		if (expectedMap.GetRowCount() != actualMap.GetRowCount()
+			|| expectedMap.GetColumnCount() != actualMap.GetColumnCount())
+		{
+			return false;
+		}
+
+		for (uint32_t row = 0; row < expectedMap.GetRowCount(); row++)
+		{
+			for (uint32_t column = 0; column < expectedMap.GetColumnCount(); column++)
+			{
+				if (expectedMap.GetValue(row, column) != actualMap.GetValue(row, column))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	SC4Rect<int32_t> GetDragBounds(int32_t clickX, int32_t clickZ, int32_t endX, int32_t endZ)
+	{
+		return SC4Rect<int32_t>(
+			(std::min)(clickX, endX),
+			(std::min)(clickZ, endZ),
+			(std::max)(clickX, endX),
+			(std::max)(clickZ, endZ));
+	}
+
+	SC4CellRegion<int32_t> CreateRegion(const SC4Rect<int32_t>& bounds, int32_t clickX, int32_t clickZ, int32_t thickness)
+	{
+		return DiagonalRegion::Create(
+			bounds.topLeftX,
+			bounds.topLeftY,
+			bounds.bottomRightX,
+			bounds.bottomRightY,
+			thickness,
+			clickX,
+			clickZ);
+	}
+}
+
+// A drag that grows and shrinks by a cell at a time, crosses the click point into
+// the other octants and steps the thickness, as the mouse move and wheel hooks do.
+TEST(DiagonalRegionBuilderTests, DragMatchesARebuiltRegion)
+{
+	constexpr int32_t clickX = 100;
+	constexpr int32_t clickZ = 100;
+
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<int32_t> step(-1, 1);
+	std::uniform_int_distribution<int32_t> action(0, 9);
+
+	DiagonalRegionBuilder builder;
+	int32_t endX = clickX;
+	int32_t endZ = clickZ;
+	int32_t thickness = 1;
+
+	for (int32_t i = 0; i < 3000; i++)
+	{
+		if (action(random) == 0)
+		{
+			// A wheel step skips a thickness of zero.
+			const int32_t newThickness = std::clamp(thickness + (step(random) < 0 ? -1 : 1), -9, 9);
+			thickness = newThickness == 0 ? -thickness : newThickness;
+		}
+		else
+		{
+			endX = std::clamp(endX + step(random), clickX - 40, clickX + 40);
+			endZ = std::clamp(endZ + step(random), clickZ - 40, clickZ + 40);
+		}
+
+		const SC4Rect<int32_t> bounds = GetDragBounds(clickX, clickZ, endX, endZ);
+
+		builder.Update(bounds, clickX, clickZ, thickness);
+
+		ASSERT_TRUE(RegionsMatch(CreateRegion(bounds, clickX, clickZ, thickness), builder.GetRegion()))
+			<< "step " << i << ", end (" << endX << ", " << endZ << "), thickness " << thickness;
+	}
+}
+
+TEST(DiagonalRegionBuilderTests, EveryThicknessStepMatchesARebuiltRegion)
+{
+	const SC4Rect<int32_t> bounds(10, 20, 73, 48);
+
+	DiagonalRegionBuilder builder;
+
+	for (int32_t thickness : { 1, 2, 3, 4, 5, 6, 7, 8, 9, 8, 7, 6, 5, 4, 3, 2, 1, -1, -2, -3, -4, -5, -6, -7, -8, -9, -8, -1, 1 })
+	{
+		builder.Update(bounds, 73, 20, thickness);
+
+		ASSERT_TRUE(RegionsMatch(CreateRegion(bounds, 73, 20, thickness), builder.GetRegion())) << "thickness " << thickness;
+	}
+}
+
+TEST(DiagonalRegionBuilderTests, WriteToOverwritesAMatchingRegion)
+{
+	const SC4Rect<int32_t> bounds(10, 20, 41, 35);
+
+	DiagonalRegionBuilder builder;
+	builder.Update(bounds, 10, 35, 3);
+
+	// The game's region has the rectangle selection in it.
+	SC4CellRegion<int32_t> target(10, 20, 41, 35, true);
+
+	ASSERT_TRUE(builder.WriteTo(target));
+	EXPECT_TRUE(RegionsMatch(CreateRegion(bounds, 10, 35, 3), target));
+
+	SC4CellRegion<int32_t> otherBounds(11, 20, 42, 35, true);
+
+	EXPECT_FALSE(builder.WriteTo(otherBounds));
+	EXPECT_TRUE(otherBounds.cellMap.GetValue(0, 0));
+}
+
+TEST(DiagonalRegionBuilderTests, SpanHashMatchesForTheSameCells)
+{
+	DiagonalRegionBuilder first;
+	DiagonalRegionBuilder second;
+
+	first.Update(SC4Rect<int32_t>(0, 0, 30, 20), 0, 0, 2);
+	second.Update(SC4Rect<int32_t>(50, 70, 80, 90), 50, 70, 2);
+
+	EXPECT_EQ(first.GetSpanHash(), second.GetSpanHash());
+
+	second.Update(SC4Rect<int32_t>(50, 70, 80, 90), 50, 70, 3);
+
+	EXPECT_NE(first.GetSpanHash(), second.GetSpanHash());
+}
@@ -0,0 +1,199 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagonalRegion.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	// The Bresenham line that the hooks used before DiagonalRegion, it sets each cell of
+	// the thick line with SetValue.
+	SC4CellRegion<int32_t> CreateReferenceRegion(
+		int32_t x1,
+		int32_t z1,
+		int32_t x2,
+		int32_t z2,
+		int32_t thickness,
+		int32_t startX,
+		int32_t startZ)
+	{
+		const int32_t minX = (std::min)(x1, x2);
+		const int32_t maxX = (std::max)(x1, x2);
+		const int32_t minZ = (std::min)(z1, z2);
+		const int32_t maxZ = (std::max)(z1, z2);
+
+		SC4CellRegion<int32_t> region(minX, minZ, maxX, maxZ, false);
+
+		int32_t diagStartX = minX;
+		int32_t diagStartZ = minZ;
+		int32_t diagEndX = maxX;
+		int32_t diagEndZ = maxZ;
+
+		if (startX != -1 && startZ != -1)
+		{
+			const int32_t centerX = (minX + maxX) / 2;
+			const int32_t centerZ = (minZ + maxZ) / 2;
+
+			if (startX > centerX && startZ <= centerZ)
+			{
+				diagStartX = maxX; diagStartZ = minZ;
+				diagEndX = minX; diagEndZ = maxZ;
+			}
+			else if (startX <= centerX && startZ > centerZ)
+			{
+				diagStartX = minX; diagStartZ = maxZ;
+				diagEndX = maxX; diagEndZ = minZ;
+			}
+			else if (startX > centerX && startZ > centerZ)
+			{
+				diagStartX = maxX; diagStartZ = maxZ;
+				diagEndX = minX; diagEndZ = minZ;
+			}
+		}
+
+		const int32_t dx = std::abs(diagEndX - diagStartX);
+		const int32_t dz = std::abs(diagEndZ - diagStartZ);
+		const int32_t sx = diagStartX < diagEndX ? 1 : -1;
+		const int32_t sz = diagStartZ < diagEndZ ? 1 : -1;
+		const int32_t startOffset = thickness > 0 ? 0 : thickness + 1;
+		const int32_t endOffset = thickness > 0 ? thickness - 1 : 0;
+
+		int32_t err = dx - dz;
+		int32_t currentX = diagStartX;
+		int32_t currentZ = diagStartZ;
+
+		while (true)
+		{
+			for (int32_t offset = startOffset; offset <= endOffset; offset++)
+			{
+				const int32_t cellX = (dx > dz ? currentX : currentX + offset) - minX;
+				const int32_t cellZ = (dx > dz ? currentZ + offset : currentZ) - minZ;
+
+				if (cellX >= 0 && cellX <= maxX - minX && cellZ >= 0 && cellZ <= maxZ - minZ)
+				{
+					region.cellMap.SetValue(cellX, cellZ, true);
+				}
+			}
+
+			if (currentX == diagEndX && currentZ == diagEndZ)
+			{
+				break;
+			}
+
+			const int32_t e2 = 2 * err;
+
+			if (e2 > -dz)
+			{
+				err -= dz;
+				currentX += sx;
+			}
+
+			if (e2 < dx)
+			{
+				err += dx;
+				currentZ += sz;
+			}
+		}
+
+		return region;
+	}
+
+	bool RegionsMatch(const SC4CellRegion<int32_t>& expected, const SC4CellRegion<int32_t>& actual)
+	{
+		const cRZCellMap& expectedMap = expected.cellMap;
+		const cRZCellMap& actualMap = actual.cellMap;
+
+		if (expectedMap.GetRowCount() != actualMap.GetRowCount()
+			|| expectedMap.GetColumnCount() != actualMap.GetColumnCount())
+		{
+			return false;
+		}
+
+		for (uint32_t row = 0; row < expectedMap.GetRowCount(); row++)
+		{
+			for (uint32_t column = 0; column < expectedMap.GetColumnCount(); column++)
+			{
+				if (expectedMap.GetValue(row, column) != actualMap.GetValue(row, column))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+// Every selection size up to 40x40, every start corner and every thickness the tool allows.
+TEST(DiagonalRegionTests, MatchesTheReferenceRasterizerForEveryThickness)
+{
+	constexpr int32_t MaxSize = 40;
+	constexpr int32_t MaxThickness = 9;
+
+	for (int32_t width = 1; width <= MaxSize; width++)
+	{
+		for (int32_t height = 1; height <= MaxSize; height++)
+		{
+			const int32_t x1 = 10;
+			const int32_t z1 = 20;
+			const int32_t x2 = x1 + width - 1;
+			const int32_t z2 = z1 + height - 1;
+
+			// No start point, then the click in each corner of the selection.
+			const int32_t startPoints[5][2] = { { -1, -1 }, { x1, z1 }, { x2, z1 }, { x1, z2 }, { x2, z2 } };
+
+			for (const auto& startPoint : startPoints)
+			{
+				for (int32_t thickness = -MaxThickness; thickness <= MaxThickness; thickness++)
+				{
+					if (thickness == 0)
+					{
+						continue;
+					}
+
+					const SC4CellRegion<int32_t> expected = CreateReferenceRegion(x1, z1, x2, z2, thickness, startPoint[0], startPoint[1]);
+					const SC4CellRegion<int32_t> actual = DiagonalRegion::Create(x1, z1, x2, z2, thickness, startPoint[0], startPoint[1]);
+
+					ASSERT_EQ(actual.bounds.topLeftX, x1);
+					ASSERT_EQ(actual.bounds.topLeftY, z1);
+					ASSERT_EQ(actual.bounds.bottomRightX, x2);
+					ASSERT_EQ(actual.bounds.bottomRightY, z2);
+					ASSERT_TRUE(RegionsMatch(expected, actual))
+						<< width << "x" << height << ", start (" << startPoint[0] << ", " << startPoint[1]
+						<< "), thickness " << thickness;
+				}
+			}
+		}
+	}
+}
+
+// The corners can be passed in any order.
+TEST(DiagonalRegionTests, CornerOrderDoesNotChangeTheRegion)
+{
+	const SC4CellRegion<int32_t> expected = DiagonalRegion::Create(5, 7, 30, 19, 3, 30, 7);
+
+	EXPECT_TRUE(RegionsMatch(expected, DiagonalRegion::Create(30, 19, 5, 7, 3, 30, 7)));
+	EXPECT_TRUE(RegionsMatch(expected, DiagonalRegion::Create(30, 7, 5, 19, 3, 30, 7)));
+	EXPECT_TRUE(RegionsMatch(expected, CreateReferenceRegion(5, 19, 30, 7, 3, 30, 7)));
+}
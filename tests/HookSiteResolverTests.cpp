@@ -0,0 +1,318 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ExecutableImage.h"
+#include "HookSiteResolver.h"
+#include "HookSites.h"
+#include "MockFileSystem.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	// A minimal 32-bit executable image with the run-time type information, vtables
+	// and code that the hook sites are found from.
+	class SyntheticImage
+	{
+	public:
+		static constexpr uint32_t ImageBase = 0x400000;
+		static constexpr uint32_t ImageSize = 0x10000;
+		static constexpr uint32_t CodeOffset = 0x1000;
+		static constexpr uint32_t CodeSize = 0x7000;
+		static constexpr uint32_t DataOffset = 0x8000;
+		static constexpr uint32_t DataSize = 0x8000;
+
+		static constexpr uint32_t OnMouseUpLOffset = 0x3000;
+		static constexpr uint32_t OnMouseUpLDemolishRegionOffset = 0x3040;
+		static constexpr uint32_t DemolishRegionOffset = 0x5000;
+		static constexpr uint32_t UpdateSelectedRegionDemolishRegionOffset = 0x2800;
+
+		static constexpr uint32_t ControlVTableOffset = 0x8104;
+		static constexpr uint32_t DemolitionVTableOffset = 0x8204;
+
+		SyntheticImage()
+			: data(ImageSize, 0)
+		{
+			WriteHeaders();
+
+			// int3 padding, like the space between functions.
+			std::memset(data.data() + CodeOffset, 0xCC, CodeSize);
+
+			std::vector<uint32_t> controlMethods;
+
+			for (uint32_t i = 0; i < 26; i++)
+			{
+				controlMethods.push_back(i == 18 ? OnMouseUpLOffset : 0x1000 + (i * 0x10));
+			}
+
+			AddClass(".?AVcSC4ViewInputControlDemolish@@", 0xA000, 0x9000, ControlVTableOffset, controlMethods);
+			AddClass(".?AVcSC4Demolition@@", 0xA100, 0x9100, DemolitionVTableOffset, { 0x4000, 0x4010, 0x4020, 0x4030, 0x4040, 0x4050, DemolishRegionOffset });
+
+			AddCall(OnMouseUpLDemolishRegionOffset, DemolishRegionOffset);
+			WriteBytes(UpdateSelectedRegionDemolishRegionOffset, { 0x6A, 0x01, 0x50, 0xFF, 0x52, 0x18 });
+		}
+
+		const uint8_t* GetData() const
+		{
+			return data.data();
+		}
+
+		uintptr_t GetAddress(uint32_t offset) const
+		{
+			return reinterpret_cast<uintptr_t>(data.data()) + offset;
+		}
+
+		void WriteUInt32(uint32_t offset, uint32_t value)
+		{
+			std::memcpy(data.data() + offset, &value, sizeof(value));
+		}
+
+		void WriteBytes(uint32_t offset, std::initializer_list<uint8_t> bytes)
+		{
+			std::copy(bytes.begin(), bytes.end(), data.begin() + offset);
+		}
+
+		void AddCall(uint32_t offset, uint32_t targetOffset)
+		{
+			data[offset] = 0xE8;
+			WriteUInt32(offset + 1, targetOffset - (offset + 5));
+		}
+
+		void AddClass(
+			const char* typeName,
+			uint32_t typeDescriptorOffset,
+			uint32_t locatorOffset,
+			uint32_t vtableOffset,
+			const std::vector<uint32_t>& methodOffsets)
+		{
+			// The type descriptor starts with the type_info vtable and a reserved field.
+			WriteUInt32(typeDescriptorOffset, ImageBase + 0xB000);
+			std::memcpy(data.data() + typeDescriptorOffset + 8, typeName, std::strlen(typeName) + 1);
+
+			// The complete object locator: signature, offset, constructor displacement
+			// offset, type descriptor and class hierarchy descriptor.
+			WriteUInt32(locatorOffset + 12, ImageBase + typeDescriptorOffset);
+			WriteUInt32(locatorOffset + 16, ImageBase + 0xB100);
+
+			WriteUInt32(vtableOffset - 4, ImageBase + locatorOffset);
+
+			for (size_t i = 0; i < methodOffsets.size(); i++)
+			{
+				WriteUInt32(vtableOffset + static_cast<uint32_t>(i * 4), ImageBase + methodOffsets[i]);
+			}
+		}
+
+	private:
+		void WriteHeaders()
+		{
+			constexpr uint32_t NtHeaders = 0x80;
+			constexpr uint32_t OptionalHeader = NtHeaders + 4 + 20;
+			constexpr uint32_t SectionTable = OptionalHeader + 0xE0;
+
+			WriteBytes(0, { 'M', 'Z' });
+			WriteUInt32(0x3C, NtHeaders);
+			WriteBytes(NtHeaders, { 'P', 'E', 0, 0, 0x4C, 0x01, 0x02, 0x00 });
+			data[NtHeaders + 4 + 16] = 0xE0;
+
+			WriteBytes(OptionalHeader, { 0x0B, 0x01 });
+			WriteUInt32(OptionalHeader + 16, CodeOffset);
+			WriteUInt32(OptionalHeader + 28, ImageBase);
+			WriteUInt32(OptionalHeader + 56, ImageSize);
+			WriteUInt32(OptionalHeader + 60, 0x400);
+
+			WriteSection(SectionTable, ".text", CodeOffset, CodeSize, 0x60000020);
+			WriteSection(SectionTable + 40, ".rdata", DataOffset, DataSize, 0x40000040);
+		}
+
+		void WriteSection(uint32_t offset, const char* name, uint32_t virtualAddress, uint32_t size, uint32_t characteristics)
+		{
+			std::memcpy(data.data() + offset, name, std::strlen(name));
+			WriteUInt32(offset + 8, size);
+			WriteUInt32(offset + 12, virtualAddress);
+			WriteUInt32(offset + 36, characteristics);
+		}
+
+		std::vector<uint8_t> data;
+	};
+
+	void ExpectSyntheticSites(const SyntheticImage& image, const HookSites::Addresses& addresses)
+	{
+		EXPECT_EQ(addresses.onKeyDown, image.GetAddress(SyntheticImage::ControlVTableOffset + (14 * 4)));
+		EXPECT_EQ(addresses.onMouseWheel, image.GetAddress(SyntheticImage::ControlVTableOffset + (21 * 4)));
+		EXPECT_EQ(addresses.activate, image.GetAddress(SyntheticImage::ControlVTableOffset + (23 * 4)));
+		EXPECT_EQ(addresses.onMouseUpLDemolishRegion, image.GetAddress(SyntheticImage::OnMouseUpLDemolishRegionOffset));
+		EXPECT_EQ(addresses.updateSelectedRegionDemolishRegion, image.GetAddress(SyntheticImage::UpdateSelectedRegionDemolishRegionOffset));
+		EXPECT_EQ(addresses.onKeyDownFunction, image.GetAddress(0x1000 + (14 * 0x10)));
+		EXPECT_EQ(addresses.activateFunction, image.GetAddress(0x1000 + (23 * 0x10)));
+		EXPECT_EQ(addresses.demolishRegionFunction, image.GetAddress(SyntheticImage::DemolishRegionOffset));
+	}
+}
+
+TEST(HookSiteResolverTests, ResolvesEverySiteInASyntheticImage)
+{
+	SyntheticImage image;
+	HookSiteResolver resolver(image.GetData());
+
+	ExpectSyntheticSites(image, HookSites::Resolve(resolver));
+}
+
+TEST(HookSiteResolverTests, AmbiguousSignatureIsNotResolved)
+{
+	SyntheticImage image;
+	image.WriteBytes(SyntheticImage::UpdateSelectedRegionDemolishRegionOffset + 0x100, { 0x6A, 0x01, 0x50, 0xFF, 0x52, 0x18 });
+
+	HookSiteResolver resolver(image.GetData());
+
+	EXPECT_THROW(HookSites::Resolve(resolver), std::runtime_error);
+}
+
+TEST(HookSiteResolverTests, SignatureOutsideTheScopeIsIgnored)
+{
+	SyntheticImage image;
+	// A copy far from OnMouseUpL, in the code of another class.
+	image.WriteBytes(0x6000, { 0x6A, 0x01, 0x50, 0xFF, 0x52, 0x18 });
+
+	HookSiteResolver resolver(image.GetData());
+
+	ExpectSyntheticSites(image, HookSites::Resolve(resolver));
+}
+
+TEST(HookSiteResolverTests, AmbiguousCallIsNotResolved)
+{
+	SyntheticImage image;
+	image.AddCall(SyntheticImage::OnMouseUpLDemolishRegionOffset + 0x20, SyntheticImage::DemolishRegionOffset);
+
+	HookSiteResolver resolver(image.GetData());
+	uintptr_t address = 0;
+
+	EXPECT_FALSE(resolver.ResolveCall(
+		HookSites::HookSiteOnMouseUpLDemolishRegion,
+		image.GetAddress(SyntheticImage::DemolishRegionOffset),
+		image.GetAddress(SyntheticImage::OnMouseUpLOffset),
+		0x800,
+		address));
+	EXPECT_THROW(HookSites::Resolve(resolver), std::runtime_error);
+}
+
+TEST(HookSiteResolverTests, MissingTypeInformationIsNotResolved)
+{
+	SyntheticImage image;
+	// Another class with the same name makes the type descriptor ambiguous.
+	image.AddClass(".?AVcSC4Demolition@@", 0xA200, 0x9200, 0x8304, { 0x4000 });
+
+	HookSiteResolver resolver(image.GetData());
+	uintptr_t address = 0;
+
+	EXPECT_TRUE(resolver.ResolveVirtualMethodSlot(HookSites::HookSiteOnKeyDown, ".?AVcSC4ViewInputControlDemolish@@", 14, address));
+	EXPECT_FALSE(resolver.ResolveVirtualMethodSlot(HookSites::HookSiteDemolishRegion, ".?AVcSC4Demolition@@", 6, address));
+	EXPECT_FALSE(resolver.ResolveVirtualMethodSlot(HookSites::HookSiteOnMouseUpL, ".?AVcSC4ViewInputControl@@", 18, address));
+}
+
+TEST(HookSiteResolverTests, CachedSitesAreReusedForTheSameBuild)
+{
+	const std::filesystem::path cachePath = MockFileSystem::GetDirectory() / "HookSiteResolverTests.hooks";
+	std::filesystem::create_directories(cachePath.parent_path());
+	std::filesystem::remove(cachePath);
+
+	SyntheticImage image;
+
+	{
+		HookSiteResolver resolver(image.GetData());
+		resolver.LoadCache(cachePath);
+		HookSites::Resolve(resolver);
+		ASSERT_TRUE(resolver.SaveCache(cachePath));
+	}
+
+	// The cached vtable entries are used without the type information.
+	SyntheticImage cachedImage;
+	std::memset(const_cast<uint8_t*>(cachedImage.GetData()) + 0xA000, 0, 0x200);
+
+	{
+		HookSiteResolver resolver(cachedImage.GetData());
+		resolver.LoadCache(cachePath);
+		ExpectSyntheticSites(cachedImage, HookSites::Resolve(resolver));
+	}
+
+	// A different build does not use the cached sites.
+	cachedImage.WriteBytes(SyntheticImage::CodeOffset, { 0x90 });
+
+	{
+		HookSiteResolver resolver(cachedImage.GetData());
+		resolver.LoadCache(cachePath);
+		EXPECT_THROW(HookSites::Resolve(resolver), std::runtime_error);
+	}
+
+	std::filesystem::remove(cachePath);
+}
+
+TEST(HookSiteResolverTests, BuildKeyHashesTheCode)
+{
+	SyntheticImage image;
+	const uint64_t buildKey = ExecutableImage::GetBuildKey(image.GetData());
+
+	EXPECT_NE(buildKey, 0u);
+
+	// The data sections change while the game runs.
+	image.WriteUInt32(SyntheticImage::DataOffset, 1);
+	EXPECT_EQ(ExecutableImage::GetBuildKey(image.GetData()), buildKey);
+
+	image.WriteBytes(SyntheticImage::CodeOffset + SyntheticImage::CodeSize - 1, { 0x90 });
+	EXPECT_NE(ExecutableImage::GetBuildKey(image.GetData()), buildKey);
+}
+
+// Set BULLDOZE_EXTENSIONS_GAME_IMAGE to a memory dump of the version 641 SimCity 4
+// executable, saved from its image base with the sections at their virtual addresses.
+TEST(HookSiteResolverTests, ResolvesTheVersion641SitesInADumpedImage)
+{
+	const char* path = std::getenv("BULLDOZE_EXTENSIONS_GAME_IMAGE");
+
+	if (!path)
+	{
+		GTEST_SKIP() << "BULLDOZE_EXTENSIONS_GAME_IMAGE is not set.";
+	}
+
+	std::ifstream file(path, std::ifstream::in | std::ifstream::binary);
+	ASSERT_TRUE(file) << path;
+
+	const std::vector<uint8_t> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	ASSERT_GE(image.size(), ExecutableImage::GetImageSize(image.data()));
+
+	const uint32_t imageBase = ExecutableImage::GetImageBase(image.data());
+	ASSERT_EQ(imageBase, 0x400000u);
+
+	const uintptr_t base = reinterpret_cast<uintptr_t>(image.data()) - imageBase;
+
+	HookSiteResolver resolver(image.data());
+	const HookSites::Addresses addresses = HookSites::Resolve(resolver);
+
+	EXPECT_EQ(addresses.onKeyDown, base + 0xa901d8);
+	EXPECT_EQ(addresses.onMouseWheel, base + 0xa901f4);
+	EXPECT_EQ(addresses.activate, base + 0xa901fc);
+	EXPECT_EQ(addresses.updateSelectedRegionDemolishRegion, base + 0x4b97ed);
+	EXPECT_EQ(addresses.onMouseUpLDemolishRegion, base + 0x4b9d02);
+}
@@ -0,0 +1,239 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FileSystem.h"
+#include "InputReplayer.h"
+#include "MockFileSystem.h"
+#include <Windows.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+
+using cSC4ViewInputControlDemolishHooks::BulldozeCursorDefaultDiagonal;
+using cSC4ViewInputControlDemolishHooks::BulldozeCursorFlora;
+
+namespace
+{
+	constexpr int32_t CitySize = 128;
+
+	void AddCity(MockHost& host)
+	{
+		OccupantGrid& grid = host.GetGrid();
+		const SC4Rect<int32_t> city(0, 0, CitySize - 1, CitySize - 1);
+
+		grid.AddRoadGrid(city, 16);
+		grid.AddForest(city, 60, 7);
+	}
+
+	Settings GetRecordingSettings()
+	{
+		const std::filesystem::path path = MockFileSystem::GetDirectory() / "InputReplayTests.ini";
+
+		std::filesystem::create_directories(path.parent_path());
+		{
+			std::ofstream file(path);
+			file << "[BulldozeExtensions]\n";
+			file << "RecordInput=true\n";
+		}
+
+		Settings settings;
+		settings.Load(path);
+
+		std::filesystem::remove(path);
+
+		return settings;
+	}
+
+	// Records a session that uses the rectangle, flora and diagonal modes, and
+	// returns the number of occupants that are left in the city.
+	size_t RecordSession()
+	{
+		MockHost host(CitySize, GetRecordingSettings());
+		AddCity(host);
+
+		host.Drag(2, 2, 20, 9);
+
+		host.SelectTool(BulldozeCursorFlora);
+		host.Drag(30, 30, 60, 50);
+
+		host.KeyDown('B', MockHost::ModifierAlt);
+		host.MouseDown(100, 10);
+		host.MouseMove(70, 40);
+		host.MouseWheel(120, MockHost::ModifierAlt);
+		host.MouseWheel(120, MockHost::ModifierAlt);
+		host.MouseUp();
+
+		host.MouseDown(10, 100);
+		host.MouseMove(40, 120);
+		host.KeyDown(VK_ESCAPE);
+
+		return host.GetGrid().GetOccupantCount();
+	}
+
+	std::vector<InputRecorder::Record> ReadRecording()
+	{
+		std::vector<InputRecorder::Record> records;
+
+		EXPECT_TRUE(InputRecorder::Read(FileSystem::GetInputRecordingFilePath(), records));
+
+		return records;
+	}
+
+	size_t GetTopLevelEventCount(const std::vector<InputRecorder::Record>& records)
+	{
+		return static_cast<size_t>(std::count_if(
+			records.begin(),
+			records.end(),
+			[](const InputRecorder::Record& record) { return record.nested == 0; }));
+	}
+}
+
+TEST(InputReplayTests, RecordingStoresTheToolState)
+{
+	RecordSession();
+
+	const std::vector<InputRecorder::Record> records = ReadRecording();
+	const InputRecorder::Record* pDiagonalDemolition = nullptr;
+
+	for (const InputRecorder::Record& record : records)
+	{
+		if (record.type == InputRecorder::EventType::DemolishRegion && (record.modeFlags & 0x100) != 0)
+		{
+			pDiagonalDemolition = &record;
+		}
+	}
+
+	ASSERT_NE(pDiagonalDemolition, nullptr);
+	EXPECT_EQ(pDiagonalDemolition->diagonalThickness, 3);
+	EXPECT_EQ(pDiagonalDemolition->cellPicked, 1);
+	EXPECT_EQ(pDiagonalDemolition->shiftDown, 0);
+	EXPECT_EQ(pDiagonalDemolition->values[0], 70);
+	EXPECT_EQ(pDiagonalDemolition->values[2], 100);
+	EXPECT_EQ(pDiagonalDemolition->values[4], 100);
+	EXPECT_EQ(pDiagonalDemolition->values[5], 10);
+}
+
+TEST(InputReplayTests, ReplayReproducesTheRecordedSession)
+{
+	const size_t recordedOccupantCount = RecordSession();
+	const std::vector<InputRecorder::Record> records = ReadRecording();
+
+	ASSERT_FALSE(records.empty());
+
+	MockHost host(CitySize);
+	AddCity(host);
+
+	InputReplayer replayer(host);
+	const InputReplayer::Result result = replayer.Replay(records);
+
+	EXPECT_EQ(result.eventCount, GetTopLevelEventCount(records));
+	EXPECT_EQ(result.divergedEventCount, 0u);
+	EXPECT_EQ(host.GetGrid().GetOccupantCount(), recordedOccupantCount);
+}
+
+TEST(InputReplayTests, ReplaysAreDeterministic)
+{
+	RecordSession();
+	const std::vector<InputRecorder::Record> records = ReadRecording();
+
+	std::vector<MockDemolition::DemolishRegionCall> firstCalls;
+	uint64_t firstChecksum = 0;
+
+	for (int i = 0; i < 2; i++)
+	{
+		MockHost host(CitySize);
+		AddCity(host);
+
+		InputReplayer replayer(host);
+		const InputReplayer::Result result = replayer.Replay(records);
+		const std::vector<MockDemolition::DemolishRegionCall>& calls = host.GetDemolition().GetDemolishRegionCalls();
+
+		if (i == 0)
+		{
+			firstCalls = calls;
+			firstChecksum = result.checksum;
+		}
+		else
+		{
+			EXPECT_EQ(result.checksum, firstChecksum);
+			ASSERT_EQ(calls.size(), firstCalls.size());
+
+			for (size_t j = 0; j < calls.size(); j++)
+			{
+				EXPECT_EQ(calls[j].demolish, firstCalls[j].demolish);
+				EXPECT_EQ(calls[j].selectedCellCount, firstCalls[j].selectedCellCount);
+				EXPECT_EQ(calls[j].occupantCount, firstCalls[j].occupantCount);
+				EXPECT_EQ(calls[j].cost, firstCalls[j].cost);
+			}
+		}
+	}
+}
+
+TEST(InputReplayTests, LatencyPercentilesUseTheNearestRank)
+{
+	std::vector<InputRecorder::Record> records;
+
+	for (uint32_t i = 1; i <= 100; i++)
+	{
+		InputRecorder::Record record{};
+		record.type = InputRecorder::EventType::KeyDown;
+		record.diagonalThickness = 1;
+		record.durationMicroseconds = i;
+		record.values[0] = 'Z';
+
+		records.push_back(record);
+	}
+
+	MockHost host;
+	InputReplayer replayer(host);
+	const InputReplayer::Result result = replayer.Replay(records);
+
+	ASSERT_EQ(result.statistics.size(), 1u);
+
+	const InputReplayer::EventStatistics& statistics = result.statistics[0];
+
+	EXPECT_EQ(statistics.type, InputRecorder::EventType::KeyDown);
+	EXPECT_EQ(statistics.count, 100u);
+	EXPECT_EQ(statistics.recorded.p50, 50000u);
+	EXPECT_EQ(statistics.recorded.p95, 95000u);
+	EXPECT_EQ(statistics.recorded.p99, 99000u);
+	EXPECT_LE(statistics.replayed.p50, statistics.replayed.p99);
+	EXPECT_EQ(result.divergedEventCount, 0u);
+}
+
+TEST(InputReplayTests, ReadRejectsOtherFiles)
+{
+	const std::filesystem::path path = MockFileSystem::GetDirectory() / "NotARecording.input";
+
+	std::filesystem::create_directories(path.parent_path());
+	{
+		std::ofstream file(path, std::ofstream::binary);
+		file << "SC4BXLOG";
+	}
+
+	std::vector<InputRecorder::Record> records;
+
+	EXPECT_FALSE(InputRecorder::Read(path, records));
+	EXPECT_FALSE(InputRecorder::Read(MockFileSystem::GetDirectory() / "Missing.input", records));
+
+	std::filesystem::remove(path);
+}
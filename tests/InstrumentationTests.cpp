@@ -0,0 +1,137 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "Instrumentation.h"
+#include <gtest/gtest.h>
+
+// This file is built with BULLDOZE_EXTENSIONS_INSTRUMENTATION, the logger is never
+// initialized so the summary only resets the histograms.
+class InstrumentationTests : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		Instrumentation::WriteSummary();
+	}
+
+	void TearDown() override
+	{
+		Instrumentation::WriteSummary();
+	}
+};
+
+TEST_F(InstrumentationTests, SmallDurationsHaveTheirOwnBuckets)
+{
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		EXPECT_EQ(Instrumentation::GetBucketIndex(i), i);
+		EXPECT_EQ(Instrumentation::GetBucketValue(i), i);
+	}
+}
+
+TEST_F(InstrumentationTests, BucketsAreLogLinear)
+{
+	// Each power of two range is split into 8 buckets of the same width.
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(8)), 8u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(15)), 15u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(16)), 16u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(17)), 16u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(18)), 18u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(1000)), 960u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(1024)), 1024u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(1151)), 1024u);
+	EXPECT_EQ(Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(1152)), 1152u);
+}
+
+TEST_F(InstrumentationTests, EveryBucketHoldsTheDurationsUpToTheNextBucket)
+{
+	const uint32_t lastIndex = Instrumentation::GetBucketIndex(UINT64_MAX);
+
+	for (uint32_t index = 0; index < lastIndex; index++)
+	{
+		const uint64_t lowest = Instrumentation::GetBucketValue(index);
+		const uint64_t next = Instrumentation::GetBucketValue(index + 1);
+
+		ASSERT_LT(lowest, next) << "index: " << index;
+		ASSERT_EQ(Instrumentation::GetBucketIndex(lowest), index);
+		ASSERT_EQ(Instrumentation::GetBucketIndex(next - 1), index);
+
+		// The bucket width is at most 1/8 of its lowest duration.
+		if (lowest >= 8)
+		{
+			ASSERT_LE((next - lowest) * 8, lowest) << "index: " << index;
+		}
+	}
+
+	EXPECT_EQ(Instrumentation::GetBucketIndex(Instrumentation::GetBucketValue(lastIndex)), lastIndex);
+}
+
+TEST_F(InstrumentationTests, PercentilesOfKnownDurations)
+{
+	// 1 to 100 microseconds, each recorded once.
+	for (uint64_t microseconds = 1; microseconds <= 100; microseconds++)
+	{
+		Instrumentation::RecordDuration(Instrumentation::Timer::PreviewRegion, microseconds * 1000);
+	}
+
+	const uint64_t p50 = Instrumentation::GetPercentile(Instrumentation::Timer::PreviewRegion, 50);
+	const uint64_t p99 = Instrumentation::GetPercentile(Instrumentation::Timer::PreviewRegion, 99);
+
+	EXPECT_EQ(p50, Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(50000)));
+	EXPECT_EQ(p99, Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(99000)));
+	EXPECT_LE(p50, 50000u);
+	EXPECT_GT(p50 * 8, 50000u * 7);
+	EXPECT_LE(p99, 99000u);
+	EXPECT_GT(p99 * 8, 99000u * 7);
+
+	// The other timers have their own histograms.
+	EXPECT_EQ(Instrumentation::GetPercentile(Instrumentation::Timer::DemolishRegion, 50), 0u);
+}
+
+TEST_F(InstrumentationTests, SlowOutliersOnlyMoveTheHighPercentiles)
+{
+	for (int32_t i = 0; i < 98; i++)
+	{
+		Instrumentation::RecordDuration(Instrumentation::Timer::DiagonalRegion, 200);
+	}
+
+	Instrumentation::RecordDuration(Instrumentation::Timer::DiagonalRegion, 5000000);
+	Instrumentation::RecordDuration(Instrumentation::Timer::DiagonalRegion, 5000000);
+
+	EXPECT_EQ(Instrumentation::GetPercentile(Instrumentation::Timer::DiagonalRegion, 50), 192u);
+	EXPECT_EQ(Instrumentation::GetPercentile(Instrumentation::Timer::DiagonalRegion, 90), 192u);
+	EXPECT_EQ(
+		Instrumentation::GetPercentile(Instrumentation::Timer::DiagonalRegion, 99),
+		Instrumentation::GetBucketValue(Instrumentation::GetBucketIndex(5000000)));
+}
+
+TEST_F(InstrumentationTests, SummaryResetsTheHistograms)
+{
+	Instrumentation::RecordDuration(Instrumentation::Timer::DemolishRegion, 4096);
+
+	EXPECT_EQ(Instrumentation::GetPercentile(Instrumentation::Timer::DemolishRegion, 50), 4096u);
+
+	Instrumentation::WriteSummary();
+
+	EXPECT_EQ(Instrumentation::GetPercentile(Instrumentation::Timer::DemolishRegion, 50), 0u);
+}
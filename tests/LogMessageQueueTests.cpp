@@ -0,0 +1,198 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "LogMessageQueue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	bool Push(LogMessageQueue& queue, const std::string& line)
+	{
+		return queue.TryPush(line.data(), line.size());
+	}
+
+	// Returns the next line without its new line, or an empty string if the queue is empty.
+	std::string Pop(LogMessageQueue& queue)
+	{
+		std::string output;
+
+		if (queue.TryPopAppend(output))
+		{
+			EXPECT_EQ(output.back(), '\n');
+			output.pop_back();
+		}
+
+		return output;
+	}
+}
+
+TEST(LogMessageQueueTests, LinesWrapAroundTheSlots)
+{
+	LogMessageQueue queue(4);
+
+	EXPECT_EQ(Pop(queue), "");
+
+	for (int32_t round = 0; round < 10; round++)
+	{
+		for (int32_t i = 0; i < 4; i++)
+		{
+			ASSERT_TRUE(Push(queue, "line " + std::to_string(round * 4 + i)));
+		}
+
+		EXPECT_FALSE(Push(queue, "full"));
+		EXPECT_EQ(queue.GetUnreadCount(), 4u);
+
+		for (int32_t i = 0; i < 4; i++)
+		{
+			ASSERT_EQ(Pop(queue), "line " + std::to_string(round * 4 + i));
+		}
+
+		EXPECT_EQ(Pop(queue), "");
+		EXPECT_EQ(queue.GetUnreadCount(), 0u);
+	}
+}
+
+TEST(LogMessageQueueTests, CapacityIsRoundedUpToAPowerOfTwo)
+{
+	LogMessageQueue queue(5);
+
+	for (int32_t i = 0; i < 8; i++)
+	{
+		ASSERT_TRUE(Push(queue, "line"));
+	}
+
+	EXPECT_FALSE(Push(queue, "line"));
+}
+
+// Lines longer than the 240 bytes of a slot are copied to the heap, the slot must
+// go back to its own text when it is reused for a short line.
+TEST(LogMessageQueueTests, LongLinesAreKeptWhole)
+{
+	LogMessageQueue queue(2);
+
+	const std::vector<std::string> lines =
+	{
+		std::string(240, 'a'),
+		std::string(241, 'b'),
+		"short",
+		std::string(4000, 'c'),
+		std::string(1, 'd'),
+		std::string(239, 'e'),
+		std::string(300, 'f'),
+		"",
+	};
+
+	for (const std::string& line : lines)
+	{
+		ASSERT_TRUE(Push(queue, line));
+
+		std::string output;
+
+		ASSERT_TRUE(queue.TryPopAppend(output));
+		EXPECT_EQ(output, line + '\n');
+	}
+
+	// The overflow text of a line that is never read is freed with the queue.
+	ASSERT_TRUE(Push(queue, std::string(1000, 'g')));
+}
+
+TEST(LogMessageQueueTests, EveryProducerLineArrivesOnce)
+{
+	constexpr int32_t ProducerCount = 4;
+	constexpr int32_t LinesPerProducer = 5000;
+
+	LogMessageQueue queue(64);
+	std::atomic<int32_t> runningProducers(ProducerCount);
+	std::vector<std::thread> producers;
+
+	for (int32_t producer = 0; producer < ProducerCount; producer++)
+	{
+		producers.emplace_back([&queue, &runningProducers, producer]()
+		{
+			for (int32_t i = 0; i < LinesPerProducer; i++)
+			{
+				// Every fourth line uses the overflow text.
+				std::string line = std::to_string(producer) + ' ' + std::to_string(i);
+
+				if ((i % 4) == 0)
+				{
+					line.append(300, '.');
+				}
+
+				while (!Push(queue, line))
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			runningProducers.fetch_sub(1, std::memory_order_release);
+		});
+	}
+
+	std::vector<int32_t> nextLine(ProducerCount, 0);
+	std::string output;
+
+	while (true)
+	{
+		const bool producersDone = runningProducers.load(std::memory_order_acquire) == 0;
+
+		output.clear();
+
+		if (!queue.TryPopAppend(output))
+		{
+			if (producersDone)
+			{
+				break;
+			}
+
+			std::this_thread::yield();
+			continue;
+		}
+
+		const size_t space = output.find(' ');
+		const int32_t producer = std::stoi(output.substr(0, space));
+		const int32_t line = std::stoi(output.substr(space + 1));
+
+		ASSERT_GE(producer, 0);
+		ASSERT_LT(producer, ProducerCount);
+		// The lines of one producer keep their order, so a line that arrives twice or
+		// not at all breaks the sequence.
+		ASSERT_EQ(line, nextLine[producer]);
+		nextLine[producer]++;
+	}
+
+	for (std::thread& thread : producers)
+	{
+		thread.join();
+	}
+
+	for (int32_t producer = 0; producer < ProducerCount; producer++)
+	{
+		EXPECT_EQ(nextLine[producer], LinesPerProducer);
+	}
+
+	EXPECT_EQ(queue.GetUnreadCount(), 0u);
+}
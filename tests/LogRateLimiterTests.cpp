@@ -0,0 +1,131 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "LogRateLimiter.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(LogRateLimiterTests, SuppressesLinesInsideTheInterval)
+{
+	uint64_t time = 1000;
+	LogRateLimiter limiter(100, [&time]() { return time; });
+	uint32_t suppressedCount = 0;
+
+	EXPECT_TRUE(limiter.TryAcquire(suppressedCount));
+	EXPECT_EQ(suppressedCount, 0u);
+
+	for (uint64_t offset : { 0, 1, 50, 99 })
+	{
+		time = 1000 + offset;
+		EXPECT_FALSE(limiter.TryAcquire(suppressedCount)) << "offset: " << offset;
+	}
+
+	time = 1100;
+	EXPECT_TRUE(limiter.TryAcquire(suppressedCount));
+}
+
+TEST(LogRateLimiterTests, ReportsTheSkippedLineCountOnce)
+{
+	uint64_t time = 0;
+	LogRateLimiter limiter(250, [&time]() { return time; });
+	uint32_t suppressedCount = 0;
+
+	ASSERT_TRUE(limiter.TryAcquire(suppressedCount));
+
+	for (int32_t i = 0; i < 7; i++)
+	{
+		time += 10;
+		ASSERT_FALSE(limiter.TryAcquire(suppressedCount));
+	}
+
+	// This count is written as "Skipped {} similar lines." before the next line.
+	time = 300;
+	ASSERT_TRUE(limiter.TryAcquire(suppressedCount));
+	EXPECT_EQ(suppressedCount, 7u);
+
+	time = 600;
+	ASSERT_TRUE(limiter.TryAcquire(suppressedCount));
+	EXPECT_EQ(suppressedCount, 0u);
+}
+
+TEST(LogRateLimiterTests, IntervalStartsAtTheLastWrittenLine)
+{
+	uint64_t time = 0;
+	LogRateLimiter limiter(100, [&time]() { return time; });
+	uint32_t suppressedCount = 0;
+
+	ASSERT_TRUE(limiter.TryAcquire(suppressedCount));
+
+	// A line written late pushes the next allowed time past the original interval.
+	time = 150;
+	ASSERT_TRUE(limiter.TryAcquire(suppressedCount));
+
+	time = 200;
+	EXPECT_FALSE(limiter.TryAcquire(suppressedCount));
+
+	time = 250;
+	EXPECT_TRUE(limiter.TryAcquire(suppressedCount));
+	EXPECT_EQ(suppressedCount, 1u);
+}
+
+TEST(LogRateLimiterTests, OneThreadWritesPerInterval)
+{
+	constexpr int32_t ThreadCount = 8;
+	constexpr int32_t CallsPerThread = 1000;
+
+	std::atomic<uint64_t> time = 5000;
+	LogRateLimiter limiter(1000, [&time]() { return time.load(); });
+	std::atomic<int32_t> writtenCount = 0;
+	std::vector<std::thread> threads;
+
+	for (int32_t thread = 0; thread < ThreadCount; thread++)
+	{
+		threads.emplace_back([&limiter, &writtenCount]()
+		{
+			uint32_t suppressedCount = 0;
+
+			for (int32_t i = 0; i < CallsPerThread; i++)
+			{
+				if (limiter.TryAcquire(suppressedCount))
+				{
+					writtenCount++;
+				}
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(writtenCount, 1);
+
+	time = 6000;
+	uint32_t suppressedCount = 0;
+
+	ASSERT_TRUE(limiter.TryAcquire(suppressedCount));
+	EXPECT_EQ(suppressedCount, static_cast<uint32_t>(ThreadCount * CallsPerThread - 1));
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Logger.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The logger is a process-wide singleton that can only be initialized once, so
+// this is its only test.
+TEST(LoggerTests, ShutdownWritesEveryQueuedLine)
+{
+	constexpr int32_t ThreadCount = 4;
+	constexpr int32_t LinesPerThread = 2000;
+
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "BulldozeExtensionsLoggerTests.log";
+
+	Logger& logger = Logger::GetInstance();
+	logger.Init(path, LogLevel::Info);
+	logger.StartAsyncWriter(LogOverflowPolicy::Block);
+
+	std::vector<std::thread> threads;
+
+	for (int32_t thread = 0; thread < ThreadCount; thread++)
+	{
+		threads.emplace_back([&logger, thread]()
+		{
+			for (int32_t i = 0; i < LinesPerThread; i++)
+			{
+				std::string line = std::to_string(thread) + ' ' + std::to_string(i);
+
+				// Some lines do not fit in a queue slot.
+				if ((i % 8) == 0)
+				{
+					line.append(400, '.');
+				}
+
+				logger.WriteLine(LogLevel::Info, line.c_str());
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	// The writer thread may still have queued lines, shutting down writes them.
+	logger.Shutdown();
+	logger.SetLogLevel(LogLevel::Error);
+
+	std::vector<int32_t> nextLine(ThreadCount, 0);
+	std::ifstream file(path);
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		const size_t space = line.find(' ');
+
+		ASSERT_NE(space, std::string::npos) << line;
+
+		const int32_t thread = std::stoi(line.substr(0, space));
+		const int32_t index = std::stoi(line.substr(space + 1));
+
+		ASSERT_EQ(index, nextLine[thread]) << "thread: " << thread;
+		nextLine[thread]++;
+	}
+
+	for (int32_t thread = 0; thread < ThreadCount; thread++)
+	{
+		EXPECT_EQ(nextLine[thread], LinesPerThread);
+	}
+}
@@ -0,0 +1,272 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "InputReplayer.h"
+#include "cSC4ViewInputControlDemolishHooks.h"
+#include "MockWin32.h"
+#include <Windows.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+	constexpr size_t EventTypeCount = static_cast<size_t>(InputRecorder::EventType::DemolishRegion) + 1;
+
+	constexpr uint64_t FnvOffsetBasis = 14695981039346656037ULL;
+	constexpr uint64_t FnvPrime = 1099511628211ULL;
+
+	void HashValue(uint64_t& hash, int64_t value)
+	{
+		for (size_t i = 0; i < sizeof(value); i++)
+		{
+			hash ^= static_cast<uint8_t>(value >> (i * 8));
+			hash *= FnvPrime;
+		}
+	}
+
+	uint64_t HashCalls(const std::vector<MockDemolition::DemolishRegionCall>& calls, size_t first)
+	{
+		uint64_t hash = FnvOffsetBasis;
+
+		for (size_t i = first; i < calls.size(); i++)
+		{
+			const MockDemolition::DemolishRegionCall& call = calls[i];
+
+			HashValue(hash, call.demolish);
+			HashValue(hash, call.bounds.topLeftX);
+			HashValue(hash, call.bounds.topLeftY);
+			HashValue(hash, call.bounds.bottomRightX);
+			HashValue(hash, call.bounds.bottomRightY);
+			HashValue(hash, call.selectedCellCount);
+			HashValue(hash, call.flags);
+			HashValue(hash, call.clearZonedArea);
+			HashValue(hash, call.cost);
+			HashValue(hash, call.occupantCount);
+			HashValue(hash, call.demolishEffectX);
+			HashValue(hash, call.demolishEffectZ);
+		}
+
+		return hash;
+	}
+
+	// The sample must be sorted.
+	uint64_t GetPercentile(const std::vector<uint64_t>& sortedSample, double percentile)
+	{
+		if (sortedSample.empty())
+		{
+			return 0;
+		}
+
+		const size_t rank = static_cast<size_t>(std::ceil((percentile / 100.0) * static_cast<double>(sortedSample.size())));
+
+		return sortedSample[(std::max)(rank, static_cast<size_t>(1)) - 1];
+	}
+
+	InputReplayer::Percentiles GetPercentiles(std::vector<uint64_t>& sample)
+	{
+		std::sort(sample.begin(), sample.end());
+
+		return InputReplayer::Percentiles{
+			GetPercentile(sample, 50),
+			GetPercentile(sample, 95),
+			GetPercentile(sample, 99)
+		};
+	}
+}
+
+InputReplayer::InputReplayer(MockHost& host)
+	: host(host),
+	  lastSelection(),
+	  hasLastSelection(false)
+{
+}
+
+InputReplayer::Result InputReplayer::Replay(const std::vector<InputRecorder::Record>& records)
+{
+	std::array<std::vector<uint64_t>, EventTypeCount> recordedNanoseconds;
+	std::array<std::vector<uint64_t>, EventTypeCount> replayedNanoseconds;
+
+	const size_t firstCall = host.GetDemolition().GetDemolishRegionCalls().size();
+
+	Result result{};
+
+	for (const InputRecorder::Record& record : records)
+	{
+		const size_t typeIndex = static_cast<size_t>(record.type);
+
+		// The nested events are raised again by the event that they are nested in.
+		if (typeIndex == 0 || typeIndex >= EventTypeCount || record.nested)
+		{
+			continue;
+		}
+
+		RestoreSelection(record);
+
+		if (!ToolStateMatches(record))
+		{
+			result.divergedEventCount++;
+		}
+
+		MockWin32::SetKeyDown(VK_SHIFT, record.shiftDown != 0);
+
+		const auto start = std::chrono::steady_clock::now();
+		Dispatch(record);
+		const auto end = std::chrono::steady_clock::now();
+
+		MockWin32::ReleaseAllKeys();
+		host.Tick();
+
+		recordedNanoseconds[typeIndex].push_back(static_cast<uint64_t>(record.durationMicroseconds) * 1000);
+		replayedNanoseconds[typeIndex].push_back(static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+		result.eventCount++;
+	}
+
+	for (size_t i = 1; i < EventTypeCount; i++)
+	{
+		if (!replayedNanoseconds[i].empty())
+		{
+			EventStatistics statistics{};
+			statistics.type = static_cast<InputRecorder::EventType>(i);
+			statistics.count = replayedNanoseconds[i].size();
+			statistics.recorded = GetPercentiles(recordedNanoseconds[i]);
+			statistics.replayed = GetPercentiles(replayedNanoseconds[i]);
+
+			result.statistics.push_back(statistics);
+		}
+	}
+
+	result.checksum = HashCalls(host.GetDemolition().GetDemolishRegionCalls(), firstCall);
+
+	return result;
+}
+
+const char* InputReplayer::GetEventTypeName(InputRecorder::EventType type)
+{
+	switch (type)
+	{
+	case InputRecorder::EventType::Activate:
+		return "Activate";
+	case InputRecorder::EventType::KeyDown:
+		return "KeyDown";
+	case InputRecorder::EventType::MouseWheel:
+		return "MouseWheel";
+	case InputRecorder::EventType::PreviewRegion:
+		return "PreviewRegion";
+	case InputRecorder::EventType::DemolishRegion:
+		return "DemolishRegion";
+	default:
+		return "Unknown";
+	}
+}
+
+InputReplayer::Selection InputReplayer::GetSelection(const InputRecorder::Record& record)
+{
+	const int32_t minX = record.values[0];
+	const int32_t minZ = record.values[1];
+	const int32_t maxX = record.values[2];
+	const int32_t maxZ = record.values[3];
+	const int32_t clickX = record.values[4];
+	const int32_t clickZ = record.values[5];
+
+	// The hooks record -1 when the click is unknown.
+	if (clickX < 0 || clickZ < 0)
+	{
+		return Selection{ minX, minZ, maxX, maxZ };
+	}
+
+	// The cursor is at the selection corner that is opposite to the click.
+	return Selection{
+		clickX,
+		clickZ,
+		clickX == minX ? maxX : minX,
+		clickZ == minZ ? maxZ : minZ
+	};
+}
+
+void InputReplayer::RestoreSelection(const InputRecorder::Record& record)
+{
+	MockViewInputControlDemolish& control = host.GetControl();
+
+	if (record.type == InputRecorder::EventType::PreviewRegion
+		|| record.type == InputRecorder::EventType::DemolishRegion)
+	{
+		lastSelection = GetSelection(record);
+		hasLastSelection = true;
+
+		control.SetSelection(lastSelection.clickX, lastSelection.clickZ, lastSelection.cursorX, lastSelection.cursorZ);
+	}
+}
+
+bool InputReplayer::ToolStateMatches(const InputRecorder::Record& record)
+{
+	MockViewInputControlDemolish& control = host.GetControl();
+
+	const InputRecorder::ToolState state = cSC4ViewInputControlDemolishHooks::GetToolState(&control);
+	const bool cellPicked = record.cellPicked != 0;
+
+	const bool matches = state.modeFlags == record.modeFlags
+		&& state.diagonalThickness == record.diagonalThickness
+		&& state.cellPicked == cellPicked;
+
+	// The recording has no mouse button events, so a selection that the user started
+	// or released without a preview is restored here to keep following the recording.
+	if (state.cellPicked != cellPicked)
+	{
+		if (!cellPicked)
+		{
+			control.EndInputImpl();
+		}
+		else if (hasLastSelection)
+		{
+			control.SetSelection(lastSelection.clickX, lastSelection.clickZ, lastSelection.cursorX, lastSelection.cursorZ);
+		}
+	}
+
+	return matches;
+}
+
+void InputReplayer::Dispatch(const InputRecorder::Record& record)
+{
+	MockViewInputControlDemolish& control = host.GetControl();
+
+	switch (record.type)
+	{
+	case InputRecorder::EventType::Activate:
+		host.SelectTool(static_cast<cSC4ViewInputControlDemolishHooks::BulldozeCursor>(record.values[0]));
+		break;
+	case InputRecorder::EventType::KeyDown:
+		host.KeyDown(record.values[0], static_cast<uint32_t>(record.values[1]));
+		break;
+	case InputRecorder::EventType::MouseWheel:
+		host.MouseWheel(record.values[3], static_cast<uint32_t>(record.values[2]));
+		break;
+	case InputRecorder::EventType::PreviewRegion:
+		control.UpdateSelectedRegion();
+		break;
+	case InputRecorder::EventType::DemolishRegion:
+		control.OnMouseUpL(control.cellPointX, static_cast<uint32_t>(control.cellPointZ));
+		break;
+	}
+}
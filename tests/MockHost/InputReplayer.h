@@ -0,0 +1,91 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "InputRecorder.h"
+#include "MockHost.h"
+#include <cstdint>
+#include <vector>
+
+// Feeds a recorded input stream back into the hooks of a mock host.
+//
+// The events are replayed in order without waiting for their timestamps, and the
+// recording has no mouse button events, so the selections are restored from the
+// recorded preview and demolition bounds. With the default settings the hooks run
+// on the calling thread and every replay of the same records in the same city
+// makes the same DemolishRegion calls. The nested events are not replayed on their
+// own, the hook that raised them raises them again.
+class InputReplayer
+{
+public:
+	// The nearest-rank percentiles of the event latencies, in nanoseconds.
+	struct Percentiles
+	{
+		uint64_t p50;
+		uint64_t p95;
+		uint64_t p99;
+	};
+
+	struct EventStatistics
+	{
+		InputRecorder::EventType type;
+		size_t count;
+		Percentiles recorded;
+		Percentiles replayed;
+	};
+
+	struct Result
+	{
+		// The events that were replayed, without the nested events.
+		size_t eventCount;
+		// The events where the tool state differed from the recorded state.
+		size_t divergedEventCount;
+		// A hash of the DemolishRegion calls that the replay made.
+		uint64_t checksum;
+		std::vector<EventStatistics> statistics;
+	};
+
+	explicit InputReplayer(MockHost& host);
+
+	Result Replay(const std::vector<InputRecorder::Record>& records);
+
+	static const char* GetEventTypeName(InputRecorder::EventType type);
+
+private:
+	struct Selection
+	{
+		int32_t clickX;
+		int32_t clickZ;
+		int32_t cursorX;
+		int32_t cursorZ;
+	};
+
+	static Selection GetSelection(const InputRecorder::Record& record);
+
+	void RestoreSelection(const InputRecorder::Record& record);
+	bool ToolStateMatches(const InputRecorder::Record& record);
+	void Dispatch(const InputRecorder::Record& record);
+
+	MockHost& host;
+	Selection lastSelection;
+	bool hasLastSelection;
+};
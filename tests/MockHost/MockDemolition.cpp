@@ -0,0 +1,246 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MockDemolition.h"
+#include "cISC4OccupantFilter.h"
+#include <algorithm>
+
+MockDemolition::MockDemolition(OccupantGrid& grid)
+	: grid(grid),
+	  demolishRegionCalls(),
+	  selectedOccupants(),
+	  cellsVisited(0),
+	  cellsScanned(0),
+	  filterInvocations(0),
+	  demolishedOccupantCount(0),
+	  demolishedCost(0),
+	  refCount(0)
+{
+}
+
+const std::vector<MockDemolition::DemolishRegionCall>& MockDemolition::GetDemolishRegionCalls() const
+{
+	return demolishRegionCalls;
+}
+
+size_t MockDemolition::GetDemolishRegionCallCount(bool demolish) const
+{
+	return static_cast<size_t>(std::count_if(
+		demolishRegionCalls.begin(),
+		demolishRegionCalls.end(),
+		[demolish](const DemolishRegionCall& call) { return call.demolish == demolish; }));
+}
+
+uint64_t MockDemolition::GetCellsVisited() const
+{
+	return cellsVisited;
+}
+
+uint64_t MockDemolition::GetCellsScanned() const
+{
+	return cellsScanned;
+}
+
+uint64_t MockDemolition::GetFilterInvocations() const
+{
+	return filterInvocations;
+}
+
+uint64_t MockDemolition::GetDemolishedOccupantCount() const
+{
+	return demolishedOccupantCount;
+}
+
+int64_t MockDemolition::GetDemolishedCost() const
+{
+	return demolishedCost;
+}
+
+void MockDemolition::ResetCounters()
+{
+	demolishRegionCalls.clear();
+	cellsVisited = 0;
+	cellsScanned = 0;
+	filterInvocations = 0;
+	demolishedOccupantCount = 0;
+	demolishedCost = 0;
+}
+
+bool MockDemolition::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	*ppvObj = nullptr;
+	return false;
+}
+
+uint32_t MockDemolition::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t MockDemolition::Release()
+{
+	return refCount > 0 ? --refCount : 0;
+}
+
+bool MockDemolition::Init()
+{
+	return true;
+}
+
+bool MockDemolition::Shutdown()
+{
+	return true;
+}
+
+void MockDemolition::SetDefaultOccupantFilter(cISC4OccupantFilter* pFilter)
+{
+}
+
+bool MockDemolition::DemolishRegion(
+	bool demolish,
+	SC4CellRegion<int32_t> const& cellRegion,
+	int32_t privilegeType,
+	uint32_t flags,
+	bool clearZonedArea,
+	cISC4OccupantFilter* pOccupantFilter,
+	int64_t* totalCost,
+	intptr_t demolishedOccupantSet,
+	cISC4Occupant* pDemolishEffectOccupant,
+	long demolishEffectX,
+	long demolishEffectZ)
+{
+	DemolishRegionCall call{};
+	call.demolish = demolish;
+	call.pCellRegion = &cellRegion;
+	call.bounds = cellRegion.bounds;
+	call.privilegeType = privilegeType;
+	call.flags = flags;
+	call.clearZonedArea = clearZonedArea;
+	call.pOccupantFilter = pOccupantFilter;
+	call.hasTotalCost = totalCost != nullptr;
+	call.pDemolishEffectOccupant = pDemolishEffectOccupant;
+	call.demolishEffectX = demolishEffectX;
+	call.demolishEffectZ = demolishEffectZ;
+
+	selectedOccupants.clear();
+
+	OccupantSet* const pSharedOccupants = reinterpret_cast<OccupantSet*>(demolishedOccupantSet);
+	const SC4Rect<int32_t>& bounds = cellRegion.bounds;
+	const uint32_t rowCount = cellRegion.cellMap.GetRowCount();
+	const uint32_t columnCount = cellRegion.cellMap.GetColumnCount();
+
+	cellsScanned += static_cast<uint64_t>(rowCount) * columnCount;
+
+	for (uint32_t row = 0; row < rowCount; row++)
+	{
+		for (uint32_t column = 0; column < columnCount; column++)
+		{
+			if (!cellRegion.cellMap.GetValue(row, column))
+			{
+				continue;
+			}
+
+			call.selectedCellCount++;
+			cellsVisited++;
+
+			const int32_t x = bounds.topLeftX + static_cast<int32_t>(row);
+			const int32_t z = bounds.topLeftY + static_cast<int32_t>(column);
+
+			for (MockOccupant* pOccupant : grid.GetOccupants(x, z))
+			{
+				bool included = true;
+
+				if (pOccupantFilter)
+				{
+					filterInvocations++;
+					included = pOccupantFilter->IsOccupantIncluded(pOccupant);
+				}
+
+				if (included
+					&& (!pSharedOccupants || !pSharedOccupants->contains(pOccupant))
+					&& selectedOccupants.insert(pOccupant).second)
+				{
+					call.cost += pOccupant->GetDemolitionCost();
+				}
+			}
+		}
+	}
+
+	call.occupantCount = static_cast<uint32_t>(selectedOccupants.size());
+
+	if (pSharedOccupants)
+	{
+		pSharedOccupants->insert(selectedOccupants.begin(), selectedOccupants.end());
+	}
+
+	if (totalCost)
+	{
+		*totalCost += call.cost;
+	}
+
+	if (demolish)
+	{
+		for (MockOccupant* pOccupant : selectedOccupants)
+		{
+			grid.Remove(pOccupant);
+		}
+
+		demolishedOccupantCount += selectedOccupants.size();
+		demolishedCost += call.cost;
+	}
+
+	demolishRegionCalls.push_back(call);
+	selectedOccupants.clear();
+
+	return call.occupantCount > 0;
+}
+
+bool MockDemolition::DemolishLots(bool demolish, SC4List<cISC4Lot*> const& lots, int32_t privilegeType, uint32_t flags, bool clearZonedArea, cISC4OccupantFilter* pOccupantFilter, int64_t* totalCost, intptr_t demolishedOccupantSet)
+{
+	return false;
+}
+
+bool MockDemolition::DemolishOccupant(bool demolish, cISC4Occupant* pOccupant, int32_t privilegeType, uint32_t flags, int64_t* totalCost, bool excludeNetworks, SC4List<cISC4Occupant*>* demolishedOccupants)
+{
+	return false;
+}
+
+int32_t MockDemolition::ModifyTerrainHeight(bool unknown1, bool unknown2, int unknown3, int unknown4, int unknown5, int unknown6, float unknown7, cISC4Lot* unknown8, uint32_t unknown9, int64_t* totalCost)
+{
+	return 0;
+}
+
+void MockDemolition::DoDemolishOccupantEffect(cISC4Occupant* unknown1, uint32_t unknown2, cISC4Lot* unknown3, bool unknown4, long unknown5, long unknown6)
+{
+}
+
+void MockDemolition::DoDemolishGroupEffect(uint32_t unknown1, int unknown2, int unknown3, SC4Rect<int32_t> const& unknown4)
+{
+}
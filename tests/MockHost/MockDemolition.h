@@ -0,0 +1,113 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cISC4Demolition.h"
+#include "OccupantGrid.h"
+#include "SC4CellRegion.h"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// Demolishes the occupants of an OccupantGrid and records every DemolishRegion call.
+//
+// The occupants are visited once for each selected cell they cover, and the filter
+// is called for each of those visits, like the game. An occupant that covers several
+// selected cells is only counted once per call.
+class MockDemolition : public cISC4Demolition
+{
+public:
+	// The demolished occupant set that a caller can pass to DemolishRegion, the layout of
+	// the game's set is not known. The occupants that are already in the set are not
+	// counted again, and the occupants that a call selects are added to it.
+	using OccupantSet = std::unordered_set<MockOccupant*>;
+
+	struct DemolishRegionCall
+	{
+		bool demolish;
+		// The region that was passed to the call, it is only valid during the call.
+		const SC4CellRegion<int32_t>* pCellRegion;
+		SC4Rect<int32_t> bounds;
+		uint32_t selectedCellCount;
+		int32_t privilegeType;
+		uint32_t flags;
+		bool clearZonedArea;
+		cISC4OccupantFilter* pOccupantFilter;
+		bool hasTotalCost;
+		int64_t cost;
+		uint32_t occupantCount;
+		cISC4Occupant* pDemolishEffectOccupant;
+		long demolishEffectX;
+		long demolishEffectZ;
+	};
+
+	explicit MockDemolition(OccupantGrid& grid);
+
+	const std::vector<DemolishRegionCall>& GetDemolishRegionCalls() const;
+	size_t GetDemolishRegionCallCount(bool demolish) const;
+
+	// The number of selected cells that were visited.
+	uint64_t GetCellsVisited() const;
+	// The number of cells inside the bounds of the regions, the game checks each of them.
+	uint64_t GetCellsScanned() const;
+	uint64_t GetFilterInvocations() const;
+	uint64_t GetDemolishedOccupantCount() const;
+	int64_t GetDemolishedCost() const;
+
+	void ResetCounters();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init() override;
+	bool Shutdown() override;
+	void SetDefaultOccupantFilter(cISC4OccupantFilter* pFilter) override;
+	bool DemolishRegion(
+		bool demolish,
+		SC4CellRegion<int32_t> const& cellRegion,
+		int32_t privilegeType,
+		uint32_t flags,
+		bool clearZonedArea,
+		cISC4OccupantFilter* pOccupantFilter,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ) override;
+	bool DemolishLots(bool demolish, SC4List<cISC4Lot*> const& lots, int32_t privilegeType, uint32_t flags, bool clearZonedArea, cISC4OccupantFilter* pOccupantFilter, int64_t* totalCost, intptr_t demolishedOccupantSet) override;
+	bool DemolishOccupant(bool demolish, cISC4Occupant* pOccupant, int32_t privilegeType, uint32_t flags, int64_t* totalCost, bool excludeNetworks, SC4List<cISC4Occupant*>* demolishedOccupants) override;
+	int32_t ModifyTerrainHeight(bool unknown1, bool unknown2, int unknown3, int unknown4, int unknown5, int unknown6, float unknown7, cISC4Lot* unknown8, uint32_t unknown9, int64_t* totalCost) override;
+	void DoDemolishOccupantEffect(cISC4Occupant* unknown1, uint32_t unknown2, cISC4Lot* unknown3, bool unknown4, long unknown5, long unknown6) override;
+	void DoDemolishGroupEffect(uint32_t unknown1, int unknown2, int unknown3, SC4Rect<int32_t> const& unknown4) override;
+
+private:
+	OccupantGrid& grid;
+	std::vector<DemolishRegionCall> demolishRegionCalls;
+	std::unordered_set<MockOccupant*> selectedOccupants;
+	uint64_t cellsVisited;
+	uint64_t cellsScanned;
+	uint64_t filterInvocations;
+	uint64_t demolishedOccupantCount;
+	int64_t demolishedCost;
+	uint32_t refCount;
+};
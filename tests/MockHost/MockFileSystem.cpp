@@ -0,0 +1,81 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MockFileSystem.h"
+#include "FileSystem.h"
+
+namespace
+{
+	std::filesystem::path& Directory()
+	{
+		static std::filesystem::path directory = std::filesystem::temp_directory_path() / "sc4-bulldoze-extensions-tests";
+
+		return directory;
+	}
+
+	std::filesystem::path GetFilePath(const char* fileName)
+	{
+		std::filesystem::create_directories(Directory());
+
+		return Directory() / fileName;
+	}
+}
+
+void MockFileSystem::SetDirectory(const std::filesystem::path& directory)
+{
+	Directory() = directory;
+}
+
+const std::filesystem::path& MockFileSystem::GetDirectory()
+{
+	return Directory();
+}
+
+std::filesystem::path FileSystem::GetConfigFilePath()
+{
+	return GetFilePath("SC4BulldozeExtensions.ini");
+}
+
+std::filesystem::path FileSystem::GetHookAddressCacheFilePath()
+{
+	return GetFilePath("SC4BulldozeExtensions.hooks");
+}
+
+std::filesystem::path FileSystem::GetInputRecordingFilePath()
+{
+	return GetFilePath("SC4BulldozeExtensions.input");
+}
+
+std::filesystem::path FileSystem::GetLogFilePath()
+{
+	return GetFilePath("SC4BulldozeExtensions.log");
+}
+
+std::filesystem::path FileSystem::GetMappedLogFilePath()
+{
+	return GetFilePath("SC4BulldozeExtensions.ringlog");
+}
+
+std::filesystem::path FileSystem::GetTraceFilePath()
+{
+	return GetFilePath("SC4BulldozeExtensions.trace.json");
+}
@@ -0,0 +1,139 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MockHost.h"
+#include "MockWin32.h"
+#include <Windows.h>
+
+MockHost::MockHost(int32_t citySize)
+	: MockHost(citySize, Settings())
+{
+}
+
+MockHost::MockHost(int32_t citySize, const Settings& settings)
+	: grid(citySize),
+	  demolition(grid),
+	  control(&demolition)
+{
+	MockWin32::ReleaseAllKeys();
+	ResetHookState();
+	// Selecting the tool resets the mode that the previous host left behind, it is
+	// done before the settings start an input recording so the recording starts
+	// from the default mode.
+	SelectTool(cSC4ViewInputControlDemolishHooks::BulldozeCursorDefault);
+	cSC4ViewInputControlDemolishHooks::Configure(settings);
+	cSC4ViewInputControlDemolishHooks::CreateOccupantFilters();
+	cSC4ViewInputControlDemolishHooks::StartSelectionWorker();
+}
+
+MockHost::~MockHost()
+{
+	ResetHookState();
+	cSC4ViewInputControlDemolishHooks::Configure(Settings());
+	MockWin32::ReleaseAllKeys();
+}
+
+OccupantGrid& MockHost::GetGrid()
+{
+	return grid;
+}
+
+MockDemolition& MockHost::GetDemolition()
+{
+	return demolition;
+}
+
+MockViewInputControlDemolish& MockHost::GetControl()
+{
+	return control;
+}
+
+void MockHost::SelectTool(cSC4ViewInputControlDemolishHooks::BulldozeCursor cursor)
+{
+	control.SetCursor(cursor);
+	control.Activate();
+}
+
+bool MockHost::KeyDown(int32_t virtualKeyCode, uint32_t modifiers)
+{
+	SetModifierKeys(modifiers);
+	const bool handled = control.OnKeyDown(virtualKeyCode, modifiers);
+	SetModifierKeys(ModifierNone);
+
+	return handled;
+}
+
+bool MockHost::MouseWheel(int32_t wheelDelta, uint32_t modifiers)
+{
+	SetModifierKeys(modifiers);
+	const bool handled = control.OnMouseWheel(control.cellPointX, control.cellPointZ, modifiers, wheelDelta);
+	SetModifierKeys(ModifierNone);
+
+	return handled;
+}
+
+void MockHost::MouseDown(int32_t x, int32_t z)
+{
+	control.OnMouseDownL(x, static_cast<uint32_t>(z));
+}
+
+void MockHost::MouseMove(int32_t x, int32_t z, uint32_t modifiers)
+{
+	SetModifierKeys(modifiers);
+	control.OnMouseMove(x, z, modifiers);
+	SetModifierKeys(ModifierNone);
+}
+
+void MockHost::MouseUp(uint32_t modifiers)
+{
+	// The hooks read the Shift key state when the mouse button is released.
+	SetModifierKeys(modifiers);
+	control.OnMouseUpL(control.cellPointX, static_cast<uint32_t>(control.cellPointZ));
+	SetModifierKeys(ModifierNone);
+}
+
+void MockHost::Drag(int32_t x1, int32_t z1, int32_t x2, int32_t z2, uint32_t modifiers)
+{
+	MouseDown(x1, z1);
+	MouseMove(x2, z2, modifiers);
+	MouseUp(modifiers);
+}
+
+void MockHost::Tick()
+{
+	cSC4ViewInputControlDemolishHooks::OnTick();
+}
+
+void MockHost::ResetHookState()
+{
+	cSC4ViewInputControlDemolishHooks::CancelScheduledDemolition();
+	cSC4ViewInputControlDemolishHooks::StopSelectionWorker();
+	cSC4ViewInputControlDemolishHooks::ClearPendingSelection();
+	cSC4ViewInputControlDemolishHooks::ReleaseOccupantFilters();
+}
+
+void MockHost::SetModifierKeys(uint32_t modifiers)
+{
+	MockWin32::SetKeyDown(VK_SHIFT, (modifiers & ModifierShift) != 0);
+	MockWin32::SetKeyDown(VK_CONTROL, (modifiers & ModifierControl) != 0);
+	MockWin32::SetKeyDown(VK_MENU, (modifiers & ModifierAlt) != 0);
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cSC4ViewInputControlDemolishHooks.h"
+#include "MockDemolition.h"
+#include "MockViewInputControlDemolish.h"
+#include "OccupantGrid.h"
+#include "Settings.h"
+#include <cstdint>
+
+// A city with a bulldoze tool that runs the plugin's hooks.
+//
+// The hooks keep their state in globals, so only one host should exist at a time.
+// The host resets that state when it is created and when it is destroyed.
+class MockHost
+{
+public:
+	enum ModifierKeys : uint32_t
+	{
+		ModifierNone = 0,
+		ModifierShift = 0x1,
+		ModifierControl = 0x2,
+		ModifierAlt = 0x4,
+	};
+
+	explicit MockHost(int32_t citySize = 256);
+	MockHost(int32_t citySize, const Settings& settings);
+	~MockHost();
+
+	MockHost(const MockHost&) = delete;
+	MockHost& operator=(const MockHost&) = delete;
+
+	OccupantGrid& GetGrid();
+	MockDemolition& GetDemolition();
+	MockViewInputControlDemolish& GetControl();
+
+	// Selects the tool with the specified cursor, like the game does when the
+	// user picks a bulldoze mode from the menu.
+	void SelectTool(cSC4ViewInputControlDemolishHooks::BulldozeCursor cursor);
+
+	bool KeyDown(int32_t virtualKeyCode, uint32_t modifiers = ModifierNone);
+	bool MouseWheel(int32_t wheelDelta, uint32_t modifiers = ModifierNone);
+
+	void MouseDown(int32_t x, int32_t z);
+	void MouseMove(int32_t x, int32_t z, uint32_t modifiers = ModifierNone);
+	void MouseUp(uint32_t modifiers = ModifierNone);
+
+	// Drags a selection from the first cell to the second and releases the mouse.
+	void Drag(int32_t x1, int32_t z1, int32_t x2, int32_t z2, uint32_t modifiers = ModifierNone);
+
+	// Runs a game tick, which picks up the worker results and runs the time-sliced demolition.
+	void Tick();
+
+private:
+	void ResetHookState();
+	void SetModifierKeys(uint32_t modifiers);
+
+	OccupantGrid grid;
+	MockDemolition demolition;
+	MockViewInputControlDemolish control;
+};
@@ -0,0 +1,603 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MockOccupant.h"
+
+MockOccupant::MockOccupant(uint32_t type, const SC4Rect<int32_t>& cells, int64_t demolitionCost)
+	: type(type),
+	  cells(cells),
+	  demolitionCost(demolitionCost),
+	  refCount(0),
+	  queryInterfaceCount(0)
+{
+}
+
+MockOccupant::~MockOccupant()
+{
+}
+
+const SC4Rect<int32_t>& MockOccupant::GetCells() const
+{
+	return cells;
+}
+
+int64_t MockOccupant::GetDemolitionCost() const
+{
+	return demolitionCost;
+}
+
+uint32_t MockOccupant::GetRefCount() const
+{
+	return refCount;
+}
+
+uint32_t MockOccupant::GetQueryInterfaceCount() const
+{
+	return queryInterfaceCount;
+}
+
+bool MockOccupant::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	queryInterfaceCount++;
+
+	if (riid == GZIID_cISC4Occupant || riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cISC4Occupant*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	*ppvObj = nullptr;
+	return false;
+}
+
+uint32_t MockOccupant::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t MockOccupant::Release()
+{
+	return refCount > 0 ? --refCount : 0;
+}
+
+bool MockOccupant::Init(void)
+{
+	return true;
+}
+
+bool MockOccupant::Shutdown(void)
+{
+	return true;
+}
+
+bool MockOccupant::IsInitialized(void)
+{
+	return true;
+}
+
+int32_t MockOccupant::GetType(void)
+{
+	return static_cast<int32_t>(type);
+}
+
+bool MockOccupant::GetBoundingCityCells(SC4Rect<long>& sRect)
+{
+	sRect.topLeftX = cells.topLeftX;
+	sRect.topLeftY = cells.topLeftY;
+	sRect.bottomRightX = cells.bottomRightX;
+	sRect.bottomRightY = cells.bottomRightY;
+
+	return true;
+}
+
+cISCPropertyHolder* MockOccupant::AsPropertyHolder(void)
+{
+	return nullptr;
+}
+
+bool MockOccupant::GetPosition(cS3DVector3* pVector)
+{
+	return false;
+}
+
+bool MockOccupant::SetPosition(cS3DVector3 const* pVector)
+{
+	return false;
+}
+
+cS3DVector3* MockOccupant::GetBoundingBox(cS3DVector3* pTopLeftVec, cS3DVector3* pBottomRightVec)
+{
+	return nullptr;
+}
+
+uint32_t MockOccupant::SetRemovalFlags(uint32_t dwFlags)
+{
+	return 0;
+}
+
+uint32_t MockOccupant::UnsetRemovalFlags(uint32_t dwFlags)
+{
+	return 0;
+}
+
+bool MockOccupant::CanRemove(uint32_t dwFlags)
+{
+	return false;
+}
+
+bool MockOccupant::PostOccupantMessage(uint32_t dwMessageID, uint32_t dwData)
+{
+	return false;
+}
+
+uint32_t MockOccupant::GetHighlight(void)
+{
+	return 0;
+}
+
+bool MockOccupant::SetHighlight(uint32_t dwHighlight, bool bSendMessageNow)
+{
+	return false;
+}
+
+uint8_t MockOccupant::SetVisibility(bool bVisible, bool bSendMessage)
+{
+	return 0;
+}
+
+cISC43DPlaceableObject* MockOccupant::GetPlaceableObject(void)
+{
+	return nullptr;
+}
+
+cISC43DPlaceableObject* MockOccupant::GetOrCreatePlaceableObject(void)
+{
+	return nullptr;
+}
+
+cISC43DPlaceableObject* MockOccupant::SetPlaceableObject(cISC43DPlaceableObject* pObject)
+{
+	return nullptr;
+}
+
+bool MockOccupant::IsOccupantGroup(uint32_t dwGroup)
+{
+	return false;
+}
+
+bool MockOccupant::AddOccupantGroup(uint32_t dwGroup)
+{
+	return false;
+}
+
+bool MockOccupant::GetOccupantGroups(std::set<uint32_t>& sGroups)
+{
+	return false;
+}
+
+bool MockOccupant::GetOccupantManagerBBox(uint8_t* cBoxArray)
+{
+	return false;
+}
+
+bool MockOccupant::SetOccupantManagerBBox(uint8_t* cBoxArray)
+{
+	return false;
+}
+
+bool MockOccupant::GetLotTag(uint32_t& dwLotTag)
+{
+	return false;
+}
+
+bool MockOccupant::SetLotTag(uint32_t dwLotTag)
+{
+	return false;
+}
+
+uint32_t MockOccupant::SetFlag(uint32_t dwFlags)
+{
+	return 0;
+}
+
+cISC4Occupant* MockOccupant::SetAllFlags(uint32_t dwFlags)
+{
+	return nullptr;
+}
+
+uint32_t MockOccupant::ClearFlag(uint32_t dwFlags)
+{
+	return 0;
+}
+
+bool MockOccupant::IsFlagSet(uint32_t dwFlags)
+{
+	return false;
+}
+
+uint32_t MockOccupant::GetFlags(void)
+{
+	return 0;
+}
+
+MockNetworkOccupant::MockNetworkOccupant(const SC4Rect<int32_t>& cells, uint32_t networkFlags, int64_t demolitionCost)
+	: MockOccupant(MockOccupantType::Network, cells, demolitionCost),
+	  networkFlags(networkFlags)
+{
+}
+
+uint32_t MockNetworkOccupant::GetNetworkFlags() const
+{
+	return networkFlags;
+}
+
+bool MockNetworkOccupant::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4NetworkOccupant)
+	{
+		queryInterfaceCount++;
+		*ppvObj = static_cast<cISC4NetworkOccupant*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return MockOccupant::QueryInterface(riid, ppvObj);
+}
+
+uint32_t MockNetworkOccupant::AddRef()
+{
+	return MockOccupant::AddRef();
+}
+
+uint32_t MockNetworkOccupant::Release()
+{
+	return MockOccupant::Release();
+}
+
+bool MockNetworkOccupant::Init(float const unknownArray[3])
+{
+	return true;
+}
+
+bool MockNetworkOccupant::Shutdown()
+{
+	return true;
+}
+
+bool MockNetworkOccupant::HasNetworkFlag(uint32_t flag) const
+{
+	return (networkFlags & flag) == flag;
+}
+
+bool MockNetworkOccupant::HasAnyNetworkFlag(uint32_t flag) const
+{
+	return (networkFlags & flag) != 0;
+}
+
+uint32_t MockNetworkOccupant::GetNetworkFlag()
+{
+	return networkFlags;
+}
+
+bool MockNetworkOccupant::IsOfType(cISC4NetworkOccupant::eNetworkType type) const
+{
+	return (networkFlags & (1U << type)) != 0;
+}
+
+cISC4Occupant* MockNetworkOccupant::AsOccupant()
+{
+	return this;
+}
+
+int64_t MockNetworkOccupant::GetCostOfDemolition()
+{
+	return demolitionCost;
+}
+
+bool MockNetworkOccupant::IsManagedGlobally() const
+{
+	return false;
+}
+
+bool MockNetworkOccupant::CheckForRetrofit()
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetRetrofitFlag(bool value)
+{
+}
+
+void MockNetworkOccupant::SetNetworkFlag(uint32_t flag)
+{
+}
+
+void MockNetworkOccupant::ClearNetworkFlag(uint32_t flag)
+{
+}
+
+bool MockNetworkOccupant::GetConnectionNodeEdgeTypes(uint32_t& unknown1, uint32_t& unknown2)
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetConnectionNodeEdgeTypes(uint32_t unknown1, uint32_t unknown2)
+{
+}
+
+uint32_t MockNetworkOccupant::GetConnectionPathIDOverride()
+{
+	return 0;
+}
+
+void MockNetworkOccupant::SetConnectionPathIDOverride(uint32_t unknown1)
+{
+}
+
+bool MockNetworkOccupant::IsImmovable() const
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetImmovable(bool value)
+{
+}
+
+bool MockNetworkOccupant::IsUsable() const
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetUsable(bool value)
+{
+}
+
+bool MockNetworkOccupant::IsPlaced()
+{
+	return false;
+}
+
+uint32_t MockNetworkOccupant::PieceId() const
+{
+	return 0;
+}
+
+uint8_t MockNetworkOccupant::GetRotation() const
+{
+	return 0;
+}
+
+uint8_t MockNetworkOccupant::GetFlip() const
+{
+	return 0;
+}
+
+uint8_t MockNetworkOccupant::GetRotationAndFlip() const
+{
+	return 0;
+}
+
+void MockNetworkOccupant::SetVariation(uint8_t value)
+{
+}
+
+uint8_t MockNetworkOccupant::GetVariation()
+{
+	return 0;
+}
+
+void MockNetworkOccupant::SetUnderTexture(uint32_t value)
+{
+}
+
+void MockNetworkOccupant::SetQuadDraw(uint32_t unknown1, uint8_t unknown2)
+{
+}
+
+void MockNetworkOccupant::AddPart(float const unknown1[3], float const unknown2[2], uint32_t const* unknown3, uint32_t unknown4)
+{
+}
+
+bool MockNetworkOccupant::HasViewDependentModel()
+{
+	return false;
+}
+
+void MockNetworkOccupant::GetModelInstances(int32_t unknown1, int32_t unknown2, cIS3DModelInstance** unknown3, int32_t unknown4, int32_t* unknown5)
+{
+}
+
+void MockNetworkOccupant::GetVertexHeights(float unknown1[4]) const
+{
+}
+
+float MockNetworkOccupant::GetVertexHeight(int32_t unknown1) const
+{
+	return 0.0f;
+}
+
+void MockNetworkOccupant::SetVertexHeights(float const unknown1[4])
+{
+}
+
+void MockNetworkOccupant::SetEdgeTypesFlag(cISC4NetworkOccupant::eNetworkType type, uint32_t unknown2)
+{
+}
+
+uint32_t MockNetworkOccupant::GetEdgeTypesFlag(cISC4NetworkOccupant::eNetworkType type)
+{
+	return 0;
+}
+
+void MockNetworkOccupant::SetEdgeType(cISC4NetworkOccupant::eNetworkType type, int32_t unknown2, uint8_t unknown3)
+{
+}
+
+uint32_t MockNetworkOccupant::GetActiveEdges()
+{
+	return 0;
+}
+
+uint32_t MockNetworkOccupant::GetActiveEdgesForType(cISC4NetworkOccupant::eNetworkType type)
+{
+	return 0;
+}
+
+uint32_t MockNetworkOccupant::GetActiveEdgesForTypeNoGroup(cISC4NetworkOccupant::eNetworkType type)
+{
+	return 0;
+}
+
+uint32_t MockNetworkOccupant::GetGroupedEdges()
+{
+	return 0;
+}
+
+void MockNetworkOccupant::SetEdgeStore(cSC4EdgeConnectionStore const& unknown1)
+{
+}
+
+cSC4EdgeConnectionStore* MockNetworkOccupant::GetEdgeStore() const
+{
+	return nullptr;
+}
+
+void MockNetworkOccupant::MarkLightingUpdateNeeded()
+{
+}
+
+bool MockNetworkOccupant::ConnectsToNeighbor(int32_t unknown1, cISC4NetworkOccupant::eNetworkType type)
+{
+	return false;
+}
+
+intptr_t MockNetworkOccupant::GetPathInfo()
+{
+	return 0;
+}
+
+void MockNetworkOccupant::ReleasePathInfo()
+{
+}
+
+void MockNetworkOccupant::SetPathIDOverride(uint32_t unknown1)
+{
+}
+
+uint32_t MockNetworkOccupant::GetPathIDOverride()
+{
+	return 0;
+}
+
+void MockNetworkOccupant::AddPathConnection(uint32_t pathType, uint8_t unknown2, uint8_t unknown3)
+{
+}
+
+bool MockNetworkOccupant::PathConnectionExists(uint32_t pathType, uint8_t unknown2, uint8_t unknown3)
+{
+	return false;
+}
+
+bool MockNetworkOccupant::IsIntersection() const
+{
+	return false;
+}
+
+float MockNetworkOccupant::GetAltitude(float unknown1, float unknown2) const
+{
+	return 0.0f;
+}
+
+float MockNetworkOccupant::GetNormal(float unknown1, float unknown2) const
+{
+	return 0.0f;
+}
+
+void MockNetworkOccupant::SetTranslucency(bool unknown1, uint8_t unknown2)
+{
+}
+
+void MockNetworkOccupant::GetOccupiedCell(uint32_t& unknown1, uint32_t& unknown2)
+{
+}
+
+bool MockNetworkOccupant::IsLit() const
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetLit(bool unknown1)
+{
+}
+
+bool MockNetworkOccupant::CanBeLit() const
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetCostOfDemolition(int64_t value)
+{
+}
+
+void MockNetworkOccupant::TransformNode(cS3DVector3& vector)
+{
+}
+
+bool MockNetworkOccupant::IsPartOfTheSameStructure(cISC4NetworkOccupant* unknown1)
+{
+	return false;
+}
+
+bool MockNetworkOccupant::GetPassageCeiling(float& unknown1)
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetPassageCeiling(float unknown1)
+{
+}
+
+uint8_t MockNetworkOccupant::GetOneWayDirections()
+{
+	return 0;
+}
+
+void MockNetworkOccupant::SetOneWayDirections(uint8_t unknown1)
+{
+}
+
+bool MockNetworkOccupant::GetComplexPieceOrigin(long& unknown1, long& unknown2)
+{
+	return false;
+}
+
+void MockNetworkOccupant::SetComplexPieceOrigin(long unknown1, long unknown2)
+{
+}
+
+bool MockNetworkOccupant::IsSupportPylonPresent() const
+{
+	return false;
+}
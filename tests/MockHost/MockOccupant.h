@@ -0,0 +1,183 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cISC4NetworkOccupant.h"
+#include "cISC4Occupant.h"
+#include "SC4Rect.h"
+#include <cstdint>
+
+// The occupant types that the plugin's filters test for.
+namespace MockOccupantType
+{
+	constexpr uint32_t Building = 0x278128A0;
+	constexpr uint32_t Flora = 0x74758926;
+	constexpr uint32_t Network = 0x088E1962;
+	constexpr uint32_t Prop = 0x2A499F85;
+}
+
+// An occupant that covers a rectangle of city cells.
+// The occupants are owned by the OccupantGrid, the reference count is only tracked
+// so the tests can check that the plugin releases the interfaces it queries.
+class MockOccupant : public cISC4Occupant
+{
+public:
+	MockOccupant(uint32_t type, const SC4Rect<int32_t>& cells, int64_t demolitionCost);
+	virtual ~MockOccupant();
+
+	const SC4Rect<int32_t>& GetCells() const;
+	int64_t GetDemolitionCost() const;
+	uint32_t GetRefCount() const;
+	uint32_t GetQueryInterfaceCount() const;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init(void) override;
+	bool Shutdown(void) override;
+	bool IsInitialized(void) override;
+	cISCPropertyHolder* AsPropertyHolder(void) override;
+	int32_t GetType(void) override;
+	bool GetPosition(cS3DVector3* pVector) override;
+	bool SetPosition(cS3DVector3 const* pVector) override;
+	cS3DVector3* GetBoundingBox(cS3DVector3* pTopLeftVec, cS3DVector3* pBottomRightVec) override;
+	bool GetBoundingCityCells(SC4Rect<long>& sRect) override;
+	uint32_t SetRemovalFlags(uint32_t dwFlags) override;
+	uint32_t UnsetRemovalFlags(uint32_t dwFlags) override;
+	bool CanRemove(uint32_t dwFlags) override;
+	bool PostOccupantMessage(uint32_t dwMessageID, uint32_t dwData) override;
+	uint32_t GetHighlight(void) override;
+	bool SetHighlight(uint32_t dwHighlight, bool bSendMessageNow) override;
+	uint8_t SetVisibility(bool bVisible, bool bSendMessage) override;
+	cISC43DPlaceableObject* GetPlaceableObject(void) override;
+	cISC43DPlaceableObject* GetOrCreatePlaceableObject(void) override;
+	cISC43DPlaceableObject* SetPlaceableObject(cISC43DPlaceableObject* pObject) override;
+	bool IsOccupantGroup(uint32_t dwGroup) override;
+	bool AddOccupantGroup(uint32_t dwGroup) override;
+	bool GetOccupantGroups(std::set<uint32_t>& sGroups) override;
+	bool GetOccupantManagerBBox(uint8_t* cBoxArray) override;
+	bool SetOccupantManagerBBox(uint8_t* cBoxArray) override;
+	bool GetLotTag(uint32_t& dwLotTag) override;
+	bool SetLotTag(uint32_t dwLotTag) override;
+	uint32_t SetFlag(uint32_t dwFlags) override;
+	cISC4Occupant* SetAllFlags(uint32_t dwFlags) override;
+	uint32_t ClearFlag(uint32_t dwFlags) override;
+	bool IsFlagSet(uint32_t dwFlags) override;
+	uint32_t GetFlags(void) override;
+
+protected:
+	uint32_t type;
+	SC4Rect<int32_t> cells;
+	int64_t demolitionCost;
+	uint32_t refCount;
+	uint32_t queryInterfaceCount;
+};
+
+class MockNetworkOccupant : public MockOccupant, public cISC4NetworkOccupant
+{
+public:
+	MockNetworkOccupant(const SC4Rect<int32_t>& cells, uint32_t networkFlags, int64_t demolitionCost);
+
+	uint32_t GetNetworkFlags() const;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	using MockOccupant::Init;
+
+	bool Init(float const unknownArray[3]) override;
+	bool Shutdown() override;
+	bool IsManagedGlobally() const override;
+	bool CheckForRetrofit() override;
+	void SetRetrofitFlag(bool value) override;
+	bool HasNetworkFlag(uint32_t flag) const override;
+	bool HasAnyNetworkFlag(uint32_t flag) const override;
+	void SetNetworkFlag(uint32_t flag) override;
+	void ClearNetworkFlag(uint32_t flag) override;
+	uint32_t GetNetworkFlag() override;
+	bool GetConnectionNodeEdgeTypes(uint32_t& unknown1, uint32_t& unknown2) override;
+	void SetConnectionNodeEdgeTypes(uint32_t unknown1, uint32_t unknown2) override;
+	uint32_t GetConnectionPathIDOverride() override;
+	void SetConnectionPathIDOverride(uint32_t unknown1) override;
+	bool IsImmovable() const override;
+	void SetImmovable(bool value) override;
+	bool IsUsable() const override;
+	void SetUsable(bool value) override;
+	bool IsPlaced() override;
+	bool IsOfType(eNetworkType type) const override;
+	uint32_t PieceId() const override;
+	uint8_t GetRotation() const override;
+	uint8_t GetFlip() const override;
+	uint8_t GetRotationAndFlip() const override;
+	void SetVariation(uint8_t value) override;
+	uint8_t GetVariation() override;
+	void SetUnderTexture(uint32_t value) override;
+	void SetQuadDraw(uint32_t unknown1, uint8_t unknown2) override;
+	void AddPart(float const unknown1[3], float const unknown2[2], uint32_t const* unknown3, uint32_t unknown4) override;
+	bool HasViewDependentModel() override;
+	void GetModelInstances(int32_t unknown1, int32_t unknown2, cIS3DModelInstance** unknown3, int32_t unknown4, int32_t* unknown5) override;
+	void GetVertexHeights(float unknown1[4]) const override;
+	float GetVertexHeight(int32_t unknown1) const override;
+	void SetVertexHeights(float const unknown1[4]) override;
+	void SetEdgeTypesFlag(eNetworkType type, uint32_t unknown2) override;
+	uint32_t GetEdgeTypesFlag(eNetworkType type) override;
+	void SetEdgeType(eNetworkType type, int32_t unknown2, uint8_t unknown3) override;
+	uint32_t GetActiveEdges() override;
+	uint32_t GetActiveEdgesForType(eNetworkType type) override;
+	uint32_t GetActiveEdgesForTypeNoGroup(eNetworkType type) override;
+	uint32_t GetGroupedEdges() override;
+	void SetEdgeStore(cSC4EdgeConnectionStore const& unknown1) override;
+	cSC4EdgeConnectionStore* GetEdgeStore() const override;
+	void MarkLightingUpdateNeeded() override;
+	bool ConnectsToNeighbor(int32_t unknown1, eNetworkType type) override;
+	cISC4Occupant* AsOccupant() override;
+	intptr_t GetPathInfo() override;
+	void ReleasePathInfo() override;
+	void SetPathIDOverride(uint32_t unknown1) override;
+	uint32_t GetPathIDOverride() override;
+	void AddPathConnection(uint32_t pathType, uint8_t unknown2, uint8_t unknown3) override;
+	bool PathConnectionExists(uint32_t pathType, uint8_t unknown2, uint8_t unknown3) override;
+	bool IsIntersection() const override;
+	float GetAltitude(float unknown1, float unknown2) const override;
+	float GetNormal(float unknown1, float unknown2) const override;
+	void SetTranslucency(bool unknown1, uint8_t unknown2) override;
+	void GetOccupiedCell(uint32_t& unknown1, uint32_t& unknown2) override;
+	bool IsLit() const override;
+	void SetLit(bool unknown1) override;
+	bool CanBeLit() const override;
+	int64_t GetCostOfDemolition() override;
+	void SetCostOfDemolition(int64_t value) override;
+	void TransformNode(cS3DVector3& vector) override;
+	bool IsPartOfTheSameStructure(class cISC4NetworkOccupant* unknown1) override;
+	bool GetPassageCeiling(float& unknown1) override;
+	void SetPassageCeiling(float unknown1) override;
+	uint8_t GetOneWayDirections() override;
+	void SetOneWayDirections(uint8_t unknown1) override;
+	bool GetComplexPieceOrigin(long& unknown1, long& unknown2) override;
+	void SetComplexPieceOrigin(long unknown1, long unknown2) override;
+	bool IsSupportPylonPresent() const override;
+
+private:
+	uint32_t networkFlags;
+};
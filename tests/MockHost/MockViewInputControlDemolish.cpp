@@ -0,0 +1,354 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MockViewInputControlDemolish.h"
+#include "cSC4ViewInputControlDemolishHooks.h"
+#include <algorithm>
+
+namespace
+{
+	MockViewInputControlDemolish* AsMock(cSC4ViewInputControlDemolish* pControl)
+	{
+		return static_cast<MockViewInputControlDemolish*>(pControl);
+	}
+}
+
+MockViewInputControlDemolish::MockViewInputControlDemolish(cISC4Demolition* pDemolition)
+	: cSC4ViewInputControlDemolish(),
+	  region(),
+	  demolishEffectOccupant(0, SC4Rect<int32_t>(0, 0, 0, 0), 0),
+	  previewOccupants(),
+	  previewCost(0),
+	  previewResult(false),
+	  onTop(true),
+	  updateSelectedRegionCount(0),
+	  endInputCount(0)
+{
+	this->pDemolition = pDemolition;
+	bInitialized = 1;
+}
+
+MockViewInputControlDemolish::~MockViewInputControlDemolish()
+{
+}
+
+void MockViewInputControlDemolish::SetOnTop(bool value)
+{
+	onTop = value;
+}
+
+void MockViewInputControlDemolish::SetSelection(int32_t clickX, int32_t clickZ, int32_t cursorX, int32_t cursorZ)
+{
+	bCellPicked = 1;
+	this->clickX = clickX;
+	this->clickZ = clickZ;
+	lotMinX = lotMaxX = clickX;
+	lotMinZ = lotMaxZ = clickZ;
+
+	SetSelectedCells(cursorX, cursorZ);
+}
+
+int64_t MockViewInputControlDemolish::GetPreviewCost() const
+{
+	return previewCost;
+}
+
+bool MockViewInputControlDemolish::GetPreviewResult() const
+{
+	return previewResult;
+}
+
+uint32_t MockViewInputControlDemolish::GetUpdateSelectedRegionCount() const
+{
+	return updateSelectedRegionCount;
+}
+
+uint32_t MockViewInputControlDemolish::GetEndInputCount() const
+{
+	return endInputCount;
+}
+
+cISC4Occupant* MockViewInputControlDemolish::GetDemolishEffectOccupant()
+{
+	return &demolishEffectOccupant;
+}
+
+bool MockViewInputControlDemolish::IsOnTopImpl() const
+{
+	return onTop;
+}
+
+void MockViewInputControlDemolish::EndInputImpl()
+{
+	endInputCount++;
+	bCellPicked = 0;
+	pCellRegion = nullptr;
+	region.reset();
+}
+
+void MockViewInputControlDemolish::UpdateSelectedRegionImpl()
+{
+	updateSelectedRegionCount++;
+
+	if (!bCellPicked || !pCellRegion)
+	{
+		return;
+	}
+
+	// The game previews the selection with its patched DemolishRegion call, the
+	// second argument is the register that the patch pushes in place of the
+	// privilege type. The occupant set starts empty for each preview.
+	previewCost = 0;
+	previewOccupants.clear();
+	previewResult = cSC4ViewInputControlDemolishHooks::UpdateSelectedRegionDemolishRegion(
+		pDemolition,
+		nullptr,
+		*pCellRegion,
+		0,
+		0,
+		false,
+		pDemolishableOccupantFilter,
+		&previewCost,
+		reinterpret_cast<intptr_t>(&previewOccupants),
+		nullptr,
+		0,
+		0);
+	bValidDemolitionTarget = previewResult;
+}
+
+bool MockViewInputControlDemolish::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	*ppvObj = nullptr;
+	return false;
+}
+
+uint32_t MockViewInputControlDemolish::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t MockViewInputControlDemolish::Release()
+{
+	return refCount > 0 ? --refCount : 0;
+}
+
+bool MockViewInputControlDemolish::Init()
+{
+	return true;
+}
+
+bool MockViewInputControlDemolish::Shutdown()
+{
+	return true;
+}
+
+uint32_t MockViewInputControlDemolish::GetID()
+{
+	return id;
+}
+
+bool MockViewInputControlDemolish::SetID(uint32_t id)
+{
+	this->id = id;
+	return true;
+}
+
+cIGZCursor* MockViewInputControlDemolish::GetCursor()
+{
+	return nullptr;
+}
+
+bool MockViewInputControlDemolish::SetCursor(cIGZCursor* cursor)
+{
+	return false;
+}
+
+bool MockViewInputControlDemolish::SetCursor(uint32_t cursorID)
+{
+	cursorIID = cursorID;
+	return true;
+}
+
+bool MockViewInputControlDemolish::SetWindow(cIGZWin* pWin)
+{
+	return true;
+}
+
+bool MockViewInputControlDemolish::IsSelfScrollingView()
+{
+	return false;
+}
+
+bool MockViewInputControlDemolish::ShouldStack()
+{
+	return false;
+}
+
+bool MockViewInputControlDemolish::OnCharacter(char value)
+{
+	return false;
+}
+
+bool MockViewInputControlDemolish::OnKeyDown(int32_t virtualKeyCode, uint32_t modifiers)
+{
+	return cSC4ViewInputControlDemolishHooks::OnKeyDownHook(this, nullptr, virtualKeyCode, static_cast<int32_t>(modifiers));
+}
+
+bool MockViewInputControlDemolish::OnKeyUp(int32_t virtualKeyCode, uint32_t modifiers)
+{
+	return false;
+}
+
+bool MockViewInputControlDemolish::OnMouseDownL(int32_t x, uint32_t z)
+{
+	bCellPicked = 1;
+	clickX = x;
+	clickZ = static_cast<int32_t>(z);
+	lotMinX = lotMaxX = clickX;
+	lotMinZ = lotMaxZ = clickZ;
+
+	SelectCells(clickX, clickZ);
+
+	return true;
+}
+
+bool MockViewInputControlDemolish::OnMouseDownR(int32_t x, uint32_t z)
+{
+	return false;
+}
+
+bool MockViewInputControlDemolish::OnMouseUpL(int32_t x, uint32_t z)
+{
+	if (!bCellPicked || !pCellRegion)
+	{
+		return false;
+	}
+
+	int64_t cost = 0;
+
+	cSC4ViewInputControlDemolishHooks::OnMouseUpLDemolishRegion(
+		pDemolition,
+		nullptr,
+		*pCellRegion,
+		0,
+		0,
+		false,
+		pDemolishableOccupantFilter,
+		&cost,
+		0,
+		&demolishEffectOccupant,
+		clickX,
+		clickZ);
+
+	EndInput();
+
+	return true;
+}
+
+bool MockViewInputControlDemolish::OnMouseUpR(int32_t x, uint32_t z)
+{
+	return false;
+}
+
+bool MockViewInputControlDemolish::OnMouseMove(int32_t x, int32_t z, uint32_t modifiers)
+{
+	if (bCellPicked)
+	{
+		SelectCells(x, z);
+	}
+
+	return true;
+}
+
+bool MockViewInputControlDemolish::OnMouseWheel(int32_t x, int32_t z, uint32_t modifiers, int32_t wheelDelta)
+{
+	return cSC4ViewInputControlDemolishHooks::OnMouseWheelHook(this, nullptr, x, z, modifiers, wheelDelta);
+}
+
+bool MockViewInputControlDemolish::OnMouseExit()
+{
+	return false;
+}
+
+void MockViewInputControlDemolish::Activate()
+{
+	cSC4ViewInputControlDemolishHooks::Activate(this, nullptr);
+}
+
+void MockViewInputControlDemolish::Deactivate()
+{
+}
+
+bool MockViewInputControlDemolish::AmCapturing()
+{
+	return bCellPicked != 0;
+}
+
+void MockViewInputControlDemolish::SelectCells(int32_t x, int32_t z)
+{
+	SetSelectedCells(x, z);
+	UpdateSelectedRegion();
+}
+
+void MockViewInputControlDemolish::SetSelectedCells(int32_t x, int32_t z)
+{
+	cellPointX = x;
+	cellPointZ = z;
+
+	// The game selects every cell in the rectangle between the click and the cursor.
+	region = std::make_unique<SC4CellRegion<int32_t>>(
+		(std::min)(clickX, x),
+		(std::min)(clickZ, z),
+		(std::max)(clickX, x),
+		(std::max)(clickZ, z),
+		true);
+	pCellRegion = region.get();
+}
+
+cSC4ViewInputControlDemolish* cSC4ViewInputControlDemolish::Create()
+{
+	// The tests create their controls themselves.
+	return nullptr;
+}
+
+bool cSC4ViewInputControlDemolish::IsOnTop()
+{
+	return AsMock(this)->IsOnTopImpl();
+}
+
+void cSC4ViewInputControlDemolish::EndInput()
+{
+	AsMock(this)->EndInputImpl();
+}
+
+void cSC4ViewInputControlDemolish::UpdateSelectedRegion()
+{
+	AsMock(this)->UpdateSelectedRegionImpl();
+}
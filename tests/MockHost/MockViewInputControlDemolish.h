@@ -0,0 +1,105 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cSC4ViewInputControlDemolish.h"
+#include "MockDemolition.h"
+#include "MockOccupant.h"
+#include <cstdint>
+#include <memory>
+
+// Stands in for the game's bulldoze tool control.
+//
+// The mouse methods select cells the way the game does, and the game code that the
+// plugin patches calls the plugin's hooks: OnKeyDown, OnMouseWheel and Activate are
+// the patched vtable entries, UpdateSelectedRegion and OnMouseUpL call the patched
+// DemolishRegion call sites. The mouse coordinates are city cells.
+class MockViewInputControlDemolish : public cSC4ViewInputControlDemolish
+{
+public:
+	explicit MockViewInputControlDemolish(cISC4Demolition* pDemolition);
+	~MockViewInputControlDemolish();
+
+	void SetOnTop(bool value);
+
+	// Selects the rectangle between the clicked cell and the cursor cell without
+	// previewing it, the replay uses this to restore a recorded selection.
+	void SetSelection(int32_t clickX, int32_t clickZ, int32_t cursorX, int32_t cursorZ);
+
+	// The cost and result of the last preview that UpdateSelectedRegion computed.
+	int64_t GetPreviewCost() const;
+	bool GetPreviewResult() const;
+
+	uint32_t GetUpdateSelectedRegionCount() const;
+	uint32_t GetEndInputCount() const;
+
+	// The occupant that the game passes to DemolishRegion for the demolition effect.
+	cISC4Occupant* GetDemolishEffectOccupant();
+
+	// The methods that the game implements itself, called through the seam in
+	// cSC4ViewInputControlDemolish.
+	bool IsOnTopImpl() const;
+	void EndInputImpl();
+	void UpdateSelectedRegionImpl();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool Init() override;
+	bool Shutdown() override;
+	uint32_t GetID() override;
+	bool SetID(uint32_t id) override;
+	cIGZCursor* GetCursor() override;
+	bool SetCursor(cIGZCursor* cursor) override;
+	bool SetCursor(uint32_t cursorID) override;
+	bool SetWindow(cIGZWin* pWin) override;
+	bool IsSelfScrollingView() override;
+	bool ShouldStack() override;
+	bool OnCharacter(char value) override;
+	bool OnKeyDown(int32_t virtualKeyCode, uint32_t modifiers) override;
+	bool OnKeyUp(int32_t virtualKeyCode, uint32_t modifiers) override;
+	bool OnMouseDownL(int32_t x, uint32_t z) override;
+	bool OnMouseDownR(int32_t x, uint32_t z) override;
+	bool OnMouseUpL(int32_t x, uint32_t z) override;
+	bool OnMouseUpR(int32_t x, uint32_t z) override;
+	bool OnMouseMove(int32_t x, int32_t z, uint32_t modifiers) override;
+	bool OnMouseWheel(int32_t x, int32_t z, uint32_t modifiers, int32_t wheelDelta) override;
+	bool OnMouseExit() override;
+	void Activate() override;
+	void Deactivate() override;
+	bool AmCapturing() override;
+
+private:
+	void SelectCells(int32_t x, int32_t z);
+	void SetSelectedCells(int32_t x, int32_t z);
+
+	std::unique_ptr<SC4CellRegion<int32_t>> region;
+	MockOccupant demolishEffectOccupant;
+	// The occupants that the last preview selected.
+	MockDemolition::OccupantSet previewOccupants;
+	int64_t previewCost;
+	bool previewResult;
+	bool onTop;
+	uint32_t updateSelectedRegionCount;
+	uint32_t endInputCount;
+};
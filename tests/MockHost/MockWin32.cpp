@@ -0,0 +1,223 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MockWin32.h"
+#include <Windows.h>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cwctype>
+#include <fstream>
+#include <string>
+
+namespace
+{
+	std::array<bool, 256> keysDown{};
+	uint64_t tickCount = 0;
+
+	std::string Narrow(const wchar_t* text)
+	{
+		std::string result;
+
+		for (; *text != L'\0'; text++)
+		{
+			result.push_back(static_cast<char>(*text));
+		}
+
+		return result;
+	}
+
+	std::string Trim(const std::string& text)
+	{
+		const size_t first = text.find_first_not_of(" \t\r");
+
+		if (first == std::string::npos)
+		{
+			return std::string();
+		}
+
+		return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+	}
+
+	bool EqualsIgnoreCase(const std::string& lhs, const std::string& rhs)
+	{
+		if (lhs.size() != rhs.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < lhs.size(); i++)
+		{
+			if (std::tolower(static_cast<unsigned char>(lhs[i])) != std::tolower(static_cast<unsigned char>(rhs[i])))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ReadIniValue(
+		const std::filesystem::path& path,
+		const std::string& section,
+		const std::string& key,
+		std::string& value)
+	{
+		std::ifstream file(path);
+		std::string line;
+		bool inSection = false;
+
+		while (std::getline(file, line))
+		{
+			line = Trim(line);
+
+			if (line.empty() || line[0] == ';')
+			{
+				continue;
+			}
+
+			if (line[0] == '[')
+			{
+				const size_t end = line.find(']');
+				inSection = end != std::string::npos && EqualsIgnoreCase(line.substr(1, end - 1), section);
+			}
+			else if (inSection)
+			{
+				const size_t separator = line.find('=');
+
+				if (separator != std::string::npos && EqualsIgnoreCase(Trim(line.substr(0, separator)), key))
+				{
+					value = Trim(line.substr(separator + 1));
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
+
+void MockWin32::SetKeyDown(int virtualKeyCode, bool down)
+{
+	keysDown[static_cast<size_t>(virtualKeyCode) & 0xFF] = down;
+}
+
+void MockWin32::ReleaseAllKeys()
+{
+	keysDown.fill(false);
+}
+
+void MockWin32::SetTickCount(uint64_t milliseconds)
+{
+	tickCount = milliseconds;
+}
+
+void MockWin32::AdvanceTickCount(uint64_t milliseconds)
+{
+	tickCount += milliseconds;
+}
+
+short GetKeyState(int virtualKeyCode)
+{
+	return keysDown[static_cast<size_t>(virtualKeyCode) & 0xFF] ? static_cast<short>(0x8000) : 0;
+}
+
+uint64_t GetTickCount64()
+{
+	return tickCount;
+}
+
+void* GetModuleHandleW(const wchar_t* moduleName)
+{
+	return nullptr;
+}
+
+void OutputDebugStringA(const char* text)
+{
+	std::fputs(text, stderr);
+}
+
+DWORD GetPrivateProfileStringW(
+	const wchar_t* section,
+	const wchar_t* key,
+	const wchar_t* defaultValue,
+	wchar_t* buffer,
+	DWORD bufferLength,
+	const std::filesystem::path::value_type* path)
+{
+	if (bufferLength == 0)
+	{
+		return 0;
+	}
+
+	std::string value;
+	std::wstring result;
+
+	if (ReadIniValue(path, Narrow(section), Narrow(key), value))
+	{
+		result.assign(value.begin(), value.end());
+	}
+	else if (defaultValue)
+	{
+		result = defaultValue;
+	}
+
+	// The value is truncated to fit the buffer, like the Win32 function.
+	const size_t length = (std::min)(result.size(), static_cast<size_t>(bufferLength - 1));
+
+	result.copy(buffer, length);
+	buffer[length] = L'\0';
+
+	return static_cast<DWORD>(length);
+}
+
+unsigned int GetPrivateProfileIntW(
+	const wchar_t* section,
+	const wchar_t* key,
+	int defaultValue,
+	const std::filesystem::path::value_type* path)
+{
+	std::string value;
+
+	if (!ReadIniValue(path, Narrow(section), Narrow(key), value))
+	{
+		return static_cast<unsigned int>(defaultValue);
+	}
+
+	return static_cast<unsigned int>(std::strtol(value.c_str(), nullptr, 10));
+}
+
+int _wcsicmp(const wchar_t* lhs, const wchar_t* rhs)
+{
+	for (;; lhs++, rhs++)
+	{
+		const wint_t left = std::towlower(static_cast<wint_t>(*lhs));
+		const wint_t right = std::towlower(static_cast<wint_t>(*rhs));
+
+		if (left != right || left == L'\0')
+		{
+			return static_cast<int>(left) - static_cast<int>(right);
+		}
+	}
+}
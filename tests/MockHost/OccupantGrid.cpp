@@ -0,0 +1,226 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OccupantGrid.h"
+#include "NetworkOccupantFilter.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	constexpr int64_t FloraDemolitionCost = 5;
+	constexpr int64_t RoadDemolitionCost = 10;
+	constexpr int64_t RailDemolitionCost = 20;
+	constexpr int64_t BuildingDemolitionCost = 100;
+
+	// SplitMix64, the standard library distributions are not the same on every platform.
+	uint64_t NextRandom(uint64_t& state)
+	{
+		uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+
+		return value ^ (value >> 31);
+	}
+
+	const std::vector<MockOccupant*> EmptyCell;
+}
+
+OccupantGrid::OccupantGrid(int32_t size)
+	: size(size),
+	  cells(static_cast<size_t>(size) * static_cast<size_t>(size)),
+	  occupants()
+{
+}
+
+OccupantGrid::~OccupantGrid()
+{
+}
+
+int32_t OccupantGrid::GetSize() const
+{
+	return size;
+}
+
+MockOccupant& OccupantGrid::AddOccupant(uint32_t type, const SC4Rect<int32_t>& cells, int64_t demolitionCost)
+{
+	auto occupant = std::make_unique<MockOccupant>(type, cells, demolitionCost);
+	MockOccupant& result = *occupant;
+
+	Place(std::move(occupant));
+
+	return result;
+}
+
+MockNetworkOccupant& OccupantGrid::AddNetwork(const SC4Rect<int32_t>& cells, uint32_t networkFlags, int64_t demolitionCost)
+{
+	auto occupant = std::make_unique<MockNetworkOccupant>(cells, networkFlags, demolitionCost);
+	MockNetworkOccupant& result = *occupant;
+
+	Place(std::move(occupant));
+
+	return result;
+}
+
+void OccupantGrid::AddForest(const SC4Rect<int32_t>& area, uint32_t percent, uint32_t seed)
+{
+	uint64_t state = seed;
+
+	for (int32_t x = area.topLeftX; x <= area.bottomRightX; x++)
+	{
+		for (int32_t z = area.topLeftY; z <= area.bottomRightY; z++)
+		{
+			if ((NextRandom(state) % 100) < percent)
+			{
+				AddOccupant(MockOccupantType::Flora, SC4Rect<int32_t>(x, z, x, z), FloraDemolitionCost);
+			}
+		}
+	}
+}
+
+void OccupantGrid::AddRoadGrid(const SC4Rect<int32_t>& area, int32_t spacing)
+{
+	const uint32_t roadFlags = static_cast<uint32_t>(NetworkTypeFlags::Road);
+
+	for (int32_t x = area.topLeftX; x <= area.bottomRightX; x++)
+	{
+		for (int32_t z = area.topLeftY; z <= area.bottomRightY; z++)
+		{
+			if (((x - area.topLeftX) % spacing) == 0 || ((z - area.topLeftY) % spacing) == 0)
+			{
+				AddNetwork(SC4Rect<int32_t>(x, z, x, z), roadFlags, RoadDemolitionCost);
+			}
+		}
+	}
+}
+
+void OccupantGrid::AddRailLine(int32_t z, int32_t firstX, int32_t lastX)
+{
+	const uint32_t railFlags = static_cast<uint32_t>(NetworkTypeFlags::Rail);
+
+	for (int32_t x = firstX; x <= lastX; x++)
+	{
+		AddNetwork(SC4Rect<int32_t>(x, z, x, z), railFlags, RailDemolitionCost);
+	}
+}
+
+void OccupantGrid::AddBuildings(const SC4Rect<int32_t>& area, int32_t spacing, int32_t footprint)
+{
+	for (int32_t x = area.topLeftX; x + footprint - 1 <= area.bottomRightX; x += spacing)
+	{
+		for (int32_t z = area.topLeftY; z + footprint - 1 <= area.bottomRightY; z += spacing)
+		{
+			AddOccupant(
+				MockOccupantType::Building,
+				SC4Rect<int32_t>(x, z, x + footprint - 1, z + footprint - 1),
+				BuildingDemolitionCost);
+		}
+	}
+}
+
+const std::vector<MockOccupant*>& OccupantGrid::GetOccupants(int32_t x, int32_t z) const
+{
+	if (x < 0 || z < 0 || x >= size || z >= size)
+	{
+		return EmptyCell;
+	}
+
+	return cells[static_cast<size_t>(x) * static_cast<size_t>(size) + static_cast<size_t>(z)];
+}
+
+bool OccupantGrid::Contains(const MockOccupant* pOccupant) const
+{
+	return occupants.find(pOccupant) != occupants.end();
+}
+
+void OccupantGrid::Remove(MockOccupant* pOccupant)
+{
+	auto it = occupants.find(pOccupant);
+
+	if (it == occupants.end())
+	{
+		return;
+	}
+
+	const SC4Rect<int32_t>& bounds = pOccupant->GetCells();
+
+	for (int32_t x = bounds.topLeftX; x <= bounds.bottomRightX; x++)
+	{
+		for (int32_t z = bounds.topLeftY; z <= bounds.bottomRightY; z++)
+		{
+			std::vector<MockOccupant*>& cell = Cell(x, z);
+
+			cell.erase(std::remove(cell.begin(), cell.end(), pOccupant), cell.end());
+		}
+	}
+
+	occupants.erase(it);
+}
+
+size_t OccupantGrid::GetOccupantCount() const
+{
+	return occupants.size();
+}
+
+size_t OccupantGrid::GetOccupantCount(uint32_t type) const
+{
+	size_t count = 0;
+
+	for (const auto& entry : occupants)
+	{
+		if (static_cast<uint32_t>(entry.second->GetType()) == type)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+void OccupantGrid::Place(std::unique_ptr<MockOccupant> occupant)
+{
+	const SC4Rect<int32_t>& bounds = occupant->GetCells();
+
+	if (bounds.topLeftX < 0
+		|| bounds.topLeftY < 0
+		|| bounds.bottomRightX >= size
+		|| bounds.bottomRightY >= size)
+	{
+		throw std::out_of_range("The occupant is outside of the city.");
+	}
+
+	for (int32_t x = bounds.topLeftX; x <= bounds.bottomRightX; x++)
+	{
+		for (int32_t z = bounds.topLeftY; z <= bounds.bottomRightY; z++)
+		{
+			Cell(x, z).push_back(occupant.get());
+		}
+	}
+
+	const MockOccupant* pOccupant = occupant.get();
+	occupants.emplace(pOccupant, std::move(occupant));
+}
+
+std::vector<MockOccupant*>& OccupantGrid::Cell(int32_t x, int32_t z)
+{
+	return cells[static_cast<size_t>(x) * static_cast<size_t>(size) + static_cast<size_t>(z)];
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "MockOccupant.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// The occupants of a square city, indexed by the cells they cover.
+class OccupantGrid
+{
+public:
+	explicit OccupantGrid(int32_t size);
+	~OccupantGrid();
+
+	int32_t GetSize() const;
+
+	MockOccupant& AddOccupant(uint32_t type, const SC4Rect<int32_t>& cells, int64_t demolitionCost);
+	MockNetworkOccupant& AddNetwork(const SC4Rect<int32_t>& cells, uint32_t networkFlags, int64_t demolitionCost);
+
+	// Places a tree on the specified percentage of the cells in the area.
+	// The same seed always produces the same forest.
+	void AddForest(const SC4Rect<int32_t>& area, uint32_t percent, uint32_t seed);
+
+	// Places roads along every spacing-th row and column of the area, one
+	// network occupant per cell like the game's network pieces.
+	void AddRoadGrid(const SC4Rect<int32_t>& area, int32_t spacing);
+
+	// Places a rail line along the specified row.
+	void AddRailLine(int32_t z, int32_t firstX, int32_t lastX);
+
+	// Places a building on every spacing-th cell of the area that is free.
+	void AddBuildings(const SC4Rect<int32_t>& area, int32_t spacing, int32_t footprint);
+
+	const std::vector<MockOccupant*>& GetOccupants(int32_t x, int32_t z) const;
+
+	bool Contains(const MockOccupant* pOccupant) const;
+	void Remove(MockOccupant* pOccupant);
+
+	size_t GetOccupantCount() const;
+	size_t GetOccupantCount(uint32_t type) const;
+
+private:
+	void Place(std::unique_ptr<MockOccupant> occupant);
+	std::vector<MockOccupant*>& Cell(int32_t x, int32_t z);
+
+	int32_t size;
+	std::vector<std::vector<MockOccupant*>> cells;
+	std::unordered_map<const MockOccupant*, std::unique_ptr<MockOccupant>> occupants;
+};
@@ -0,0 +1,64 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// The parts of the Win32 API that the plugin uses outside of the code that is
+// only built for Windows. The keyboard state and the tick count are controlled
+// by the tests through MockWin32.h.
+
+typedef unsigned long DWORD;
+typedef int BOOL;
+
+#define VK_RETURN 0x0D
+#define VK_SHIFT 0x10
+#define VK_CONTROL 0x11
+#define VK_MENU 0x12
+#define VK_ESCAPE 0x1B
+
+short GetKeyState(int virtualKeyCode);
+
+uint64_t GetTickCount64();
+
+void* GetModuleHandleW(const wchar_t* moduleName);
+
+void OutputDebugStringA(const char* text);
+
+// Reads the value from an ini file with the same rules as the Win32 API, the path
+// is a native path because the file paths are std::filesystem::path values.
+DWORD GetPrivateProfileStringW(
+	const wchar_t* section,
+	const wchar_t* key,
+	const wchar_t* defaultValue,
+	wchar_t* buffer,
+	DWORD bufferLength,
+	const std::filesystem::path::value_type* path);
+
+unsigned int GetPrivateProfileIntW(
+	const wchar_t* section,
+	const wchar_t* key,
+	int defaultValue,
+	const std::filesystem::path::value_type* path);
+
+int _wcsicmp(const wchar_t* lhs, const wchar_t* rhs);
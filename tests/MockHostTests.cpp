@@ -0,0 +1,782 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MockHost.h"
+#include "MockFileSystem.h"
+#include "NetworkOccupantFilter.h"
+#include "RegionDecomposition.h"
+#include <Windows.h>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <vector>
+
+using cSC4ViewInputControlDemolishHooks::BulldozeCursorDefault;
+using cSC4ViewInputControlDemolishHooks::BulldozeCursorDefaultDiagonal;
+using cSC4ViewInputControlDemolishHooks::BulldozeCursorFlora;
+using cSC4ViewInputControlDemolishHooks::BulldozeCursorNetwork;
+
+namespace
+{
+	Settings LoadSettings(const char* text)
+	{
+		const std::filesystem::path path = MockFileSystem::GetDirectory() / "MockHostTests.ini";
+
+		std::filesystem::create_directories(path.parent_path());
+		{
+			std::ofstream file(path);
+			file << "[BulldozeExtensions]\n" << text;
+		}
+
+		Settings settings;
+		settings.Load(path);
+
+		std::filesystem::remove(path);
+
+		return settings;
+	}
+
+	struct DiagonalDemolition
+	{
+		size_t callCount;
+		uint64_t cellsScanned;
+		size_t occupantsLeft;
+	};
+
+	DiagonalDemolition DemolishDiagonal(const Settings& settings)
+	{
+		MockHost host(256, settings);
+		host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 255, 255), 100, 1);
+		host.KeyDown('B', MockHost::ModifierAlt);
+		host.MouseDown(0, 0);
+		host.MouseMove(255, 255);
+		host.GetDemolition().ResetCounters();
+		host.MouseUp();
+
+		const MockDemolition& demolition = host.GetDemolition();
+
+		return DiagonalDemolition
+		{
+			demolition.GetDemolishRegionCallCount(true),
+			demolition.GetCellsScanned(),
+			host.GetGrid().GetOccupantCount()
+		};
+	}
+
+	struct DragPreviews
+	{
+		std::vector<int64_t> costs;
+		std::vector<bool> results;
+		uint64_t cellsScanned;
+	};
+
+	// Replays a drag that grows, shrinks and flips the selection over a city with trees,
+	// roads and buildings that cover several cells, and records the preview of each step.
+	DragPreviews ReplayDrag(const Settings& settings, uint32_t modeModifiers)
+	{
+		static constexpr int32_t path[][2] =
+		{
+			{ 20, 20 }, { 21, 20 }, { 22, 22 }, { 40, 40 }, { 41, 43 }, { 39, 41 }, { 30, 30 },
+			{ 30, 50 }, { 60, 35 }, { 59, 35 }, { 5, 5 }, { 12, 12 }, { 100, 100 }, { 98, 101 }
+		};
+
+		MockHost host(256, settings);
+		OccupantGrid& grid = host.GetGrid();
+		const SC4Rect<int32_t> area(0, 0, 127, 127);
+
+		grid.AddForest(area, 30, 7);
+		grid.AddRoadGrid(area, 8);
+		grid.AddBuildings(area, 5, 3);
+
+		if (modeModifiers != MockHost::ModifierNone)
+		{
+			host.KeyDown('B', modeModifiers);
+		}
+
+		host.MouseDown(10, 10);
+		host.GetDemolition().ResetCounters();
+
+		DragPreviews previews{};
+
+		for (const auto& cell : path)
+		{
+			host.MouseMove(cell[0], cell[1]);
+			previews.costs.push_back(host.GetControl().GetPreviewCost());
+			previews.results.push_back(host.GetControl().GetPreviewResult());
+		}
+
+		previews.cellsScanned = host.GetDemolition().GetCellsScanned();
+
+		return previews;
+	}
+}
+
+TEST(MockHostTests, RectangleDragDemolishesTheSelectedOccupants)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 50, 1);
+	const size_t treeCount = grid.GetOccupantCount();
+
+	host.Drag(0, 0, 63, 63);
+
+	const MockDemolition& demolition = host.GetDemolition();
+
+	ASSERT_EQ(demolition.GetDemolishRegionCallCount(true), 1u);
+	EXPECT_EQ(grid.GetOccupantCount(), 0u);
+	EXPECT_EQ(demolition.GetDemolishedOccupantCount(), treeCount);
+
+	const MockDemolition::DemolishRegionCall& call = demolition.GetDemolishRegionCalls().back();
+
+	EXPECT_TRUE(call.demolish);
+	EXPECT_EQ(call.bounds.topLeftX, 0);
+	EXPECT_EQ(call.bounds.bottomRightY, 63);
+	EXPECT_EQ(call.selectedCellCount, 64u * 64u);
+	EXPECT_EQ(call.privilegeType, 1);
+	EXPECT_EQ(call.pOccupantFilter, nullptr);
+	EXPECT_EQ(call.pDemolishEffectOccupant, host.GetControl().GetDemolishEffectOccupant());
+	EXPECT_EQ(host.GetControl().GetEndInputCount(), 1u);
+}
+
+TEST(MockHostTests, DraggingPreviewsTheSelection)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 15, 15), 100, 1);
+
+	host.MouseDown(0, 0);
+	host.MouseMove(3, 3);
+
+	MockViewInputControlDemolish& control = host.GetControl();
+
+	EXPECT_EQ(control.GetUpdateSelectedRegionCount(), 2u);
+	EXPECT_TRUE(control.GetPreviewResult());
+	EXPECT_EQ(control.GetPreviewCost(), 16 * 5);
+	EXPECT_EQ(host.GetDemolition().GetDemolishRegionCallCount(false), 2u);
+	EXPECT_EQ(host.GetGrid().GetOccupantCount(), 256u);
+}
+
+TEST(MockHostTests, FloraModeOnlyDemolishesFlora)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 31, 31), 40, 7);
+	grid.AddRoadGrid(SC4Rect<int32_t>(0, 0, 31, 31), 8);
+	const size_t roadCount = grid.GetOccupantCount(MockOccupantType::Network);
+
+	EXPECT_TRUE(host.KeyDown('B', MockHost::ModifierControl));
+	host.Drag(0, 0, 31, 31);
+
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Flora), 0u);
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Network), roadCount);
+
+	const MockDemolition::DemolishRegionCall& call = host.GetDemolition().GetDemolishRegionCalls().back();
+
+	EXPECT_NE(call.pOccupantFilter, nullptr);
+	EXPECT_EQ(host.GetControl().cursorIID, BulldozeCursorFlora);
+}
+
+TEST(MockHostTests, NetworkModeOnlyDemolishesNetworks)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 31, 31), 40, 7);
+	grid.AddRoadGrid(SC4Rect<int32_t>(0, 0, 31, 31), 8);
+	grid.AddRailLine(4, 0, 31);
+	const size_t treeCount = grid.GetOccupantCount(MockOccupantType::Flora);
+
+	EXPECT_TRUE(host.KeyDown('B', MockHost::ModifierShift));
+	host.Drag(0, 0, 31, 31);
+
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Flora), treeCount);
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Network), 0u);
+}
+
+TEST(MockHostTests, PressingFloraModeAgainSelectsProps)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 31, 31), 40, 7);
+	grid.AddOccupant(MockOccupantType::Prop, SC4Rect<int32_t>(3, 3, 3, 3), 5);
+	grid.AddOccupant(MockOccupantType::Prop, SC4Rect<int32_t>(20, 4, 21, 4), 5);
+	const size_t treeCount = grid.GetOccupantCount(MockOccupantType::Flora);
+
+	EXPECT_TRUE(host.KeyDown('B', MockHost::ModifierControl));
+	EXPECT_TRUE(host.KeyDown('B', MockHost::ModifierControl));
+	EXPECT_EQ(host.GetControl().cursorIID, BulldozeCursorFlora);
+
+	host.Drag(0, 0, 31, 31);
+
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Prop), 0u);
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Flora), treeCount);
+
+	// A third press switches back to the flora mode.
+	host.KeyDown('B', MockHost::ModifierControl);
+	host.Drag(0, 0, 31, 31);
+
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Flora), 0u);
+}
+
+TEST(MockHostTests, PressingNetworkModeAgainSelectsRail)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddRoadGrid(SC4Rect<int32_t>(0, 0, 31, 31), 8);
+	const size_t roadCount = grid.GetOccupantCount(MockOccupantType::Network);
+	grid.AddRailLine(4, 0, 31);
+
+	host.KeyDown('B', MockHost::ModifierShift);
+	host.KeyDown('B', MockHost::ModifierShift);
+	EXPECT_EQ(host.GetControl().cursorIID, BulldozeCursorNetwork);
+
+	host.Drag(0, 0, 31, 31);
+
+	// Only the rail line is demolished.
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Network), roadCount);
+}
+
+// The prop and rail modes share the flora and network cursors, the preview color
+// tells them apart.
+TEST(MockHostTests, EachFilterModeHasItsOwnPreviewColor)
+{
+	MockHost host;
+	host.MouseDown(0, 0);
+
+	std::vector<S3DColorFloat> colors;
+
+	const auto recordColor = [&](uint32_t modifiers)
+	{
+		host.KeyDown('B', modifiers);
+		host.MouseMove(7, 7);
+		colors.push_back(host.GetControl().demolishOK);
+	};
+
+	recordColor(MockHost::ModifierNone);
+	recordColor(MockHost::ModifierControl);
+	recordColor(MockHost::ModifierControl);
+	recordColor(MockHost::ModifierShift);
+	recordColor(MockHost::ModifierShift);
+
+	for (size_t i = 0; i < colors.size(); i++)
+	{
+		for (size_t j = i + 1; j < colors.size(); j++)
+		{
+			EXPECT_FALSE(colors[i].r == colors[j].r && colors[i].g == colors[j].g && colors[i].b == colors[j].b)
+				<< "modes " << i << " and " << j;
+		}
+	}
+}
+
+TEST(MockHostTests, OccupantTypeModeOnlyDemolishesTheListedTypes)
+{
+	MockHost host(256, LoadSettings("OccupantTypes=0x2A499F85, 0x278128A0\n"));
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 31, 31), 40, 7);
+	grid.AddRoadGrid(SC4Rect<int32_t>(0, 0, 31, 31), 8);
+	grid.AddOccupant(MockOccupantType::Prop, SC4Rect<int32_t>(3, 3, 3, 3), 5);
+	grid.AddOccupant(MockOccupantType::Building, SC4Rect<int32_t>(10, 10, 12, 12), 50);
+	const size_t treeCount = grid.GetOccupantCount(MockOccupantType::Flora);
+	const size_t roadCount = grid.GetOccupantCount(MockOccupantType::Network);
+
+	EXPECT_TRUE(host.KeyDown('B', MockHost::ModifierControl | MockHost::ModifierShift));
+	EXPECT_EQ(host.GetControl().cursorIID, BulldozeCursorDefault);
+
+	host.Drag(0, 0, 31, 31);
+
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Prop), 0u);
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Building), 0u);
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Flora), treeCount);
+	EXPECT_EQ(grid.GetOccupantCount(MockOccupantType::Network), roadCount);
+	EXPECT_NE(host.GetDemolition().GetDemolishRegionCalls().back().pOccupantFilter, nullptr);
+}
+
+TEST(MockHostTests, OccupantTypeModeRequiresTheTypeList)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 15, 15), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierControl);
+	host.KeyDown('B', MockHost::ModifierControl | MockHost::ModifierShift);
+
+	// The mode is unchanged.
+	EXPECT_EQ(host.GetControl().cursorIID, BulldozeCursorFlora);
+}
+
+TEST(MockHostTests, EscapeEndsTheSelection)
+{
+	MockHost host;
+
+	host.MouseDown(2, 2);
+	host.MouseMove(10, 10);
+
+	EXPECT_TRUE(host.KeyDown(VK_ESCAPE));
+	EXPECT_EQ(host.GetControl().GetEndInputCount(), 1u);
+	EXPECT_EQ(host.GetControl().bCellPicked, 0);
+
+	// There is nothing left to cancel.
+	EXPECT_FALSE(host.KeyDown(VK_ESCAPE));
+}
+
+TEST(MockHostTests, KeysAreIgnoredWhenTheToolIsNotOnTop)
+{
+	MockHost host;
+
+	host.GetControl().SetOnTop(false);
+
+	EXPECT_FALSE(host.KeyDown('B', MockHost::ModifierControl));
+	EXPECT_EQ(host.GetControl().cursorIID, BulldozeCursorDefault);
+}
+
+TEST(MockHostTests, DiagonalModeDemolishesABandOfCells)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	EXPECT_TRUE(host.KeyDown('B', MockHost::ModifierAlt));
+	EXPECT_EQ(host.GetControl().cursorIID, BulldozeCursorDefaultDiagonal);
+
+	host.Drag(0, 0, 63, 63);
+
+	const MockDemolition& demolition = host.GetDemolition();
+	uint64_t demolishedCells = 0;
+
+	for (const MockDemolition::DemolishRegionCall& call : demolition.GetDemolishRegionCalls())
+	{
+		if (call.demolish)
+		{
+			demolishedCells += call.selectedCellCount;
+		}
+	}
+
+	// A one cell thick diagonal of a square covers one cell per row.
+	EXPECT_EQ(demolishedCells, 64u);
+	EXPECT_EQ(grid.GetOccupantCount(), 64u * 64u - 64u);
+}
+
+TEST(MockHostTests, DiagonalPreviewIsWrittenIntoTheControlRegion)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.MouseMove(31, 31);
+
+	const MockViewInputControlDemolish& control = host.GetControl();
+	const MockDemolition::DemolishRegionCall& call = host.GetDemolition().GetDemolishRegionCalls().back();
+
+	// The game's region is passed on with the diagonal written into it, no copy is made.
+	EXPECT_FALSE(call.demolish);
+	EXPECT_EQ(call.pCellRegion, control.pCellRegion);
+	EXPECT_EQ(call.selectedCellCount, 32u);
+
+	for (uint32_t x = 0; x < 32; x++)
+	{
+		for (uint32_t z = 0; z < 32; z++)
+		{
+			EXPECT_EQ(control.pCellRegion->cellMap.GetValue(x, z), x == z) << x << ", " << z;
+		}
+	}
+}
+
+TEST(MockHostTests, DiagonalPreviewFallsBackWhenTheControlRegionDoesNotMatch)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.MouseMove(31, 31);
+
+	// A region whose cell map is smaller than its bounds, the hook must not write into it.
+	MockViewInputControlDemolish& control = host.GetControl();
+	SC4CellRegion<int32_t> mismatchedRegion(0, 0, 15, 15, true);
+	mismatchedRegion.bounds = SC4Rect<int32_t>(0, 0, 31, 31);
+
+	SC4CellRegion<int32_t>* const pGameRegion = control.pCellRegion;
+	control.pCellRegion = &mismatchedRegion;
+	control.UpdateSelectedRegion();
+	control.pCellRegion = pGameRegion;
+
+	const MockDemolition::DemolishRegionCall& call = host.GetDemolition().GetDemolishRegionCalls().back();
+
+	EXPECT_NE(call.pCellRegion, &mismatchedRegion);
+	EXPECT_EQ(call.bounds.bottomRightX, 31);
+	EXPECT_EQ(call.selectedCellCount, 32u);
+
+	for (uint32_t x = 0; x < 16; x++)
+	{
+		for (uint32_t z = 0; z < 16; z++)
+		{
+			ASSERT_TRUE(mismatchedRegion.cellMap.GetValue(x, z)) << x << ", " << z;
+		}
+	}
+}
+
+TEST(MockHostTests, DiagonalDemolitionIsOneMaskedCallByDefault)
+{
+	const DiagonalDemolition demolition = DemolishDiagonal(Settings());
+
+	EXPECT_EQ(demolition.callCount, 1u);
+	EXPECT_EQ(demolition.cellsScanned, 256u * 256u);
+	EXPECT_EQ(demolition.occupantsLeft, 256u * 256u - 256u);
+}
+
+TEST(MockHostTests, SplitDiagonalDemolitionScansFewerCells)
+{
+	const DiagonalDemolition single = DemolishDiagonal(Settings());
+	const DiagonalDemolition split = DemolishDiagonal(LoadSettings("SplitSparseDemolition=true\n"));
+
+	EXPECT_GT(split.callCount, 1u);
+	EXPECT_EQ(split.occupantsLeft, single.occupantsLeft);
+
+	// The per-call overhead that the planner assumes is included in the comparison.
+	EXPECT_LT(
+		split.cellsScanned + (split.callCount * RegionDecomposition::DefaultPieceOverhead),
+		single.cellsScanned + RegionDecomposition::DefaultPieceOverhead);
+}
+
+TEST(MockHostTests, DiagonalPreviewIsOneCallByDefault)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.GetDemolition().ResetCounters();
+	host.MouseMove(63, 63);
+
+	ASSERT_EQ(host.GetDemolition().GetDemolishRegionCallCount(false), 1u);
+	EXPECT_EQ(host.GetDemolition().GetDemolishRegionCalls().back().selectedCellCount, 64u);
+}
+
+// The pieces of a split preview share the preview's occupant set, so a building that
+// covers cells of two pieces is only paid for once.
+TEST(MockHostTests, SplitDiagonalPreviewCountsAnOccupantOnce)
+{
+	const SC4Rect<int32_t> buildingCells(30, 30, 33, 33);
+	constexpr int64_t buildingCost = 500;
+
+	MockHost host(256, LoadSettings("SplitSparseDemolition=true\n"));
+	host.GetGrid().AddOccupant(MockOccupantType::Building, buildingCells, buildingCost);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.GetDemolition().ResetCounters();
+	host.MouseMove(63, 63);
+
+	size_t piecesCoveringTheBuilding = 0;
+
+	for (const MockDemolition::DemolishRegionCall& call : host.GetDemolition().GetDemolishRegionCalls())
+	{
+		if (call.bounds.topLeftX <= buildingCells.bottomRightX
+			&& call.bounds.bottomRightX >= buildingCells.topLeftX
+			&& call.bounds.topLeftY <= buildingCells.bottomRightY
+			&& call.bounds.bottomRightY >= buildingCells.topLeftY)
+		{
+			piecesCoveringTheBuilding++;
+		}
+	}
+
+	ASSERT_GT(host.GetDemolition().GetDemolishRegionCallCount(false), 1u);
+	ASSERT_GT(piecesCoveringTheBuilding, 1u);
+	EXPECT_EQ(host.GetControl().GetPreviewCost(), buildingCost);
+	EXPECT_TRUE(host.GetControl().GetPreviewResult());
+}
+
+// Each preview of the drag only passes the changed strips to the game, but it must
+// report the same cost as previewing the whole rectangle.
+TEST(MockHostTests, IncrementalPreviewCostMatchesTheFullPreview)
+{
+	for (const uint32_t modeModifiers : { MockHost::ModifierNone, MockHost::ModifierControl, MockHost::ModifierShift })
+	{
+		SCOPED_TRACE(modeModifiers);
+
+		const DragPreviews full = ReplayDrag(Settings(), modeModifiers);
+		const DragPreviews incremental = ReplayDrag(LoadSettings("IncrementalPreviewCost=true\n"), modeModifiers);
+
+		EXPECT_EQ(incremental.costs, full.costs);
+		EXPECT_EQ(incremental.results, full.results);
+		EXPECT_LT(incremental.cellsScanned, full.cellsScanned);
+	}
+}
+
+// A building that is only partly inside the removed strip is still selected.
+TEST(MockHostTests, IncrementalPreviewKeepsAnOccupantThatStillTouchesTheSelection)
+{
+	constexpr int64_t buildingCost = 500;
+
+	MockHost host(256, LoadSettings("IncrementalPreviewCost=true\n"));
+	host.GetGrid().AddOccupant(MockOccupantType::Building, SC4Rect<int32_t>(28, 0, 31, 3), buildingCost);
+
+	host.MouseDown(0, 0);
+	host.MouseMove(40, 40);
+	ASSERT_EQ(host.GetControl().GetPreviewCost(), buildingCost);
+
+	host.GetDemolition().ResetCounters();
+	host.MouseMove(30, 40);
+
+	EXPECT_EQ(host.GetControl().GetPreviewCost(), buildingCost);
+	EXPECT_TRUE(host.GetControl().GetPreviewResult());
+	// Only the removed strip is passed to the game.
+	ASSERT_EQ(host.GetDemolition().GetDemolishRegionCallCount(false), 1u);
+	EXPECT_EQ(host.GetDemolition().GetDemolishRegionCalls().back().bounds.topLeftX, 31);
+
+	host.MouseMove(27, 40);
+
+	EXPECT_EQ(host.GetControl().GetPreviewCost(), 0);
+	EXPECT_FALSE(host.GetControl().GetPreviewResult());
+}
+
+TEST(MockHostTests, SplitDiagonalDemolitionPlaysTheEffectOnce)
+{
+	MockHost host(256, LoadSettings("SplitSparseDemolition=true\n"));
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.Drag(0, 0, 63, 63);
+
+	size_t effectCount = 0;
+	size_t pieceCount = 0;
+	const MockDemolition::DemolishRegionCall* pFirstPiece = nullptr;
+
+	for (const MockDemolition::DemolishRegionCall& call : host.GetDemolition().GetDemolishRegionCalls())
+	{
+		if (call.demolish)
+		{
+			if (!pFirstPiece)
+			{
+				pFirstPiece = &call;
+			}
+
+			pieceCount++;
+			effectCount += call.pDemolishEffectOccupant != nullptr;
+		}
+	}
+
+	ASSERT_GT(pieceCount, 1u);
+	EXPECT_EQ(effectCount, 1u);
+	EXPECT_EQ(pFirstPiece->pDemolishEffectOccupant, host.GetControl().GetDemolishEffectOccupant());
+}
+
+TEST(MockHostTests, AltWheelChangesTheDiagonalThickness)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.MouseMove(63, 63);
+
+	const int64_t thinCost = host.GetControl().GetPreviewCost();
+
+	EXPECT_TRUE(host.MouseWheel(120, MockHost::ModifierAlt));
+	EXPECT_GT(host.GetControl().GetPreviewCost(), thinCost);
+
+	// The wheel zooms the view when Alt is not held.
+	EXPECT_FALSE(host.MouseWheel(120));
+}
+
+TEST(MockHostTests, AltWheelUpdatesThePreviewOnce)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.MouseMove(63, 63);
+
+	const uint32_t updateCount = host.GetControl().GetUpdateSelectedRegionCount();
+
+	EXPECT_TRUE(host.MouseWheel(120, MockHost::ModifierAlt));
+	EXPECT_EQ(host.GetControl().GetUpdateSelectedRegionCount(), updateCount + 1);
+}
+
+TEST(MockHostTests, PressingTheActiveModeKeyAgainDoesNotUpdateThePreview)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.MouseMove(63, 63);
+
+	const uint32_t updateCount = host.GetControl().GetUpdateSelectedRegionCount();
+
+	EXPECT_TRUE(host.KeyDown('B', MockHost::ModifierAlt));
+	EXPECT_EQ(host.GetControl().GetUpdateSelectedRegionCount(), updateCount);
+
+	// Switching to another mode changes the preview.
+	EXPECT_TRUE(host.KeyDown('B'));
+	EXPECT_EQ(host.GetControl().GetUpdateSelectedRegionCount(), updateCount + 1);
+}
+
+// A thickness of 1 and -1 select the same cells of a square selection, so the
+// change from one to the other does not update the preview.
+TEST(MockHostTests, ThicknessChangeThatKeepsTheSelectedCellsIsSkipped)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.MouseMove(63, 63);
+
+	const uint32_t updateCount = host.GetControl().GetUpdateSelectedRegionCount();
+	const int64_t cost = host.GetControl().GetPreviewCost();
+
+	EXPECT_TRUE(host.MouseWheel(-120, MockHost::ModifierAlt));
+	EXPECT_EQ(host.GetControl().GetUpdateSelectedRegionCount(), updateCount);
+	EXPECT_EQ(host.GetControl().GetPreviewCost(), cost);
+
+	// The next step back to 1 is skipped too, the step after it is not.
+	EXPECT_TRUE(host.MouseWheel(120, MockHost::ModifierAlt));
+	EXPECT_EQ(host.GetControl().GetUpdateSelectedRegionCount(), updateCount);
+	EXPECT_TRUE(host.MouseWheel(120, MockHost::ModifierAlt));
+	EXPECT_EQ(host.GetControl().GetUpdateSelectedRegionCount(), updateCount + 1);
+}
+
+TEST(MockHostTests, QueuedSelectionsAreDemolishedInOneCall)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 127, 127), 100, 1);
+
+	host.Drag(0, 0, 31, 31, MockHost::ModifierShift);
+	host.Drag(16, 16, 47, 47, MockHost::ModifierShift);
+	host.Drag(100, 100, 103, 103, MockHost::ModifierShift);
+
+	MockDemolition& demolition = host.GetDemolition();
+
+	EXPECT_EQ(demolition.GetDemolishRegionCallCount(true), 0u);
+	EXPECT_EQ(grid.GetOccupantCount(), 128u * 128u);
+
+	EXPECT_TRUE(host.KeyDown(VK_RETURN));
+
+	ASSERT_EQ(demolition.GetDemolishRegionCallCount(true), 1u);
+
+	const MockDemolition::DemolishRegionCall& call = demolition.GetDemolishRegionCalls().back();
+	const uint32_t selectedCells = (32 * 32 * 2) - (16 * 16) + (4 * 4);
+
+	EXPECT_EQ(call.bounds.topLeftX, 0);
+	EXPECT_EQ(call.bounds.topLeftY, 0);
+	EXPECT_EQ(call.bounds.bottomRightX, 103);
+	EXPECT_EQ(call.bounds.bottomRightY, 103);
+	EXPECT_EQ(call.selectedCellCount, selectedCells);
+	EXPECT_EQ(call.pDemolishEffectOccupant, host.GetControl().GetDemolishEffectOccupant());
+	EXPECT_EQ(grid.GetOccupantCount(), (128u * 128u) - selectedCells);
+
+	// The queue is empty after it has been demolished.
+	EXPECT_FALSE(host.KeyDown(VK_RETURN));
+	EXPECT_EQ(demolition.GetDemolishRegionCallCount(true), 1u);
+}
+
+TEST(MockHostTests, QueuedSelectionsMustUseTheSameMode)
+{
+	MockHost host;
+	OccupantGrid& grid = host.GetGrid();
+
+	grid.AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.Drag(0, 0, 15, 15, MockHost::ModifierShift);
+	host.KeyDown('B', MockHost::ModifierControl);
+	host.Drag(32, 32, 47, 47, MockHost::ModifierShift);
+	host.KeyDown(VK_RETURN);
+
+	const MockDemolition& demolition = host.GetDemolition();
+
+	// The flora selection is not queued with the earlier selection.
+	ASSERT_EQ(demolition.GetDemolishRegionCallCount(true), 1u);
+	EXPECT_EQ(demolition.GetDemolishRegionCalls().back().bounds.bottomRightX, 15);
+	EXPECT_EQ(grid.GetOccupantCount(), (64u * 64u) - (16u * 16u));
+}
+
+TEST(MockHostTests, EscapeClearsTheQueuedSelections)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.Drag(0, 0, 15, 15, MockHost::ModifierShift);
+	host.Drag(20, 20, 25, 25, MockHost::ModifierShift);
+
+	EXPECT_TRUE(host.KeyDown(VK_ESCAPE));
+	EXPECT_FALSE(host.KeyDown(VK_RETURN));
+	EXPECT_EQ(host.GetDemolition().GetDemolishRegionCallCount(true), 0u);
+	EXPECT_EQ(host.GetGrid().GetOccupantCount(), 64u * 64u);
+}
+
+TEST(MockHostTests, PreviewIncludesTheQueuedSelections)
+{
+	MockHost host;
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 100, 1);
+
+	host.MouseDown(40, 40);
+	host.MouseMove(43, 43);
+
+	const int64_t selectionCost = host.GetControl().GetPreviewCost();
+
+	host.MouseUp();
+
+	host.Drag(0, 0, 3, 3, MockHost::ModifierShift);
+	host.MouseDown(20, 20);
+	host.MouseMove(23, 23);
+
+	// The two selections have the same number of trees.
+	EXPECT_EQ(host.GetControl().GetPreviewCost(), selectionCost * 2);
+}
+
+TEST(MockHostTests, SettingsAreReadFromTheIniFile)
+{
+	const std::filesystem::path path = MockFileSystem::GetDirectory() / "SettingsTest.ini";
+
+	std::filesystem::create_directories(path.parent_path());
+	{
+		std::ofstream file(path);
+		file << "[BulldozeExtensions]\n";
+		file << "TimeSlicedDemolition=true\n";
+		file << "TimeSliceBudgetMilliseconds=500\n";
+		file << "TimeSlicedDemolitionMinimumCells=1024\n";
+		file << "AsyncLogOverflow=Block\n";
+		file << "OccupantTypes=0x74758926,foo, 123 ,0x2A499F85\n";
+	}
+
+	Settings settings;
+	settings.Load(path);
+
+	EXPECT_TRUE(settings.TimeSlicedDemolition());
+	EXPECT_EQ(settings.TimeSliceBudgetMilliseconds(), 100u);
+	EXPECT_EQ(settings.TimeSlicedDemolitionMinimumCells(), 1024u);
+	EXPECT_EQ(settings.AsyncLogOverflow(), LogOverflowPolicy::Block);
+	EXPECT_FALSE(settings.BackgroundSelectionGeometry());
+	EXPECT_EQ(settings.OccupantTypes(), (std::vector<uint32_t>{ 0x74758926, 123, 0x2A499F85 }));
+
+	std::filesystem::remove(path);
+}
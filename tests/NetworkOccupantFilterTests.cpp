@@ -0,0 +1,104 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MockOccupant.h"
+#include "NetworkOccupantFilter.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <new>
+
+namespace
+{
+	constexpr uint32_t RoadFlag = static_cast<uint32_t>(NetworkTypeFlags::Road);
+	constexpr uint32_t PowerPoleFlag = static_cast<uint32_t>(NetworkTypeFlags::PowerPole);
+
+	// Storage for an occupant that is destroyed and replaced by a different one at the
+	// same address, like a network piece that the game rebuilds during a demolition.
+	class ReusedOccupantAddress
+	{
+	public:
+		ReusedOccupantAddress()
+			: pOccupant(nullptr)
+		{
+		}
+
+		~ReusedOccupantAddress()
+		{
+			Destroy();
+		}
+
+		MockNetworkOccupant* Create(uint32_t networkFlags)
+		{
+			Destroy();
+			pOccupant = new (storage) MockNetworkOccupant(SC4Rect<int32_t>(0, 0, 0, 0), networkFlags, 10);
+
+			return pOccupant;
+		}
+
+	private:
+		void Destroy()
+		{
+			if (pOccupant)
+			{
+				pOccupant->~MockNetworkOccupant();
+				pOccupant = nullptr;
+			}
+		}
+
+		alignas(MockNetworkOccupant) unsigned char storage[sizeof(MockNetworkOccupant)];
+		MockNetworkOccupant* pOccupant;
+	};
+}
+
+TEST(NetworkOccupantFilterTests, NetworkOccupantsAreTestedByNetworkType)
+{
+	NetworkOccupantFilter filter(NetworkTypeFlags::AllTransportationNetworks);
+	MockNetworkOccupant road(SC4Rect<int32_t>(0, 0, 3, 0), RoadFlag, 10);
+	MockNetworkOccupant powerPole(SC4Rect<int32_t>(0, 1, 0, 1), PowerPoleFlag, 10);
+
+	EXPECT_TRUE(filter.IsOccupantIncluded(&road));
+	EXPECT_FALSE(filter.IsOccupantIncluded(&powerPole));
+
+	// The network interface is released after each test.
+	EXPECT_EQ(road.GetQueryInterfaceCount(), 1u);
+	EXPECT_EQ(road.GetRefCount(), 0u);
+	EXPECT_EQ(powerPole.GetRefCount(), 0u);
+}
+
+TEST(NetworkOccupantFilterTests, NonNetworkOccupantsAreRejectedByType)
+{
+	NetworkOccupantFilter filter(NetworkTypeFlags::AllTransportationNetworks);
+	MockOccupant tree(MockOccupantType::Flora, SC4Rect<int32_t>(0, 0, 0, 0), 5);
+
+	EXPECT_FALSE(filter.IsOccupantIncluded(&tree));
+	EXPECT_EQ(tree.GetQueryInterfaceCount(), 0u);
+}
+
+TEST(NetworkOccupantFilterTests, ReusedAddressIsTestedAgain)
+{
+	NetworkOccupantFilter filter(NetworkTypeFlags::AllTransportationNetworks);
+	ReusedOccupantAddress address;
+
+	// A demolition can replace a network piece with a different one at the same address.
+	EXPECT_TRUE(filter.IsOccupantIncluded(address.Create(RoadFlag)));
+	EXPECT_FALSE(filter.IsOccupantIncluded(address.Create(PowerPoleFlag)));
+	EXPECT_TRUE(filter.IsOccupantIncluded(address.Create(RoadFlag)));
+}
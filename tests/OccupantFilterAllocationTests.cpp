@@ -0,0 +1,204 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MockHost.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <set>
+
+// Counts the allocations that the test thread makes while counting is enabled.
+namespace
+{
+	thread_local bool countAllocations = false;
+	thread_local uint64_t allocationCount = 0;
+}
+
+void* operator new(std::size_t size)
+{
+	if (countAllocations)
+	{
+		allocationCount++;
+	}
+
+	void* ptr = std::malloc(size != 0 ? size : 1);
+
+	if (!ptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace
+{
+	// Records the filter of each preview without allocating, so the only
+	// allocations that are counted are the ones that the hooks make.
+	class FilterRecordingDemolition : public MockDemolition
+	{
+	public:
+		explicit FilterRecordingDemolition(OccupantGrid& grid)
+			: MockDemolition(grid),
+			  firstFilter(nullptr),
+			  differentFilterCount(0),
+			  callCount(0)
+		{
+		}
+
+		bool DemolishRegion(
+			bool demolish,
+			SC4CellRegion<int32_t> const& cellRegion,
+			int32_t privilegeType,
+			uint32_t flags,
+			bool clearZonedArea,
+			cISC4OccupantFilter* pOccupantFilter,
+			int64_t* totalCost,
+			intptr_t demolishedOccupantSet,
+			cISC4Occupant* pDemolishEffectOccupant,
+			long demolishEffectX,
+			long demolishEffectZ) override
+		{
+			if (callCount == 0)
+			{
+				firstFilter = pOccupantFilter;
+			}
+			else if (pOccupantFilter != firstFilter)
+			{
+				differentFilterCount++;
+			}
+
+			callCount++;
+			return true;
+		}
+
+		cISC4OccupantFilter* firstFilter;
+		uint32_t differentFilterCount;
+		uint32_t callCount;
+	};
+
+	struct PreviewAllocations
+	{
+		uint64_t allocationCount;
+		cISC4OccupantFilter* pOccupantFilter;
+		uint32_t differentFilterCount;
+	};
+
+	PreviewAllocations RunPreviews(MockHost& host, int32_t count)
+	{
+		FilterRecordingDemolition demolition(host.GetGrid());
+		MockViewInputControlDemolish& control = host.GetControl();
+
+		host.MouseDown(10, 10);
+		host.MouseMove(73, 41);
+
+		allocationCount = 0;
+		countAllocations = true;
+
+		for (int32_t i = 0; i < count; i++)
+		{
+			int64_t cost = 0;
+
+			cSC4ViewInputControlDemolishHooks::UpdateSelectedRegionDemolishRegion(
+				&demolition,
+				nullptr,
+				*control.pCellRegion,
+				0,
+				0,
+				false,
+				nullptr,
+				&cost,
+				0,
+				nullptr,
+				0,
+				0);
+		}
+
+		countAllocations = false;
+
+		host.MouseUp();
+
+		return PreviewAllocations{ allocationCount, demolition.firstFilter, demolition.differentFilterCount };
+	}
+}
+
+// The filters are created when the city is loaded, a preview reuses them.
+TEST(OccupantFilterAllocationTests, PreviewsDoNotAllocateFilters)
+{
+	constexpr int32_t PreviewCount = 10000;
+
+	// The counter sees the allocations of this thread.
+	allocationCount = 0;
+	countAllocations = true;
+	int* volatile pValue = new int(0);
+	delete pValue;
+	countAllocations = false;
+	ASSERT_EQ(allocationCount, 1u);
+
+	MockHost host;
+	std::set<cISC4OccupantFilter*> filters;
+
+	struct Mode
+	{
+		int32_t virtualKeyCode;
+		uint32_t modifiers;
+		bool hasFilter;
+	};
+
+	// Flora, props, networks, rail and the diagonal mode, which demolishes everything.
+	const Mode modes[] =
+	{
+		{ 'B', MockHost::ModifierControl, true },
+		{ 'B', MockHost::ModifierControl, true },
+		{ 'B', MockHost::ModifierShift, true },
+		{ 'B', MockHost::ModifierShift, true },
+		{ 'B', MockHost::ModifierAlt, false },
+	};
+
+	for (const Mode& mode : modes)
+	{
+		host.KeyDown(mode.virtualKeyCode, mode.modifiers);
+
+		const PreviewAllocations previews = RunPreviews(host, PreviewCount);
+
+		EXPECT_EQ(previews.allocationCount, 0u);
+		EXPECT_EQ(previews.differentFilterCount, 0u);
+		EXPECT_EQ(previews.pOccupantFilter != nullptr, mode.hasFilter);
+
+		if (previews.pOccupantFilter)
+		{
+			filters.insert(previews.pOccupantFilter);
+		}
+	}
+
+	EXPECT_EQ(filters.size(), 4u);
+}
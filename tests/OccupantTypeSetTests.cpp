@@ -0,0 +1,125 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OccupantTypeSet.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+	// Checks every ID of the set, its neighbours and random IDs against a std::set.
+	void ExpectSameAsStdSet(const std::vector<uint32_t>& types, std::mt19937& random)
+	{
+		const OccupantTypeSet set(types.data(), types.size());
+		const std::set<uint32_t> expected(types.begin(), types.end());
+
+		ASSERT_EQ(set.GetCount(), expected.size());
+		EXPECT_EQ(set.IsEmpty(), expected.empty());
+
+		std::vector<uint32_t> queries = { 0, 1, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF };
+
+		for (const uint32_t type : types)
+		{
+			queries.push_back(type);
+			queries.push_back(type - 1);
+			queries.push_back(type + 1);
+		}
+
+		for (int32_t i = 0; i < 200; i++)
+		{
+			queries.push_back(random());
+		}
+
+		for (const uint32_t query : queries)
+		{
+			ASSERT_EQ(set.Contains(query), expected.contains(query))
+				<< "count: " << types.size() << ", query: 0x" << std::hex << query;
+		}
+	}
+}
+
+TEST(OccupantTypeSetTests, EmptySetContainsNothing)
+{
+	const OccupantTypeSet set;
+
+	EXPECT_TRUE(set.IsEmpty());
+	EXPECT_EQ(set.GetCount(), 0u);
+	EXPECT_FALSE(set.Contains(0));
+	EXPECT_FALSE(set.Contains(0xFFFFFFFF));
+}
+
+TEST(OccupantTypeSetTests, DuplicatesAreCountedOnce)
+{
+	const OccupantTypeSet set = { 0x2A499F85, 0x278128A0, 0x2A499F85 };
+
+	EXPECT_EQ(set.GetCount(), 2u);
+	EXPECT_TRUE(set.Contains(0x2A499F85));
+	EXPECT_TRUE(set.Contains(0x278128A0));
+	EXPECT_FALSE(set.Contains(0x74758926));
+}
+
+// The sizes around 32 switch between the scan and the hash lookup, and the sizes
+// that are not a multiple of 4 use the padding of the last scan block.
+TEST(OccupantTypeSetTests, MatchesStdSetAroundTheScanLimit)
+{
+	std::mt19937 random(8);
+
+	for (size_t count = 1; count <= 70; count++)
+	{
+		std::vector<uint32_t> types;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			types.push_back(random());
+		}
+
+		ExpectSameAsStdSet(types, random);
+	}
+}
+
+// The SSE2 scan compares signed 32-bit lanes, the IDs with the high bit set must
+// still only match themselves.
+TEST(OccupantTypeSetTests, MatchesStdSetWithHighBitIds)
+{
+	std::mt19937 random(9);
+
+	for (const size_t count : { 1, 3, 4, 31, 32, 33, 64 })
+	{
+		std::vector<uint32_t> types;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			types.push_back(random() | 0x80000000);
+		}
+
+		types[0] = 0xFFFFFFFF;
+
+		if (count > 1)
+		{
+			types[1] = 0x80000000;
+		}
+
+		ExpectSameAsStdSet(types, random);
+	}
+}
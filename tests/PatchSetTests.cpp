@@ -0,0 +1,244 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MemoryProtection.h"
+#include "PatchSet.h"
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	// Read-only anonymous pages that stand in for the game's code.
+	class ProtectedPages
+	{
+	public:
+		explicit ProtectedPages(size_t count)
+			: size(count * MemoryProtection::GetPageSize()),
+			  data(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0))
+		{
+			if (data == MAP_FAILED)
+			{
+				throw std::runtime_error("mmap failed.");
+			}
+
+			// int3 padding with a recognizable byte at the start of each page.
+			std::memset(data, 0xCC, size);
+			mprotect(data, size, PROT_READ);
+		}
+
+		~ProtectedPages()
+		{
+			munmap(data, size);
+		}
+
+		uintptr_t GetAddress(size_t offset) const
+		{
+			return reinterpret_cast<uintptr_t>(data) + offset;
+		}
+
+		const uint8_t* GetBytes(size_t offset) const
+		{
+			return static_cast<const uint8_t*>(data) + offset;
+		}
+
+		uint32_t GetProtection(size_t offset) const
+		{
+			uint32_t protection = 0;
+			EXPECT_TRUE(MemoryProtection::GetProtection(GetAddress(offset), protection));
+			return protection;
+		}
+
+		bool IsUnchanged() const
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				if (GetBytes(0)[i] != 0xCC)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		size_t size;
+		void* data;
+	};
+
+	// A page of a read-only file that is mapped shared in place of an existing page,
+	// mprotect cannot make it writable.
+	class ReadOnlyFilePage
+	{
+	public:
+		explicit ReadOnlyFilePage(uintptr_t address)
+			: file(std::tmpfile()),
+			  data(MAP_FAILED)
+		{
+			const size_t pageSize = MemoryProtection::GetPageSize();
+
+			if (file && ftruncate(fileno(file), static_cast<off_t>(pageSize)) == 0)
+			{
+				// Reopen the file read-only, the shared mapping then cannot become writable.
+				char path[64]{};
+				std::snprintf(path, sizeof(path), "/proc/self/fd/%d", fileno(file));
+
+				const int descriptor = open(path, O_RDONLY);
+
+				if (descriptor >= 0)
+				{
+					data = mmap(reinterpret_cast<void*>(address), pageSize, PROT_READ, MAP_SHARED | MAP_FIXED, descriptor, 0);
+					close(descriptor);
+				}
+			}
+		}
+
+		~ReadOnlyFilePage()
+		{
+			if (data != MAP_FAILED)
+			{
+				munmap(data, MemoryProtection::GetPageSize());
+			}
+
+			if (file)
+			{
+				std::fclose(file);
+			}
+		}
+
+		bool IsMapped() const
+		{
+			return data != MAP_FAILED;
+		}
+
+		uintptr_t GetAddress() const
+		{
+			return reinterpret_cast<uintptr_t>(data);
+		}
+
+	private:
+		FILE* file;
+		void* data;
+	};
+}
+
+TEST(PatchSetTests, AppliesThePatchesAndRestoresTheProtection)
+{
+	ProtectedPages pages(3);
+	const size_t pageSize = MemoryProtection::GetPageSize();
+
+	PatchSet patchSet;
+	patchSet.AddBytes(pages.GetAddress(16), { 0x56, 0x50 }, { 0xCC, 0xCC });
+	// A patch that crosses the boundary between the second and third pages.
+	patchSet.AddCallHook(pages.GetAddress((2 * pageSize) - 2), pages.GetAddress(64), { 0xCC, 0xCC, 0xCC, 0xCC, 0xCC });
+	patchSet.AddJumpTableHook(pages.GetAddress(pageSize + 32), 0x12345678, PatchSet::GetJumpTableBytes(0xCCCCCCCCCCCCCCCCULL));
+	patchSet.Apply();
+
+	EXPECT_EQ(pages.GetBytes(16)[0], 0x56);
+	EXPECT_EQ(pages.GetBytes(16)[1], 0x50);
+
+	const std::vector<uint8_t> call = PatchSet::GetCallBytes(pages.GetAddress((2 * pageSize) - 2), pages.GetAddress(64));
+	EXPECT_EQ(std::memcmp(pages.GetBytes((2 * pageSize) - 2), call.data(), call.size()), 0);
+
+	uintptr_t tableEntry = 0;
+	std::memcpy(&tableEntry, pages.GetBytes(pageSize + 32), sizeof(tableEntry));
+	EXPECT_EQ(tableEntry, 0x12345678u);
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		EXPECT_EQ(pages.GetProtection(i * pageSize), static_cast<uint32_t>(PROT_READ));
+	}
+}
+
+TEST(PatchSetTests, CallBytesAreRelativeToTheNextInstruction)
+{
+	const std::vector<uint8_t> bytes = PatchSet::GetCallBytes(0x4b9d02, 0x4b9d02 + 5 + 0x100);
+
+	ASSERT_EQ(bytes.size(), 5u);
+	EXPECT_EQ(bytes[0], 0xE8);
+	EXPECT_EQ(bytes[1], 0x00);
+	EXPECT_EQ(bytes[2], 0x01);
+	EXPECT_EQ(bytes[3], 0x00);
+	EXPECT_EQ(bytes[4], 0x00);
+}
+
+TEST(PatchSetTests, OverlappingPatchesAreRejected)
+{
+	ProtectedPages pages(1);
+
+	PatchSet patchSet;
+	patchSet.AddCallHook(pages.GetAddress(100), pages.GetAddress(0));
+	patchSet.AddBytes(pages.GetAddress(104), { 0x90 });
+
+	EXPECT_THROW(patchSet.Apply(), std::runtime_error);
+	EXPECT_TRUE(pages.IsUnchanged());
+	EXPECT_EQ(pages.GetProtection(0), static_cast<uint32_t>(PROT_READ));
+}
+
+TEST(PatchSetTests, MismatchedBytesAreRejected)
+{
+	ProtectedPages pages(1);
+
+	PatchSet patchSet;
+	patchSet.AddBytes(pages.GetAddress(0), { 0x90 }, { 0xCC });
+	// The call does not target the expected function.
+	patchSet.AddCallHook(pages.GetAddress(100), pages.GetAddress(0), PatchSet::GetCallBytes(pages.GetAddress(100), pages.GetAddress(8)));
+
+	EXPECT_THROW(patchSet.Apply(), std::runtime_error);
+	EXPECT_TRUE(pages.IsUnchanged());
+	EXPECT_EQ(pages.GetProtection(0), static_cast<uint32_t>(PROT_READ));
+}
+
+TEST(PatchSetTests, ExpectedBytesLongerThanThePatchAreRejected)
+{
+	ProtectedPages pages(1);
+
+	PatchSet patchSet;
+	patchSet.AddBytes(pages.GetAddress(0), { 0x90 }, { 0xCC, 0xCC });
+
+	EXPECT_THROW(patchSet.Apply(), std::runtime_error);
+	EXPECT_TRUE(pages.IsUnchanged());
+}
+
+TEST(PatchSetTests, FailureRollsBackAndRestoresTheProtection)
+{
+	// The second page is replaced by the file, the pages are unprotected in address
+	// order so the first page is already writable when the second one fails.
+	ProtectedPages pages(2);
+	ReadOnlyFilePage readOnlyPage(pages.GetAddress(MemoryProtection::GetPageSize()));
+
+	ASSERT_TRUE(readOnlyPage.IsMapped());
+
+	PatchSet patchSet;
+	patchSet.AddBytes(pages.GetAddress(0), { 0x90 });
+	patchSet.AddBytes(readOnlyPage.GetAddress(), { 0x90 });
+
+	EXPECT_THROW(patchSet.Apply(), std::runtime_error);
+	EXPECT_EQ(*pages.GetBytes(0), 0xCC);
+	EXPECT_EQ(pages.GetProtection(0), static_cast<uint32_t>(PROT_READ));
+	EXPECT_EQ(*reinterpret_cast<const uint8_t*>(readOnlyPage.GetAddress()), 0);
+}
@@ -0,0 +1,255 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DiagonalRegion.h"
+#include "RegionDecomposition.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	bool Contains(const SC4Rect<int32_t>& rect, int32_t x, int32_t z)
+	{
+		return x >= rect.topLeftX && x <= rect.bottomRightX && z >= rect.topLeftY && z <= rect.bottomRightY;
+	}
+
+	// Checks that every set cell is covered by exactly one piece and that the pieces
+	// stay inside the region bounds.
+	void ExpectCoversSetCells(const SC4CellRegion<int32_t>& region, const std::vector<SC4Rect<int32_t>>& pieces)
+	{
+		const SC4Rect<int32_t>& bounds = region.bounds;
+
+		for (const SC4Rect<int32_t>& piece : pieces)
+		{
+			EXPECT_LE(piece.topLeftX, piece.bottomRightX);
+			EXPECT_LE(piece.topLeftY, piece.bottomRightY);
+			EXPECT_GE(piece.topLeftX, bounds.topLeftX);
+			EXPECT_GE(piece.topLeftY, bounds.topLeftY);
+			EXPECT_LE(piece.bottomRightX, bounds.bottomRightX);
+			EXPECT_LE(piece.bottomRightY, bounds.bottomRightY);
+		}
+
+		for (int32_t x = bounds.topLeftX; x <= bounds.bottomRightX; x++)
+		{
+			for (int32_t z = bounds.topLeftY; z <= bounds.bottomRightY; z++)
+			{
+				size_t coveringPieces = 0;
+
+				for (const SC4Rect<int32_t>& piece : pieces)
+				{
+					if (Contains(piece, x, z))
+					{
+						coveringPieces++;
+					}
+				}
+
+				const bool set = region.cellMap.GetValue(x - bounds.topLeftX, z - bounds.topLeftY);
+
+				EXPECT_LE(coveringPieces, 1u) << "x: " << x << ", z: " << z;
+
+				if (set)
+				{
+					EXPECT_EQ(coveringPieces, 1u) << "x: " << x << ", z: " << z;
+				}
+			}
+		}
+	}
+
+	uint64_t GetPlanCost(const std::vector<SC4Rect<int32_t>>& pieces, uint64_t pieceOverhead)
+	{
+		return RegionDecomposition::GetCellCount(pieces) + (pieces.size() * pieceOverhead);
+	}
+
+	// Returns the lowest cost of every split into runs of consecutive rows,
+	// each run is trimmed to its set cells.
+	uint64_t GetBruteForceCost(const SC4CellRegion<int32_t>& region, uint64_t pieceOverhead)
+	{
+		const uint32_t rowCount = region.cellMap.GetRowCount();
+		const uint32_t columnCount = region.cellMap.GetColumnCount();
+		uint64_t bestCost = (std::numeric_limits<uint64_t>::max)();
+
+		// Bit i of the mask starts a new run at row i + 1.
+		for (uint32_t mask = 0; mask < (1U << (rowCount - 1)); mask++)
+		{
+			uint64_t cost = 0;
+			uint32_t start = 0;
+
+			for (uint32_t end = 1; end <= rowCount; end++)
+			{
+				if (end != rowCount && (mask & (1U << (end - 1))) == 0)
+				{
+					continue;
+				}
+
+				int32_t firstRow = -1;
+				int32_t lastRow = -1;
+				int32_t firstColumn = static_cast<int32_t>(columnCount);
+				int32_t lastColumn = -1;
+
+				for (uint32_t row = start; row < end; row++)
+				{
+					for (uint32_t column = 0; column < columnCount; column++)
+					{
+						if (region.cellMap.GetValue(row, column))
+						{
+							if (firstRow < 0)
+							{
+								firstRow = static_cast<int32_t>(row);
+							}
+							lastRow = static_cast<int32_t>(row);
+							firstColumn = (std::min)(firstColumn, static_cast<int32_t>(column));
+							lastColumn = (std::max)(lastColumn, static_cast<int32_t>(column));
+						}
+					}
+				}
+
+				if (firstRow >= 0)
+				{
+					cost += pieceOverhead
+						+ static_cast<uint64_t>(lastRow - firstRow + 1) * static_cast<uint64_t>(lastColumn - firstColumn + 1);
+				}
+
+				start = end;
+			}
+
+			bestCost = (std::min)(bestCost, cost);
+		}
+
+		return bestCost;
+	}
+}
+
+TEST(RegionDecompositionTests, EmptyRegionHasNoPieces)
+{
+	const SC4CellRegion<int32_t> region(0, 0, 15, 15, false);
+	std::vector<SC4Rect<int32_t>> pieces;
+
+	RegionDecomposition::Plan(region, pieces);
+
+	EXPECT_TRUE(pieces.empty());
+}
+
+TEST(RegionDecompositionTests, FullRegionIsOnePiece)
+{
+	const SC4CellRegion<int32_t> region(10, 20, 41, 51, true);
+	std::vector<SC4Rect<int32_t>> pieces;
+
+	RegionDecomposition::Plan(region, pieces);
+
+	ASSERT_EQ(pieces.size(), 1u);
+	EXPECT_EQ(pieces[0].topLeftX, 10);
+	EXPECT_EQ(pieces[0].topLeftY, 20);
+	EXPECT_EQ(pieces[0].bottomRightX, 41);
+	EXPECT_EQ(pieces[0].bottomRightY, 51);
+}
+
+TEST(RegionDecompositionTests, DiagonalPiecesCoverTheSetCells)
+{
+	for (int32_t size : { 8, 33, 128 })
+	{
+		for (int32_t thickness = -9; thickness <= 9; thickness++)
+		{
+			if (thickness == 0)
+			{
+				continue;
+			}
+
+			SCOPED_TRACE(testing::Message() << "size: " << size << ", thickness: " << thickness);
+
+			const SC4CellRegion<int32_t> region = DiagonalRegion::Create(5, 7, 5 + size - 1, 7 + size - 1, thickness);
+			std::vector<SC4Rect<int32_t>> pieces;
+
+			RegionDecomposition::Plan(region, pieces);
+
+			ExpectCoversSetCells(region, pieces);
+
+			// The plan is never worse than scanning the whole bounds in one call.
+			const uint64_t boundsCells = static_cast<uint64_t>(size) * static_cast<uint64_t>(size);
+
+			EXPECT_LE(
+				GetPlanCost(pieces, RegionDecomposition::DefaultPieceOverhead),
+				boundsCells + RegionDecomposition::DefaultPieceOverhead);
+		}
+	}
+}
+
+TEST(RegionDecompositionTests, LargeDiagonalScansFewerCells)
+{
+	const SC4CellRegion<int32_t> region = DiagonalRegion::Create(0, 0, 511, 511, 1);
+	std::vector<SC4Rect<int32_t>> pieces;
+
+	RegionDecomposition::Plan(region, pieces);
+
+	EXPECT_GT(pieces.size(), 1u);
+	EXPECT_LT(RegionDecomposition::GetCellCount(pieces), 512u * 512u / 16u);
+}
+
+TEST(RegionDecompositionTests, PlanHasTheLowestCost)
+{
+	std::mt19937 random(12345);
+	std::bernoulli_distribution setCell(0.2);
+
+	for (uint64_t pieceOverhead : { 0, 4, 64 })
+	{
+		for (int iteration = 0; iteration < 200; iteration++)
+		{
+			SC4CellRegion<int32_t> region(0, 0, 9, 11, false);
+
+			for (uint32_t row = 0; row < 10; row++)
+			{
+				for (uint32_t column = 0; column < 12; column++)
+				{
+					region.cellMap.SetValue(row, column, setCell(random));
+				}
+			}
+
+			std::vector<SC4Rect<int32_t>> pieces;
+			RegionDecomposition::Plan(region, pieces, pieceOverhead);
+
+			ExpectCoversSetCells(region, pieces);
+			EXPECT_EQ(GetPlanCost(pieces, pieceOverhead), GetBruteForceCost(region, pieceOverhead));
+		}
+	}
+}
+
+TEST(RegionDecompositionTests, ExtractCopiesTheCellsInsideThePiece)
+{
+	const SC4CellRegion<int32_t> region = DiagonalRegion::Create(100, 200, 163, 263, 3);
+	const SC4Rect<int32_t> rect(110, 205, 130, 240);
+	const SC4CellRegion<int32_t> piece = RegionDecomposition::Extract(region, rect);
+
+	ASSERT_EQ(piece.bounds.topLeftX, rect.topLeftX);
+	ASSERT_EQ(piece.bounds.bottomRightY, rect.bottomRightY);
+
+	for (int32_t x = rect.topLeftX; x <= rect.bottomRightX; x++)
+	{
+		for (int32_t z = rect.topLeftY; z <= rect.bottomRightY; z++)
+		{
+			EXPECT_EQ(
+				piece.cellMap.GetValue(x - rect.topLeftX, z - rect.topLeftY),
+				region.cellMap.GetValue(x - region.bounds.topLeftX, z - region.bounds.topLeftY));
+		}
+	}
+}
@@ -0,0 +1,318 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryMappedFile.h"
+#include "MockFileSystem.h"
+#include "RingLog.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::filesystem::path GetTestFilePath(const char* fileName)
+	{
+		std::filesystem::create_directories(MockFileSystem::GetDirectory());
+
+		const std::filesystem::path path = MockFileSystem::GetDirectory() / fileName;
+		std::filesystem::remove(path);
+
+		return path;
+	}
+
+	std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ifstream::in | std::ifstream::binary);
+
+		return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	}
+
+	std::string DecodeFile(const std::filesystem::path& path)
+	{
+		const std::vector<uint8_t> fileData = ReadFile(path);
+		std::string text;
+
+		EXPECT_TRUE(RingLog::Decode(fileData.data(), fileData.size(), text));
+
+		return text;
+	}
+
+	// The text that Decode should return after all of the text was written to a ring
+	// that holds capacity bytes: the last capacity bytes without the partly
+	// overwritten oldest line.
+	std::string ExpectedWrappedText(const std::string& allText, size_t capacity)
+	{
+		const std::string ringText = allText.substr(allText.size() - capacity);
+
+		return ringText.substr(ringText.find('\n') + 1);
+	}
+
+	std::string MakeLine(int index)
+	{
+		return "line " + std::to_string(index) + '\n';
+	}
+
+	// Changes the ring bytes of a closed log file without advancing its write
+	// position, as a write that was interrupted before it completed would.
+	void WriteTornText(const std::filesystem::path& path, size_t ringOffset, const char* text)
+	{
+		MemoryMappedFile file;
+
+		ASSERT_TRUE(file.Open(path, std::filesystem::file_size(path)));
+		std::memcpy(file.GetData() + RingLog::HeaderSize + ringOffset, text, std::strlen(text));
+		file.Close();
+	}
+}
+
+TEST(RingLogTests, MappedFileIsExtendedWithZerosAndKeepsItsData)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.mapped");
+
+	MemoryMappedFile file;
+
+	ASSERT_TRUE(file.Open(path, 4096));
+	ASSERT_EQ(file.GetSize(), 4096u);
+
+	for (size_t i = 0; i < file.GetSize(); i++)
+	{
+		ASSERT_EQ(file.GetData()[i], 0) << "offset " << i;
+	}
+
+	std::memcpy(file.GetData(), "mapped", 6);
+	file.Flush();
+	file.Close();
+
+	EXPECT_FALSE(file.IsOpen());
+	EXPECT_EQ(std::filesystem::file_size(path), 4096u);
+
+	ASSERT_TRUE(file.Open(path, 8192));
+	EXPECT_EQ(std::filesystem::file_size(path), 8192u);
+	EXPECT_EQ(std::memcmp(file.GetData(), "mapped", 6), 0);
+
+	for (size_t i = 4096; i < file.GetSize(); i++)
+	{
+		ASSERT_EQ(file.GetData()[i], 0) << "offset " << i;
+	}
+
+	file.Close();
+
+	const std::vector<uint8_t> fileData = ReadFile(path);
+
+	ASSERT_EQ(fileData.size(), 8192u);
+	EXPECT_EQ(std::memcmp(fileData.data(), "mapped", 6), 0);
+}
+
+TEST(RingLogTests, DecodeReturnsTheLinesInOrder)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.ringlog");
+
+	RingLog log;
+	std::string allText;
+
+	ASSERT_TRUE(log.Open(path, 4096));
+
+	for (int i = 0; i < 10; i++)
+	{
+		const std::string line = MakeLine(i);
+
+		log.Write(line.data(), line.size());
+		allText += line;
+	}
+
+	log.Close();
+
+	EXPECT_EQ(DecodeFile(path), allText);
+}
+
+TEST(RingLogTests, WrappedLogKeepsTheNewestCompleteLines)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.ringlog");
+	constexpr size_t capacity = 100;
+
+	RingLog log;
+	std::string allText;
+
+	ASSERT_TRUE(log.Open(path, capacity));
+
+	for (int i = 0; i < 1000; i++)
+	{
+		const std::string line = MakeLine(i);
+
+		log.Write(line.data(), line.size());
+		allText += line;
+
+		// Check the file at a range of ring offsets, including the writes that wrap.
+		if (i >= 10 && i % 7 == 0)
+		{
+			EXPECT_EQ(DecodeFile(path), ExpectedWrappedText(allText, capacity)) << "after line " << i;
+		}
+	}
+
+	log.Close();
+
+	const std::string text = DecodeFile(path);
+
+	EXPECT_EQ(text, ExpectedWrappedText(allText, capacity));
+	EXPECT_TRUE(text.ends_with(MakeLine(999)));
+}
+
+TEST(RingLogTests, TextLongerThanTheRingKeepsItsEnd)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.ringlog");
+	constexpr size_t capacity = 64;
+
+	RingLog log;
+	std::string allText;
+
+	ASSERT_TRUE(log.Open(path, capacity));
+
+	for (int i = 0; i < 40; i++)
+	{
+		allText += MakeLine(i);
+	}
+
+	log.Write(allText.data(), allText.size());
+	log.Close();
+
+	EXPECT_EQ(DecodeFile(path), ExpectedWrappedText(allText, capacity));
+}
+
+TEST(RingLogTests, TornWriteIsNotDecoded)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.ringlog");
+
+	RingLog log;
+	std::string allText;
+
+	ASSERT_TRUE(log.Open(path, 4096));
+
+	for (int i = 0; i < 5; i++)
+	{
+		const std::string line = MakeLine(i);
+
+		log.Write(line.data(), line.size());
+		allText += line;
+	}
+
+	log.Close();
+
+	// The text after the write position is not part of the log.
+	WriteTornText(path, allText.size(), "torn li");
+
+	EXPECT_EQ(DecodeFile(path), allText);
+}
+
+TEST(RingLogTests, TornWriteInAWrappedLogOnlyLosesTheOldestLine)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.ringlog");
+	constexpr size_t capacity = 100;
+
+	RingLog log;
+	std::string allText;
+
+	ASSERT_TRUE(log.Open(path, capacity));
+
+	for (int i = 0; i < 50; i++)
+	{
+		const std::string line = MakeLine(i);
+
+		log.Write(line.data(), line.size());
+		allText += line;
+	}
+
+	log.Close();
+
+	const std::string expected = ExpectedWrappedText(allText, capacity);
+
+	// An interrupted write overwrites the start of the oldest line, which is
+	// already skipped because it was partly overwritten by the previous writes.
+	const size_t writeOffset = allText.size() % capacity;
+	const size_t oldestLineLength = allText.size() - expected.size() - (allText.size() - capacity);
+
+	ASSERT_GT(oldestLineLength, 1u);
+
+	const std::string tornText(oldestLineLength - 1, 'x');
+
+	WriteTornText(path, writeOffset, tornText.c_str());
+
+	const std::string text = DecodeFile(path);
+
+	EXPECT_EQ(text, expected);
+	EXPECT_EQ(text.find('x'), std::string::npos);
+}
+
+TEST(RingLogTests, DecodeRejectsInvalidFiles)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.ringlog");
+
+	RingLog log;
+
+	ASSERT_TRUE(log.Open(path, 256));
+	log.Write("line\n", 5);
+	log.Close();
+
+	const std::vector<uint8_t> fileData = ReadFile(path);
+	std::string text;
+
+	EXPECT_FALSE(RingLog::Decode(fileData.data(), RingLog::HeaderSize - 1, text));
+
+	// The ring is shorter than the capacity in the header.
+	EXPECT_FALSE(RingLog::Decode(fileData.data(), fileData.size() - 1, text));
+
+	std::vector<uint8_t> badSignature = fileData;
+	badSignature[0] = 'X';
+
+	EXPECT_FALSE(RingLog::Decode(badSignature.data(), badSignature.size(), text));
+
+	std::vector<uint8_t> zeroCapacity = fileData;
+	std::memset(zeroCapacity.data() + 16, 0, sizeof(uint64_t));
+
+	EXPECT_FALSE(RingLog::Decode(zeroCapacity.data(), zeroCapacity.size(), text));
+	EXPECT_TRUE(text.empty());
+}
+
+TEST(RingLogTests, ReopeningKeepsTheLogUnlessTheCapacityChanges)
+{
+	const std::filesystem::path path = GetTestFilePath("RingLogTests.ringlog");
+
+	RingLog log;
+
+	ASSERT_TRUE(log.Open(path, 256));
+	log.Write("first session\n", 14);
+	log.Close();
+
+	ASSERT_TRUE(log.Open(path, 256));
+	log.Write("second session\n", 15);
+	log.Close();
+
+	EXPECT_EQ(DecodeFile(path), "first session\nsecond session\n");
+
+	ASSERT_TRUE(log.Open(path, 512));
+	log.Write("third session\n", 14);
+	log.Close();
+
+	EXPECT_EQ(DecodeFile(path), "third session\n");
+}
@@ -0,0 +1,219 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagonalRegion.h"
+#include "SelectionWorker.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// These tests are also meant to be run in a ThreadSanitizer build, see the
+// BULLDOZE_EXTENSIONS_SANITIZE_THREAD option in the top level CMakeLists.txt.
+
+namespace
+{
+	struct PostedRequest
+	{
+		SC4Rect<int32_t> bounds;
+		int32_t startX;
+		int32_t startZ;
+		int32_t thickness;
+	};
+
+	bool RegionsMatch(const SC4CellRegion<int32_t>& expected, const SC4CellRegion<int32_t>& actual)
+	{
+		if (expected.bounds.topLeftX != actual.bounds.topLeftX
+			|| expected.bounds.topLeftY != actual.bounds.topLeftY
+			|| expected.bounds.bottomRightX != actual.bounds.bottomRightX
+			|| expected.bounds.bottomRightY != actual.bounds.bottomRightY)
+		{
+			return false;
+		}
+
+		for (uint32_t row = 0; row < expected.cellMap.GetRowCount(); row++)
+		{
+			for (uint32_t column = 0; column < expected.cellMap.GetColumnCount(); column++)
+			{
+				if (expected.cellMap.GetValue(row, column) != actual.cellMap.GetValue(row, column))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// A drag from a fixed click point to a random end point, with a random thickness.
+	PostedRequest CreateRandomRequest(std::mt19937& random)
+	{
+		constexpr int32_t clickX = 64;
+		constexpr int32_t clickZ = 64;
+
+		std::uniform_int_distribution<int32_t> endDistribution(0, 128);
+		std::uniform_int_distribution<int32_t> thicknessDistribution(1, 9);
+
+		const int32_t endX = endDistribution(random);
+		const int32_t endZ = endDistribution(random);
+		const int32_t thickness = thicknessDistribution(random) * (random() & 1 ? 1 : -1);
+
+		return PostedRequest
+		{
+			SC4Rect<int32_t>((std::min)(clickX, endX), (std::min)(clickZ, endZ), (std::max)(clickX, endX), (std::max)(clickZ, endZ)),
+			clickX,
+			clickZ,
+			thickness
+		};
+	}
+
+	void ExpectResultMatchesRequest(const SelectionWorker::Result& result, const PostedRequest& request)
+	{
+		const SC4CellRegion<int32_t> expected = DiagonalRegion::Create(
+			request.bounds.topLeftX,
+			request.bounds.topLeftY,
+			request.bounds.bottomRightX,
+			request.bounds.bottomRightY,
+			request.thickness,
+			request.startX,
+			request.startZ);
+
+		EXPECT_EQ(result.request.thickness, request.thickness);
+		EXPECT_TRUE(RegionsMatch(expected, result.region)) << "request: " << result.request.id;
+	}
+
+	// Polls for the result of the newest request, like the UI thread does on every frame.
+	std::unique_ptr<SelectionWorker::Result> WaitForResult(SelectionWorker& worker)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+		while (std::chrono::steady_clock::now() < deadline)
+		{
+			std::unique_ptr<SelectionWorker::Result> result = worker.TakeResult();
+
+			if (result)
+			{
+				return result;
+			}
+
+			std::this_thread::yield();
+		}
+
+		return nullptr;
+	}
+}
+
+TEST(SelectionWorkerTests, ReturnsTheResultOfTheRequest)
+{
+	SelectionWorker worker;
+	std::mt19937 random(17);
+
+	worker.Start();
+
+	const PostedRequest request = CreateRandomRequest(random);
+	const uint64_t id = worker.Post(request.bounds, request.startX, request.startZ, request.thickness);
+	const std::unique_ptr<SelectionWorker::Result> result = WaitForResult(worker);
+
+	ASSERT_NE(result, nullptr);
+	EXPECT_EQ(result->request.id, id);
+	ExpectResultMatchesRequest(*result, request);
+
+	// A result is only returned once.
+	EXPECT_EQ(worker.TakeResult(), nullptr);
+}
+
+// The UI thread posts a request for every mouse move and polls between them, the
+// only results it can take are for the newest request.
+TEST(SelectionWorkerTests, RapidRequestsOnlyReturnTheNewestResult)
+{
+	SelectionWorker worker;
+	std::mt19937 random(1234);
+	std::vector<PostedRequest> requests;
+	uint64_t lastResultId = 0;
+
+	worker.Start();
+
+	for (int i = 0; i < 5000; i++)
+	{
+		requests.push_back(CreateRandomRequest(random));
+
+		const PostedRequest& request = requests.back();
+		const uint64_t id = worker.Post(request.bounds, request.startX, request.startZ, request.thickness);
+
+		ASSERT_EQ(id, requests.size());
+
+		const std::unique_ptr<SelectionWorker::Result> result = worker.TakeResult();
+
+		if (result)
+		{
+			EXPECT_EQ(result->request.id, id);
+			ExpectResultMatchesRequest(*result, request);
+			lastResultId = result->request.id;
+		}
+	}
+
+	// The last request is always completed, unless its result was taken in the loop.
+	if (lastResultId != requests.size())
+	{
+		const std::unique_ptr<SelectionWorker::Result> result = WaitForResult(worker);
+
+		ASSERT_NE(result, nullptr);
+		EXPECT_EQ(result->request.id, requests.size());
+		ExpectResultMatchesRequest(*result, requests.back());
+	}
+}
+
+TEST(SelectionWorkerTests, StopAndRestartWithRequestsInFlight)
+{
+	SelectionWorker worker;
+	std::mt19937 random(99);
+
+	for (int cycle = 0; cycle < 200; cycle++)
+	{
+		worker.Start();
+		ASSERT_TRUE(worker.IsRunning());
+
+		for (int i = 0; i < 4; i++)
+		{
+			const PostedRequest request = CreateRandomRequest(random);
+
+			worker.Post(request.bounds, request.startX, request.startZ, request.thickness);
+		}
+
+		// Stop deletes the request or result that is still in a mailbox.
+		worker.Stop();
+		ASSERT_FALSE(worker.IsRunning());
+		EXPECT_EQ(worker.TakeResult(), nullptr);
+	}
+
+	worker.Start();
+
+	const PostedRequest request = CreateRandomRequest(random);
+	const uint64_t id = worker.Post(request.bounds, request.startX, request.startZ, request.thickness);
+	const std::unique_ptr<SelectionWorker::Result> result = WaitForResult(worker);
+
+	ASSERT_NE(result, nullptr);
+	EXPECT_EQ(result->request.id, id);
+	ExpectResultMatchesRequest(*result, request);
+}
@@ -0,0 +1,301 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FileSystem.h"
+#include "MockFileSystem.h"
+#include "MockHost.h"
+#include "TraceRecorder.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// The buffer size that the hooks use, the recorder keeps the size of its first start.
+	constexpr size_t EventsPerThread = 65536;
+
+	struct TraceEvent
+	{
+		std::string name;
+		uint32_t threadId;
+		double timestamp;
+		double duration;
+		int32_t cellCount;
+		int32_t mode;
+		int32_t thickness;
+	};
+
+	struct TraceFile
+	{
+		std::vector<TraceEvent> events;
+		uint64_t droppedEvents;
+	};
+
+	// Parses a trace file and checks that it matches the layout that Write produces.
+	TraceFile ReadTrace(const std::filesystem::path& path)
+	{
+		static const std::regex eventPattern(
+			R"re(\{"name":"([^"]+)","cat":"bulldoze","ph":"X","pid":1,"tid":(\d+),)re"
+			R"re("ts":(\d+\.\d{3}),"dur":(\d+\.\d{3}),"args":\{"cells":(-?\d+),"mode":(-?\d+),"thickness":(-?\d+)\}\},?)re");
+		static const std::regex footerPattern(R"re(\],"otherData":\{"droppedEvents":(\d+)\}\})re");
+
+		TraceFile trace{};
+		std::ifstream file(path);
+		std::string line;
+
+		EXPECT_TRUE(std::getline(file, line));
+		EXPECT_EQ(line, R"({"displayTimeUnit":"ms","traceEvents":[)");
+
+		std::vector<std::string> lines;
+
+		while (std::getline(file, line))
+		{
+			lines.push_back(line);
+		}
+
+		// The event list is followed by an empty line and the footer.
+		EXPECT_GE(lines.size(), 2u);
+
+		if (lines.size() < 2)
+		{
+			return trace;
+		}
+
+		std::smatch match;
+
+		EXPECT_TRUE(std::regex_match(lines.back(), match, footerPattern)) << lines.back();
+		trace.droppedEvents = match.empty() ? 0 : std::stoull(match[1]);
+
+		for (size_t i = 0; i < lines.size() - 1; i++)
+		{
+			if (lines[i].empty())
+			{
+				EXPECT_EQ(i, lines.size() - 2);
+				continue;
+			}
+
+			const bool lastEvent = i + 1 == lines.size() - 1 || lines[i + 1].empty();
+
+			if (!std::regex_match(lines[i], match, eventPattern))
+			{
+				ADD_FAILURE() << lines[i];
+				continue;
+			}
+
+			// Only the last event has no trailing comma.
+			EXPECT_EQ(lines[i].back() == ',', !lastEvent) << lines[i];
+
+			TraceEvent event{};
+			event.name = match[1];
+			event.threadId = static_cast<uint32_t>(std::stoul(match[2]));
+			event.timestamp = std::stod(match[3]);
+			event.duration = std::stod(match[4]);
+			event.cellCount = std::stoi(match[5]);
+			event.mode = std::stoi(match[6]);
+			event.thickness = std::stoi(match[7]);
+
+			trace.events.push_back(event);
+		}
+
+		return trace;
+	}
+
+	Settings GetTraceSettings()
+	{
+		const std::filesystem::path path = MockFileSystem::GetDirectory() / "TraceRecorderTests.ini";
+
+		std::filesystem::create_directories(path.parent_path());
+		{
+			std::ofstream file(path);
+			file << "[BulldozeExtensions]\n";
+			file << "TraceEvents=true\n";
+		}
+
+		Settings settings;
+		settings.Load(path);
+
+		std::filesystem::remove(path);
+
+		return settings;
+	}
+
+	// Writes the events that earlier tests left in the buffers, so each test starts empty.
+	void DiscardRecordedEvents()
+	{
+		TraceRecorder& recorder = TraceRecorder::GetInstance();
+
+		recorder.Start(EventsPerThread);
+		ASSERT_TRUE(recorder.Write(FileSystem::GetTraceFilePath()));
+	}
+
+	void RecordEvents(const char* name, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			TraceRecorder::ScopedEvent event(name, static_cast<int32_t>(i));
+		}
+	}
+
+	size_t CountEvents(const TraceFile& trace, const std::string& name)
+	{
+		size_t count = 0;
+
+		for (const TraceEvent& event : trace.events)
+		{
+			count += event.name == name;
+		}
+
+		return count;
+	}
+}
+
+TEST(TraceRecorderTests, MockHostTraceMatchesTheChromeTraceSchema)
+{
+	MockHost host(256, GetTraceSettings());
+	DiscardRecordedEvents();
+
+	host.GetGrid().AddForest(SC4Rect<int32_t>(0, 0, 63, 63), 50, 3);
+	host.KeyDown('B', MockHost::ModifierAlt);
+	host.MouseDown(0, 0);
+	host.MouseMove(40, 40);
+	host.MouseWheel(120, MockHost::ModifierAlt);
+	host.MouseUp();
+
+	// Control + Shift + T writes the trace.
+	EXPECT_TRUE(host.KeyDown('T', MockHost::ModifierControl | MockHost::ModifierShift));
+
+	const TraceFile trace = ReadTrace(FileSystem::GetTraceFilePath());
+
+	EXPECT_EQ(trace.droppedEvents, 0u);
+	EXPECT_GE(CountEvents(trace, "OnKeyDown"), 1u);
+	EXPECT_EQ(CountEvents(trace, "OnMouseWheel"), 1u);
+	EXPECT_EQ(CountEvents(trace, "DemolishSelection"), 1u);
+	EXPECT_GE(CountEvents(trace, "UpdateDiagonalRegion"), 1u);
+	EXPECT_GE(CountEvents(trace, "cISC4Demolition::DemolishRegion"), 1u);
+
+	for (const TraceEvent& event : trace.events)
+	{
+		EXPECT_GE(event.timestamp, 0.0);
+		EXPECT_GE(event.duration, 0.0);
+		EXPECT_GE(event.cellCount, 0);
+
+		if (event.name == "DemolishSelection")
+		{
+			// The diagonal mode flag and the thickness that the wheel selected.
+			EXPECT_EQ(event.mode, 0x100);
+			EXPECT_EQ(event.thickness, 2);
+			EXPECT_EQ(event.cellCount, 41 * 41);
+		}
+	}
+}
+
+TEST(TraceRecorderTests, WriteEmptiesTheBuffers)
+{
+	DiscardRecordedEvents();
+
+	const std::filesystem::path path = FileSystem::GetTraceFilePath();
+	TraceRecorder& recorder = TraceRecorder::GetInstance();
+
+	RecordEvents("First", 3);
+	ASSERT_TRUE(recorder.Write(path));
+	EXPECT_EQ(CountEvents(ReadTrace(path), "First"), 3u);
+
+	RecordEvents("Second", 2);
+	ASSERT_TRUE(recorder.Write(path));
+
+	const TraceFile trace = ReadTrace(path);
+
+	EXPECT_EQ(trace.events.size(), 2u);
+	EXPECT_EQ(CountEvents(trace, "Second"), 2u);
+
+	ASSERT_TRUE(recorder.Write(path));
+	EXPECT_TRUE(ReadTrace(path).events.empty());
+}
+
+TEST(TraceRecorderTests, FullBufferRecordsAgainAfterWrite)
+{
+	DiscardRecordedEvents();
+
+	const std::filesystem::path path = FileSystem::GetTraceFilePath();
+	TraceRecorder& recorder = TraceRecorder::GetInstance();
+
+	// A new thread starts with an empty buffer.
+	std::thread([]() { RecordEvents("Fill", EventsPerThread + 10); }).join();
+
+	ASSERT_TRUE(recorder.Write(path));
+
+	TraceFile trace = ReadTrace(path);
+
+	EXPECT_EQ(CountEvents(trace, "Fill"), EventsPerThread);
+	EXPECT_EQ(trace.droppedEvents, 10u);
+
+	RecordEvents("AfterWrite", 1);
+	ASSERT_TRUE(recorder.Write(path));
+
+	trace = ReadTrace(path);
+
+	EXPECT_EQ(CountEvents(trace, "AfterWrite"), 1u);
+	EXPECT_EQ(trace.droppedEvents, 0u);
+}
+
+TEST(TraceRecorderTests, ExitedThreadBuffersAreReused)
+{
+	DiscardRecordedEvents();
+
+	const std::filesystem::path path = FileSystem::GetTraceFilePath();
+	TraceRecorder& recorder = TraceRecorder::GetInstance();
+
+	// The buffer of an exited thread is not reused while it has unwritten events,
+	// the events keep the ID of the thread that recorded them.
+	std::thread([]() { RecordEvents("Exited", 4); }).join();
+	std::thread([]() { RecordEvents("Unwritten", 1); }).join();
+
+	ASSERT_TRUE(recorder.Write(path));
+
+	const TraceFile trace = ReadTrace(path);
+	std::set<uint32_t> threadIds;
+
+	for (const TraceEvent& event : trace.events)
+	{
+		threadIds.insert(event.threadId);
+	}
+
+	EXPECT_EQ(CountEvents(trace, "Exited"), 4u);
+	EXPECT_EQ(CountEvents(trace, "Unwritten"), 1u);
+	EXPECT_EQ(threadIds.size(), 2u);
+
+	// Once the events are written the buffers are reused instead of allocating new ones.
+	const size_t bufferCount = recorder.GetThreadBufferCount();
+
+	for (int i = 0; i < 8; i++)
+	{
+		std::thread([]() { RecordEvents("Reused", 1); }).join();
+		ASSERT_TRUE(recorder.Write(path));
+	}
+
+	EXPECT_EQ(recorder.GetThreadBufferCount(), bufferCount);
+}
@@ -0,0 +1,178 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays a SC4BulldozeExtensions input recording in a synthetic city and prints the
+// p50/p95/p99 latency of each event type, for the recording and for the replay.
+//
+// The replay runs the plugin's hooks in the mock SC4 host, so it works on any platform
+// that builds the tests. The city is replayed twice and the tool fails if the two
+// replays made different DemolishRegion calls.
+
+#include "InputRecorder.h"
+#include "InputReplayer.h"
+#include "MockHost.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct Options
+	{
+		const char* path = nullptr;
+		int32_t citySize = 256;
+		uint32_t forestPercent = 40;
+		int32_t roadSpacing = 16;
+		uint32_t seed = 1;
+	};
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: InputReplay [options] <input recording file>\n"
+			<< "  --city-size <cells>      The city width and height, default 256.\n"
+			<< "  --forest-percent <0-100> The share of cells with a tree, default 40.\n"
+			<< "  --road-spacing <cells>   The distance between the roads, 0 for none, default 16.\n"
+			<< "  --seed <value>           The seed of the tree placement, default 1.\n";
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* argument = argv[i];
+
+			if (argument[0] != '-')
+			{
+				if (options.path)
+				{
+					return false;
+				}
+
+				options.path = argument;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				return false;
+			}
+
+			const long value = std::strtol(argv[++i], nullptr, 10);
+
+			if (std::strcmp(argument, "--city-size") == 0 && value > 0)
+			{
+				options.citySize = static_cast<int32_t>(value);
+			}
+			else if (std::strcmp(argument, "--forest-percent") == 0 && value >= 0 && value <= 100)
+			{
+				options.forestPercent = static_cast<uint32_t>(value);
+			}
+			else if (std::strcmp(argument, "--road-spacing") == 0 && value >= 0)
+			{
+				options.roadSpacing = static_cast<int32_t>(value);
+			}
+			else if (std::strcmp(argument, "--seed") == 0 && value >= 0)
+			{
+				options.seed = static_cast<uint32_t>(value);
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options.path != nullptr;
+	}
+
+	InputReplayer::Result Replay(const Options& options, const std::vector<InputRecorder::Record>& records)
+	{
+		MockHost host(options.citySize);
+		OccupantGrid& grid = host.GetGrid();
+		const SC4Rect<int32_t> city(0, 0, options.citySize - 1, options.citySize - 1);
+
+		if (options.roadSpacing > 0)
+		{
+			grid.AddRoadGrid(city, options.roadSpacing);
+		}
+
+		grid.AddForest(city, options.forestPercent, options.seed);
+
+		InputReplayer replayer(host);
+
+		return replayer.Replay(records);
+	}
+
+	void PrintPercentiles(const char* name, const InputReplayer::Percentiles& percentiles)
+	{
+		std::printf(
+			"  %-9s p50 %10.1f us  p95 %10.1f us  p99 %10.1f us\n",
+			name,
+			static_cast<double>(percentiles.p50) / 1000.0,
+			static_cast<double>(percentiles.p95) / 1000.0,
+			static_cast<double>(percentiles.p99) / 1000.0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::vector<InputRecorder::Record> records;
+
+	if (!InputRecorder::Read(options.path, records))
+	{
+		std::cerr << options.path << " is not an input recording file." << std::endl;
+		return 1;
+	}
+
+	const InputReplayer::Result result = Replay(options, records);
+	const InputReplayer::Result repeatResult = Replay(options, records);
+
+	std::printf("Replayed %zu events, %zu diverged from the recorded tool state.\n", result.eventCount, result.divergedEventCount);
+
+	for (const InputReplayer::EventStatistics& statistics : result.statistics)
+	{
+		std::printf("%s (%zu events)\n", InputReplayer::GetEventTypeName(statistics.type), statistics.count);
+		PrintPercentiles("recorded", statistics.recorded);
+		PrintPercentiles("replayed", statistics.replayed);
+	}
+
+	std::printf("DemolishRegion checksum: %016" PRIx64 "\n", result.checksum);
+
+	if (repeatResult.checksum != result.checksum)
+	{
+		std::cerr << "The second replay made different DemolishRegion calls, checksum "
+			<< std::hex << repeatResult.checksum << "." << std::endl;
+		return 2;
+	}
+
+	return 0;
+}
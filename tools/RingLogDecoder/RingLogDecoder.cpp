@@ -0,0 +1,65 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4ClearPollution.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Prints the lines of a SC4BulldozeExtensions.ringlog file in the order that they were written.
+//
+// The decoder only uses standard C++ and the plugin's ring log format code, so it
+// can be built on any platform, for example:
+//   g++ -std=c++20 -I../../src RingLogDecoder.cpp ../../src/RingLog.cpp ../../src/MemoryMappedFile.cpp
+//   cl /std:c++20 /EHsc /I..\..\src RingLogDecoder.cpp ..\..\src\RingLog.cpp ..\..\src\MemoryMappedFile.cpp
+
+#include "RingLog.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		std::cerr << "Usage: RingLogDecoder <ring log file>" << std::endl;
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ifstream::in | std::ifstream::binary);
+
+	if (!file)
+	{
+		std::cerr << "Failed to open " << argv[1] << std::endl;
+		return 1;
+	}
+
+	const std::vector<uint8_t> fileData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	std::string text;
+
+	if (!RingLog::Decode(fileData.data(), fileData.size(), text))
+	{
+		std::cerr << argv[1] << " is not a ring log file." << std::endl;
+		return 1;
+	}
+
+	std::cout << text;
+
+	return 0;
+}